@@ -0,0 +1,116 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+#include "../TinySTL/map.h"
+#include "../TinySTL/btree_map.h"
+
+// 对比 map 与 btree_map<int, int>：
+// 1. 随机顺序插入
+// 2. 随机查找
+// 3. 顺序遍历
+// 4. 每个元素占用的堆内存（含节点头部与空闲槽位）
+// 5. btree_map 从有序区间批量建树
+// 元素个数由命令行参数给出，缺省为 1000000，可以依次测试 1M / 10M / 100M
+
+static size_t g_live_bytes = 0;
+
+void *operator new(size_t n)
+{
+  void *p = std::malloc(n + sizeof(size_t));
+  if (p == nullptr)
+    throw std::bad_alloc();
+  *static_cast<size_t *>(p) = n;
+  g_live_bytes += n;
+  return static_cast<size_t *>(p) + 1;
+}
+
+// GCC 把它内联到 ::operator new 的调用者之后，会把读取头部误报为越界与 new / free 不匹配
+#if defined(__GNUC__)
+__attribute__((noinline))
+#endif
+void operator delete(void *p) noexcept
+{
+  if (p == nullptr)
+    return;
+  size_t *q = static_cast<size_t *>(p) - 1;
+  g_live_bytes -= *q;
+  std::free(q);
+}
+
+// 带大小的版本同样按记录的大小计数
+void operator delete(void *p, size_t) noexcept
+{
+  operator delete(p);
+}
+
+template <class F>
+double time_it(F f)
+{
+  auto start = std::chrono::steady_clock::now();
+  f();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+template <class Map>
+void bench(const char *name, const std::vector<int> &keys)
+{
+  const size_t n = keys.size();
+  const size_t base = g_live_bytes;
+  Map m;
+  double insert = time_it([&]()
+                          {
+    for (size_t i = 0; i < n; ++i)
+      m.insert(tinystl::make_pair(keys[i], static_cast<int>(i))); });
+  const double bytes = static_cast<double>(g_live_bytes - base) / n;
+
+  long long sum = 0;
+  double find = time_it([&]()
+                        {
+    for (size_t i = 0; i < n; ++i)
+      sum += m.find(keys[(i * 7919) % n])->second; });
+
+  double traverse = time_it([&]()
+                            {
+    for (auto it = m.begin(); it != m.end(); ++it)
+      sum += it->second; });
+
+  std::cout << name << " insert: " << insert << " ms, find: " << find
+            << " ms, traverse: " << traverse << " ms, " << bytes
+            << " bytes/elem (checksum " << sum << ")" << std::endl;
+}
+
+void bench_bulk(const std::vector<int> &keys)
+{
+  std::vector<tinystl::pair<int, int>> sorted(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i)
+    sorted[i] = tinystl::make_pair(static_cast<int>(i), static_cast<int>(i));
+  const size_t base = g_live_bytes;
+  tinystl::btree_map<int, int> *m = nullptr;
+  double build = time_it([&]()
+                         { m = new tinystl::btree_map<int, int>(sorted.data(), sorted.data() + sorted.size()); });
+  const double bytes = static_cast<double>(g_live_bytes - base - sizeof(*m)) / keys.size();
+  std::cout << "btree_map<int, int> bulk load: " << build << " ms, " << bytes
+            << " bytes/elem" << std::endl;
+  delete m;
+}
+
+int main(int argc, char **argv)
+{
+  const size_t n = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 1000000;
+  std::vector<int> keys(n);
+  for (size_t i = 0; i < n; ++i)
+    keys[i] = static_cast<int>(i);
+  std::mt19937 rng(1);
+  for (size_t i = n - 1; i > 0; --i)
+    std::swap(keys[i], keys[rng() % (i + 1)]);
+
+  std::cout << n << " keys" << std::endl;
+  bench<tinystl::map<int, int>>("map<int, int>      ", keys);
+  bench<tinystl::btree_map<int, int>>("btree_map<int, int>", keys);
+  bench_bulk(keys);
+  return 0;
+}
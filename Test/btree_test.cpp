@@ -0,0 +1,51 @@
+#include <iostream>
+#include <string>
+#include "../TinySTL/btree_map.h"
+#include "../TinySTL/btree_set.h"
+
+template <class Set>
+void printSet(const Set &s)
+{
+  for (auto it = s.begin(); it != s.end(); ++it)
+    std::cout << *it << " ";
+  std::cout << std::endl;
+}
+
+int main()
+{
+  // 元素足够多，使树有多层
+  tinystl::btree_set<int> s;
+  for (int i = 0; i < 1000; ++i)
+    s.insert((i * 37) % 1000);
+  std::cout << "size: " << s.size() << ", first: " << *s.begin() << ", last: " << *s.rbegin() << std::endl;
+
+  s.erase(s.lower_bound(10), s.lower_bound(990));
+  printSet(s);
+
+  tinystl::btree_multiset<int> ms = {5, 1, 3, 3, 3, 2};
+  printSet(ms);
+  std::cout << "count(3): " << ms.count(3) << ", erase(3): " << ms.erase(3) << std::endl;
+  printSet(ms);
+
+  tinystl::btree_map<std::string, int> m;
+  m["one"] = 1;
+  m["two"] = 2;
+  m["three"] = 3;
+  m.emplace("four", 4);
+  for (auto &kv : m)
+    std::cout << kv.first << ":" << kv.second << " ";
+  std::cout << std::endl;
+  std::cout << "at(two): " << m.at("two") << ", find(five) == end: " << (m.find("five") == m.end()) << std::endl;
+
+  // 有序区间批量建树
+  tinystl::pair<int, int> sorted[100];
+  for (int i = 0; i < 100; ++i)
+    sorted[i] = tinystl::make_pair(i, i * i);
+  tinystl::btree_multimap<int, int> mm(sorted, sorted + 100);
+  std::cout << "size: " << mm.size() << ", lower_bound(50): " << mm.lower_bound(50)->second
+            << ", upper_bound(98): " << mm.upper_bound(98)->second << std::endl;
+
+  tinystl::btree_multimap<int, int> mm2 = mm;
+  std::cout << "copy equal: " << (mm2 == mm) << std::endl;
+  return 0;
+}
@@ -0,0 +1,87 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "../TinySTL/list.h"
+#include "../TinySTL/map.h"
+
+// compact 前后的遍历速度对比
+// list: 随机值排序后，结点在内存中的顺序与遍历顺序无关
+// map : 以随机顺序插入键，并穿插其他分配，模拟长时间运行后结点分散的情况
+
+const int kSize = 1000000;
+const int kRounds = 10;
+
+template <class F>
+double time_it(F f)
+{
+  auto start = std::chrono::steady_clock::now();
+  f();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void bench_list()
+{
+  std::mt19937 rng(1);
+  tinystl::list<int> l;
+  for (int i = 0; i < kSize; ++i)
+    l.push_back(static_cast<int>(rng() % kSize));
+  l.sort();
+
+  long long sum = 0;
+  auto traverse = [&]()
+  {
+    for (int r = 0; r < kRounds; ++r)
+      for (auto it = l.begin(); it != l.end(); ++it)
+        sum += *it;
+  };
+  double before = time_it(traverse);
+  double compact = time_it([&]()
+                           { l.compact(); });
+  double after = time_it(traverse);
+  std::cout << "list<int>     traverse x" << kRounds << ": " << before << " ms -> " << after
+            << " ms (compact " << compact << " ms, checksum " << sum << ")" << std::endl;
+}
+
+void bench_map()
+{
+  std::mt19937 rng(2);
+  std::vector<int> keys(kSize);
+  for (int i = 0; i < kSize; ++i)
+    keys[i] = i;
+  for (int i = kSize - 1; i > 0; --i)
+    std::swap(keys[i], keys[rng() % (i + 1)]);
+
+  tinystl::map<int, int> m;
+  std::vector<int *> noise;
+  for (int i = 0; i < kSize; ++i)
+  {
+    m.insert(tinystl::make_pair(keys[i], i));
+    if (i % 2 == 0)
+      noise.push_back(new int(i));
+  }
+  for (int *p : noise)
+    delete p;
+
+  long long sum = 0;
+  auto traverse = [&]()
+  {
+    for (int r = 0; r < kRounds; ++r)
+      for (auto it = m.begin(); it != m.end(); ++it)
+        sum += it->second;
+  };
+  double before = time_it(traverse);
+  double compact = time_it([&]()
+                           { m.compact(); });
+  double after = time_it(traverse);
+  std::cout << "map<int, int> traverse x" << kRounds << ": " << before << " ms -> " << after
+            << " ms (compact " << compact << " ms, checksum " << sum << ")" << std::endl;
+}
+
+int main()
+{
+  bench_list();
+  bench_map();
+  return 0;
+}
@@ -0,0 +1,197 @@
+#include <iostream>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "../TinySTL/list.h"
+#include "../TinySTL/map.h"
+#include "../TinySTL/set.h"
+
+// compact 之后内容、顺序与大小不变，之后的 splice / merge / insert / erase 仍然正确
+
+template <class Container, class Expected>
+bool same_contents(const Container &c, const Expected &e)
+{
+  if (c.size() != e.size())
+    return false;
+  auto ei = e.begin();
+  for (auto it = c.begin(); it != c.end(); ++it, ++ei)
+  {
+    if (!(*it == *ei))
+      return false;
+  }
+  auto re = e.rbegin();
+  for (auto it = c.rbegin(); it != c.rend(); ++it, ++re)
+  {
+    if (!(*it == *re))
+      return false;
+  }
+  return true;
+}
+
+// 相邻元素的地址间隔都相同，说明结点按遍历顺序排列在同一块内存中
+template <class Container>
+bool contiguous(const Container &c)
+{
+  if (c.size() < 3)
+    return true;
+  auto it = c.begin();
+  const char *prev = reinterpret_cast<const char *>(&*it);
+  ++it;
+  const ptrdiff_t step = reinterpret_cast<const char *>(&*it) - prev;
+  for (; it != c.end(); ++it)
+  {
+    const char *cur = reinterpret_cast<const char *>(&*it);
+    if (cur - prev != step)
+      return false;
+    prev = cur;
+  }
+  return true;
+}
+
+void test_list()
+{
+  // 插入删除交错，使结点在内存中分散
+  tinystl::list<std::string> l;
+  std::vector<std::string> expect;
+  for (int i = 0; i < 2000; ++i)
+  {
+    if (i % 2)
+      l.push_back(std::to_string(i));
+    else
+      l.push_front(std::to_string(i));
+  }
+  l.remove_if([](const std::string &s)
+              { return s.size() == 3; });
+  for (auto it = l.begin(); it != l.end(); ++it)
+    expect.push_back(*it);
+
+  l.compact();
+  bool ok = same_contents(l, expect) && contiguous(l);
+  std::cout << "list compact: contents / order / size " << same_contents(l, expect)
+            << ", contiguous " << contiguous(l) << ", size " << l.size() << std::endl;
+
+  // compact 之后 splice 到另一个 list，再在两边插入删除，结点要能各自释放
+  tinystl::list<std::string> other{"x", "y"};
+  auto mid = l.begin();
+  for (int k = 0; k < 500; ++k)
+    ++mid;
+  other.splice(++other.begin(), l, l.begin(), mid);
+  std::vector<std::string> expect_other;
+  expect_other.push_back("x");
+  expect_other.insert(expect_other.end(), expect.begin(), expect.begin() + 500);
+  expect_other.push_back("y");
+  expect.erase(expect.begin(), expect.begin() + 500);
+  ok = ok && same_contents(l, expect) && same_contents(other, expect_other);
+
+  l.erase(l.begin());
+  expect.erase(expect.begin());
+  l.push_back("tail");
+  expect.push_back("tail");
+  other.pop_front();
+  expect_other.erase(expect_other.begin());
+  other.sort();
+  std::sort(expect_other.begin(), expect_other.end());
+  ok = ok && same_contents(l, expect) && same_contents(other, expect_other);
+
+  // 再次 compact，然后 merge 两个 list
+  l.sort();
+  std::sort(expect.begin(), expect.end());
+  l.compact();
+  other.compact();
+  l.merge(other);
+  expect.insert(expect.end(), expect_other.begin(), expect_other.end());
+  std::sort(expect.begin(), expect.end());
+  ok = ok && same_contents(l, expect) && other.empty();
+  l.clear();
+  std::cout << "list splice / erase / sort / merge after compact: " << ok << std::endl;
+
+  // splice 只修改指针：转移后迭代器与元素地址不变；compact 的 list 先析构，块中的结点仍归新的 list
+  tinystl::list<std::string> dest;
+  bool stable = true;
+  {
+    tinystl::list<std::string> src;
+    for (int i = 0; i < 100; ++i)
+      src.push_back(std::to_string(i));
+    src.compact();
+    auto first = src.begin();
+    auto last = --src.end();
+    const std::string *first_addr = &*first;
+    const std::string *last_addr = &*last;
+    dest.splice(dest.end(), src, first);
+    dest.splice(dest.begin(), src, last);
+    auto from = src.begin();
+    for (int k = 0; k < 10; ++k)
+      ++from;
+    auto kept = from;
+    const std::string *kept_addr = &*kept;
+    dest.splice(dest.end(), src, from, src.end());
+    stable = &*first == first_addr && *first == "0" && &*last == last_addr && *last == "99" &&
+             &*kept == kept_addr && *kept == "11" && dest.size() == 2 + 88 && src.size() == 10;
+  }
+  dest.erase(dest.begin());
+  dest.push_back("new");
+  stable = stable && dest.front() == "0" && dest.back() == "new" && dest.size() == 90;
+  std::cout << "list splice after compact keeps iterators and addresses: " << stable << std::endl;
+}
+
+void test_map()
+{
+  tinystl::map<int, std::string> m;
+  for (int i = 0; i < 3000; ++i)
+    m[(i * 7919) % 3001] = std::to_string(i);
+  for (int i = 0; i < 3000; i += 3)
+    m.erase((i * 7919) % 3001);
+  std::vector<tinystl::pair<const int, std::string>> expect;
+  for (auto it = m.begin(); it != m.end(); ++it)
+    expect.push_back(*it);
+
+  m.compact();
+  std::cout << "map compact: contents / order / size " << same_contents(m, expect)
+            << ", contiguous " << contiguous(m) << ", size " << m.size() << std::endl;
+
+  // compact 之后插入、删除、提取与合并
+  bool ok = true;
+  for (int k = 5000; k < 5100; ++k)
+    m.emplace(k, "new");
+  for (int k = 5000; k < 5100; k += 2)
+    ok = ok && m.erase(k) == 1;
+  for (int k = 0; k < 10; ++k)
+    m.erase(m.begin());
+  auto nh = m.extract(m.begin()->first);
+  tinystl::map<int, std::string> other;
+  other.insert(tinystl::move(nh));
+  other.emplace(-1, "neg");
+  m.merge(other);
+  size_t n = 0;
+  int prev = -2;
+  for (auto i = m.begin(); i != m.end(); ++i, ++n)
+  {
+    ok = ok && i->first > prev;
+    prev = i->first;
+  }
+  ok = ok && n == m.size() && m.size() == expect.size() + 50 - 10 + 1 && other.empty() && m.at(-1) == "neg";
+  m.clear();
+  m[1] = "one";
+  std::cout << "map insert / erase / extract / merge after compact: " << ok << ", reuse after clear " << m[1]
+            << std::endl;
+
+  tinystl::multiset<int> ms;
+  std::vector<int> mexpect;
+  for (int i = 0; i < 1000; ++i)
+    ms.insert(i % 37);
+  for (auto i = ms.begin(); i != ms.end(); ++i)
+    mexpect.push_back(*i);
+  ms.compact();
+  bool mok = same_contents(ms, mexpect) && ms.count(5) == mexpect.size() / 37 + (1000 % 37 > 5);
+  ms.erase(5);
+  tinystl::multiset<int> copy(ms);
+  mok = mok && ms.count(5) == 0 && copy.size() == ms.size() && ms.size() == mexpect.size() - 27;
+  std::cout << "multiset compact: " << mok << ", size " << ms.size() << std::endl;
+}
+
+int main()
+{
+  test_list();
+  test_map();
+  return 0;
+}
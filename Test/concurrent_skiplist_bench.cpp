@@ -0,0 +1,104 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../TinySTL/map.h"
+#include "../TinySTL/concurrent_skiplist.h"
+
+// 多个线程对同一个有序映射做随机的查找、插入、删除，统计总吞吐量：
+// 1. 由一把 std::mutex 保护的 map
+// 2. concurrent_skiplist_map
+// 键值范围为 kKeys，预先插入一半，读写比例分别为 90/10、50/50 与 10/90
+// 每个线程的操作次数由命令行参数给出，缺省为 200000
+
+const int kKeys = 100000;
+
+struct locked_map
+{
+  std::mutex lock;
+  tinystl::map<int, int> map;
+
+  bool find(int k)
+  {
+    std::lock_guard<std::mutex> lk(lock);
+    return map.find(k) != map.end();
+  }
+  void insert(int k)
+  {
+    std::lock_guard<std::mutex> lk(lock);
+    map.emplace(k, k);
+  }
+  void erase(int k)
+  {
+    std::lock_guard<std::mutex> lk(lock);
+    map.erase(k);
+  }
+};
+
+struct skiplist_map
+{
+  tinystl::concurrent_skiplist_map<int, int> map;
+
+  bool find(int k) { return map.contains(k); }
+  void insert(int k) { map.emplace(k, k); }
+  void erase(int k) { map.erase(k); }
+};
+
+// 返回每秒百万次操作
+template <class Map>
+double run(int threads, int read_percent, size_t ops)
+{
+  Map m;
+  for (int k = 0; k < kKeys; k += 2)
+    m.insert(k);
+  std::vector<std::thread> workers;
+  auto start = std::chrono::steady_clock::now();
+  for (int t = 0; t < threads; ++t)
+  {
+    workers.push_back(std::thread([&m, t, read_percent, ops]()
+                                  {
+      unsigned long long s = 0x9E3779B97F4A7C15ull * (t + 1);
+      size_t hits = 0;
+      for (size_t i = 0; i < ops; ++i)
+      {
+        s ^= s << 13;
+        s ^= s >> 7;
+        s ^= s << 17;
+        const int k = static_cast<int>(s % kKeys);
+        const int r = static_cast<int>((s >> 32) % 100);
+        if (r < read_percent)
+          hits += m.find(k);
+        else if (r % 2 == 0)
+          m.insert(k);
+        else
+          m.erase(k);
+      }
+      if (hits == static_cast<size_t>(-1))
+        std::cout << hits; }));
+  }
+  for (auto &w : workers)
+    w.join();
+  auto end = std::chrono::steady_clock::now();
+  return static_cast<double>(ops) * threads / std::chrono::duration<double>(end - start).count() / 1e6;
+}
+
+int main(int argc, char **argv)
+{
+  const size_t ops = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 200000;
+  const int counts[] = {1, 2, 4, 8, 16, 32};
+  const int reads[] = {90, 50, 10};
+  std::cout << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+  std::cout << "read%  threads   mutex+map(Mops/s)   skiplist(Mops/s)" << std::endl;
+  for (int r : reads)
+  {
+    for (int threads : counts)
+    {
+      const double a = run<locked_map>(threads, r, ops);
+      const double b = run<skiplist_map>(threads, r, ops);
+      std::cout << "  " << r << "\t" << threads << "\t\t" << a << "\t\t" << b << std::endl;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,50 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../TinySTL/concurrent_skiplist.h"
+
+int main()
+{
+  tinystl::concurrent_skiplist_map<int, std::string> m;
+  m.emplace(3, "three");
+  m.emplace(1, "one");
+  m.insert(tinystl::make_pair(2, std::string("two")));
+  std::cout << "insert existing: " << m.emplace(2, "deux").second << ", at(2): " << m.at(2) << std::endl;
+  for (auto it = m.begin(); it != m.end(); ++it)
+    std::cout << it->first << ":" << it->second << " ";
+  std::cout << std::endl;
+  std::cout << "lower_bound(2): " << m.lower_bound(2)->first
+            << ", upper_bound(2): " << m.upper_bound(2)->first
+            << ", erase(1): " << m.erase(1) << ", contains(1): " << m.contains(1) << std::endl;
+
+  // 四个线程同时插入，各自删除一半
+  tinystl::concurrent_skiplist_set<int> s;
+  std::vector<std::thread> workers;
+  for (int t = 0; t < 4; ++t)
+  {
+    workers.push_back(std::thread([&s, t]()
+                                  {
+      for (int i = t; i < 4000; i += 4)
+        s.insert(i);
+      for (int i = t; i < 4000; i += 8)
+        s.erase(i); }));
+  }
+  for (auto &w : workers)
+    w.join();
+  int prev = -1;
+  size_t n = 0;
+  bool sorted = true;
+  for (auto it = s.begin(); it != s.end(); ++it, ++n)
+  {
+    sorted = sorted && *it > prev && *it % 8 >= 4;
+    prev = *it;
+  }
+  std::cout << "size: " << s.size() << ", walked: " << n << ", sorted and correct: " << sorted << std::endl;
+
+  // 读者持有迭代器时删除元素，节点延迟到读者离开之后才释放
+  auto it = s.find(4);
+  s.erase(4);
+  std::cout << "erased but still readable: " << *it << ", find(4) == end: " << (s.find(4) == s.end()) << std::endl;
+  return 0;
+}
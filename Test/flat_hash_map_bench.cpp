@@ -0,0 +1,113 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include "../TinySTL/unordered_map.h"
+#include "../TinySTL/flat_hash_map.h"
+
+// 比较 unordered_map（拉链法）与 flat_hash_map（开放寻址，16 个槽一组探查）：
+// 插入 n 个随机键值、查找命中、查找未命中、删除一半，以及每个元素占用的堆内存
+// 查找与删除按打乱后的顺序进行，避免节点按插入顺序连续分配带来的预取优势
+// 元素个数由命令行参数给出，缺省为 1000000
+
+static size_t g_live_bytes = 0;
+
+void *operator new(size_t n)
+{
+  void *p = std::malloc(n + sizeof(size_t));
+  if (p == nullptr)
+    throw std::bad_alloc();
+  *static_cast<size_t *>(p) = n;
+  g_live_bytes += n;
+  return static_cast<size_t *>(p) + 1;
+}
+
+// GCC 把它内联到 ::operator new 的调用者之后，会把读取头部误报为越界与 new / free 不匹配
+#if defined(__GNUC__)
+__attribute__((noinline))
+#endif
+void operator delete(void *p) noexcept
+{
+  if (p == nullptr)
+    return;
+  size_t *q = static_cast<size_t *>(p) - 1;
+  g_live_bytes -= *q;
+  std::free(q);
+}
+
+// 带大小的版本同样按记录的大小计数
+void operator delete(void *p, size_t) noexcept
+{
+  operator delete(p);
+}
+
+struct int_hash
+{
+  size_t operator()(long long x) const { return static_cast<size_t>(x); }
+};
+
+template <class F>
+double time_ms(F f)
+{
+  auto start = std::chrono::steady_clock::now();
+  f();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+template <class Map>
+void bench(const char *name, const std::vector<long long> &keys, const std::vector<long long> &shuffled,
+           const std::vector<long long> &misses)
+{
+  const size_t base = g_live_bytes;
+  Map m;
+  size_t found = 0;
+  const double insert = time_ms([&]()
+                                {
+    for (size_t i = 0; i < keys.size(); ++i)
+      m.insert(tinystl::pair<const long long, long long>(keys[i], i)); });
+  const double bytes = static_cast<double>(g_live_bytes - base) / m.size();
+  const double hit = time_ms([&]()
+                             {
+    for (size_t i = 0; i < shuffled.size(); ++i)
+      found += m.find(shuffled[i]) != m.end(); });
+  const double miss = time_ms([&]()
+                              {
+    for (size_t i = 0; i < misses.size(); ++i)
+      found += m.find(misses[i]) != m.end(); });
+  const double erase = time_ms([&]()
+                               {
+    for (size_t i = 0; i < shuffled.size(); i += 2)
+      m.erase(shuffled[i]); });
+  std::cout << name << ": insert " << insert << " ms, hit " << hit << " ms, miss " << miss
+            << " ms, erase half " << erase << " ms, " << bytes << " bytes/elem"
+            << " (found " << found << ", left " << m.size() << ")" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+  const size_t n = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 1000000;
+  std::vector<long long> keys, misses;
+  unsigned long long s = 88172645463325252ull;
+  for (size_t i = 0; i < 2 * n; ++i)
+  {
+    s ^= s << 13;
+    s ^= s >> 7;
+    s ^= s << 17;
+    // 命中的键值为偶数，未命中的为奇数
+    (i < n ? keys : misses).push_back(static_cast<long long>(s >> 1) * 2 + (i < n ? 0 : 1));
+  }
+  std::vector<long long> shuffled(keys);
+  for (size_t i = shuffled.size(); i > 1; --i)
+  {
+    s ^= s << 13;
+    s ^= s >> 7;
+    s ^= s << 17;
+    tinystl::swap(shuffled[i - 1], shuffled[s % i]);
+  }
+  std::cout << n << " random long long keys" << std::endl;
+  bench<tinystl::unordered_map<long long, long long, int_hash>>("unordered_map", keys, shuffled, misses);
+  bench<tinystl::flat_hash_map<long long, long long, int_hash>>("flat_hash_map", keys, shuffled, misses);
+  return 0;
+}
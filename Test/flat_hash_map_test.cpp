@@ -0,0 +1,84 @@
+#include <iostream>
+#include <string>
+#include <stdexcept>
+#include <unordered_map>
+#include "../TinySTL/flat_hash_map.h"
+#include "../TinySTL/flat_hash_set.h"
+
+struct int_hash
+{
+  size_t operator()(int x) const { return static_cast<size_t>(x); }
+};
+
+int main()
+{
+  tinystl::flat_hash_map<int, std::string, int_hash> m;
+  m.emplace(1, "one");
+  m.insert(tinystl::make_pair(2, std::string("two")));
+  m[3] = "three";
+  std::cout << "size: " << m.size() << ", m[2]: " << m[2] << ", insert existing: "
+            << m.emplace(1, "uno").second << ", at(1): " << m.at(1)
+            << ", try_emplace(4): " << m.try_emplace(4, 3, 'x').first->second << std::endl;
+  try
+  {
+    m.at(5);
+  }
+  catch (const std::out_of_range &e)
+  {
+    std::cout << "at(5): " << e.what() << std::endl;
+  }
+  std::cout << "erase(2): " << m.erase(2) << ", erase(2): " << m.erase(2)
+            << ", count(2): " << m.count(2) << ", bucket_count: " << m.bucket_count() << std::endl;
+
+  // 与 std::unordered_map 对照，随机插入删除，覆盖墓碑与重建
+  m.clear();
+  std::unordered_map<int, std::string> ref;
+  unsigned long long s = 88172645463325252ull;
+  bool same = true;
+  for (int i = 0; i < 200000; ++i)
+  {
+    s ^= s << 13;
+    s ^= s >> 7;
+    s ^= s << 17;
+    const int k = static_cast<int>(s % 5000);
+    if ((s >> 40) % 3 == 0)
+    {
+      same = same && m.erase(k) == ref.erase(k);
+    }
+    else
+    {
+      m[k] = std::to_string(k);
+      ref[k] = std::to_string(k);
+    }
+  }
+  size_t walked = 0;
+  for (auto it = m.begin(); it != m.end(); ++it, ++walked)
+    same = same && ref.count(it->first) && ref[it->first] == it->second;
+  std::cout << "matches std::unordered_map: " << (same && walked == ref.size() && m.size() == ref.size())
+            << ", load_factor <= 7/8: " << (m.load_factor() <= 0.875f) << std::endl;
+
+  // 复制、移动、比较、合并
+  tinystl::flat_hash_map<int, std::string, int_hash> c(m);
+  std::cout << "copy == : " << (c == m);
+  c[-1] = "x";
+  std::cout << ", after change != : " << (c != m);
+  tinystl::flat_hash_map<int, std::string, int_hash> mv(tinystl::move(c));
+  std::cout << ", moved size: " << mv.size() << ", source empty: " << c.empty() << std::endl;
+  tinystl::flat_hash_map<int, std::string, int_hash> a{{1, "a"}, {2, "b"}}, b{{2, "B"}, {3, "C"}};
+  a.merge(b);
+  std::cout << "merge: a.size " << a.size() << ", a[2] " << a[2] << ", b.size " << b.size() << std::endl;
+  m.clear();
+  m.rehash(0);
+  std::cout << "clear + rehash(0): size " << m.size() << ", bucket_count " << m.bucket_count()
+            << ", begin == end: " << (m.begin() == m.end()) << std::endl;
+
+  tinystl::flat_hash_set<int, int_hash> st{5, 3, 5, 1};
+  st.insert(7);
+  int sum = 0;
+  for (auto it = st.begin(); it != st.end(); ++it)
+    sum += *it;
+  st.erase(st.find(3));
+  std::cout << "set size: " << st.size() << ", sum before erase: " << sum
+            << ", count(3): " << st.count(3) << ", count(7): " << st.count(7) << std::endl;
+  return 0;
+}
@@ -0,0 +1,72 @@
+#include <iostream>
+#include <string>
+#include "../TinySTL/flat_map.h"
+#include "../TinySTL/flat_set.h"
+
+template <class Set>
+void printSet(const Set &s)
+{
+  for (auto it = s.begin(); it != s.end(); ++it)
+    std::cout << *it << " ";
+  std::cout << std::endl;
+}
+
+template <class Map>
+void printMap(const Map &m)
+{
+  // 解引用得到的是代理 pair<const Key&, T&>，按值接收
+  for (auto kv : m)
+    std::cout << kv.first << ":" << kv.second << " ";
+  std::cout << std::endl;
+}
+
+int main()
+{
+  tinystl::flat_set<int> s = {5, 1, 4, 1, 3, 9, 2, 6};
+  printSet(s);
+  int more[] = {8, 7, 3, 0};
+  s.insert(more, more + 4);
+  printSet(s);
+  s.erase(s.lower_bound(2), s.upper_bound(6));
+  printSet(s);
+
+  tinystl::flat_multiset<int> ms = {5, 1, 3, 3, 3, 2};
+  printSet(ms);
+  std::cout << "count(3): " << ms.count(3) << ", erase(3): " << ms.erase(3) << std::endl;
+  printSet(ms);
+
+  tinystl::flat_map<std::string, int> m;
+  m["one"] = 1;
+  m["two"] = 2;
+  m["three"] = 3;
+  m.emplace("four", 4);
+  m.begin()->second = 40;
+  printMap(m);
+  std::cout << "at(two): " << m.at("two") << ", find(five) == end: " << (m.find("five") == m.end()) << std::endl;
+
+  // 批量插入：追加、排序、归并，已有的键值保留原来的实值
+  tinystl::pair<std::string, int> batch[] = {
+      tinystl::pair<std::string, int>("two", 22),
+      tinystl::pair<std::string, int>("five", 5),
+      tinystl::pair<std::string, int>("zero", 0)};
+  m.insert(batch, batch + 3);
+  printMap(m);
+
+  // 反向迭代器的 operator-> 转交给代理
+  m.rbegin()->second = 100;
+  const tinystl::flat_map<std::string, int> &cm = m;
+  std::cout << "rbegin()->first: " << m.rbegin()->first << ", rbegin()->second: " << m.rbegin()->second
+            << ", crbegin()->first: " << cm.crbegin()->first << ", (++rbegin())->first: " << (++cm.rbegin())->first << std::endl;
+
+  tinystl::pair<int, int> sorted[100];
+  for (int i = 0; i < 100; ++i)
+    sorted[i] = tinystl::make_pair(i / 2, i);
+  tinystl::flat_multimap<int, int> mm(sorted, sorted + 100);
+  std::cout << "size: " << mm.size() << ", count(7): " << mm.count(7)
+            << ", lower_bound(7): " << mm.lower_bound(7)->second
+            << ", upper_bound(48): " << mm.upper_bound(48)->second << std::endl;
+
+  tinystl::flat_multimap<int, int> mm2 = mm;
+  std::cout << "copy equal: " << (mm2 == mm) << std::endl;
+  return 0;
+}
@@ -0,0 +1,101 @@
+#include <iostream>
+#include "../TinySTL/list.h"
+#include "../TinySTL/forward_list.h"
+
+void printForwardList(const tinystl::forward_list<int> &l)
+{
+  for (tinystl::forward_list<int>::const_iterator it = l.begin(); it != l.end(); it++)
+  {
+    std::cout << *it << " ";
+  }
+  std::cout << std::endl;
+}
+
+// 简单的结点池：释放的结点串在空闲链表上，分配时优先复用，空闲链表为空时才向系统申请
+template <class Node>
+struct pool_allocator
+{
+  static void *free_list;
+  static size_t fresh; // 向系统申请的次数
+
+  static Node *allocate(size_t)
+  {
+    if (free_list == nullptr)
+    {
+      ++fresh;
+      return static_cast<Node *>(::operator new(sizeof(Node)));
+    }
+    void *p = free_list;
+    free_list = *static_cast<void **>(p);
+    return static_cast<Node *>(p);
+  }
+  static void deallocate(Node *p)
+  {
+    *reinterpret_cast<void **>(p) = free_list;
+    free_list = p;
+  }
+  static void release()
+  {
+    while (free_list != nullptr)
+    {
+      void *next = *static_cast<void **>(free_list);
+      ::operator delete(free_list);
+      free_list = next;
+    }
+  }
+};
+template <class Node>
+void *pool_allocator<Node>::free_list = nullptr;
+template <class Node>
+size_t pool_allocator<Node>::fresh = 0;
+
+int main()
+{
+  std::cout << "list node: " << sizeof(tinystl::list_node<int>)
+            << " bytes, forward_list node: " << sizeof(tinystl::forward_list_node<int>)
+            << " bytes" << std::endl;
+
+  tinystl::forward_list<int> l1;
+  for (int i = 0; i < 10; i++)
+  {
+    l1.push_front(i);
+  }
+  printForwardList(l1);
+
+  l1.sort();
+  printForwardList(l1);
+
+  auto it = l1.begin();
+  l1.insert_after(it, 100);
+  l1.erase_after(l1.before_begin());
+  printForwardList(l1);
+
+  tinystl::forward_list<int> l2 = {3, 5, 7};
+  l1.remove(100);
+  l1.merge(l2);
+  printForwardList(l1);
+
+  l1.unique();
+  l1.reverse();
+  printForwardList(l1);
+
+  // 换用结点池，释放的结点被之后的插入复用
+  typedef pool_allocator<tinystl::forward_list_node<int>> pool;
+  {
+    tinystl::forward_list<int, pool> pl;
+    for (int i = 0; i < 100; ++i)
+      pl.push_front(i);
+    pl.clear();
+    for (int i = 0; i < 100; ++i)
+      pl.push_front(i);
+    pl.sort();
+    int expect = 0;
+    bool ok = true;
+    for (auto i = pl.begin(); i != pl.end(); ++i, ++expect)
+      ok = ok && *i == expect;
+    std::cout << "pool allocator: contents " << (ok && expect == 100) << ", nodes from the system "
+              << pool::fresh << std::endl;
+  }
+  pool::release();
+  return 0;
+}
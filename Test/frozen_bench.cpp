@@ -0,0 +1,70 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "../TinySTL/set.h"
+#include "../TinySTL/frozen_set.h"
+
+// 对比三种只读查找 lower_bound(int)：
+// 1. set（rb_tree），每一层一次指针追逐
+// 2. 有序 vector 上的二分查找，后几层的访存互相独立但无法预测
+// 3. frozen_set，Eytzinger 布局的无分支查找加预取
+// 元素个数由命令行参数给出，缺省为 1000000，查找 4 * n 次随机键值
+
+template <class F>
+double time_it(F f)
+{
+  auto start = std::chrono::steady_clock::now();
+  f();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char **argv)
+{
+  const size_t n = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 1000000;
+  const size_t lookups = 4 * n;
+  std::vector<int> keys(n);
+  for (size_t i = 0; i < n; ++i)
+    keys[i] = static_cast<int>(2 * i);
+  std::mt19937 rng(1);
+  std::vector<int> queries(lookups);
+  for (size_t i = 0; i < lookups; ++i)
+    queries[i] = static_cast<int>(rng() % (2 * n + 1));
+
+  tinystl::set<int> s;
+  for (size_t i = 0; i < n; ++i)
+    s.insert(s.end(), keys[i]);
+  const int *sorted = keys.data();
+  tinystl::frozen_set<int> fs(s.begin(), s.end());
+
+  long long sum = 0;
+  double a = time_it([&]()
+                     {
+    for (size_t i = 0; i < lookups; ++i)
+    {
+      auto it = s.lower_bound(queries[i]);
+      sum += it == s.end() ? -1 : *it;
+    } });
+  double b = time_it([&]()
+                     {
+    for (size_t i = 0; i < lookups; ++i)
+    {
+      const int *p = std::lower_bound(sorted, sorted + n, queries[i]);
+      sum += p == sorted + n ? -1 : *p;
+    } });
+  double c = time_it([&]()
+                     {
+    for (size_t i = 0; i < lookups; ++i)
+    {
+      auto it = fs.lower_bound(queries[i]);
+      sum += it == fs.end() ? -1 : *it;
+    } });
+
+  std::cout << n << " keys, " << lookups << " lower_bound:" << std::endl;
+  std::cout << "set: " << a << " ms, sorted vector: " << b << " ms, frozen_set: " << c << " ms" << std::endl;
+  std::cout << "checksum: " << sum << std::endl;
+  return 0;
+}
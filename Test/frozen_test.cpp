@@ -0,0 +1,72 @@
+#include <iostream>
+#include <string>
+#include "../TinySTL/set.h"
+#include "../TinySTL/map.h"
+#include "../TinySTL/frozen_set.h"
+#include "../TinySTL/frozen_map.h"
+
+template <class Set>
+void printSet(const Set &s)
+{
+  for (auto it = s.begin(); it != s.end(); ++it)
+    std::cout << *it << " ";
+  std::cout << std::endl;
+}
+
+template <class Map>
+void printMap(const Map &m)
+{
+  // 解引用得到的是代理 pair<const Key&, T&>，按值接收
+  for (auto kv : m)
+    std::cout << kv.first << ":" << kv.second << " ";
+  std::cout << std::endl;
+}
+
+int main()
+{
+  // 乱序输入：排序、去重，底层数组按层序排列
+  tinystl::frozen_set<int> fs = {5, 1, 4, 1, 3, 9, 2, 6, 8, 7};
+  printSet(fs);
+  for (size_t i = 0; i < fs.keys().size(); ++i)
+    std::cout << fs.keys()[i] << " ";
+  std::cout << std::endl;
+  std::cout << "find(4): " << *fs.find(4) << ", count(10): " << fs.count(10)
+            << ", lower_bound(0): " << *fs.lower_bound(0)
+            << ", upper_bound(9) == end: " << (fs.upper_bound(9) == fs.end()) << std::endl;
+  for (auto it = fs.rbegin(); it != fs.rend(); ++it)
+    std::cout << *it << " ";
+  std::cout << std::endl;
+
+  // 从 set 构造，输入已经有序，不再排序
+  tinystl::set<int> s;
+  for (int i = 0; i < 20; i += 3)
+    s.insert(i);
+  tinystl::frozen_set<int> fs2(s.begin(), s.end());
+  printSet(fs2);
+  auto r = fs2.equal_range(9);
+  std::cout << "equal_range(9): [" << *r.first << ", " << *r.second << ")" << std::endl;
+
+  // frozen_map：键值重复时保留最先出现的实值，实值可以修改
+  tinystl::map<std::string, int> m;
+  m["one"] = 1;
+  m["two"] = 2;
+  m["three"] = 3;
+  tinystl::frozen_map<std::string, int> fm(m.begin(), m.end());
+  printMap(fm);
+  fm.at("two") = 22;
+  fm.find("one")->second = 11;
+  printMap(fm);
+  std::cout << "contains(four): " << fm.contains("four") << std::endl;
+  try
+  {
+    fm.at("four");
+  }
+  catch (const std::out_of_range &e)
+  {
+    std::cout << "at(four): " << e.what() << std::endl;
+  }
+
+  tinystl::frozen_map<int, char> fm2 = {{3, 'c'}, {1, 'a'}, {3, 'x'}, {2, 'b'}};
+  printMap(fm2);
+  return 0;
+}
@@ -0,0 +1,91 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "../TinySTL/unordered_map.h"
+
+// 比较 hashtable 节点保存哈希值与不保存哈希值的差别，键值为字符串
+// 插入（包括增长时的 rehash）、遍历、查找命中与查找未命中的时间
+// 字符串的长度与元素个数由命令行参数给出，缺省为 32 个字符、500000 个元素
+
+struct cached_hash
+{
+  size_t operator()(const std::string &s) const { return tinystl::hash<std::string>()(s); }
+};
+
+struct uncached_hash
+{
+  size_t operator()(const std::string &s) const { return tinystl::hash<std::string>()(s); }
+};
+
+namespace tinystl
+{
+  template <>
+  struct ht_cache_hash_code<std::string, uncached_hash> : public m_false_type
+  {
+  };
+}
+
+template <class F>
+double time_ms(F f)
+{
+  auto start = std::chrono::steady_clock::now();
+  f();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+template <class Hash>
+void bench(const char *name, const std::vector<std::string> &keys, const std::vector<std::string> &misses)
+{
+  tinystl::unordered_map<std::string, int, Hash> m;
+  const double insert = time_ms([&]()
+                                {
+    for (size_t i = 0; i < keys.size(); ++i)
+      m.emplace(keys[i], static_cast<int>(i)); });
+  long long sum = 0;
+  const double walk = time_ms([&]()
+                              {
+    for (int r = 0; r < 10; ++r)
+      for (auto it = m.begin(); it != m.end(); ++it)
+        sum += it->second; });
+  size_t found = 0;
+  const double hit = time_ms([&]()
+                             {
+    for (size_t i = 0; i < keys.size(); ++i)
+      found += m.count(keys[i]); });
+  const double miss = time_ms([&]()
+                              {
+    for (size_t i = 0; i < misses.size(); ++i)
+      found += m.count(misses[i]); });
+  const double grow = time_ms([&]()
+                              { m.rehash(m.bucket_count() * 3); });
+  std::cout << name << ": insert " << insert << " ms, iterate x10 " << walk << " ms, hit " << hit
+            << " ms, miss " << miss << " ms, rehash x3 " << grow << " ms (found " << found
+            << ", sum " << sum << ")" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+  const size_t len = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 32;
+  const size_t n = argc > 2 ? static_cast<size_t>(std::atoll(argv[2])) : 500000;
+  std::vector<std::string> keys, misses;
+  unsigned long long s = 88172645463325252ull;
+  for (size_t i = 0; i < 2 * n; ++i)
+  {
+    std::string k(len, 'x');
+    for (size_t j = 0; j < len; ++j)
+    {
+      s ^= s << 13;
+      s ^= s >> 7;
+      s ^= s << 17;
+      k[j] = static_cast<char>('a' + s % 26);
+    }
+    (i < n ? keys : misses).push_back(k);
+  }
+  std::cout << n << " strings of length " << len << std::endl;
+  bench<cached_hash>("cached    ", keys, misses);
+  bench<uncached_hash>("not cached", keys, misses);
+  return 0;
+}
@@ -0,0 +1,106 @@
+#include <iostream>
+#include <string>
+#include "../TinySTL/unordered_map.h"
+#include "../TinySTL/unordered_set.h"
+
+// 统计哈希函数与相等比较的调用次数
+static size_t hash_calls = 0;
+static size_t equal_calls = 0;
+
+struct counting_hash
+{
+  size_t operator()(const std::string &s) const
+  {
+    ++hash_calls;
+    return tinystl::hash<std::string>()(s);
+  }
+};
+
+struct counting_equal
+{
+  bool operator()(const std::string &a, const std::string &b) const
+  {
+    ++equal_calls;
+    return a == b;
+  }
+};
+
+// 不保存哈希值的对照组
+struct nocache_hash : counting_hash
+{
+};
+
+namespace tinystl
+{
+  template <>
+  struct ht_cache_hash_code<std::string, nocache_hash> : public m_false_type
+  {
+  };
+}
+
+template <class Hash>
+void run(const char *name)
+{
+  typedef tinystl::unordered_map<std::string, int, Hash, counting_equal> map_type;
+  const int n = 20000;
+  hash_calls = equal_calls = 0;
+  map_type m;
+  for (int i = 0; i < n; ++i)
+    m.emplace("key-" + std::to_string(i), i);
+  const size_t insert_hashes = hash_calls;
+
+  hash_calls = 0;
+  long long sum = 0;
+  for (auto it = m.begin(); it != m.end(); ++it)
+    sum += it->second;
+  const size_t walk_hashes = hash_calls;
+
+  hash_calls = equal_calls = 0;
+  int found = 0;
+  for (int i = 0; i < 2 * n; ++i)
+    found += static_cast<int>(m.count("key-" + std::to_string(i)));
+  const size_t find_equals = equal_calls;
+
+  hash_calls = 0;
+  m.rehash(m.bucket_count() * 4);
+  const size_t rehash_hashes = hash_calls;
+
+  // 复制保留哈希值，删除与区间删除仍然正确
+  map_type c(m);
+  bool same = c.size() == m.size();
+  for (int i = 0; i < n; i += 3)
+    same = same && c.erase("key-" + std::to_string(i)) == 1;
+  for (int i = 0; i < n; ++i)
+    same = same && (c.count("key-" + std::to_string(i)) == 1) == (i % 3 != 0);
+  c.erase(c.begin(), c.end());
+  same = same && c.empty() && m.at("key-77") == 77;
+
+  std::cout << name << ": node size " << sizeof(typename tinystl::hashtable<tinystl::pair<const std::string, int>, Hash, counting_equal>::node_type)
+            << ", hashes for " << n << " inserts: " << insert_hashes
+            << ", during iteration: " << walk_hashes
+            << ", during rehash: " << rehash_hashes
+            << ", key_equal calls for " << n << " hits + " << n << " misses: " << find_equals
+            << ", found " << found << ", sum " << sum << ", copy / erase: " << same << std::endl;
+}
+
+int main()
+{
+  std::cout << "cache_hash: string " << tinystl::hashtable<std::string, counting_hash, counting_equal>::cache_hash
+            << ", int " << tinystl::hashtable<int, tinystl::hash<int>, tinystl::equal_to<int>>::cache_hash
+            << ", specialized off " << tinystl::hashtable<std::string, nocache_hash, counting_equal>::cache_hash
+            << std::endl;
+  run<counting_hash>("cached    ");
+  run<nocache_hash>("not cached");
+
+  // 多重集合与节点句柄
+  tinystl::unordered_multiset<std::string, counting_hash, counting_equal> ms;
+  for (int i = 0; i < 1000; ++i)
+    ms.insert(std::to_string(i % 100));
+  auto nh = ms.extract(std::string("42"));
+  tinystl::unordered_multiset<std::string, counting_hash, counting_equal> other;
+  other.insert(tinystl::move(nh));
+  other.insert(std::string("42"));
+  std::cout << "multiset count(42): " << ms.count("42") << ", other count(42): " << other.count("42")
+            << ", size " << ms.size() << std::endl;
+  return 0;
+}
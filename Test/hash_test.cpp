@@ -0,0 +1,100 @@
+#include <iostream>
+#include <string>
+#include <limits>
+#include <set>
+#include "../TinySTL/functional.h"
+#include "../TinySTL/unordered_map.h"
+#include "../TinySTL/unordered_set.h"
+#include "../TinySTL/flat_hash_map.h"
+
+int main()
+{
+  // 整数：相等的值哈希值相等，相邻的值低位也不同
+  tinystl::hash<int> hi;
+  std::set<size_t> low_bits;
+  for (int i = 0; i < 1024; ++i)
+    low_bits.insert(hi(i) & 0xffff);
+  std::cout << "int: hash(42) == hash(42): " << (hi(42) == tinystl::hash<int>()(42))
+            << ", distinct low 16 bits of 0..1023: " << low_bits.size() << std::endl;
+  std::cout << "unsigned char / long long / bool: " << (tinystl::hash<unsigned char>()(7) == tinystl::hash<long long>()(7))
+            << (tinystl::hash<bool>()(true) != tinystl::hash<bool>()(false)) << std::endl;
+
+  // 浮点数
+  tinystl::hash<double> hd;
+  tinystl::hash<float> hf;
+  const double nan1 = std::numeric_limits<double>::quiet_NaN();
+  const double nan2 = -std::numeric_limits<double>::quiet_NaN();
+  std::cout << "double: hash(0.0) == hash(-0.0): " << (hd(0.0) == hd(-0.0))
+            << ", NaN == -NaN: " << (hd(nan1) == hd(nan2))
+            << ", hash(1.0) != hash(2.0): " << (hd(1.0) != hd(2.0))
+            << ", float hash(0) == hash(-0): " << (hf(0.0f) == hf(-0.0f))
+            << ", long double hash(-0) == hash(0): " << (tinystl::hash<long double>()(-0.0L) == tinystl::hash<long double>()(0.0L))
+            << std::endl;
+
+  // 指针
+  int arr[64];
+  std::set<size_t> ptr_low;
+  tinystl::hash<int *> hp;
+  for (int i = 0; i < 64; ++i)
+    ptr_low.insert(hp(arr + i) & 63);
+  std::cout << "pointer: distinct low 6 bits of 64 adjacent ints: " << (ptr_low.size() > 32)
+            << ", const pointer: " << (tinystl::hash<const int *>()(arr) == hp(arr)) << std::endl;
+
+  // 字符串：长度 0 到 200 的所有前缀的哈希值各不相同，内容相同的不同对象哈希值相同
+  tinystl::hash<std::string> hs;
+  std::string text;
+  for (int i = 0; i < 200; ++i)
+    text.push_back(static_cast<char>('a' + i % 26));
+  std::set<size_t> prefixes;
+  for (size_t n = 0; n <= text.size(); ++n)
+    prefixes.insert(hs(text.substr(0, n)));
+  bool one_byte = true;
+  for (size_t n = 1; n <= text.size(); ++n)
+  { // 改动任意一个字节都会改变哈希值
+    std::string t = text.substr(0, n);
+    const size_t h = hs(t);
+    for (size_t k = 0; k < n; ++k)
+    {
+      t[k] ^= 1;
+      one_byte = one_byte && hs(t) != h;
+      t[k] ^= 1;
+    }
+  }
+  std::cout << "string: distinct prefixes " << prefixes.size() << " of " << text.size() + 1
+            << ", equal content: " << (hs(std::string("hello")) == hs(std::string("hel") + "lo"))
+            << ", any one-bit change: " << one_byte
+            << ", hash_bytes == hash<string>: " << (tinystl::hash_bytes("hello", 5) == hs("hello"))
+            << ", seed changes: " << (tinystl::hash_bytes("hello", 5, 1) != tinystl::hash_bytes("hello", 5))
+            << ", wstring: " << (tinystl::hash<std::wstring>()(L"ab") != tinystl::hash<std::wstring>()(L"ba"))
+            << std::endl;
+
+  // pair 与 hash_combine
+  typedef tinystl::pair<int, std::string> pis;
+  tinystl::hash<pis> hpair;
+  size_t ab = 0, ba = 0;
+  tinystl::hash_combine(ab, 1);
+  tinystl::hash_combine(ab, 2);
+  tinystl::hash_combine(ba, 2);
+  tinystl::hash_combine(ba, 1);
+  std::cout << "pair: equal: " << (hpair(pis(1, "x")) == hpair(tinystl::make_pair(1, std::string("x"))))
+            << ", (1, x) != (2, x): " << (hpair(pis(1, "x")) != hpair(pis(2, "x")))
+            << ", hash_combine order matters: " << (ab != ba) << std::endl;
+
+  // 容器使用缺省的哈希函数
+  tinystl::unordered_map<int, int> um;
+  for (int i = 0; i < 10000; ++i)
+    um[i] = i * 2;
+  tinystl::unordered_set<std::string> us;
+  us.insert("apple");
+  us.insert("banana");
+  tinystl::flat_hash_map<tinystl::pair<int, int>, double> fm;
+  fm[tinystl::make_pair(1, 2)] = 0.5;
+  tinystl::unordered_map<double, int> dm;
+  dm[0.0] = 1;
+  dm[-0.0] += 1;
+  std::cout << "default hashers: unordered_map<int> " << um.size() << " " << um[1234]
+            << ", unordered_set<string> count(banana): " << us.count("banana")
+            << ", flat_hash_map<pair> " << fm[tinystl::make_pair(1, 2)]
+            << ", unordered_map<double> -0.0 merged: " << dm.size() << " " << dm[0.0] << std::endl;
+  return 0;
+}
@@ -0,0 +1,97 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+#include "../TinySTL/unordered_map.h"
+
+// 比较 hashtable 的三种 bucket 策略：ht_prime_policy（质数个 bucket，取模）、
+// ht_fastmod_policy（质数个 bucket，Lemire fastmod）与 ht_power2_policy（2 的幂个 bucket，混合后取掩码）
+// 小表全部位于缓存中，映射的代价占主要部分；大表的查找以缓存未命中为主
+// 每次查找、插入以及迭代器跨越 bucket 时都要做一次映射，这里统计查找命中、查找未命中与遍历的平均时间
+// 独立的查找之间可以重叠执行，除法的延迟会被部分掩盖，所以另外测一条依赖链：
+// 每个元素的实值是下一个要查找的键值的下标，下一次查找必须等上一次完成
+// 缺省的大表元素个数可以由命令行参数给出
+
+struct int_hash
+{
+  size_t operator()(long long x) const { return static_cast<size_t>(x); }
+};
+
+template <class F>
+double time_ns(F f)
+{
+  auto start = std::chrono::steady_clock::now();
+  f();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+template <class Policy>
+void bench(const char *name, const std::vector<long long> &keys, const std::vector<long long> &shuffled,
+           const std::vector<long long> &misses, size_t rounds)
+{
+  tinystl::unordered_map<long long, long long, int_hash, tinystl::equal_to<long long>, Policy> m;
+  for (size_t i = 0; i < shuffled.size(); ++i)
+    m.insert(tinystl::pair<const long long, long long>(shuffled[i], (i + 1) % shuffled.size()));
+  size_t found = 0;
+  long long next = 0;
+  const double chain = time_ns([&]()
+                               {
+    for (size_t r = 0; r < rounds; ++r)
+      for (size_t i = 0; i < shuffled.size(); ++i)
+        next = m.find(shuffled[next])->second; });
+  const double hit = time_ns([&]()
+                             {
+    for (size_t r = 0; r < rounds; ++r)
+      for (size_t i = 0; i < shuffled.size(); ++i)
+        found += m.find(shuffled[i]) != m.end(); });
+  const double miss = time_ns([&]()
+                              {
+    for (size_t r = 0; r < rounds; ++r)
+      for (size_t i = 0; i < misses.size(); ++i)
+        found += m.find(misses[i]) != m.end(); });
+  long long sum = 0;
+  const double walk = time_ns([&]()
+                              {
+    for (size_t r = 0; r < rounds; ++r)
+      for (auto it = m.begin(); it != m.end(); ++it)
+        sum += it->second; });
+  const double lookups = static_cast<double>(rounds * keys.size());
+  std::cout << name << ": buckets " << m.bucket_count() << ", dependent hit " << chain / lookups
+            << " ns, hit " << hit / lookups << " ns, miss " << miss / lookups << " ns, iterate "
+            << walk / lookups << " ns/elem (found " << found << ", sum " << sum + next << ")" << std::endl;
+}
+
+void run(size_t n, size_t rounds)
+{
+  std::vector<long long> keys, misses;
+  unsigned long long s = 88172645463325252ull;
+  for (size_t i = 0; i < 2 * n; ++i)
+  {
+    s ^= s << 13;
+    s ^= s >> 7;
+    s ^= s << 17;
+    // 命中的键值为偶数，未命中的为奇数
+    (i < n ? keys : misses).push_back(static_cast<long long>(s >> 1) * 2 + (i < n ? 0 : 1));
+  }
+  std::vector<long long> shuffled(keys);
+  for (size_t i = shuffled.size(); i > 1; --i)
+  {
+    s ^= s << 13;
+    s ^= s >> 7;
+    s ^= s << 17;
+    tinystl::swap(shuffled[i - 1], shuffled[s % i]);
+  }
+  std::cout << n << " random long long keys, " << rounds << " rounds" << std::endl;
+  bench<tinystl::ht_prime_policy>("prime  ", keys, shuffled, misses, rounds);
+  bench<tinystl::ht_fastmod_policy>("fastmod", keys, shuffled, misses, rounds);
+  bench<tinystl::ht_power2_policy>("power2 ", keys, shuffled, misses, rounds);
+}
+
+int main(int argc, char **argv)
+{
+  const size_t n = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 1000000;
+  run(4096, 1000);
+  run(n, 4);
+  return 0;
+}
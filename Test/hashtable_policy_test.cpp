@@ -0,0 +1,112 @@
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include "../TinySTL/unordered_map.h"
+#include "../TinySTL/unordered_set.h"
+
+struct int_hash
+{
+  size_t operator()(int x) const { return static_cast<size_t>(x); }
+};
+
+// 低 16 位全为 0 的哈希值，只取低位的映射会把它们全部放进同一个 bucket
+struct shifted_hash
+{
+  size_t operator()(int x) const { return static_cast<size_t>(x) << 16; }
+};
+
+// 在同一组随机操作下与 std::unordered_map 对照，并检查每个元素都位于 bucket(key) 中
+template <class Policy>
+bool check_policy(const char *name)
+{
+  tinystl::unordered_map<int, std::string, int_hash, tinystl::equal_to<int>, Policy> m;
+  std::unordered_map<int, std::string> ref;
+  unsigned long long s = 88172645463325252ull;
+  bool same = true;
+  for (int i = 0; i < 100000; ++i)
+  {
+    s ^= s << 13;
+    s ^= s >> 7;
+    s ^= s << 17;
+    const int k = static_cast<int>(s % 20000) - 10000;
+    if ((s >> 40) % 3 == 0)
+    {
+      same = same && m.erase(k) == ref.erase(k);
+    }
+    else
+    {
+      m[k] = std::to_string(k);
+      ref[k] = std::to_string(k);
+    }
+  }
+  size_t walked = 0;
+  for (auto it = m.begin(); it != m.end(); ++it, ++walked)
+    same = same && ref.count(it->first) && ref[it->first] == it->second;
+  for (size_t b = 0; b < m.bucket_count(); ++b)
+  {
+    for (auto it = m.begin(b); it != m.end(b); ++it)
+      same = same && m.bucket(it->first) == b;
+  }
+  std::cout << name << ": matches std::unordered_map: " << (same && walked == ref.size() && m.size() == ref.size())
+            << ", bucket_count: " << m.bucket_count() << std::endl;
+  return same;
+}
+
+int main()
+{
+  check_policy<tinystl::ht_prime_policy>("prime");
+  check_policy<tinystl::ht_fastmod_policy>("fastmod");
+  check_policy<tinystl::ht_power2_policy>("power2");
+
+  // fastmod 的结果与取模完全相同
+  tinystl::ht_fastmod_policy fm;
+  bool exact = true;
+  const size_t sizes[] = {1, 2, 3, 101, 65521, 1000003, 4294967291u};
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+  {
+    fm.reset(sizes[i]);
+    unsigned long long s = 2463534242ull;
+    for (int j = 0; j < 100000; ++j)
+    {
+      s ^= s << 13;
+      s ^= s >> 7;
+      s ^= s << 17;
+      const size_t h = static_cast<size_t>(s);
+      const unsigned long long folded = (s ^ (s >> 32)) & 0xffffffffull;
+      exact = exact && fm.index(h) == folded % sizes[i];
+    }
+  }
+  std::cout << "fastmod == %: " << exact << std::endl;
+
+  // 2 的幂策略的 bucket 数量，以及混合步骤对低位相同的哈希值的作用
+  tinystl::unordered_set<int, shifted_hash, tinystl::equal_to<int>, tinystl::ht_power2_policy> ps;
+  for (int i = 0; i < 4096; ++i)
+    ps.insert(i);
+  const size_t n = ps.bucket_count();
+  size_t longest = 0;
+  for (size_t b = 0; b < n; ++b)
+    longest = ps.bucket_size(b) > longest ? ps.bucket_size(b) : longest;
+  std::cout << "power2 bucket_count: " << n << ", is power of two: " << ((n & (n - 1)) == 0)
+            << ", longest chain with low bits zero: " << longest << std::endl;
+
+  // 复制、移动、交换后映射仍与 bucket 数量一致
+  tinystl::unordered_set<int, shifted_hash, tinystl::equal_to<int>, tinystl::ht_power2_policy> small;
+  small.insert(7);
+  tinystl::unordered_set<int, shifted_hash, tinystl::equal_to<int>, tinystl::ht_power2_policy> copy(ps);
+  copy.swap(small);
+  bool found = small.size() == 4096 && copy.size() == 1 && copy.count(7) == 1;
+  for (int i = 0; i < 4096; ++i)
+    found = found && small.count(i) == 1;
+  tinystl::unordered_set<int, shifted_hash, tinystl::equal_to<int>, tinystl::ht_power2_policy> moved(tinystl::move(small));
+  found = found && moved.count(4095) == 1;
+  moved.rehash(100000);
+  found = found && moved.count(123) == 1 && moved.bucket_count() == 131072;
+  std::cout << "copy / swap / move / rehash: " << found << std::endl;
+
+  tinystl::unordered_multimap<int, int, int_hash, tinystl::equal_to<int>, tinystl::ht_fastmod_policy> mm;
+  for (int i = 0; i < 1000; ++i)
+    mm.emplace(i % 10, i);
+  std::cout << "multimap fastmod count(3): " << mm.count(3) << ", max_bucket_count: "
+            << mm.max_bucket_count() << std::endl;
+  return 0;
+}
@@ -0,0 +1,73 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "../TinySTL/map.h"
+#include "../TinySTL/interval_map.h"
+
+// 查询与 [a, b] 相交的所有区间：
+// 1. multimap<low, high> 上的线性扫描
+// 2. multimap 上扫描到左端点大于 b 为止（只对左端点剪枝）
+// 3. interval_map，按子树最大右端点剪枝
+// 区间个数由命令行参数给出，缺省为 100000，区间长度多数较短，少数很长
+
+template <class F>
+double time_it(F f)
+{
+  auto start = std::chrono::steady_clock::now();
+  f();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char **argv)
+{
+  const size_t n = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 100000;
+  const size_t queries = 2000;
+  const int domain = 100000000;
+  std::mt19937 rng(1);
+  tinystl::multimap<int, int> mm;
+  tinystl::interval_map<int, int> im;
+  for (size_t i = 0; i < n; ++i)
+  {
+    const int low = static_cast<int>(rng() % domain);
+    const int len = (i % 100 == 0) ? static_cast<int>(rng() % 1000000) : static_cast<int>(rng() % 1000);
+    mm.emplace(low, low + len);
+    im.insert(low, low + len, static_cast<int>(i));
+  }
+  std::vector<int> qa(queries);
+  for (size_t i = 0; i < queries; ++i)
+    qa[i] = static_cast<int>(rng() % domain);
+
+  size_t found1 = 0, found2 = 0, found3 = 0;
+  double a = time_it([&]()
+                     {
+    for (size_t q = 0; q < queries; ++q)
+    {
+      const int lo = qa[q], hi = qa[q] + 10000;
+      for (auto it = mm.begin(); it != mm.end(); ++it)
+        if (it->first <= hi && it->second >= lo)
+          ++found1;
+    } });
+  double b = time_it([&]()
+                     {
+    for (size_t q = 0; q < queries; ++q)
+    {
+      const int lo = qa[q], hi = qa[q] + 10000;
+      for (auto it = mm.begin(); it != mm.end() && it->first <= hi; ++it)
+        if (it->second >= lo)
+          ++found2;
+    } });
+  double c = time_it([&]()
+                     {
+    for (size_t q = 0; q < queries; ++q)
+      im.for_each_overlap(qa[q], qa[q] + 10000, [&found3](tinystl::pair<const tinystl::pair<int, int>, int> &)
+                          { ++found3; }); });
+
+  std::cout << n << " intervals, " << queries << " overlap queries:" << std::endl;
+  std::cout << "multimap scan: " << a << " ms, scan until low > b: " << b
+            << " ms, interval_map: " << c << " ms" << std::endl;
+  std::cout << "found: " << found1 << " / " << found2 << " / " << found3 << std::endl;
+  return 0;
+}
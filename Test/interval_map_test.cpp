@@ -0,0 +1,49 @@
+#include <iostream>
+#include <string>
+#include "../TinySTL/interval_map.h"
+
+typedef tinystl::interval_map<int, std::string> schedule;
+
+template <class Vector>
+void printResult(const char *title, const Vector &v)
+{
+  std::cout << title;
+  for (size_t i = 0; i < v.size(); ++i)
+    std::cout << "[" << v[i]->first.first << ", " << v[i]->first.second << "]:" << v[i]->second << " ";
+  std::cout << std::endl;
+}
+
+int main()
+{
+  // 会议时间表，区间为闭区间
+  schedule s;
+  s.insert(9, 10, "standup");
+  s.insert(10, 12, "review");
+  s.insert(13, 14, "lunch");
+  s.insert(11, 17, "oncall");
+  s.insert(15, 16, "sync");
+  s.insert(9, 10, "standup-2");
+
+  printResult("overlaps [12, 13]: ", s.overlaps(12, 13));
+  printResult("stab 10: ", s.stab(10));
+  printResult("stab 18: ", s.stab(18));
+  std::cout << "overlaps_any [17, 20]: " << s.overlaps_any(17, 20)
+            << ", find_overlap [14, 15]: " << s.find_overlap(14, 15)->second << std::endl;
+
+  // 删除之后子树的最大右端点随之更新
+  s.erase(s.find(schedule::interval_type(11, 17)));
+  printResult("after erase, overlaps [12, 13]: ", s.overlaps(12, 13));
+  std::cout << "count [9, 10]: " << s.count(schedule::interval_type(9, 10)) << std::endl;
+
+  // IP 段查找
+  tinystl::interval_map<unsigned, int> ranges = {
+      {{0x0A000000u, 0x0AFFFFFFu}, 10},
+      {{0xC0A80000u, 0xC0A8FFFFu}, 192},
+      {{0xC0A80100u, 0xC0A801FFu}, 1921}};
+  int total = 0;
+  ranges.for_each_containing(0xC0A80105u, [&total](tinystl::pair<const tinystl::pair<unsigned, unsigned>, int> &kv)
+                             { total += kv.second; });
+  std::cout << "ranges containing 192.168.1.5: " << ranges.stab(0xC0A80105u).size()
+            << ", sum of tags: " << total << std::endl;
+  return 0;
+}
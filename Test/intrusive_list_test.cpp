@@ -0,0 +1,96 @@
+#include <iostream>
+#include "../TinySTL/intrusive_list.h"
+
+// 一个元素同时挂在两个 intrusive_list 上：
+// lru 链表按访问顺序排列，timer 链表按加入顺序排列
+
+struct entry
+{
+  int key;
+  tinystl::intrusive_list_hook lru_hook;
+  tinystl::intrusive_list_hook timer_hook;
+
+  explicit entry(int k) : key(k) {}
+};
+
+// 不是 standard-layout 的元素：有虚函数，也有虚基类，hook 前面还有其他成员
+struct named
+{
+  const char *name;
+  virtual ~named() {}
+};
+
+struct job : virtual named
+{
+  double weight;
+  tinystl::intrusive_list_hook hook;
+  int id;
+
+  explicit job(int i) : weight(i * 0.5), id(i) { name = "job"; }
+  virtual int run() const { return id * 10; }
+};
+
+typedef tinystl::intrusive_list<entry, &entry::lru_hook> lru_list;
+typedef tinystl::intrusive_list<entry, &entry::timer_hook> timer_list;
+
+template <class List>
+void print(const char *name, const List &l)
+{
+  std::cout << name << " (" << l.size() << "): ";
+  for (typename List::const_iterator it = l.begin(); it != l.end(); ++it)
+    std::cout << it->key << " ";
+  std::cout << std::endl;
+}
+
+int main()
+{
+  entry e[5] = {entry(0), entry(1), entry(2), entry(3), entry(4)};
+  lru_list lru;
+  timer_list timers;
+  for (int i = 0; i < 5; ++i)
+  {
+    lru.push_front(e[i]);
+    timers.push_back(e[i]);
+  }
+  print("lru", lru);
+  print("timers", timers);
+
+  // 访问 e[1]：在 lru 中移到最前，不需要查找，也不分配内存
+  lru.splice(lru.begin(), lru, lru.iterator_to(e[1]));
+  print("lru after touching 1", lru);
+
+  // 淘汰最久未访问的元素，同时从 timer 链表中移除
+  entry &victim = lru.back();
+  lru.pop_back();
+  timers.erase(victim);
+  std::cout << "evicted " << victim.key
+            << ", linked: " << victim.lru_hook.is_linked() << victim.timer_hook.is_linked() << std::endl;
+  print("lru", lru);
+  print("timers", timers);
+
+  timer_list moved(tinystl::move(timers));
+  print("moved timers", moved);
+  std::cout << "old timers empty: " << timers.empty() << std::endl;
+
+  lru.clear();
+  moved.clear();
+  std::cout << "e[2] linked after clear: " << e[2].lru_hook.is_linked() << std::endl;
+
+  // hook 与元素之间的转换对多态元素同样正确
+  job jobs[] = {job(1), job(2), job(3)};
+  tinystl::intrusive_list<job, &job::hook> queue;
+  for (int i = 0; i < 3; ++i)
+    queue.push_front(jobs[i]);
+  int total = 0;
+  bool same_object = true;
+  int k = 2;
+  for (auto it = queue.begin(); it != queue.end(); ++it, --k)
+  {
+    total += it->run();
+    same_object = same_object && &*it == &jobs[k];
+  }
+  std::cout << "polymorphic elements: sum of run() " << total << ", iterators reach the original objects "
+            << same_object << ", name " << queue.front().name << std::endl;
+  queue.clear();
+  return 0;
+}
@@ -0,0 +1,57 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include "../TinySTL/list.h"
+
+// list::sort 在不同规模和输入分布下的耗时，单位为每个元素的纳秒数
+// 排序后检查结果有序
+
+enum input_kind
+{
+  kRandom,
+  kSorted,
+  kReverse
+};
+
+double bench(size_t n, input_kind kind)
+{
+  std::mt19937 rng(42);
+  tinystl::list<int> l;
+  for (size_t i = 0; i < n; ++i)
+  {
+    int v = kind == kRandom ? static_cast<int>(rng()) : (kind == kSorted ? static_cast<int>(i) : static_cast<int>(n - i));
+    l.push_back(v);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  l.sort();
+  auto end = std::chrono::steady_clock::now();
+
+  auto prev = l.begin();
+  for (auto it = prev; it != l.end(); prev = it++)
+  {
+    if (*it < *prev)
+    {
+      std::cout << "not sorted!" << std::endl;
+      break;
+    }
+  }
+  return std::chrono::duration<double, std::nano>(end - start).count() / n;
+}
+
+int main()
+{
+  const size_t sizes[] = {1000, 10000, 100000, 1000000, 10000000};
+  const input_kind kinds[] = {kRandom, kSorted, kReverse};
+  std::cout << "size\t\trandom\tsorted\treverse   (ns per element)" << std::endl;
+  for (size_t n : sizes)
+  {
+    std::cout << n << "\t";
+    if (n < 10000000)
+      std::cout << "\t";
+    for (input_kind k : kinds)
+      std::cout << bench(n, k) << "\t";
+    std::cout << std::endl;
+  }
+  return 0;
+}
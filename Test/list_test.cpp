@@ -1,4 +1,5 @@
 #include <iostream>
+#include <stdexcept>
 #include "../TinySTL/list.h"
 
 void printList(tinystl::list<int> l1)
@@ -18,5 +19,60 @@ int main()
     l1.push_back(i);
   }
   printList(l1);
+
+  // 稳定性：只按键值 (first) 比较，键值相等的元素保持原来的相对顺序 (second 递增)
+  tinystl::list<tinystl::pair<int, int>> pl;
+  for (int i = 0; i < 1000; i++)
+  {
+    pl.push_back(tinystl::make_pair((i * 7919) % 13, i));
+  }
+  pl.sort([](const tinystl::pair<int, int> &a, const tinystl::pair<int, int> &b)
+          { return a.first < b.first; });
+  bool stable = pl.size() == 1000;
+  for (auto it = pl.begin(), nx = ++pl.begin(); nx != pl.end(); ++it, ++nx)
+  {
+    stable = stable && (it->first < nx->first || (it->first == nx->first && it->second < nx->second));
+  }
+  std::cout << "sort stable: " << stable << std::endl;
+
+  // 比较函数抛出异常：元素一个不少，前后两个方向的链接仍然完整，之后还能正常排序
+  tinystl::list<int> l2;
+  long long expect = 0;
+  for (int i = 0; i < 500; i++)
+  {
+    l2.push_back((i * 31) % 97);
+    expect += (i * 31) % 97;
+  }
+  int calls = 0;
+  try
+  {
+    l2.sort([&calls](int a, int b)
+            {
+      if (++calls == 1500)
+        throw std::runtime_error("comparator failed");
+      return a < b; });
+  }
+  catch (const std::runtime_error &e)
+  {
+    std::cout << "sort threw: " << e.what();
+  }
+  long long forward = 0;
+  size_t n = 0, back = 0;
+  for (auto it = l2.begin(); it != l2.end(); ++it, ++n)
+  {
+    forward += *it;
+  }
+  for (auto it = l2.rbegin(); it != l2.rend(); ++it)
+  {
+    ++back;
+  }
+  l2.sort();
+  bool sorted = true;
+  for (auto it = l2.begin(), nx = ++l2.begin(); nx != l2.end(); ++it, ++nx)
+  {
+    sorted = sorted && !(*nx < *it);
+  }
+  std::cout << ", size " << l2.size() << ", forward " << n << ", backward " << back
+            << ", same elements " << (forward == expect) << ", sorted afterwards " << sorted << std::endl;
   return 0;
 }
\ No newline at end of file
@@ -0,0 +1,46 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "../TinySTL/map.h"
+
+// map<int, int> 区间构造：
+// 1. 有序区间，自底向上 O(n) 建树
+// 2. 打乱后的区间，逐个插入 O(n log n)
+// 元素个数由命令行参数给出，缺省为 1000000
+
+template <class F>
+double time_it(F f)
+{
+  auto start = std::chrono::steady_clock::now();
+  f();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void bench(const char *name, const std::vector<tinystl::pair<int, int>> &items)
+{
+  size_t size = 0;
+  double build = time_it([&]()
+                         {
+    tinystl::map<int, int> m(items.data(), items.data() + items.size());
+    size = m.size(); });
+  std::cout << name << ": " << build << " ms (size " << size << ")" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+  const size_t n = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 1000000;
+  std::vector<tinystl::pair<int, int>> items(n);
+  for (size_t i = 0; i < n; ++i)
+    items[i] = tinystl::make_pair(static_cast<int>(i), static_cast<int>(i));
+
+  std::cout << n << " keys" << std::endl;
+  bench("sorted  ", items);
+  std::mt19937 rng(1);
+  for (size_t i = n - 1; i > 0; --i)
+    std::swap(items[i], items[rng() % (i + 1)]);
+  bench("shuffled", items);
+  return 0;
+}
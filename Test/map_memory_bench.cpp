@@ -0,0 +1,64 @@
+#include <iostream>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include "../TinySTL/map.h"
+#include "../TinySTL/set.h"
+
+// 统计 map / set 每个元素占用的堆内存（节点大小，不含 malloc 自身的开销）
+// 元素个数由命令行参数给出，缺省为 1000000
+
+static size_t g_live_bytes = 0;
+
+void *operator new(size_t n)
+{
+  void *p = std::malloc(n + sizeof(size_t));
+  if (p == nullptr)
+    throw std::bad_alloc();
+  *static_cast<size_t *>(p) = n;
+  g_live_bytes += n;
+  return static_cast<size_t *>(p) + 1;
+}
+
+void operator delete(void *p) noexcept
+{
+  if (p == nullptr)
+    return;
+  size_t *q = static_cast<size_t *>(p) - 1;
+  g_live_bytes -= *q;
+  std::free(q);
+}
+
+// 带大小的版本同样按记录的大小计数
+void operator delete(void *p, size_t) noexcept
+{
+  operator delete(p);
+}
+
+template <class Container, class Make>
+void bench(const char *name, size_t n, Make make)
+{
+  const size_t base = g_live_bytes;
+  {
+    Container c;
+    for (size_t i = 0; i < n; ++i)
+      c.insert(make(i));
+    std::cout << name << ": " << static_cast<double>(g_live_bytes - base) / n
+              << " bytes/elem" << std::endl;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  const size_t n = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 1000000;
+  std::cout << n << " elements" << std::endl;
+  bench<tinystl::map<int, int>>("map<int, int>      ", n, [](size_t i)
+                                { return tinystl::pair<const int, int>(static_cast<int>(i), 0); });
+  bench<tinystl::set<int>>("set<int>           ", n, [](size_t i)
+                           { return static_cast<int>(i); });
+  bench<tinystl::map<long long, long long>>("map<ll, ll>        ", n, [](size_t i)
+                                            { return tinystl::pair<const long long, long long>(i, 0); });
+  bench<tinystl::multiset<char>>("multiset<char>     ", n, [](size_t i)
+                                 { return static_cast<char>(i); });
+  return 0;
+}
@@ -0,0 +1,118 @@
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include "../TinySTL/mpmc_queue.h"
+
+// 每轮使用相同数量的生产者和消费者，总共传递 kItems 个元素，
+// 统计吞吐量并用元素之和检验没有丢失或重复
+
+const long long kItems = 4000000;
+const size_t kCapacity = 1024;
+const size_t kBatch = 32;
+
+double run_single(int threads)
+{
+  tinystl::mpmc_queue<long long> q(kCapacity);
+  std::atomic<long long> sum(0);
+  std::vector<std::thread> workers;
+  const long long per = kItems / threads;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int t = 0; t < threads; ++t)
+  {
+    workers.push_back(std::thread([&q, per, t]()
+                                  {
+      for (long long i = 0; i < per; ++i)
+        q.push(t * per + i); }));
+    workers.push_back(std::thread([&q, &sum, per]()
+                                  {
+      long long local = 0, v = 0;
+      for (long long i = 0; i < per; ++i)
+      {
+        q.pop(v);
+        local += v;
+      }
+      sum += local; }));
+  }
+  for (auto &w : workers)
+    w.join();
+  auto end = std::chrono::steady_clock::now();
+
+  const long long total = per * threads;
+  if (sum.load() != total * (total - 1) / 2)
+    std::cout << "  sum mismatch: " << sum.load() << std::endl;
+  return std::chrono::duration<double>(end - start).count();
+}
+
+double run_batch(int threads)
+{
+  tinystl::mpmc_queue<long long> q(kCapacity);
+  std::atomic<long long> sum(0);
+  std::vector<std::thread> workers;
+  const long long per = kItems / threads;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int t = 0; t < threads; ++t)
+  {
+    workers.push_back(std::thread([&q, per, t]()
+                                  {
+      long long buf[kBatch];
+      long long next = 0;
+      while (next < per)
+      {
+        size_t n = 0;
+        for (; n < kBatch && next + (long long)n < per; ++n)
+          buf[n] = t * per + next + n;
+        size_t done = 0;
+        while (done < n)
+        {
+          size_t k = q.try_push_n(buf + done, n - done);
+          if (k == 0)
+            std::this_thread::yield();
+          done += k;
+        }
+        next += n;
+      } }));
+    workers.push_back(std::thread([&q, &sum, per]()
+                                  {
+      long long buf[kBatch];
+      long long local = 0, got = 0;
+      while (got < per)
+      {
+        size_t want = per - got < (long long)kBatch ? (size_t)(per - got) : kBatch;
+        size_t k = q.try_pop_n(buf, want);
+        if (k == 0)
+          std::this_thread::yield();
+        for (size_t i = 0; i < k; ++i)
+          local += buf[i];
+        got += k;
+      }
+      sum += local; }));
+  }
+  for (auto &w : workers)
+    w.join();
+  auto end = std::chrono::steady_clock::now();
+
+  const long long total = per * threads;
+  if (sum.load() != total * (total - 1) / 2)
+    std::cout << "  sum mismatch: " << sum.load() << std::endl;
+  return std::chrono::duration<double>(end - start).count();
+}
+
+int main()
+{
+  const int counts[] = {1, 2, 4, 8, 16};
+  std::cout << "producers/consumers   single(Mops/s)   batch(Mops/s)" << std::endl;
+  for (int threads : counts)
+  {
+    double s = run_single(threads);
+    double b = run_batch(threads);
+    const double items = static_cast<double>(kItems / threads * threads);
+    std::cout << "  " << threads << " / " << threads
+              << "\t\t" << items / s / 1e6
+              << "\t\t" << items / b / 1e6 << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,142 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include "../TinySTL/mpmc_queue.h"
+
+// 单线程下的边界情况，以及多生产者多消费者下每个元素恰好被取出一次
+
+const int kProducers = 4;
+const int kConsumers = 4;
+const int kPerProducer = 50000;
+
+// 多个生产者与消费者同时运行，blocking 为 true 时使用 push / pop，否则使用 try_push / try_pop
+bool run_mpmc(bool blocking)
+{
+  tinystl::mpmc_queue<int> q(64);
+  const int total = kProducers * kPerProducer;
+  std::vector<std::atomic<int>> seen(total);
+  for (auto &s : seen)
+    s.store(0);
+  std::atomic<int> consumed(0);
+  std::atomic<bool> ordered(true);
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < kProducers; ++p)
+  {
+    threads.push_back(std::thread([&, p]()
+                                  {
+      for (int i = 0; i < kPerProducer; ++i)
+      {
+        const int v = p * kPerProducer + i;
+        if (blocking)
+          q.push(v);
+        else
+          while (!q.try_push(v))
+            std::this_thread::yield();
+      } }));
+  }
+  for (int c = 0; c < kConsumers; ++c)
+  {
+    threads.push_back(std::thread([&]()
+                                  {
+      // 同一个生产者的元素在同一个消费者看来是按放入顺序取出的
+      std::vector<int> last(kProducers, -1);
+      int v;
+      while (true)
+      {
+        if (consumed.load(std::memory_order_relaxed) >= total)
+          break;
+        if (blocking)
+        {
+          // 阻塞的 pop 在没有更多元素时会一直等待，只在还有元素可取时调用
+          if (consumed.fetch_add(1) >= total)
+            break;
+          q.pop(v);
+        }
+        else
+        {
+          if (!q.try_pop(v))
+          {
+            std::this_thread::yield();
+            continue;
+          }
+          consumed.fetch_add(1);
+        }
+        seen[v].fetch_add(1, std::memory_order_relaxed);
+        const int p = v / kPerProducer;
+        if (v <= last[p])
+          ordered = false;
+        last[p] = v;
+      } }));
+  }
+  for (auto &t : threads)
+    t.join();
+
+  bool once = true;
+  for (int i = 0; i < total; ++i)
+    once = once && seen[i].load() == 1;
+  int v;
+  return once && ordered.load() && !q.try_pop(v) && q.empty_approx();
+}
+
+int main()
+{
+  // 容量向上取整为 2 的幂
+  tinystl::mpmc_queue<int> q(5);
+  std::cout << "capacity(5): " << q.capacity() << std::endl;
+
+  // 空队列上 try_pop 失败，满队列上 try_push 失败，且都不改变队列
+  int v = -1;
+  bool empty_fail = !q.try_pop(v) && v == -1 && q.size_approx() == 0;
+  int pushed = 0;
+  while (q.try_push(pushed))
+    ++pushed;
+  bool full_fail = pushed == static_cast<int>(q.capacity()) && !q.try_push(100) &&
+                   q.size_approx() == q.capacity();
+  bool fifo = true;
+  for (int i = 0; i < pushed; ++i)
+    fifo = fifo && q.try_pop(v) && v == i;
+  std::cout << "try_pop on empty fails: " << empty_fail << ", try_push on full fails after " << pushed
+            << ": " << full_fail << ", FIFO: " << fifo << ", empty again: " << (!q.try_pop(v)) << std::endl;
+
+  // 位置计数器越过容量很多圈：每一圈都先填满再取空
+  bool wrap = true;
+  int next_in = 0, next_out = 0;
+  for (int round = 0; round < 1000; ++round)
+  {
+    const int n = 1 + round % static_cast<int>(q.capacity());
+    for (int i = 0; i < n; ++i)
+      wrap = wrap && q.try_push(next_in++);
+    for (int i = 0; i < n; ++i)
+      wrap = wrap && q.try_pop(v) && v == next_out++;
+  }
+  std::cout << "wrap-around over " << next_in << " elements: " << (wrap && !q.try_pop(v)) << std::endl;
+
+  // 批量操作在满 / 空时只处理能处理的部分
+  int src[20];
+  for (int i = 0; i < 20; ++i)
+    src[i] = i;
+  int dst[20] = {};
+  const size_t in = q.try_push_n(src, 20);
+  const size_t out = q.try_pop_n(dst, 20);
+  bool batch = in == q.capacity() && out == in;
+  for (size_t i = 0; i < out; ++i)
+    batch = batch && dst[i] == static_cast<int>(i);
+  std::cout << "try_push_n / try_pop_n: " << in << " / " << out << ", in order: " << batch << std::endl;
+
+  // 析构时销毁仍在队列中的元素
+  {
+    tinystl::mpmc_queue<std::string> sq(4);
+    sq.try_push(std::string(100, 'a'));
+    sq.push(std::string(100, 'b'));
+    std::string s;
+    sq.pop(s);
+    std::cout << "string element popped: " << s.substr(0, 3) << ", left in queue: " << sq.size_approx() << std::endl;
+  }
+
+  std::cout << "MPMC try_push / try_pop, each item exactly once: " << run_mpmc(false) << std::endl;
+  std::cout << "MPMC push / pop, each item exactly once: " << run_mpmc(true) << std::endl;
+  return 0;
+}
@@ -0,0 +1,69 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include "../TinySTL/map.h"
+#include "../TinySTL/unordered_map.h"
+
+// 把一个容器中的元素全部转移到另一个容器：
+// 1. 逐个 insert 复制元素再 clear，每个元素一次分配和一次释放
+// 2. merge，只重新链接节点
+// 键值为较长的 std::string，元素个数由命令行参数给出，缺省为 200000
+
+struct string_hash
+{
+  size_t operator()(const std::string &s) const
+  {
+    size_t h = 14695981039346656037ull;
+    for (char c : s)
+      h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    return h;
+  }
+};
+
+template <class F>
+double time_it(F f)
+{
+  auto start = std::chrono::steady_clock::now();
+  f();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+std::string make_key(size_t i)
+{
+  return "node-handle-benchmark-key-" + std::to_string(i * 2654435761u % 1000000007u);
+}
+
+template <class Map>
+void bench(const char *name, size_t n)
+{
+  Map src1, src2, dst1, dst2;
+  for (size_t i = 0; i < n; ++i)
+  {
+    src1.emplace(make_key(i), static_cast<int>(i));
+    src2.emplace(make_key(i), static_cast<int>(i));
+    dst1.emplace(make_key(i + n), static_cast<int>(i));
+    dst2.emplace(make_key(i + n), static_cast<int>(i));
+  }
+
+  double copy = time_it([&]()
+                        {
+    for (auto it = src1.begin(); it != src1.end(); ++it)
+      dst1.insert(*it);
+    src1.clear(); });
+
+  double merge = time_it([&]()
+                         { dst2.merge(src2); });
+
+  std::cout << name << " " << n << ": insert + clear " << copy << " ms, merge " << merge
+            << " ms (size " << dst1.size() << " / " << dst2.size() << ")" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+  const size_t n = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 200000;
+  bench<tinystl::map<std::string, int>>("map", n);
+  bench<tinystl::unordered_map<std::string, int, string_hash>>("unordered_map", n);
+  return 0;
+}
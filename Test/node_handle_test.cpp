@@ -0,0 +1,83 @@
+#include <iostream>
+#include <string>
+#include "../TinySTL/map.h"
+#include "../TinySTL/set.h"
+#include "../TinySTL/unordered_map.h"
+#include "../TinySTL/unordered_set.h"
+
+struct int_hash
+{
+  size_t operator()(int x) const { return static_cast<size_t>(x); }
+};
+
+template <class Set>
+void printSet(const Set &s)
+{
+  for (auto it = s.begin(); it != s.end(); ++it)
+    std::cout << *it << " ";
+  std::cout << std::endl;
+}
+
+int main()
+{
+  // 摘下节点修改键值后重新插入，不分配内存
+  tinystl::map<int, std::string> m;
+  m[1] = "one";
+  m[2] = "two";
+  m[3] = "three";
+  auto nh = m.extract(2);
+  std::cout << "extract: " << nh.key() << ":" << nh.mapped() << ", size: " << m.size() << std::endl;
+  nh.key() = 20;
+  auto res = m.insert(tinystl::move(nh));
+  std::cout << "inserted: " << res.inserted << ", position: " << res.position->first << std::endl;
+  for (auto &kv : m)
+    std::cout << kv.first << ":" << kv.second << " ";
+  std::cout << std::endl;
+
+  // 键值重复时插入失败，节点留在返回值中
+  auto dup = m.extract(m.begin());
+  dup.key() = 3;
+  res = m.insert(tinystl::move(dup));
+  std::cout << "inserted: " << res.inserted << ", node kept: " << !res.node.empty()
+            << ", mapped: " << res.node.mapped() << std::endl;
+
+  // merge：键值已存在的元素留在 source 中
+  tinystl::set<int> a = {1, 3, 5, 7};
+  tinystl::set<int> b = {2, 3, 4, 5};
+  a.merge(b);
+  printSet(a);
+  printSet(b);
+
+  tinystl::multiset<int> ms = {3, 3, 9};
+  ms.merge(a);
+  printSet(ms);
+  std::cout << "a empty: " << a.empty() << std::endl;
+
+  // compact 之后的节点同样可以摘下
+  ms.compact();
+  auto snh = ms.extract(9);
+  std::cout << "value: " << snh.value() << ", size: " << ms.size() << std::endl;
+  ms.insert(ms.end(), tinystl::move(snh));
+  printSet(ms);
+
+  // 无序容器
+  tinystl::unordered_map<int, std::string, int_hash> um;
+  um[1] = "a";
+  um[2] = "b";
+  tinystl::unordered_multimap<int, std::string, int_hash> umm;
+  umm.insert(tinystl::make_pair(2, std::string("x")));
+  umm.insert(tinystl::make_pair(3, std::string("y")));
+  um.merge(umm);
+  std::cout << "size: " << um.size() << ", left: " << umm.size() << ", um[3]: " << um[3] << std::endl;
+  auto unh = um.extract(1);
+  umm.insert(tinystl::move(unh));
+  std::cout << "count(1): " << umm.count(1) << ", count(2): " << umm.count(2) << std::endl;
+
+  tinystl::unordered_set<int, int_hash> us;
+  tinystl::unordered_multiset<int, int_hash> ums;
+  for (int i = 0; i < 10; ++i)
+    ums.insert(i % 5);
+  us.merge(ums);
+  std::cout << "unique: " << us.size() << ", left: " << ums.size() << std::endl;
+  return 0;
+}
@@ -0,0 +1,55 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "../TinySTL/set.h"
+
+// set<int> 的 rank 查询：
+// 1. rb_tree_size_update，沿查找路径累加子树大小，O(log n)
+// 2. 缺省的 rb_tree_null_update，从 begin 开始计数，O(n)
+// 元素个数由命令行参数给出，缺省为 100000
+
+template <class F>
+double time_it(F f)
+{
+  auto start = std::chrono::steady_clock::now();
+  f();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+template <class Set>
+void bench(const char *name, const std::vector<int> &keys, size_t queries)
+{
+  Set s;
+  double insert = time_it([&]()
+                          {
+    for (size_t i = 0; i < keys.size(); ++i)
+      s.insert(keys[i]); });
+
+  size_t sum = 0;
+  double rank = time_it([&]()
+                        {
+    for (size_t i = 0; i < queries; ++i)
+      sum += s.rank(keys[(i * 7919) % keys.size()]); });
+
+  std::cout << name << " insert: " << insert << " ms, " << queries << " rank: " << rank
+            << " ms (checksum " << sum << ")" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+  const size_t n = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 100000;
+  std::vector<int> keys(n);
+  for (size_t i = 0; i < n; ++i)
+    keys[i] = static_cast<int>(i);
+  std::mt19937 rng(1);
+  for (size_t i = n - 1; i > 0; --i)
+    std::swap(keys[i], keys[rng() % (i + 1)]);
+
+  std::cout << n << " keys" << std::endl;
+  bench<tinystl::set<int, tinystl::less<int>, tinystl::rb_tree_size_update>>("size_update", keys, 1000);
+  bench<tinystl::set<int>>("null_update", keys, 1000);
+  return 0;
+}
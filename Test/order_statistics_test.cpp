@@ -0,0 +1,37 @@
+#include <iostream>
+#include <string>
+#include "../TinySTL/map.h"
+#include "../TinySTL/set.h"
+
+int main()
+{
+  // 带子树大小的 set，nth / rank / distance 为 O(log n)
+  tinystl::set<int, tinystl::less<int>, tinystl::rb_tree_size_update> s;
+  for (int i = 0; i < 100; ++i)
+    s.insert((i * 37) % 100);
+  s.erase(s.lower_bound(20), s.lower_bound(80));
+  std::cout << "size: " << s.size() << ", nth(0): " << *s.nth(0) << ", nth(25): " << *s.nth(25)
+            << ", nth(size) == end: " << (s.nth(s.size()) == s.end()) << std::endl;
+  std::cout << "rank(15): " << s.rank(15) << ", rank(50): " << s.rank(50) << ", rank(99): " << s.rank(99)
+            << ", distance(find(10), find(90)): " << s.distance(s.find(10), s.find(90)) << std::endl;
+
+  tinystl::multiset<int, tinystl::less<int>, tinystl::rb_tree_size_update> ms = {5, 1, 3, 3, 3, 2};
+  std::cout << "rank(3): " << ms.rank(3) << ", rank(4): " << ms.rank(4)
+            << ", distance(equal_range(3)): " << ms.distance(ms.lower_bound(3), ms.upper_bound(3)) << std::endl;
+
+  tinystl::map<std::string, int, tinystl::less<std::string>, tinystl::rb_tree_size_update> m;
+  m["one"] = 1;
+  m["two"] = 2;
+  m["three"] = 3;
+  m["four"] = 4;
+  for (size_t k = 0; k < m.size(); ++k)
+    std::cout << m.nth(k)->first << " ";
+  std::cout << std::endl;
+  std::cout << "rank(three): " << m.rank("three") << std::endl;
+
+  // 缺省的 set 不维护子树大小，同样的接口退化为线性时间
+  tinystl::set<int> plain = {4, 8, 15, 16, 23, 42};
+  std::cout << "nth(3): " << *plain.nth(3) << ", rank(20): " << plain.rank(20)
+            << ", distance: " << plain.distance(plain.begin(), plain.end()) << std::endl;
+  return 0;
+}
@@ -0,0 +1,82 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "../TinySTL/map.h"
+#include "../TinySTL/persistent_map.h"
+
+// 一个写者不断更新，读者需要一致的快照：
+// 1. 取快照：map 整棵复制，persistent_map 的 snapshot() 为 O(1)
+// 2. 没有快照时的更新吞吐
+// 3. 每 snapshot_every 次更新取一次快照时的更新吞吐（persistent_map 只复制被修改的路径）
+// 元素个数由命令行参数给出，缺省为 1000000
+
+template <class F>
+double time_it(F f)
+{
+  auto start = std::chrono::steady_clock::now();
+  f();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char **argv)
+{
+  const size_t n = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 1000000;
+  const size_t updates = 1000000;
+  const size_t snapshot_every = 1000;
+  std::vector<int> keys(updates);
+  std::mt19937 rng(1);
+  for (size_t i = 0; i < updates; ++i)
+    keys[i] = static_cast<int>(rng() % n);
+
+  tinystl::map<int, int> m;
+  tinystl::persistent_map<int, int> pm;
+  for (size_t i = 0; i < n; ++i)
+  {
+    m[static_cast<int>(i)] = 0;
+    pm.insert_or_assign(static_cast<int>(i), 0);
+  }
+  std::cout << n << " keys, " << updates << " updates" << std::endl;
+
+  double copy = time_it([&]()
+                        { tinystl::map<int, int> snap(m); });
+  double snap = time_it([&]()
+                        { auto s = pm.snapshot(); });
+  std::cout << "snapshot: map copy " << copy << " ms, persistent_map " << snap << " ms" << std::endl;
+
+  double map_update = time_it([&]()
+                              {
+    for (size_t i = 0; i < updates; ++i)
+      m[keys[i]] = static_cast<int>(i); });
+  double pm_update = time_it([&]()
+                             {
+    for (size_t i = 0; i < updates; ++i)
+      pm.insert_or_assign(keys[i], static_cast<int>(i)); });
+  std::cout << "updates without snapshots: map " << map_update << " ms, persistent_map " << pm_update
+            << " ms" << std::endl;
+
+  // map 需要整棵复制，只测 1/100 的更新量
+  const size_t map_updates = updates / 100;
+  double map_snap_update = time_it([&]()
+                                   {
+    for (size_t i = 0; i < map_updates; ++i)
+    {
+      if (i % snapshot_every == 0)
+        tinystl::map<int, int> snap(m);
+      m[keys[i]] = static_cast<int>(i);
+    } });
+  tinystl::persistent_map<int, int> reader;
+  double pm_snap_update = time_it([&]()
+                                  {
+    for (size_t i = 0; i < updates; ++i)
+    {
+      if (i % snapshot_every == 0)
+        reader = pm.snapshot();
+      pm.insert_or_assign(keys[i], static_cast<int>(i));
+    } });
+  std::cout << "updates with a snapshot every " << snapshot_every << ": map " << map_snap_update * 100
+            << " ms (extrapolated), persistent_map " << pm_snap_update << " ms" << std::endl;
+  return 0;
+}
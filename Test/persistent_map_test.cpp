@@ -0,0 +1,37 @@
+#include <iostream>
+#include <string>
+#include "../TinySTL/persistent_map.h"
+
+template <class Map>
+void printMap(const Map &m)
+{
+  for (auto it = m.begin(); it != m.end(); ++it)
+    std::cout << it->first << ":" << it->second << " ";
+  std::cout << std::endl;
+}
+
+int main()
+{
+  tinystl::persistent_map<int, std::string> m = {{3, "three"}, {1, "one"}, {2, "two"}};
+  printMap(m);
+
+  // 快照与原对象共享节点，之后的修改互不影响
+  auto v1 = m.snapshot();
+  m.insert_or_assign(2, "TWO");
+  m.insert(tinystl::make_pair(4, std::string("four")));
+  m.erase(1);
+  printMap(m);
+  printMap(v1);
+  std::cout << "v1 size: " << v1.size() << ", m size: " << m.size() << std::endl;
+
+  std::cout << "at(3): " << m.at(3) << ", count(1): " << m.count(1) << ", v1.count(1): " << v1.count(1) << std::endl;
+  std::cout << "lower_bound(2): " << m.lower_bound(2)->first << ", upper_bound(2): " << m.upper_bound(2)->first
+            << ", find(9) == end: " << (m.find(9) == m.end()) << std::endl;
+  for (auto it = m.rbegin(); it != m.rend(); ++it)
+    std::cout << it->first << " ";
+  std::cout << std::endl;
+
+  auto v2 = m.snapshot();
+  std::cout << "v2 == m: " << (v2 == m) << ", v1 == m: " << (v1 == m) << std::endl;
+  return 0;
+}
@@ -0,0 +1,211 @@
+#include <iostream>
+#include <map>
+#include "../TinySTL/map.h"
+#include "../TinySTL/set.h"
+#include "../TinySTL/vector.h"
+
+// 检查红黑树的结构：父子链接互相一致，根为黑，红节点没有红子节点，
+// 每条根到叶的路径黑高相同，header 的 left / right 为最小 / 最大节点，节点个数等于 size()
+// 返回黑高，不满足时返回 -1
+template <class BasePtr>
+int check_subtree(BasePtr x, BasePtr parent, size_t &count)
+{
+  if (x == nullptr)
+    return 1;
+  ++count;
+  if (x->parent() != parent)
+    return -1;
+  if (tinystl::rb_tree_is_red(x) &&
+      ((x->left != nullptr && tinystl::rb_tree_is_red(x->left)) ||
+       (x->right != nullptr && tinystl::rb_tree_is_red(x->right))))
+    return -1;
+  const int lh = check_subtree(x->left, x, count);
+  const int rh = check_subtree(x->right, x, count);
+  if (lh < 0 || rh < 0 || lh != rh)
+    return -1;
+  return lh + (tinystl::rb_tree_is_red(x) ? 0 : 1);
+}
+
+template <class Container>
+bool valid_rb_tree(const Container &c)
+{
+  auto header = c.end().node;
+  auto root = header->parent();
+  if (root == nullptr)
+    return c.empty() && header->left == header && header->right == header;
+  if (root->parent() != header || tinystl::rb_tree_is_red(root) || !tinystl::rb_tree_is_red(header))
+    return false;
+  if (header->left != tinystl::rb_tree_min(root) || header->right != tinystl::rb_tree_max(root))
+    return false;
+  size_t count = 0;
+  return check_subtree(root, header, count) > 0 && count == c.size();
+}
+
+// 遍历顺序：正向不递减（unique 时严格递增），反向遍历得到同样的元素
+template <class Container, class Key>
+bool in_order(const Container &c, Key key, bool unique)
+{
+  size_t n = 0;
+  for (auto it = c.begin(); it != c.end(); ++it, ++n)
+  {
+    auto next = it;
+    if (++next != c.end() && (key(*next) < key(*it) || (unique && !(key(*it) < key(*next)))))
+      return false;
+  }
+  size_t back = 0;
+  for (auto it = c.rbegin(); it != c.rend(); ++it)
+    ++back;
+  return n == c.size() && back == n;
+}
+
+int main()
+{
+  // 有序区间建树：元素个数取 0、1、2、2^k - 1、2^k、2^k + 1
+  tinystl::vector<size_t> sizes;
+  sizes.push_back(0);
+  sizes.push_back(1);
+  sizes.push_back(2);
+  for (size_t k = 2; k <= 12; ++k)
+  {
+    sizes.push_back((size_t(1) << k) - 1);
+    sizes.push_back(size_t(1) << k);
+    sizes.push_back((size_t(1) << k) + 1);
+  }
+  auto pair_key = [](const tinystl::pair<const int, int> &v)
+  { return v.first; };
+  auto int_key = [](int v)
+  { return v; };
+  bool unique_ok = true, multi_ok = true;
+  for (size_t s = 0; s < sizes.size(); ++s)
+  {
+    const size_t n = sizes[s];
+    tinystl::vector<tinystl::pair<int, int>> sorted;
+    tinystl::vector<int> keys;
+    for (size_t i = 0; i < n; ++i)
+    {
+      sorted.push_back(tinystl::make_pair(static_cast<int>(i), static_cast<int>(i * 2)));
+      keys.push_back(static_cast<int>(i));
+    }
+    tinystl::map<int, int> m(sorted.begin(), sorted.end());
+    tinystl::set<int> st(keys.begin(), keys.end());
+    unique_ok = unique_ok && m.size() == n && st.size() == n && valid_rb_tree(m) && valid_rb_tree(st) &&
+                in_order(m, pair_key, true) && in_order(st, int_key, true);
+    for (size_t i = 0; i < n; ++i)
+      unique_ok = unique_ok && m.at(static_cast<int>(i)) == static_cast<int>(i * 2);
+
+    // 重复键值：每个键值出现 1 到 3 次；multimap 保留全部且相等键值保持输入顺序，map 只保留第一个
+    tinystl::vector<tinystl::pair<int, int>> dup;
+    tinystl::vector<int> dup_keys;
+    for (size_t i = 0; i < n; ++i)
+    {
+      for (size_t r = 0; r <= i % 3; ++r)
+      {
+        dup.push_back(tinystl::make_pair(static_cast<int>(i), static_cast<int>(r)));
+        dup_keys.push_back(static_cast<int>(i));
+      }
+    }
+    tinystl::multimap<int, int> mm(dup.begin(), dup.end());
+    tinystl::multiset<int> ms(dup_keys.begin(), dup_keys.end());
+    tinystl::map<int, int> first_only(dup.begin(), dup.end());
+    multi_ok = multi_ok && mm.size() == dup.size() && ms.size() == dup_keys.size() &&
+               valid_rb_tree(mm) && valid_rb_tree(ms) && valid_rb_tree(first_only) &&
+               in_order(mm, pair_key, false) && in_order(ms, int_key, false) && first_only.size() == n;
+    size_t j = 0;
+    for (auto it = mm.begin(); it != mm.end(); ++it, ++j)
+      multi_ok = multi_ok && it->first == dup[j].first && it->second == dup[j].second;
+    for (auto it = first_only.begin(); it != first_only.end(); ++it)
+      multi_ok = multi_ok && it->second == 0;
+
+    // 建好的树之后仍然可以正常插入删除
+    m.insert(tinystl::make_pair(-1, 0));
+    m.erase(static_cast<int>(n / 2));
+    unique_ok = unique_ok && valid_rb_tree(m) && in_order(m, pair_key, true);
+  }
+  std::cout << "sorted build, sizes 0 .. 4097: map / set valid " << unique_ok
+            << ", multimap / multiset with duplicates valid " << multi_ok << std::endl;
+
+  // 无序区间走逐个插入的路径
+  int unsorted[] = {5, 3, 9, 1, 5, 7, 2};
+  tinystl::set<int> us(unsorted, unsorted + 7);
+  tinystl::multiset<int> ums{5, 3, 9, 1, 5, 7, 2};
+  std::cout << "unsorted input: set size " << us.size() << ", multiset size " << ums.size()
+            << ", valid " << (valid_rb_tree(us) && valid_rb_tree(ums) && in_order(us, int_key, true)) << std::endl;
+
+  // 颜色存放在父指针的最低位：大量随机插入删除后逐项检查父链接、颜色与黑高
+  tinystl::multimap<int, int> heavy;
+  std::multimap<int, int> ref;
+  unsigned long long x = 88172645463325252ull;
+  bool heavy_ok = true;
+  size_t checks = 0;
+  for (int step = 0; step < 200000; ++step)
+  {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    const int k = static_cast<int>(x % 4096);
+    switch ((x >> 32) % 8)
+    {
+    case 0:
+    case 1:
+    case 2:
+      heavy.insert(tinystl::make_pair(k, step));
+      ref.insert(std::make_pair(k, step));
+      break;
+    case 3:
+      heavy.emplace_hint(heavy.lower_bound(k), k, step);
+      ref.emplace_hint(ref.lower_bound(k), k, step);
+      break;
+    case 4:
+      heavy_ok = heavy_ok && heavy.erase(k) == ref.erase(k);
+      break;
+    case 5:
+    { // 删除第一个不小于 k 的元素
+      auto it = heavy.lower_bound(k);
+      auto rit = ref.lower_bound(k);
+      if (it != heavy.end())
+      {
+        heavy.erase(it);
+        ref.erase(rit);
+      }
+      break;
+    }
+    case 6:
+    { // 提取再放回，节点脱离又重新链接
+      auto nh = heavy.extract(k);
+      auto rit = ref.find(k);
+      if (rit != ref.end())
+      {
+        const int v = rit->second;
+        ref.erase(rit);
+        ref.insert(std::make_pair(k, v));
+        heavy.insert(tinystl::move(nh));
+      }
+      break;
+    }
+    default:
+      heavy.erase(heavy.lower_bound(k), heavy.upper_bound(k + 3));
+      ref.erase(ref.lower_bound(k), ref.upper_bound(k + 3));
+      break;
+    }
+    if (step % 2000 == 0)
+    {
+      heavy_ok = heavy_ok && valid_rb_tree(heavy) && heavy.size() == ref.size();
+      ++checks;
+    }
+  }
+  auto rit = ref.begin();
+  for (auto it = heavy.begin(); it != heavy.end() && heavy_ok; ++it, ++rit)
+    heavy_ok = it->first == rit->first;
+  tinystl::multimap<int, int> copied(heavy);
+  heavy_ok = heavy_ok && valid_rb_tree(heavy) && valid_rb_tree(copied) && copied.size() == ref.size();
+  while (!heavy.empty() && heavy_ok)
+  {
+    heavy.erase(heavy.begin());
+    if (heavy.size() % 512 == 0)
+      heavy_ok = valid_rb_tree(heavy);
+  }
+  std::cout << "200000 random inserts / erases: parent links, colours and black height valid " << heavy_ok
+            << " (" << checks << " checks), node size " << sizeof(tinystl::rb_tree_node<int>)
+            << ", pointer size " << sizeof(void *) << std::endl;
+  return 0;
+}
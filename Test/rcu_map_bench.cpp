@@ -0,0 +1,121 @@
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include <pthread.h>
+#include "../TinySTL/map.h"
+#include "../TinySTL/rcu_map.h"
+
+// 多个读者线程不断查找，同时一个写者线程按固定间隔修改，统计读者的查找延迟：
+// 1. 由读写锁保护的 map（C++11 没有 std::shared_mutex，这里直接使用 pthread_rwlock_t）
+// 2. rcu_map
+// 读者每 kBatch 次查找计时一次，报告平均延迟与 p99 延迟
+// 读者线程数与写者两次修改之间的间隔（微秒）由命令行参数给出，缺省为 3 与 100
+
+const int kKeys = 10000;
+const int kBatch = 64;
+const int kDurationMs = 1000;
+
+struct rwlock_map
+{
+  mutable pthread_rwlock_t lock;
+  tinystl::map<int, int> map;
+
+  rwlock_map() { pthread_rwlock_init(&lock, nullptr); }
+  ~rwlock_map() { pthread_rwlock_destroy(&lock); }
+
+  bool find(int k) const
+  {
+    pthread_rwlock_rdlock(&lock);
+    bool found = map.find(k) != map.end();
+    pthread_rwlock_unlock(&lock);
+    return found;
+  }
+  void assign(int k, int v)
+  {
+    pthread_rwlock_wrlock(&lock);
+    map[k] = v;
+    pthread_rwlock_unlock(&lock);
+  }
+};
+
+struct rcu_map
+{
+  tinystl::rcu_map<int, int> map;
+
+  bool find(int k) const { return map.contains(k); }
+  void assign(int k, int v) { map.insert_or_assign(k, v); }
+};
+
+template <class Map>
+void run(const char *name, int readers, int interval_us)
+{
+  Map m;
+  for (int k = 0; k < kKeys; k += 2)
+    m.assign(k, k);
+  std::atomic<bool> done(false);
+  std::atomic<size_t> updates(0);
+  std::vector<std::vector<double>> samples(readers);
+  std::vector<std::thread> workers;
+  for (int t = 0; t < readers; ++t)
+  {
+    workers.push_back(std::thread([&m, &done, &samples, t]()
+                                  {
+      unsigned long long s = 0x9E3779B97F4A7C15ull * (t + 1);
+      size_t hits = 0;
+      while (!done.load(std::memory_order_relaxed))
+      {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < kBatch; ++i)
+        {
+          s ^= s << 13;
+          s ^= s >> 7;
+          s ^= s << 17;
+          hits += m.find(static_cast<int>(s % kKeys));
+        }
+        auto end = std::chrono::steady_clock::now();
+        samples[t].push_back(std::chrono::duration<double, std::nano>(end - start).count() / kBatch);
+      }
+      if (hits == static_cast<size_t>(-1))
+        std::cout << hits; }));
+  }
+  workers.push_back(std::thread([&m, &done, &updates, interval_us]()
+                                {
+    int k = 1;
+    while (!done.load(std::memory_order_relaxed))
+    {
+      m.assign(k, k);
+      k = (k + 2) % kKeys;
+      updates.fetch_add(1, std::memory_order_relaxed);
+      std::this_thread::sleep_for(std::chrono::microseconds(interval_us));
+    } }));
+  std::this_thread::sleep_for(std::chrono::milliseconds(kDurationMs));
+  done.store(true);
+  for (auto &w : workers)
+    w.join();
+
+  std::vector<double> all;
+  for (auto &v : samples)
+    all.insert(all.end(), v.begin(), v.end());
+  std::sort(all.begin(), all.end());
+  double sum = 0;
+  for (double x : all)
+    sum += x;
+  const double mean = all.empty() ? 0 : sum / all.size();
+  const double p99 = all.empty() ? 0 : all[all.size() * 99 / 100];
+  std::cout << "  " << name << ": mean " << mean << " ns, p99 " << p99 << " ns, lookups "
+            << all.size() * kBatch << ", updates " << updates.load() << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+  const int readers = argc > 1 ? std::atoi(argv[1]) : 3;
+  const int interval_us = argc > 2 ? std::atoi(argv[2]) : 100;
+  std::cout << "readers: " << readers << ", update interval: " << interval_us << " us, keys: " << kKeys << std::endl;
+  run<rwlock_map>("rwlock map", readers, interval_us);
+  run<rcu_map>("rcu_map   ", readers, interval_us);
+  return 0;
+}
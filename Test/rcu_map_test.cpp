@@ -0,0 +1,83 @@
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../TinySTL/rcu_map.h"
+
+struct int_hash
+{
+  size_t operator()(int x) const { return static_cast<size_t>(x); }
+};
+
+int main()
+{
+  tinystl::rcu_map<int, std::string> m;
+  m.insert_or_assign(2, "two");
+  m.insert_or_assign(1, "one");
+  m.insert_or_assign(3, "three");
+  std::string v;
+  std::cout << "get(2): " << m.get(2, v) << " " << v << ", contains(4): " << m.contains(4)
+            << ", size: " << m.size() << std::endl;
+
+  // 读者持有的版本不受之后的写入影响
+  {
+    auto snap = m.read();
+    m.erase(1);
+    m.update([](tinystl::map<int, std::string> &x)
+             { x[4] = "four"; x[2] = "deux"; });
+    std::cout << "snapshot: ";
+    for (auto it = snap->begin(); it != snap->end(); ++it)
+      std::cout << it->first << ":" << it->second << " ";
+    std::cout << std::endl;
+  }
+  std::cout << "current: " << m.read([](const tinystl::map<int, std::string> &x)
+                                     {
+    std::string s;
+    for (auto it = x.begin(); it != x.end(); ++it)
+      s += std::to_string(it->first) + ":" + it->second + " ";
+    return s; }) << std::endl;
+
+  // update 抛出异常时当前版本不变
+  try
+  {
+    m.update([](tinystl::map<int, std::string> &x)
+             { x.clear(); throw std::runtime_error("abort"); });
+  }
+  catch (const std::runtime_error &)
+  {
+  }
+  std::cout << "after failed update size: " << m.size() << std::endl;
+
+  // 三个读者不断读取，一个写者每次同时修改两个键值，读者看到的两个键值必须相等
+  tinystl::rcu_unordered_map<int, int, int_hash> u;
+  u.update([](tinystl::unordered_map<int, int, int_hash> &x)
+           { x[0] = 0; x[1] = 0; });
+  std::atomic<bool> done(false);
+  std::atomic<size_t> torn(0);
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 3; ++t)
+  {
+    readers.push_back(std::thread([&u, &done, &torn]()
+                                  {
+      while (!done.load(std::memory_order_relaxed))
+      {
+        auto snap = u.read();
+        if (snap->find(0)->second != snap->find(1)->second)
+          torn.fetch_add(1);
+      } }));
+  }
+  for (int i = 1; i <= 2000; ++i)
+  {
+    u.update([i](tinystl::unordered_map<int, int, int_hash> &x)
+             { x[0] = i; x[1] = i; });
+  }
+  done.store(true);
+  for (auto &r : readers)
+    r.join();
+  int last = 0;
+  u.get(1, last);
+  u.synchronize();
+  std::cout << "torn reads: " << torn.load() << ", last: " << last << ", size: " << u.size() << std::endl;
+  return 0;
+}
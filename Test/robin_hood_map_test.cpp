@@ -0,0 +1,179 @@
+#include <iostream>
+#include <string>
+#include <stdexcept>
+#include <unordered_map>
+#include "../TinySTL/robin_hood_map.h"
+#include "../TinySTL/robin_hood_set.h"
+
+struct int_hash
+{
+  size_t operator()(int x) const { return static_cast<size_t>(x); }
+};
+
+// 所有键值的哈希值都相同
+struct bad_hash
+{
+  size_t operator()(int) const { return 42; }
+};
+
+// 哈希值都相同，g_hash_throws 为 true 时抛出异常
+bool g_hash_throws = false;
+struct throwing_hash
+{
+  size_t operator()(int) const
+  {
+    if (g_hash_throws)
+      throw std::runtime_error("hash");
+    return 42;
+  }
+};
+
+int main()
+{
+  tinystl::robin_hood_map<int, std::string, int_hash> m;
+  m.emplace(1, "one");
+  m.insert(tinystl::make_pair(2, std::string("two")));
+  m[3] = "three";
+  std::cout << "size: " << m.size() << ", m[2]: " << m[2] << ", insert existing: "
+            << m.emplace(1, "uno").second << ", at(1): " << m.at(1)
+            << ", try_emplace(4): " << m.try_emplace(4, 3, 'x').first->second << std::endl;
+  std::cout << "erase(2): " << m.erase(2) << ", erase(2): " << m.erase(2)
+            << ", count(2): " << m.count(2) << ", max_load_factor: " << m.max_load_factor() << std::endl;
+
+  // 与 std::unordered_map 对照，负载因子 0.95 下随机插入删除
+  m.clear();
+  m.max_load_factor(0.95f);
+  std::unordered_map<int, std::string> ref;
+  unsigned long long s = 88172645463325252ull;
+  bool same = true;
+  float max_load = 0;
+  for (int i = 0; i < 200000; ++i)
+  {
+    s ^= s << 13;
+    s ^= s >> 7;
+    s ^= s << 17;
+    const int k = static_cast<int>(s % 5000);
+    if ((s >> 40) % 3 == 0)
+    {
+      same = same && m.erase(k) == ref.erase(k);
+    }
+    else
+    {
+      m[k] = std::to_string(k);
+      ref[k] = std::to_string(k);
+    }
+    max_load = m.load_factor() > max_load ? m.load_factor() : max_load;
+  }
+  size_t walked = 0;
+  for (auto it = m.begin(); it != m.end(); ++it, ++walked)
+    same = same && ref.count(it->first) && ref[it->first] == it->second;
+  std::cout << "matches std::unordered_map: " << (same && walked == ref.size() && m.size() == ref.size())
+            << ", max load_factor seen > 0.9: " << (max_load > 0.9f) << std::endl;
+
+  // 区间删除：删除前一半元素，其余元素会前移
+  size_t half = m.size() / 2;
+  auto mid = m.begin();
+  for (size_t i = 0; i < half; ++i)
+    ++mid;
+  m.erase(m.begin(), mid);
+  walked = 0;
+  for (auto it = m.begin(); it != m.end(); ++it, ++walked)
+    same = same && ref.count(it->first);
+  std::cout << "erase(first, last): size " << m.size() << ", walked " << walked
+            << ", consistent: " << (same && walked == ref.size() - half) << std::endl;
+
+  // 边遍历边删除：删除键值为 3 的倍数的元素，erase 返回下一个元素，每个元素恰好访问一次
+  const size_t before = m.size();
+  size_t visited = 0, erased = 0;
+  for (auto it = m.begin(); it != m.end(); ++visited)
+  {
+    if (it->first % 3 == 0)
+    {
+      ref.erase(it->first);
+      it = m.erase(it);
+      ++erased;
+    }
+    else
+    {
+      ++it;
+    }
+  }
+  walked = 0;
+  for (auto it = m.begin(); it != m.end(); ++it, ++walked)
+    same = same && it->first % 3 != 0 && ref.count(it->first);
+  std::cout << "erase while iterating: visited " << (visited == before) << ", erased some " << (erased > 0)
+            << ", consistent: " << (same && walked == before - erased && m.size() == walked) << std::endl;
+
+  // 复制、移动、比较、合并
+  tinystl::robin_hood_map<int, std::string, int_hash> c(m);
+  std::cout << "copy == : " << (c == m);
+  c[-1] = "x";
+  std::cout << ", after change != : " << (c != m);
+  tinystl::robin_hood_map<int, std::string, int_hash> mv(tinystl::move(c));
+  std::cout << ", moved size: " << mv.size() << ", source empty: " << c.empty() << std::endl;
+  tinystl::robin_hood_map<int, std::string, int_hash> a{{1, "a"}, {2, "b"}}, b{{2, "B"}, {3, "C"}};
+  a.merge(b);
+  std::cout << "merge: a.size " << a.size() << ", a[2] " << a[2] << ", b.size " << b.size() << std::endl;
+
+  try
+  {
+    m.max_load_factor(1.5f);
+  }
+  catch (const std::out_of_range &e)
+  {
+    std::cout << "max_load_factor(1.5): " << e.what() << std::endl;
+  }
+
+  // 哈希值全部相同时，探查距离远远超过一个字节能表示的范围，表退化为线性探查但仍然正确
+  tinystl::robin_hood_set<int, bad_hash> bad;
+  const int nbad = 3000;
+  for (int i = 0; i < nbad; ++i)
+    bad.insert(i);
+  bool bad_ok = bad.size() == static_cast<size_t>(nbad) && bad.count(nbad) == 0;
+  for (int i = 0; i < nbad; ++i)
+    bad_ok = bad_ok && bad.count(i) == 1;
+  for (int i = 0; i < nbad; i += 2)
+    bad_ok = bad_ok && bad.erase(i) == 1;
+  for (int i = 0; i < nbad; ++i)
+    bad_ok = bad_ok && bad.count(i) == static_cast<size_t>(i % 2);
+  tinystl::robin_hood_set<int, bad_hash> bad_copy(bad);
+  bad_copy.rehash(bad_copy.bucket_count() * 4);
+  for (int i = 0; i < nbad; ++i)
+    bad_ok = bad_ok && bad_copy.count(i) == static_cast<size_t>(i % 2);
+  std::cout << "equal hashes: size " << bad.size() << ", consistent: " << bad_ok << std::endl;
+
+  // 删除时其后有饱和元素，需要重新计算哈希值；哈希函数抛出异常时表不变
+  tinystl::robin_hood_set<int, throwing_hash> th;
+  for (int i = 0; i < 600; ++i)
+    th.insert(i);
+  g_hash_throws = true;
+  bool thrown = false;
+  try
+  {
+    th.erase(th.begin());
+  }
+  catch (const std::runtime_error &)
+  {
+    thrown = true;
+  }
+  g_hash_throws = false;
+  bool th_ok = thrown && th.size() == 600;
+  for (int i = 0; i < 600; ++i)
+    th_ok = th_ok && th.count(i) == 1;
+  for (int i = 0; i < 600; i += 3)
+    th_ok = th_ok && th.erase(i) == 1;
+  for (int i = 0; i < 600; ++i)
+    th_ok = th_ok && th.count(i) == static_cast<size_t>(i % 3 != 0);
+  std::cout << "hash throws during erase: thrown " << thrown << ", table unchanged and usable: " << th_ok
+            << std::endl;
+
+  tinystl::robin_hood_set<int, int_hash> st{5, 3, 5, 1};
+  st.insert(7);
+  int sum = 0;
+  for (auto it = st.begin(); it != st.end(); ++it)
+    sum += *it;
+  st.erase(st.find(3));
+  std::cout << "set size: " << st.size() << ", sum before erase: " << sum
+            << ", count(3): " << st.count(3) << ", count(7): " << st.count(7) << std::endl;
+  return 0;
+}
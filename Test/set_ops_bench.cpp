@@ -0,0 +1,65 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+#include "../TinySTL/set.h"
+
+// set<int> 的并集：
+// 1. 逐个 insert，O(m log n)
+// 2. set_union，基于 split / join，O(m log(n / m + 1))
+// 3. set_union 并行执行
+// 大集合的元素个数由命令行参数给出，缺省为 1000000，小集合依次为其 1/1000、1/10 与相同大小
+
+template <class F>
+double time_it(F f)
+{
+  auto start = std::chrono::steady_clock::now();
+  f();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+tinystl::set<int> make_set(size_t n, std::mt19937 &rng)
+{
+  tinystl::set<int> s;
+  while (s.size() < n)
+    s.insert(static_cast<int>(rng() % (n * 8)));
+  return s;
+}
+
+void bench(size_t n, size_t m, size_t threads)
+{
+  std::mt19937 rng(1);
+  const tinystl::set<int> big = make_set(n, rng);
+  const tinystl::set<int> small = make_set(m, rng);
+
+  tinystl::set<int> a = big;
+  double insert = time_it([&]()
+                          {
+    for (auto it = small.begin(); it != small.end(); ++it)
+      a.insert(*it); });
+
+  tinystl::set<int> b = big, c = small;
+  double join = time_it([&]()
+                        { b.set_union(c); });
+
+  tinystl::set<int> d = big, e = small;
+  double parallel = time_it([&]()
+                            { d.set_union(e, threads); });
+
+  std::cout << n << " + " << m << ": insert " << insert << " ms, set_union " << join
+            << " ms, set_union(" << threads << " threads) " << parallel << " ms (size "
+            << a.size() << " / " << b.size() << " / " << d.size() << ")" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+  const size_t n = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 1000000;
+  const size_t threads = std::thread::hardware_concurrency() == 0 ? 4 : std::thread::hardware_concurrency();
+  bench(n, n / 1000, threads);
+  bench(n, n / 10, threads);
+  bench(n, n, threads);
+  return 0;
+}
@@ -0,0 +1,141 @@
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+#include "../TinySTL/map.h"
+#include "../TinySTL/set.h"
+
+template <class Set>
+void printSet(const Set &s)
+{
+  for (auto it = s.begin(); it != s.end(); ++it)
+    std::cout << *it << " ";
+  std::cout << std::endl;
+}
+
+// 倒数到 0 的那次比较抛出异常，为负数时不抛出；并行时多个线程同时比较
+std::atomic<long> g_countdown(-1);
+struct throwing_less
+{
+  bool operator()(int x, int y) const
+  {
+    if (g_countdown.fetch_sub(1) == 0)
+      throw std::runtime_error("compare");
+    return x < y;
+  }
+};
+typedef tinystl::set<int, throwing_less, tinystl::rb_tree_size_update> throwing_set;
+
+// 严格递增，正反遍历的个数都等于 size()，顺序统计与遍历位置一致
+bool consistent(const throwing_set &s)
+{
+  size_t n = 0, back = 0;
+  const int *prev = nullptr;
+  for (auto it = s.begin(); it != s.end(); ++it, ++n)
+  {
+    if ((prev != nullptr && !(*prev < *it)) || s.nth(n) != it)
+      return false;
+    prev = &*it;
+  }
+  for (auto it = s.rbegin(); it != s.rend(); ++it)
+    ++back;
+  return n == s.size() && back == n;
+}
+
+// 比较函数在集合运算途中抛出异常：两个容器都保持合法，元素不会凭空出现，
+// 并集不丢失任何键值，节点不泄漏（由 AddressSanitizer 检查）
+bool set_ops_throwing(int op, size_t threads, long countdown, bool compact_other)
+{
+  throwing_set a, b;
+  for (int i = 0; i < 40000; i += 2)
+    a.insert(i);
+  for (int i = 0; i < 40000; i += 3)
+    b.insert(i);
+  if (compact_other)
+    b.compact();
+  g_countdown = countdown;
+  bool thrown = false;
+  try
+  {
+    if (op == 0)
+      a.set_union(b, threads);
+    else if (op == 1)
+      a.set_intersection(b, threads);
+    else
+      a.set_difference(b, threads);
+  }
+  catch (const std::runtime_error &)
+  {
+    thrown = true;
+  }
+  g_countdown = -1;
+  bool ok = thrown && consistent(a) && consistent(b);
+  for (auto it = a.begin(); it != a.end(); ++it)
+    ok = ok && (*it % 2 == 0 || (op == 0 && *it % 3 == 0));
+  for (auto it = b.begin(); it != b.end(); ++it)
+    ok = ok && *it % 3 == 0;
+  if (op == 0)
+  {
+    for (int i = 0; i < 40000; ++i)
+      ok = ok && ((i % 2 != 0 && i % 3 != 0) || a.count(i) + b.count(i) > 0);
+  }
+  // 出错后两个容器仍可正常使用
+  a.insert(-1);
+  b.insert(-3);
+  a.set_union(b);
+  return ok && b.empty() && a.count(-3) == 1 && consistent(a);
+}
+
+int main()
+{
+  tinystl::set<int> a = {1, 3, 5, 7, 9, 11};
+  tinystl::set<int> b = {3, 4, 5, 6, 7};
+  a.set_union(b);
+  printSet(a);
+  std::cout << "other empty: " << b.empty() << std::endl;
+
+  b = {1, 2, 3, 4, 5};
+  a.set_intersection(b);
+  printSet(a);
+
+  b = {2, 4};
+  a.set_difference(b);
+  printSet(a);
+
+  // 大集合与小集合，带子树大小的集合结果仍可做顺序统计，并行求并集
+  tinystl::set<int, tinystl::less<int>, tinystl::rb_tree_size_update> big, small, other;
+  for (int i = 0; i < 100000; i += 2)
+    big.insert(i);
+  for (int i = 1; i < 100; i += 10)
+    small.insert(i);
+  for (int i = 0; i < 100000; i += 3)
+    other.insert(i);
+  big.set_union(small);
+  std::cout << "size: " << big.size() << ", rank(50): " << big.rank(50) << std::endl;
+  big.set_union(other, 4);
+  std::cout << "size: " << big.size() << ", nth(10): " << *big.nth(10) << std::endl;
+
+  // map 键值相同时保留本容器的值
+  tinystl::map<int, char> m1, m2;
+  m1[1] = 'a';
+  m1[2] = 'b';
+  m2[2] = 'x';
+  m2[3] = 'y';
+  m1.set_union(m2);
+  for (auto &kv : m1)
+    std::cout << kv.first << ":" << kv.second << " ";
+  std::cout << std::endl;
+
+  bool throw_ok = true;
+  const long countdowns[] = {0, 7, 60, 900, 20000};
+  for (int op = 0; op < 3; ++op)
+  {
+    for (size_t threads = 1; threads <= 4; threads *= 4)
+    {
+      for (long c : countdowns)
+        throw_ok = throw_ok && set_ops_throwing(op, threads, c, false) && set_ops_throwing(op, threads, c, true);
+    }
+  }
+  std::cout << "comparator throws during union / intersection / difference, 1 and 4 threads: "
+            << "both sets valid " << throw_ok << std::endl;
+  return 0;
+}
@@ -0,0 +1,122 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "../TinySTL/map.h"
+#include "../TinySTL/unordered_map.h"
+
+// 用字符串视图（指针加长度）查找以 std::string 为键值的容器：
+// 1. 普通比较函数，每次查找先构造一个临时的 std::string
+// 2. 带 is_transparent 标记的比较函数与哈希函数，直接比较
+// 键值长度超过短字符串优化的范围，元素个数由命令行参数给出，缺省为 100000
+
+struct str_ref
+{
+  const char *p;
+  size_t n;
+};
+
+struct string_less
+{
+  typedef void is_transparent;
+
+  bool operator()(const std::string &a, const std::string &b) const { return a < b; }
+  bool operator()(const std::string &a, const str_ref &b) const { return a.compare(0, a.size(), b.p, b.n) < 0; }
+  bool operator()(const str_ref &a, const std::string &b) const { return b.compare(0, b.size(), a.p, a.n) > 0; }
+};
+
+struct string_hash
+{
+  typedef void is_transparent;
+
+  size_t operator()(const str_ref &s) const
+  {
+    size_t h = 14695981039346656037ull;
+    for (size_t i = 0; i < s.n; ++i)
+      h = (h ^ static_cast<unsigned char>(s.p[i])) * 1099511628211ull;
+    return h;
+  }
+  size_t operator()(const std::string &s) const { return (*this)(str_ref{s.data(), s.size()}); }
+};
+
+struct string_equal
+{
+  typedef void is_transparent;
+
+  bool operator()(const std::string &a, const std::string &b) const { return a == b; }
+  bool operator()(const std::string &a, const str_ref &b) const { return a.compare(0, a.size(), b.p, b.n) == 0; }
+};
+
+template <class F>
+double time_it(F f)
+{
+  auto start = std::chrono::steady_clock::now();
+  f();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// 非 transparent 的容器先由视图构造临时的 std::string
+template <class Map>
+double lookup(const Map &m, const std::vector<str_ref> &refs, size_t rounds, size_t &found)
+{
+  return time_it([&]()
+                 {
+    for (size_t r = 0; r < rounds; ++r)
+      for (size_t i = 0; i < refs.size(); ++i)
+        found += m.count(std::string(refs[i].p, refs[i].n)); });
+}
+
+template <class Map>
+double lookup_transparent(const Map &m, const std::vector<str_ref> &refs, size_t rounds, size_t &found)
+{
+  return time_it([&]()
+                 {
+    for (size_t r = 0; r < rounds; ++r)
+      for (size_t i = 0; i < refs.size(); ++i)
+        found += m.count(refs[i]); });
+}
+
+int main(int argc, char **argv)
+{
+  const size_t n = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 100000;
+  const size_t rounds = 10;
+  std::vector<std::string> keys;
+  for (size_t i = 0; i < n; ++i)
+    keys.push_back("transparent-lookup-key-" + std::to_string(i * 2654435761u % 1000000007u));
+  // 视图指向另一份数据，模拟从输入缓冲区中切出的键值
+  std::string buffer;
+  std::vector<size_t> offsets;
+  for (size_t i = 0; i < n; ++i)
+  {
+    offsets.push_back(buffer.size());
+    buffer += keys[i];
+  }
+  std::vector<str_ref> refs;
+  for (size_t i = 0; i < n; ++i)
+    refs.push_back(str_ref{buffer.data() + offsets[i], keys[i].size()});
+
+  tinystl::map<std::string, int> plain;
+  tinystl::map<std::string, int, string_less> transparent;
+  tinystl::unordered_map<std::string, int, string_hash> uplain;
+  tinystl::unordered_map<std::string, int, string_hash, string_equal> utransparent;
+  for (size_t i = 0; i < n; ++i)
+  {
+    plain.emplace(keys[i], 0);
+    transparent.emplace(keys[i], 0);
+    uplain.emplace(keys[i], 0);
+    utransparent.emplace(keys[i], 0);
+  }
+
+  size_t found = 0;
+  double a = lookup(plain, refs, rounds, found);
+  double b = lookup_transparent(transparent, refs, rounds, found);
+  double c = lookup(uplain, refs, rounds, found);
+  double d = lookup_transparent(utransparent, refs, rounds, found);
+  std::cout << n * rounds << " lookups by string view:" << std::endl;
+  std::cout << "map: temporary key " << a << " ms, transparent " << b << " ms" << std::endl;
+  std::cout << "unordered_map: temporary key " << c << " ms, transparent " << d << " ms" << std::endl;
+  std::cout << "found: " << found << std::endl;
+  return 0;
+}
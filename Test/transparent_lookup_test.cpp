@@ -0,0 +1,67 @@
+#include <iostream>
+#include <string>
+#include <cstring>
+#include "../TinySTL/map.h"
+#include "../TinySTL/set.h"
+#include "../TinySTL/unordered_map.h"
+#include "../TinySTL/unordered_set.h"
+
+// 记录构造次数的键值类型，可以直接与 const char * 比较
+static int constructed = 0;
+
+struct name
+{
+  std::string s;
+  name(const char *p) : s(p) { ++constructed; }
+  name(const name &rhs) : s(rhs.s) { ++constructed; }
+};
+
+bool operator<(const name &a, const name &b) { return a.s < b.s; }
+bool operator<(const name &a, const char *b) { return std::strcmp(a.s.c_str(), b) < 0; }
+bool operator<(const char *a, const name &b) { return std::strcmp(a, b.s.c_str()) < 0; }
+bool operator==(const name &a, const name &b) { return a.s == b.s; }
+bool operator==(const name &a, const char *b) { return a.s == b; }
+
+// 对 name 与 const char * 给出相同的哈希值
+struct name_hash
+{
+  typedef void is_transparent;
+
+  size_t operator()(const char *p) const
+  {
+    size_t h = 5381;
+    for (; *p; ++p)
+      h = h * 33 + static_cast<unsigned char>(*p);
+    return h;
+  }
+  size_t operator()(const name &n) const { return (*this)(n.s.c_str()); }
+};
+
+int main()
+{
+  tinystl::map<name, int, tinystl::less<>> m;
+  m.emplace("apple", 1);
+  m.emplace("banana", 2);
+  m.emplace("cherry", 3);
+  tinystl::multiset<name, tinystl::less<>> ms;
+  ms.emplace("x");
+  ms.emplace("x");
+  ms.emplace("y");
+  tinystl::unordered_map<name, int, name_hash, tinystl::equal_to<>> um;
+  um.emplace("apple", 1);
+  um.emplace("banana", 2);
+  tinystl::unordered_set<name, name_hash, tinystl::equal_to<>> us;
+  us.emplace("kiwi");
+
+  const int before = constructed;
+  std::cout << "map find(banana): " << m.find("banana")->second
+            << ", count(durian): " << m.count("durian")
+            << ", lower_bound(b): " << m.lower_bound("b")->second
+            << ", upper_bound(banana): " << m.upper_bound("banana")->second << std::endl;
+  std::cout << "multiset count(x): " << ms.count("x") << std::endl;
+  std::cout << "unordered_map find(apple): " << um.find("apple")->second
+            << ", count(cherry): " << um.count("cherry") << std::endl;
+  std::cout << "unordered_set count(kiwi): " << us.count("kiwi") << std::endl;
+  std::cout << "keys constructed during lookup: " << constructed - before << std::endl;
+  return 0;
+}
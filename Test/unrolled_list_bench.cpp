@@ -0,0 +1,65 @@
+#include <iostream>
+#include <chrono>
+#include "../TinySTL/list.h"
+#include "../TinySTL/unrolled_list.h"
+
+// 对比 list 与 unrolled_list：
+// 1. 顺序遍历求和
+// 2. 遍历时在每个元素前插入一个元素
+// 3. 遍历时删除每隔一个的元素
+
+const int kSize = 1000000;
+const int kRounds = 20;
+
+template <class F>
+double time_it(F f)
+{
+  auto start = std::chrono::steady_clock::now();
+  f();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+template <class List>
+void bench(const char *name)
+{
+  List l;
+  for (int i = 0; i < kSize; ++i)
+    l.push_back(i);
+
+  long long sum = 0;
+  double traverse = time_it([&]()
+                            {
+    for (int r = 0; r < kRounds; ++r)
+      for (auto it = l.begin(); it != l.end(); ++it)
+        sum += *it; });
+
+  double insert = time_it([&]()
+                          {
+    for (auto it = l.begin(); it != l.end(); ++it)
+    {
+      it = l.insert(it, -1);
+      ++it;
+    } });
+
+  double erase = time_it([&]()
+                         {
+    for (auto it = l.begin(); it != l.end();)
+    {
+      it = l.erase(it);
+      if (it != l.end())
+        ++it;
+    } });
+
+  std::cout << name << "\ttraverse x" << kRounds << ": " << traverse << " ms"
+            << "\tinsert: " << insert << " ms"
+            << "\terase: " << erase << " ms"
+            << "\t(size " << l.size() << ", checksum " << sum << ")" << std::endl;
+}
+
+int main()
+{
+  bench<tinystl::list<int>>("list         ");
+  bench<tinystl::unrolled_list<int>>("unrolled_list");
+  return 0;
+}
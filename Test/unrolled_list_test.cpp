@@ -0,0 +1,143 @@
+#include <iostream>
+#include "../TinySTL/unrolled_list.h"
+#include "../TinySTL/list.h"
+
+static unsigned long long g_state = 88172645463325252ull;
+
+unsigned long long next_random()
+{
+  g_state ^= g_state << 13;
+  g_state ^= g_state >> 7;
+  g_state ^= g_state << 17;
+  return g_state;
+}
+
+// 正反两个方向与 tinystl::list 的内容逐个比较
+bool same_contents(const tinystl::unrolled_list<int> &u, const tinystl::list<int> &l)
+{
+  if (u.size() != l.size())
+    return false;
+  auto li = l.begin();
+  for (auto ui = u.begin(); ui != u.end(); ++ui, ++li)
+  {
+    if (*ui != *li)
+      return false;
+  }
+  auto rl = l.rbegin();
+  for (auto ru = u.rbegin(); ru != u.rend(); ++ru, ++rl)
+  {
+    if (*ru != *rl)
+      return false;
+  }
+  return li == l.end() && rl == l.rend();
+}
+
+int main()
+{
+  std::cout << "node_capacity for int: " << tinystl::unrolled_list<int>::node_capacity << std::endl;
+
+  // 在随机位置插入删除，与 tinystl::list 对照；返回的迭代器必须指向新元素 / 下一个元素
+  tinystl::unrolled_list<int> u;
+  tinystl::list<int> l;
+  bool same = true;
+  size_t splits = 0, merges = 0, max_nodes = 0;
+  for (int step = 0; step < 40000; ++step)
+  {
+    const unsigned long long r = next_random();
+    // 前一半偏向插入，后一半偏向删除，使节点先拆分再合并
+    const bool do_insert = u.empty() || (r >> 32) % 10 < (step < 20000 ? 7u : 4u);
+    const size_t pos = static_cast<size_t>(r % (u.size() + (do_insert ? 1 : 0)));
+    auto ui = u.begin();
+    auto li = l.begin();
+    for (size_t k = 0; k < pos; ++k, ++ui, ++li)
+      ;
+    const size_t nodes_before = u.node_count();
+    if (do_insert)
+    {
+      auto ri = u.insert(ui, step);
+      l.insert(li, step);
+      same = same && *ri == step;
+      splits += u.node_count() > nodes_before;
+    }
+    else
+    {
+      auto ri = u.erase(ui);
+      auto rl = l.erase(li);
+      same = same && ((ri == u.end()) == (rl == l.end())) && (rl == l.end() || *ri == *rl);
+      merges += u.node_count() < nodes_before;
+    }
+    max_nodes = u.node_count() > max_nodes ? u.node_count() : max_nodes;
+    if (step % 1000 == 0)
+      same = same && same_contents(u, l);
+  }
+  same = same && same_contents(u, l);
+  std::cout << "random insert / erase matches list: " << same << ", nodes grew: " << (splits > 0)
+            << ", nodes shrank: " << (merges > 0) << ", max nodes " << max_nodes
+            << ", nodes now " << u.node_count() << ", size " << u.size() << std::endl;
+
+  // 区间插入与区间删除跨越多个节点
+  tinystl::unrolled_list<int> v(1000, 7);
+  tinystl::list<int> lv(1000, 7);
+  int src[300];
+  for (int i = 0; i < 300; ++i)
+    src[i] = i;
+  auto vi = v.begin();
+  auto lvi = lv.begin();
+  for (int k = 0; k < 500; ++k, ++vi, ++lvi)
+    ;
+  auto first = v.insert(vi, src, src + 300);
+  lv.insert(lvi, src, src + 300);
+  bool range_ok = *first == 0 && same_contents(v, lv);
+  auto ef = v.begin();
+  auto lef = lv.begin();
+  for (int k = 0; k < 100; ++k, ++ef, ++lef)
+    ;
+  auto el = ef;
+  auto lel = lef;
+  for (int k = 0; k < 700; ++k, ++el, ++lel)
+    ;
+  auto after = v.erase(ef, el);
+  auto lafter = lv.erase(lef, lel);
+  range_ok = range_ok && *after == *lafter && same_contents(v, lv);
+  std::cout << "range insert / erase across nodes: " << range_ok << ", size " << v.size() << std::endl;
+
+  // 迭代器稳定性：在前部插入删除引起拆分与合并，后部节点上的迭代器与元素地址不变
+  tinystl::unrolled_list<int> s;
+  for (int i = 0; i < 1000; ++i)
+    s.push_back(i);
+  auto last = --s.end();
+  auto mid = s.begin();
+  for (int k = 0; k < 700; ++k)
+    ++mid;
+  const int *last_addr = &*last;
+  const int *mid_addr = &*mid;
+  const size_t nodes_before = s.node_count();
+  for (int i = 0; i < 200; ++i)
+  {
+    auto it = s.begin();
+    ++it;
+    s.insert(it, -i);
+  }
+  const size_t nodes_grown = s.node_count();
+  for (int i = 0; i < 400; ++i)
+  {
+    auto it = s.begin();
+    ++it;
+    s.erase(it);
+  }
+  bool stable = *last == 999 && &*last == last_addr && *mid == 700 && &*mid == mid_addr;
+  int expect = 999;
+  for (auto it = last; it != s.begin(); --it, --expect)
+    stable = stable && *it == expect;
+  std::cout << "iterators on untouched nodes stay valid: " << stable << ", nodes " << nodes_before
+            << " -> " << nodes_grown << " -> " << s.node_count() << std::endl;
+
+  // 复制、移动、交换
+  tinystl::unrolled_list<int> c(u);
+  tinystl::unrolled_list<int> m(tinystl::move(c));
+  tinystl::unrolled_list<int> w{1, 2, 3};
+  w.swap(m);
+  std::cout << "copy / move / swap: " << same_contents(w, l) << ", moved-from empty: " << c.empty()
+            << ", swapped size: " << m.size() << std::endl;
+  return 0;
+}
@@ -0,0 +1,86 @@
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include "../TinySTL/work_stealing_deque.h"
+
+// 基准测试：
+// 1. 无竞争时拥有者 push / pop 的速率
+// 2. 拥有者持续放入任务、若干窃取者同时窃取时，双方的操作速率
+
+const int kOps = 10000000;
+
+void bench_owner()
+{
+  tinystl::work_stealing_deque<int> dq;
+  int v = 0;
+  long long sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kOps; i += 64)
+  {
+    for (int j = 0; j < 64; ++j)
+      dq.push(i + j);
+    while (dq.pop(v))
+      sum += v;
+  }
+  auto end = std::chrono::steady_clock::now();
+  double secs = std::chrono::duration<double>(end - start).count();
+  std::cout << "owner push+pop: " << 2.0 * kOps / secs / 1e6 << " Mops/s"
+            << " (checksum " << sum << ")" << std::endl;
+}
+
+void bench_steal(int thieves)
+{
+  tinystl::work_stealing_deque<int> dq;
+  std::atomic<bool> done(false);
+  std::atomic<long long> stolen(0), attempts(0);
+  std::vector<std::thread> ts;
+  for (int i = 0; i < thieves; ++i)
+  {
+    ts.push_back(std::thread([&]()
+                             {
+      int v;
+      long long ok = 0, tries = 0;
+      while (!done.load(std::memory_order_relaxed))
+      {
+        ++tries;
+        if (dq.steal(v))
+          ++ok;
+      }
+      stolen += ok;
+      attempts += tries; }));
+  }
+
+  int v = 0;
+  long long popped = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kOps; ++i)
+  {
+    dq.push(i);
+    if (i % 4 == 0 && dq.pop(v))
+      ++popped;
+  }
+  while (dq.pop(v))
+    ++popped;
+  auto end = std::chrono::steady_clock::now();
+  done.store(true);
+  for (auto &t : ts)
+    t.join();
+
+  double secs = std::chrono::duration<double>(end - start).count();
+  std::cout << "thieves " << thieves
+            << "\towner " << (kOps + popped) / secs / 1e6 << " Mops/s"
+            << "\tsteals " << stolen.load() / secs / 1e6 << " M/s"
+            << "\tsteal success " << 100.0 * stolen.load() / (attempts.load() ? attempts.load() : 1) << "%"
+            << std::endl;
+}
+
+int main()
+{
+  bench_owner();
+  const int counts[] = {1, 2, 4, 8};
+  for (int n : counts)
+    bench_steal(n);
+  return 0;
+}
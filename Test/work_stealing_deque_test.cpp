@@ -0,0 +1,86 @@
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include "../TinySTL/work_stealing_deque.h"
+
+// 压力测试：拥有者不断放入并取出任务，若干窃取者同时窃取，
+// 最后检查每个任务恰好被执行一次
+
+const int kTasks = 2000000;
+const int kThieves = 4;
+
+int main()
+{
+  tinystl::work_stealing_deque<int> dq(4); // 初始容量很小，测试过程中会多次扩容
+  std::vector<std::atomic<int>> seen(kTasks);
+  for (auto &s : seen)
+    s.store(0);
+  std::atomic<bool> done(false);
+  std::atomic<int> stolen(0);
+
+  std::vector<std::thread> thieves;
+  for (int i = 0; i < kThieves; ++i)
+  {
+    thieves.push_back(std::thread([&]()
+                                  {
+      int v;
+      int local = 0;
+      while (!done.load(std::memory_order_acquire))
+      {
+        if (dq.steal(v))
+        {
+          seen[v].fetch_add(1, std::memory_order_relaxed);
+          ++local;
+        }
+      }
+      while (dq.steal(v))
+      {
+        seen[v].fetch_add(1, std::memory_order_relaxed);
+        ++local;
+      }
+      stolen += local; }));
+  }
+
+  int popped = 0;
+  int v;
+  for (int i = 0; i < kTasks; ++i)
+  {
+    dq.push(i);
+    // 每放入若干个任务就自己取出一部分，制造与窃取者争抢最后一个元素的情况
+    if (i % 3 == 0)
+    {
+      while (dq.pop(v))
+      {
+        seen[v].fetch_add(1, std::memory_order_relaxed);
+        ++popped;
+        if (v % 2 == 0)
+          break;
+      }
+    }
+  }
+  while (dq.pop(v))
+  {
+    seen[v].fetch_add(1, std::memory_order_relaxed);
+    ++popped;
+  }
+  done.store(true, std::memory_order_release);
+  for (auto &t : thieves)
+    t.join();
+
+  int bad = 0;
+  for (int i = 0; i < kTasks; ++i)
+  {
+    if (seen[i].load() != 1)
+      ++bad;
+  }
+  std::cout << "popped: " << popped << " stolen: " << stolen.load()
+            << " capacity: " << dq.capacity() << std::endl;
+  if (bad != 0 || popped + stolen.load() != kTasks)
+  {
+    std::cout << "FAILED: " << bad << " tasks lost or duplicated" << std::endl;
+    return 1;
+  }
+  std::cout << "OK" << std::endl;
+  return 0;
+}
@@ -7,6 +7,8 @@
 #include "algobase.h"
 #include "memory.h"
 #include "functional.h"
+#include "allocator.h"
+#include "uninitialized.h"
 
 namespace tinystl
 {
@@ -515,7 +517,215 @@ namespace tinystl
     return last;
   }
 
-  
+  /*****************************************************************************************/
+  // lower_bound
+  // 在 [first, last) 中查找第一个不小于 value 的元素，返回指向它的迭代器，若没有则返回 last
+  /*****************************************************************************************/
+  template <class ForwardIter, class T>
+  ForwardIter lower_bound(ForwardIter first, ForwardIter last, const T &value)
+  {
+    auto len = tinystl::distance(first, last);
+    while (len > 0)
+    {
+      auto half = len / 2;
+      auto middle = first;
+      tinystl::advance(middle, half);
+      if (*middle < value)
+      {
+        first = ++middle;
+        len = len - half - 1;
+      }
+      else
+      {
+        len = half;
+      }
+    }
+    return first;
+  }
+
+  // 重载版本使用函数对象 comp 代替比较操作
+  template <class ForwardIter, class T, class Compared>
+  ForwardIter lower_bound(ForwardIter first, ForwardIter last, const T &value, Compared comp)
+  {
+    auto len = tinystl::distance(first, last);
+    while (len > 0)
+    {
+      auto half = len / 2;
+      auto middle = first;
+      tinystl::advance(middle, half);
+      if (comp(*middle, value))
+      {
+        first = ++middle;
+        len = len - half - 1;
+      }
+      else
+      {
+        len = half;
+      }
+    }
+    return first;
+  }
+
+  /*****************************************************************************************/
+  // upper_bound
+  // 在 [first, last) 中查找第一个大于 value 的元素，返回指向它的迭代器，若没有则返回 last
+  /*****************************************************************************************/
+  template <class ForwardIter, class T>
+  ForwardIter upper_bound(ForwardIter first, ForwardIter last, const T &value)
+  {
+    auto len = tinystl::distance(first, last);
+    while (len > 0)
+    {
+      auto half = len / 2;
+      auto middle = first;
+      tinystl::advance(middle, half);
+      if (value < *middle)
+      {
+        len = half;
+      }
+      else
+      {
+        first = ++middle;
+        len = len - half - 1;
+      }
+    }
+    return first;
+  }
+
+  // 重载版本使用函数对象 comp 代替比较操作
+  template <class ForwardIter, class T, class Compared>
+  ForwardIter upper_bound(ForwardIter first, ForwardIter last, const T &value, Compared comp)
+  {
+    auto len = tinystl::distance(first, last);
+    while (len > 0)
+    {
+      auto half = len / 2;
+      auto middle = first;
+      tinystl::advance(middle, half);
+      if (comp(value, *middle))
+      {
+        len = half;
+      }
+      else
+      {
+        first = ++middle;
+        len = len - half - 1;
+      }
+    }
+    return first;
+  }
+
+  /*****************************************************************************************/
+  // stable_sort
+  // 对 [first, last) 内的元素做稳定排序，要求随机访问迭代器，缺省使用 operator< 比较
+  // 先对每 STABLE_SORT_RUN 个元素做插入排序，再借助一块等长的缓冲区自底向上两两归并
+  /*****************************************************************************************/
+  // helper function
+  constexpr ptrdiff_t STABLE_SORT_RUN = 32;
+
+  template <class RandomIter, class Compared>
+  void stable_insertion_sort(RandomIter first, RandomIter last, Compared comp)
+  {
+    if (first == last)
+      return;
+    for (auto i = first + 1; i != last; ++i)
+    {
+      auto value = tinystl::move(*i);
+      auto hole = i;
+      for (; hole != first && comp(value, *(hole - 1)); --hole)
+        *hole = tinystl::move(*(hole - 1));
+      *hole = tinystl::move(value);
+    }
+  }
+
+  // 把两个有序区间移动归并到 result，相等时前一个区间的元素在前
+  template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+  OutputIter merge_move(InputIter1 first1, InputIter1 last1,
+                        InputIter2 first2, InputIter2 last2,
+                        OutputIter result, Compared comp)
+  {
+    while (first1 != last1 && first2 != last2)
+    {
+      if (comp(*first2, *first1))
+      {
+        *result = tinystl::move(*first2);
+        ++first2;
+      }
+      else
+      {
+        *result = tinystl::move(*first1);
+        ++first1;
+      }
+      ++result;
+    }
+    result = tinystl::move(first1, last1, result);
+    return tinystl::move(first2, last2, result);
+  }
+
+  // 把 [first, first + n) 中每对长为 step 的相邻有序段归并到 result
+  template <class RandomIter1, class RandomIter2, class Distance, class Compared>
+  void merge_pass(RandomIter1 first, Distance n, RandomIter2 result, Distance step, Compared comp)
+  {
+    for (Distance i = 0; i < n; i += step * 2)
+    {
+      const Distance mid = tinystl::min(i + step, n);
+      const Distance end = tinystl::min(i + step * 2, n);
+      result = tinystl::merge_move(first + i, first + mid, first + mid, first + end, result, comp);
+    }
+  }
+
+  template <class RandomIter, class Compared>
+  void stable_sort(RandomIter first, RandomIter last, Compared comp)
+  {
+    typedef typename iterator_traits<RandomIter>::value_type value_type;
+    typedef typename iterator_traits<RandomIter>::difference_type difference_type;
+    const difference_type n = last - first;
+    const difference_type run = STABLE_SORT_RUN;
+    for (difference_type i = 0; i < n; i += run)
+      tinystl::stable_insertion_sort(first + i, first + tinystl::min(i + run, n), comp);
+    if (n <= run)
+      return;
+
+    // 缓冲区与原区间轮流作为归并的目标
+    value_type *buf = tinystl::allocator<value_type>::allocate(static_cast<size_t>(n));
+    try
+    {
+      tinystl::uninitialized_move(first, last, buf);
+    }
+    catch (...)
+    {
+      tinystl::allocator<value_type>::deallocate(buf, static_cast<size_t>(n));
+      throw;
+    }
+    bool in_buf = true;
+    try
+    {
+      for (difference_type step = run; step < n; step *= 2)
+      {
+        if (in_buf)
+          tinystl::merge_pass(buf, n, first, step, comp);
+        else
+          tinystl::merge_pass(first, n, buf, step, comp);
+        in_buf = !in_buf;
+      }
+      if (in_buf)
+        tinystl::move(buf, buf + n, first);
+    }
+    catch (...)
+    {
+      tinystl::destroy(buf, buf + n);
+      tinystl::allocator<value_type>::deallocate(buf, static_cast<size_t>(n));
+      throw;
+    }
+    tinystl::destroy(buf, buf + n);
+    tinystl::allocator<value_type>::deallocate(buf, static_cast<size_t>(n));
+  }
+
+  template <class RandomIter>
+  void stable_sort(RandomIter first, RandomIter last)
+  {
+    tinystl::stable_sort(first, last, tinystl::less<typename iterator_traits<RandomIter>::value_type>());
+  }
 
 } // namespace tinystl
 
@@ -426,7 +426,7 @@ namespace tinystl
   void fill_cat(RandomIter first, RandomIter last, const T &value,
                 tinystl::random_access_iterator_tag)
   {
-    fill_n(first, last - first, value);
+    tinystl::fill_n(first, last - first, value);
   }
 
   template <class ForwardIter, class T>
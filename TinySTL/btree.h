@@ -0,0 +1,1629 @@
+#ifndef TINYSTL_BTREE_H_
+#define TINYSTL_BTREE_H_
+
+// 这个头文件包含一个模板类 btree
+// btree : B+ 树，作为 btree_map / btree_multimap / btree_set / btree_multiset 的底层机制
+
+// notes:
+//
+// 1. 每个节点约 TINYSTL_BTREE_NODE_BYTES 字节，一个节点内的查找只涉及几条缓存行，树高为 log_B(n)
+// 2. 元素只保存在叶节点中，内部节点保存键值的副本作为分隔键，满足
+//    max(children[i]) <= keys[i] <= min(children[i + 1])
+// 3. 叶节点通过 prev / next 连成带头节点的环形双向链表，迭代器由叶节点和节点内下标组成
+// 4. 元素在节点内以移动构造 + 析构的方式搬动，要求元素与键值的移动构造不抛出异常
+// 5. 插入或删除会使所在叶节点以及拆分、借用、合并所涉及的叶节点上的迭代器失效
+// 6. 对空树以有序的前向迭代器区间插入时，自底向上直接建树，为线性时间，节点全部填满
+
+#include <initializer_list>
+#include <type_traits>
+
+#include "algobase.h"
+#include "allocator.h"
+#include "iterator.h"
+#include "memory.h"
+#include "type_traits.h"
+#include "exceptdef.h"
+
+namespace tinystl
+{
+// B+ 树节点的目标大小（字节）
+#ifndef TINYSTL_BTREE_NODE_BYTES
+#define TINYSTL_BTREE_NODE_BYTES 256
+#endif
+
+// 树高的上限，节点的扇出至少为 4，64 层足以容纳任何规模的数据
+#ifndef BTREE_MAX_HEIGHT
+#define BTREE_MAX_HEIGHT 64
+#endif
+
+  // btree value traits
+
+  template <class T, bool>
+  struct btree_value_traits_imp
+  {
+    typedef T key_type;
+    typedef T mapped_type;
+    typedef T value_type;
+
+    template <class Ty>
+    static const key_type &get_key(const Ty &value)
+    {
+      return value;
+    }
+
+    template <class Ty>
+    static const value_type &get_value(const Ty &value)
+    {
+      return value;
+    }
+  };
+
+  template <class T>
+  struct btree_value_traits_imp<T, true>
+  {
+    typedef typename std::remove_cv<typename T::first_type>::type key_type;
+    typedef typename T::second_type mapped_type;
+    typedef T value_type;
+
+    template <class Ty>
+    static const key_type &get_key(const Ty &value)
+    {
+      return value.first;
+    }
+
+    template <class Ty>
+    static const value_type &get_value(const Ty &value)
+    {
+      return value;
+    }
+  };
+
+  template <class T>
+  struct btree_value_traits
+  {
+    static constexpr bool is_map = tinystl::is_pair<T>::value;
+
+    typedef btree_value_traits_imp<T, is_map> value_traits_type;
+
+    typedef typename value_traits_type::key_type key_type;
+    typedef typename value_traits_type::mapped_type mapped_type;
+    typedef typename value_traits_type::value_type value_type;
+
+    template <class Ty>
+    static const key_type &get_key(const Ty &value)
+    {
+      return value_traits_type::get_key(value);
+    }
+
+    template <class Ty>
+    static const value_type &get_value(const Ty &value)
+    {
+      return value_traits_type::get_value(value);
+    }
+  };
+
+  // forward declaration
+
+  template <class T>
+  struct btree_leaf_link;
+  template <class T>
+  struct btree_node_base;
+  template <class T>
+  struct btree_leaf_node;
+  template <class T>
+  struct btree_internal_node;
+
+  // btree node traits
+
+  template <class T>
+  struct btree_node_traits
+  {
+    typedef typename btree_value_traits<T>::key_type key_type;
+
+    typedef btree_leaf_link<T> *link_ptr;
+    typedef btree_node_base<T> *base_ptr;
+    typedef btree_leaf_node<T> *leaf_ptr;
+    typedef btree_internal_node<T> *internal_ptr;
+
+    // 叶节点的元素个数与内部节点的分隔键个数，节点头部约占四个指针
+    static constexpr size_t leaf_slots = (TINYSTL_BTREE_NODE_BYTES - 4 * sizeof(void *)) / sizeof(T);
+    static constexpr size_t leaf_capacity = leaf_slots < 4 ? 4 : leaf_slots;
+
+    static constexpr size_t internal_slots = (TINYSTL_BTREE_NODE_BYTES - 3 * sizeof(void *)) /
+                                             (sizeof(key_type) + sizeof(void *));
+    static constexpr size_t internal_capacity = internal_slots < 3 ? 3 : internal_slots;
+
+    static_assert(leaf_capacity < 65536 && internal_capacity < 65536,
+                  "TINYSTL_BTREE_NODE_BYTES is too big");
+  };
+
+  // 叶节点链表的链接部分，头节点只包含这一部分
+  template <class T>
+  struct btree_leaf_link
+  {
+    typedef typename btree_node_traits<T>::link_ptr link_ptr;
+    typedef typename btree_node_traits<T>::leaf_ptr leaf_ptr;
+
+    link_ptr prev;
+    link_ptr next;
+
+    leaf_ptr as_leaf() { return static_cast<leaf_ptr>(this); }
+    void unlink() { prev = next = this; }
+  };
+
+  // 叶节点与内部节点共有的部分
+  template <class T>
+  struct btree_node_base
+  {
+    typedef typename btree_node_traits<T>::leaf_ptr leaf_ptr;
+    typedef typename btree_node_traits<T>::internal_ptr internal_ptr;
+
+    internal_ptr parent;     // 父节点，根节点为 nullptr
+    unsigned short position; // 在父节点 children 中的下标
+    unsigned short count;    // 叶节点为元素个数，内部节点为分隔键个数
+    bool leaf;
+
+    leaf_ptr as_leaf() { return static_cast<leaf_ptr>(this); }
+    internal_ptr as_internal() { return static_cast<internal_ptr>(this); }
+  };
+
+  // 叶节点，保存 count 个已构造的元素
+  template <class T>
+  struct btree_leaf_node : public btree_leaf_link<T>, public btree_node_base<T>
+  {
+    static constexpr size_t capacity = btree_node_traits<T>::leaf_capacity;
+
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type data[capacity];
+
+    T *values() noexcept { return reinterpret_cast<T *>(data); }
+  };
+
+  // 内部节点，保存 count 个分隔键与 count + 1 个子节点
+  template <class T>
+  struct btree_internal_node : public btree_node_base<T>
+  {
+    typedef typename btree_node_traits<T>::key_type key_type;
+    typedef typename btree_node_traits<T>::base_ptr base_ptr;
+
+    static constexpr size_t capacity = btree_node_traits<T>::internal_capacity;
+
+    typename std::aligned_storage<sizeof(key_type), alignof(key_type)>::type data[capacity];
+    base_ptr children[capacity + 1];
+
+    key_type *keys() noexcept { return reinterpret_cast<key_type *>(data); }
+
+    void set_child(size_t i, base_ptr c) noexcept
+    {
+      children[i] = c;
+      c->parent = this;
+      c->position = static_cast<unsigned short>(i);
+    }
+  };
+
+  // btree 的迭代器，由所在叶节点和节点内下标组成，end() 为 (头节点, 0)
+  template <class T, class Ref, class Ptr>
+  struct btree_iterator : public iterator<bidirectional_iterator_tag, T>
+  {
+    typedef btree_iterator<T, T &, T *> iterator;
+    typedef btree_iterator<T, const T &, const T *> const_iterator;
+    typedef btree_iterator self;
+
+    typedef T value_type;
+    typedef Ptr pointer;
+    typedef Ref reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef typename btree_node_traits<T>::link_ptr link_ptr;
+
+    link_ptr node_;
+    size_type index_;
+
+    btree_iterator() noexcept : node_(nullptr), index_(0) {}
+    btree_iterator(link_ptr n, size_type i) noexcept : node_(n), index_(i) {}
+    btree_iterator(const iterator &rhs) noexcept
+        : node_(rhs.node_), index_(rhs.index_) {}
+    self &operator=(const iterator &rhs) noexcept
+    {
+      node_ = rhs.node_;
+      index_ = rhs.index_;
+      return *this;
+    }
+
+    reference operator*() const { return node_->as_leaf()->values()[index_]; }
+    pointer operator->() const { return &(operator*()); }
+
+    self &operator++()
+    {
+      TINYSTL_DEBUG(node_ != nullptr);
+      if (++index_ == node_->as_leaf()->count)
+      {
+        node_ = node_->next;
+        index_ = 0;
+      }
+      return *this;
+    }
+    self operator++(int)
+    {
+      self tmp = *this;
+      ++*this;
+      return tmp;
+    }
+    self &operator--()
+    {
+      TINYSTL_DEBUG(node_ != nullptr);
+      if (index_ == 0)
+      {
+        node_ = node_->prev;
+        index_ = node_->as_leaf()->count;
+      }
+      --index_;
+      return *this;
+    }
+    self operator--(int)
+    {
+      self tmp = *this;
+      --*this;
+      return tmp;
+    }
+
+    bool operator==(const self &rhs) const { return node_ == rhs.node_ && index_ == rhs.index_; }
+    bool operator!=(const self &rhs) const { return !(*this == rhs); }
+  };
+
+  // 模板类 btree
+  // 参数一代表数据类型，参数二代表键值比较类型
+  template <class T, class Compare>
+  class btree
+  {
+  public:
+    typedef btree_node_traits<T> node_traits;
+    typedef btree_value_traits<T> value_traits;
+
+    typedef typename node_traits::link_ptr link_ptr;
+    typedef typename node_traits::base_ptr base_ptr;
+    typedef typename node_traits::leaf_ptr leaf_ptr;
+    typedef typename node_traits::internal_ptr internal_ptr;
+    typedef btree_leaf_link<T> link_type;
+    typedef btree_leaf_node<T> leaf_type;
+    typedef btree_internal_node<T> internal_type;
+
+    typedef typename value_traits::key_type key_type;
+    typedef typename value_traits::mapped_type mapped_type;
+    typedef typename value_traits::value_type value_type;
+    typedef Compare key_compare;
+
+    typedef tinystl::allocator<T> allocator_type;
+    typedef tinystl::allocator<T> data_allocator;
+    typedef tinystl::allocator<key_type> key_allocator;
+    typedef tinystl::allocator<link_type> link_allocator;
+    typedef tinystl::allocator<leaf_type> leaf_allocator;
+    typedef tinystl::allocator<internal_type> internal_allocator;
+    typedef tinystl::allocator<base_ptr> base_ptr_allocator;
+    typedef tinystl::allocator<internal_ptr> internal_ptr_allocator;
+
+    typedef typename allocator_type::pointer pointer;
+    typedef typename allocator_type::const_pointer const_pointer;
+    typedef typename allocator_type::reference reference;
+    typedef typename allocator_type::const_reference const_reference;
+    typedef typename allocator_type::size_type size_type;
+    typedef typename allocator_type::difference_type difference_type;
+
+    typedef btree_iterator<T, T &, T *> iterator;
+    typedef btree_iterator<T, const T &, const T *> const_iterator;
+    typedef tinystl::reverse_iterator<iterator> reverse_iterator;
+    typedef tinystl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    static constexpr size_type leaf_capacity = node_traits::leaf_capacity;
+    static constexpr size_type internal_capacity = node_traits::internal_capacity;
+    static constexpr size_type leaf_min = leaf_capacity / 2;
+    static constexpr size_type internal_min = (internal_capacity - 1) / 2;
+
+    allocator_type get_allocator() const { return allocator_type(); }
+    key_compare key_comp() const { return key_comp_; }
+
+  private:
+    // 用以下四个数据表现 btree
+    link_ptr header_;      // 叶节点链表的头节点，header_->next 为最左叶节点，header_->prev 为最右叶节点
+    base_ptr root_;        // 根节点，空树时为 nullptr
+    size_type size_;       // 元素个数
+    key_compare key_comp_; // 键值比较的准则
+
+  public:
+    // 构造、复制、析构函数
+    btree() { btree_init(); }
+
+    btree(const btree &rhs);
+    btree(btree &&rhs) noexcept;
+
+    btree &operator=(const btree &rhs);
+    btree &operator=(btree &&rhs);
+
+    ~btree()
+    {
+      if (header_ != nullptr)
+      {
+        clear();
+        link_allocator::deallocate(header_);
+      }
+    }
+
+  public:
+    // 迭代器相关操作
+
+    iterator begin() noexcept
+    {
+      return iterator(header_->next, 0);
+    }
+    const_iterator begin() const noexcept
+    {
+      return const_iterator(header_->next, 0);
+    }
+    iterator end() noexcept
+    {
+      return iterator(header_, 0);
+    }
+    const_iterator end() const noexcept
+    {
+      return const_iterator(header_, 0);
+    }
+
+    reverse_iterator rbegin() noexcept
+    {
+      return reverse_iterator(end());
+    }
+    const_reverse_iterator rbegin() const noexcept
+    {
+      return const_reverse_iterator(end());
+    }
+    reverse_iterator rend() noexcept
+    {
+      return reverse_iterator(begin());
+    }
+    const_reverse_iterator rend() const noexcept
+    {
+      return const_reverse_iterator(begin());
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+      return begin();
+    }
+    const_iterator cend() const noexcept
+    {
+      return end();
+    }
+    const_reverse_iterator crbegin() const noexcept
+    {
+      return rbegin();
+    }
+    const_reverse_iterator crend() const noexcept
+    {
+      return rend();
+    }
+
+    // 容量相关操作
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type max_size() const noexcept { return static_cast<size_type>(-1); }
+
+    // 插入删除相关操作
+
+    // emplace
+
+    template <class... Args>
+    iterator emplace_multi(Args &&...args);
+
+    template <class... Args>
+    tinystl::pair<iterator, bool> emplace_unique(Args &&...args);
+
+    template <class... Args>
+    iterator emplace_multi_use_hint(const_iterator hint, Args &&...args);
+
+    template <class... Args>
+    iterator emplace_unique_use_hint(const_iterator hint, Args &&...args);
+
+    // insert
+
+    iterator insert_multi(const value_type &value)
+    {
+      return emplace_multi(value);
+    }
+    iterator insert_multi(value_type &&value)
+    {
+      return emplace_multi(tinystl::move(value));
+    }
+
+    iterator insert_multi(const_iterator hint, const value_type &value)
+    {
+      return emplace_multi_use_hint(hint, value);
+    }
+    iterator insert_multi(const_iterator hint, value_type &&value)
+    {
+      return emplace_multi_use_hint(hint, tinystl::move(value));
+    }
+
+    template <class InputIterator>
+    void insert_multi(InputIterator first, InputIterator last)
+    {
+      insert_range(first, last, false, iterator_category(first));
+    }
+
+    tinystl::pair<iterator, bool> insert_unique(const value_type &value);
+    tinystl::pair<iterator, bool> insert_unique(value_type &&value)
+    {
+      return emplace_unique(tinystl::move(value));
+    }
+
+    iterator insert_unique(const_iterator hint, const value_type &value)
+    {
+      return emplace_unique_use_hint(hint, value);
+    }
+    iterator insert_unique(const_iterator hint, value_type &&value)
+    {
+      return emplace_unique_use_hint(hint, tinystl::move(value));
+    }
+
+    template <class InputIterator>
+    void insert_unique(InputIterator first, InputIterator last)
+    {
+      insert_range(first, last, true, iterator_category(first));
+    }
+
+    // erase
+
+    iterator erase(const_iterator pos);
+
+    size_type erase_multi(const key_type &key);
+    size_type erase_unique(const key_type &key);
+
+    iterator erase(const_iterator first, const_iterator last);
+
+    void clear();
+
+    // btree 相关操作
+
+    iterator find(const key_type &key);
+    const_iterator find(const key_type &key) const;
+
+    size_type count_multi(const key_type &key) const
+    {
+      auto p = equal_range_multi(key);
+      return static_cast<size_type>(tinystl::distance(p.first, p.second));
+    }
+    size_type count_unique(const key_type &key) const
+    {
+      return find(key) != end() ? 1 : 0;
+    }
+
+    iterator lower_bound(const key_type &key);
+    const_iterator lower_bound(const key_type &key) const;
+
+    iterator upper_bound(const key_type &key);
+    const_iterator upper_bound(const key_type &key) const;
+
+    tinystl::pair<iterator, iterator>
+    equal_range_multi(const key_type &key)
+    {
+      return tinystl::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+    }
+    tinystl::pair<const_iterator, const_iterator>
+    equal_range_multi(const key_type &key) const
+    {
+      return tinystl::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+    }
+
+    tinystl::pair<iterator, iterator>
+    equal_range_unique(const key_type &key)
+    {
+      iterator it = find(key);
+      auto next = it;
+      return it == end() ? tinystl::make_pair(it, it) : tinystl::make_pair(it, ++next);
+    }
+    tinystl::pair<const_iterator, const_iterator>
+    equal_range_unique(const key_type &key) const
+    {
+      const_iterator it = find(key);
+      auto next = it;
+      return it == end() ? tinystl::make_pair(it, it) : tinystl::make_pair(it, ++next);
+    }
+
+    void swap(btree &rhs) noexcept;
+
+  private:
+    // node related
+    leaf_ptr create_leaf();
+    internal_ptr create_internal();
+    void destroy_leaf(leaf_ptr p);
+    void destroy_internal(internal_ptr x);
+    void destroy_subtree(base_ptr x);
+
+    void link_leaf_after(link_ptr pos, leaf_ptr p) noexcept;
+    void unlink_leaf(leaf_ptr p) noexcept;
+
+    // init / reset
+    void btree_init();
+    void reset();
+
+    // search
+    size_type leaf_lower(leaf_ptr p, const key_type &key) const;
+    size_type leaf_upper(leaf_ptr p, const key_type &key) const;
+    size_type internal_lower(internal_ptr x, const key_type &key) const;
+    size_type internal_upper(internal_ptr x, const key_type &key) const;
+    leaf_ptr descend_lower(const key_type &key, size_type &i) const;
+    leaf_ptr descend_upper(const key_type &key, size_type &i) const;
+    iterator make_iterator(leaf_ptr p, size_type i) const;
+    static leaf_ptr leftmost_leaf(base_ptr x);
+
+    // insert
+    iterator insert_value_at(leaf_ptr p, size_type i, value_type &&value);
+    size_type split_cost(leaf_ptr p) const;
+    void insert_into_parent(base_ptr left, key_type &sep, base_ptr right, internal_ptr *&spare);
+    void insert_key_child(internal_ptr x, size_type i, key_type &sep, base_ptr right);
+
+    template <class InputIterator>
+    void insert_range(InputIterator first, InputIterator last, bool unique, input_iterator_tag);
+    template <class ForwardIterator>
+    void insert_range(ForwardIterator first, ForwardIterator last, bool unique, forward_iterator_tag);
+    template <class ForwardIterator>
+    void bulk_load(ForwardIterator first, size_type n, bool unique);
+
+    // erase
+    void erase_key_child(internal_ptr x, size_type i);
+    iterator rebalance_leaf(leaf_ptr p, size_type i);
+    void rebalance_internal(internal_ptr x);
+  };
+
+  /*****************************************************************************************/
+
+  // 复制构造函数，rhs 已经有序，直接自底向上建树
+  template <class T, class Compare>
+  btree<T, Compare>::
+      btree(const btree &rhs)
+  {
+    btree_init();
+    key_comp_ = rhs.key_comp_;
+    bulk_load(rhs.begin(), rhs.size_, false);
+  }
+
+  // 移动构造函数
+  template <class T, class Compare>
+  btree<T, Compare>::
+      btree(btree &&rhs) noexcept
+      : header_(rhs.header_),
+        root_(rhs.root_),
+        size_(rhs.size_),
+        key_comp_(rhs.key_comp_)
+  {
+    rhs.reset();
+  }
+
+  // 复制赋值操作符
+  template <class T, class Compare>
+  btree<T, Compare> &
+  btree<T, Compare>::
+  operator=(const btree &rhs)
+  {
+    if (this != &rhs)
+    {
+      clear();
+      key_comp_ = rhs.key_comp_;
+      bulk_load(rhs.begin(), rhs.size_, false);
+    }
+    return *this;
+  }
+
+  // 移动赋值操作符
+  template <class T, class Compare>
+  btree<T, Compare> &
+  btree<T, Compare>::
+  operator=(btree &&rhs)
+  {
+    if (this != &rhs)
+    {
+      clear();
+      swap(rhs);
+    }
+    return *this;
+  }
+
+  // 就地插入元素，键值允许重复
+  template <class T, class Compare>
+  template <class... Args>
+  typename btree<T, Compare>::iterator
+  btree<T, Compare>::
+      emplace_multi(Args &&...args)
+  {
+    value_type tmp(tinystl::forward<Args>(args)...);
+    if (root_ == nullptr)
+      return insert_value_at(nullptr, 0, tinystl::move(tmp));
+    size_type i = 0;
+    leaf_ptr p = descend_upper(value_traits::get_key(tmp), i);
+    return insert_value_at(p, i, tinystl::move(tmp));
+  }
+
+  // 就地插入元素，键值不允许重复
+  template <class T, class Compare>
+  template <class... Args>
+  tinystl::pair<typename btree<T, Compare>::iterator, bool>
+  btree<T, Compare>::
+      emplace_unique(Args &&...args)
+  {
+    value_type tmp(tinystl::forward<Args>(args)...);
+    if (root_ == nullptr)
+      return tinystl::make_pair(insert_value_at(nullptr, 0, tinystl::move(tmp)), true);
+    size_type i = 0;
+    leaf_ptr p = descend_lower(value_traits::get_key(tmp), i);
+    iterator it = make_iterator(p, i);
+    if (it != end() && !key_comp_(value_traits::get_key(tmp), value_traits::get_key(*it)))
+      return tinystl::make_pair(it, false);
+    return tinystl::make_pair(insert_value_at(p, i, tinystl::move(tmp)), true);
+  }
+
+  // 就地插入元素，键值允许重复，hint 为 end() 且元素不小于最后一个元素时直接追加到末尾
+  template <class T, class Compare>
+  template <class... Args>
+  typename btree<T, Compare>::iterator
+  btree<T, Compare>::
+      emplace_multi_use_hint(const_iterator hint, Args &&...args)
+  {
+    value_type tmp(tinystl::forward<Args>(args)...);
+    if (root_ == nullptr)
+      return insert_value_at(nullptr, 0, tinystl::move(tmp));
+    if (hint == cend())
+    {
+      leaf_ptr p = header_->prev->as_leaf();
+      if (!key_comp_(value_traits::get_key(tmp), value_traits::get_key(p->values()[p->count - 1])))
+        return insert_value_at(p, p->count, tinystl::move(tmp));
+    }
+    size_type i = 0;
+    leaf_ptr p = descend_upper(value_traits::get_key(tmp), i);
+    return insert_value_at(p, i, tinystl::move(tmp));
+  }
+
+  // 就地插入元素，键值不允许重复，hint 为 end() 且元素大于最后一个元素时直接追加到末尾
+  template <class T, class Compare>
+  template <class... Args>
+  typename btree<T, Compare>::iterator
+  btree<T, Compare>::
+      emplace_unique_use_hint(const_iterator hint, Args &&...args)
+  {
+    value_type tmp(tinystl::forward<Args>(args)...);
+    if (root_ == nullptr)
+      return insert_value_at(nullptr, 0, tinystl::move(tmp));
+    if (hint == cend())
+    {
+      leaf_ptr p = header_->prev->as_leaf();
+      if (key_comp_(value_traits::get_key(p->values()[p->count - 1]), value_traits::get_key(tmp)))
+        return insert_value_at(p, p->count, tinystl::move(tmp));
+    }
+    size_type i = 0;
+    leaf_ptr p = descend_lower(value_traits::get_key(tmp), i);
+    iterator it = make_iterator(p, i);
+    if (it != end() && !key_comp_(value_traits::get_key(tmp), value_traits::get_key(*it)))
+      return it;
+    return insert_value_at(p, i, tinystl::move(tmp));
+  }
+
+  // 插入元素，键值不允许重复，已存在时不复制元素
+  template <class T, class Compare>
+  tinystl::pair<typename btree<T, Compare>::iterator, bool>
+  btree<T, Compare>::
+      insert_unique(const value_type &value)
+  {
+    if (root_ == nullptr)
+      return tinystl::make_pair(insert_value_at(nullptr, 0, value_type(value)), true);
+    size_type i = 0;
+    leaf_ptr p = descend_lower(value_traits::get_key(value), i);
+    iterator it = make_iterator(p, i);
+    if (it != end() && !key_comp_(value_traits::get_key(value), value_traits::get_key(*it)))
+      return tinystl::make_pair(it, false);
+    return tinystl::make_pair(insert_value_at(p, i, value_type(value)), true);
+  }
+
+  // 删除 pos 处的元素，返回指向下一个元素的迭代器
+  template <class T, class Compare>
+  typename btree<T, Compare>::iterator
+  btree<T, Compare>::
+      erase(const_iterator pos)
+  {
+    TINYSTL_DEBUG(pos != cend());
+    leaf_ptr p = pos.node_->as_leaf();
+    const size_type i = pos.index_;
+    T *v = p->values();
+    data_allocator::destroy(v + i);
+    for (size_type j = i + 1; j < p->count; ++j)
+    {
+      data_allocator::construct(v + j - 1, tinystl::move(v[j]));
+      data_allocator::destroy(v + j);
+    }
+    --p->count;
+    --size_;
+    return rebalance_leaf(p, i);
+  }
+
+  // 删除键值等于 key 的元素，返回删除的个数
+  template <class T, class Compare>
+  typename btree<T, Compare>::size_type
+  btree<T, Compare>::
+      erase_multi(const key_type &key)
+  {
+    auto p = equal_range_multi(key);
+    size_type n = static_cast<size_type>(tinystl::distance(p.first, p.second));
+    const_iterator it = p.first;
+    for (size_type k = n; k > 0; --k)
+      it = erase(it);
+    return n;
+  }
+
+  // 删除键值等于 key 的元素，返回删除的个数
+  template <class T, class Compare>
+  typename btree<T, Compare>::size_type
+  btree<T, Compare>::
+      erase_unique(const key_type &key)
+  {
+    iterator it = find(key);
+    if (it != end())
+    {
+      erase(it);
+      return 1;
+    }
+    return 0;
+  }
+
+  // 删除 [first, last) 内的元素
+  // 删除过程中的借用与合并会使 last 失效，因此按个数删除
+  template <class T, class Compare>
+  typename btree<T, Compare>::iterator
+  btree<T, Compare>::
+      erase(const_iterator first, const_iterator last)
+  {
+    if (first == cbegin() && last == cend())
+    {
+      clear();
+      return end();
+    }
+    size_type n = static_cast<size_type>(tinystl::distance(first, last));
+    iterator it(first.node_, first.index_);
+    for (; n > 0; --n)
+      it = erase(it);
+    return it;
+  }
+
+  // 清空 btree
+  template <class T, class Compare>
+  void btree<T, Compare>::clear()
+  {
+    if (root_ != nullptr)
+    {
+      destroy_subtree(root_);
+      root_ = nullptr;
+      header_->unlink();
+      size_ = 0;
+    }
+  }
+
+  // 查找键值为 key 的元素，返回指向它的迭代器
+  template <class T, class Compare>
+  typename btree<T, Compare>::iterator
+  btree<T, Compare>::
+      find(const key_type &key)
+  {
+    iterator it = lower_bound(key);
+    return (it == end() || key_comp_(key, value_traits::get_key(*it))) ? end() : it;
+  }
+
+  template <class T, class Compare>
+  typename btree<T, Compare>::const_iterator
+  btree<T, Compare>::
+      find(const key_type &key) const
+  {
+    const_iterator it = lower_bound(key);
+    return (it == end() || key_comp_(key, value_traits::get_key(*it))) ? end() : it;
+  }
+
+  // 键值不小于 key 的第一个位置
+  template <class T, class Compare>
+  typename btree<T, Compare>::iterator
+  btree<T, Compare>::
+      lower_bound(const key_type &key)
+  {
+    if (root_ == nullptr)
+      return end();
+    size_type i = 0;
+    leaf_ptr p = descend_lower(key, i);
+    return make_iterator(p, i);
+  }
+
+  template <class T, class Compare>
+  typename btree<T, Compare>::const_iterator
+  btree<T, Compare>::
+      lower_bound(const key_type &key) const
+  {
+    if (root_ == nullptr)
+      return end();
+    size_type i = 0;
+    leaf_ptr p = descend_lower(key, i);
+    return make_iterator(p, i);
+  }
+
+  // 键值大于 key 的第一个位置
+  template <class T, class Compare>
+  typename btree<T, Compare>::iterator
+  btree<T, Compare>::
+      upper_bound(const key_type &key)
+  {
+    if (root_ == nullptr)
+      return end();
+    size_type i = 0;
+    leaf_ptr p = descend_upper(key, i);
+    return make_iterator(p, i);
+  }
+
+  template <class T, class Compare>
+  typename btree<T, Compare>::const_iterator
+  btree<T, Compare>::
+      upper_bound(const key_type &key) const
+  {
+    if (root_ == nullptr)
+      return end();
+    size_type i = 0;
+    leaf_ptr p = descend_upper(key, i);
+    return make_iterator(p, i);
+  }
+
+  // 交换 btree
+  template <class T, class Compare>
+  void btree<T, Compare>::
+      swap(btree &rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      tinystl::swap(header_, rhs.header_);
+      tinystl::swap(root_, rhs.root_);
+      tinystl::swap(size_, rhs.size_);
+      tinystl::swap(key_comp_, rhs.key_comp_);
+    }
+  }
+
+  /*****************************************************************************************/
+  // helper function
+
+  template <class T, class Compare>
+  typename btree<T, Compare>::leaf_ptr
+  btree<T, Compare>::create_leaf()
+  {
+    leaf_ptr p = leaf_allocator::allocate(1);
+    p->prev = p->next = p;
+    p->parent = nullptr;
+    p->position = 0;
+    p->count = 0;
+    p->leaf = true;
+    return p;
+  }
+
+  template <class T, class Compare>
+  typename btree<T, Compare>::internal_ptr
+  btree<T, Compare>::create_internal()
+  {
+    internal_ptr x = internal_allocator::allocate(1);
+    x->parent = nullptr;
+    x->position = 0;
+    x->count = 0;
+    x->leaf = false;
+    return x;
+  }
+
+  template <class T, class Compare>
+  void btree<T, Compare>::destroy_leaf(leaf_ptr p)
+  {
+    data_allocator::destroy(p->values(), p->values() + p->count);
+    leaf_allocator::deallocate(p, 1);
+  }
+
+  template <class T, class Compare>
+  void btree<T, Compare>::destroy_internal(internal_ptr x)
+  {
+    key_allocator::destroy(x->keys(), x->keys() + x->count);
+    internal_allocator::deallocate(x, 1);
+  }
+
+  // 销毁以 x 为根的子树，递归深度为树高
+  template <class T, class Compare>
+  void btree<T, Compare>::destroy_subtree(base_ptr x)
+  {
+    if (x->leaf)
+    {
+      destroy_leaf(x->as_leaf());
+      return;
+    }
+    internal_ptr n = x->as_internal();
+    for (size_type i = 0; i <= n->count; ++i)
+      destroy_subtree(n->children[i]);
+    destroy_internal(n);
+  }
+
+  template <class T, class Compare>
+  void btree<T, Compare>::link_leaf_after(link_ptr pos, leaf_ptr p) noexcept
+  {
+    p->prev = pos;
+    p->next = pos->next;
+    pos->next->prev = p;
+    pos->next = p;
+  }
+
+  template <class T, class Compare>
+  void btree<T, Compare>::unlink_leaf(leaf_ptr p) noexcept
+  {
+    p->prev->next = p->next;
+    p->next->prev = p->prev;
+  }
+
+  // 初始化 btree
+  template <class T, class Compare>
+  void btree<T, Compare>::btree_init()
+  {
+    header_ = link_allocator::allocate(1);
+    header_->unlink();
+    root_ = nullptr;
+    size_ = 0;
+  }
+
+  // reset 函数
+  template <class T, class Compare>
+  void btree<T, Compare>::reset()
+  {
+    header_ = nullptr;
+    root_ = nullptr;
+    size_ = 0;
+  }
+
+  // 节点内的二分查找，返回第一个键值不小于 / 大于 key 的下标
+  template <class T, class Compare>
+  typename btree<T, Compare>::size_type
+  btree<T, Compare>::leaf_lower(leaf_ptr p, const key_type &key) const
+  {
+    const T *v = p->values();
+    size_type lo = 0, hi = p->count;
+    while (lo < hi)
+    {
+      const size_type mid = (lo + hi) / 2;
+      if (key_comp_(value_traits::get_key(v[mid]), key))
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    return lo;
+  }
+
+  template <class T, class Compare>
+  typename btree<T, Compare>::size_type
+  btree<T, Compare>::leaf_upper(leaf_ptr p, const key_type &key) const
+  {
+    const T *v = p->values();
+    size_type lo = 0, hi = p->count;
+    while (lo < hi)
+    {
+      const size_type mid = (lo + hi) / 2;
+      if (key_comp_(key, value_traits::get_key(v[mid])))
+        hi = mid;
+      else
+        lo = mid + 1;
+    }
+    return lo;
+  }
+
+  template <class T, class Compare>
+  typename btree<T, Compare>::size_type
+  btree<T, Compare>::internal_lower(internal_ptr x, const key_type &key) const
+  {
+    const key_type *k = x->keys();
+    size_type lo = 0, hi = x->count;
+    while (lo < hi)
+    {
+      const size_type mid = (lo + hi) / 2;
+      if (key_comp_(k[mid], key))
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    return lo;
+  }
+
+  template <class T, class Compare>
+  typename btree<T, Compare>::size_type
+  btree<T, Compare>::internal_upper(internal_ptr x, const key_type &key) const
+  {
+    const key_type *k = x->keys();
+    size_type lo = 0, hi = x->count;
+    while (lo < hi)
+    {
+      const size_type mid = (lo + hi) / 2;
+      if (key_comp_(key, k[mid]))
+        hi = mid;
+      else
+        lo = mid + 1;
+    }
+    return lo;
+  }
+
+  // 从根节点下降到 lower_bound(key) 所在的叶节点，i 为叶节点内的下标，可能等于 count
+  template <class T, class Compare>
+  typename btree<T, Compare>::leaf_ptr
+  btree<T, Compare>::descend_lower(const key_type &key, size_type &i) const
+  {
+    base_ptr x = root_;
+    while (!x->leaf)
+    {
+      internal_ptr n = x->as_internal();
+      x = n->children[internal_lower(n, key)];
+    }
+    leaf_ptr p = x->as_leaf();
+    i = leaf_lower(p, key);
+    return p;
+  }
+
+  // 从根节点下降到 upper_bound(key) 所在的叶节点，i 为叶节点内的下标，可能等于 count
+  template <class T, class Compare>
+  typename btree<T, Compare>::leaf_ptr
+  btree<T, Compare>::descend_upper(const key_type &key, size_type &i) const
+  {
+    base_ptr x = root_;
+    while (!x->leaf)
+    {
+      internal_ptr n = x->as_internal();
+      x = n->children[internal_upper(n, key)];
+    }
+    leaf_ptr p = x->as_leaf();
+    i = leaf_upper(p, key);
+    return p;
+  }
+
+  // 下标等于 count 时指向下一个叶节点的第一个元素
+  template <class T, class Compare>
+  typename btree<T, Compare>::iterator
+  btree<T, Compare>::make_iterator(leaf_ptr p, size_type i) const
+  {
+    if (i == p->count)
+      return iterator(p->next, 0);
+    return iterator(p, i);
+  }
+
+  template <class T, class Compare>
+  typename btree<T, Compare>::leaf_ptr
+  btree<T, Compare>::leftmost_leaf(base_ptr x)
+  {
+    while (!x->leaf)
+      x = x->as_internal()->children[0];
+    return x->as_leaf();
+  }
+
+  // 在叶节点 p 的下标 i 处插入 value，p 为 nullptr 表示空树
+  // 叶节点已满时先拆分：在节点两端插入时把元素全部留在一侧，使顺序插入得到填满的节点
+  template <class T, class Compare>
+  typename btree<T, Compare>::iterator
+  btree<T, Compare>::insert_value_at(leaf_ptr p, size_type i, value_type &&value)
+  {
+    THROW_LENGTH_ERROR_IF(size_ == max_size(), "btree<T, Comp>'s size too big");
+    if (p == nullptr)
+    {
+      p = create_leaf();
+      link_leaf_after(header_, p);
+      root_ = p;
+    }
+    else if (p->count == leaf_capacity)
+    {
+      const size_type cap = leaf_capacity;
+      const size_type s = i == 0 ? 0 : (i == cap ? cap : cap / 2);
+      const bool to_right = i > s || s == cap;
+      const size_type j = to_right ? i - s : i;
+
+      // 先复制分隔键并分配拆分所需的全部节点，之后只移动元素，不会失败
+      key_type sep(to_right && j == 0 ? value_traits::get_key(value)
+                                      : value_traits::get_key(p->values()[s]));
+      internal_ptr pool[BTREE_MAX_HEIGHT];
+      const size_type need = split_cost(p);
+      size_type got = 0;
+      leaf_ptr q = nullptr;
+      try
+      {
+        q = create_leaf();
+        for (; got < need; ++got)
+          pool[got] = create_internal();
+      }
+      catch (...)
+      {
+        if (q != nullptr)
+          leaf_allocator::deallocate(q, 1);
+        for (size_type k = 0; k < got; ++k)
+          internal_allocator::deallocate(pool[k], 1);
+        throw;
+      }
+
+      T *src = p->values();
+      T *dst = q->values();
+      for (size_type k = s; k < cap; ++k)
+      {
+        data_allocator::construct(dst + k - s, tinystl::move(src[k]));
+        data_allocator::destroy(src + k);
+      }
+      q->count = static_cast<unsigned short>(cap - s);
+      p->count = static_cast<unsigned short>(s);
+      link_leaf_after(p, q);
+      internal_ptr *spare = pool;
+      insert_into_parent(p, sep, q, spare);
+      if (to_right)
+      {
+        p = q;
+        i = j;
+      }
+    }
+
+    T *v = p->values();
+    for (size_type k = p->count; k > i; --k)
+    {
+      data_allocator::construct(v + k, tinystl::move(v[k - 1]));
+      data_allocator::destroy(v + k - 1);
+    }
+    data_allocator::construct(v + i, tinystl::move(value));
+    ++p->count;
+    ++size_;
+    return iterator(p, i);
+  }
+
+  // 拆分叶节点 p 需要新建的内部节点个数：向上连续已满的祖先各需一个，拆到根节点时再需要一个新根
+  template <class T, class Compare>
+  typename btree<T, Compare>::size_type
+  btree<T, Compare>::split_cost(leaf_ptr p) const
+  {
+    size_type n = 0;
+    internal_ptr x = p->parent;
+    while (x != nullptr && x->count == internal_capacity)
+    {
+      ++n;
+      x = x->parent;
+    }
+    return x == nullptr ? n + 1 : n;
+  }
+
+  // 把分隔键 sep 与新节点 right 插入到 left 的父节点中，right 位于 left 之后
+  // 父节点已满时继续向上拆分，所需的新节点从 spare 中取得
+  template <class T, class Compare>
+  void btree<T, Compare>::insert_into_parent(base_ptr left, key_type &sep, base_ptr right,
+                                             internal_ptr *&spare)
+  {
+    internal_ptr x = left->parent;
+    if (x == nullptr)
+    { // 根节点被拆分，树长高一层
+      internal_ptr r = *spare++;
+      key_allocator::construct(r->keys(), tinystl::move(sep));
+      r->count = 1;
+      r->set_child(0, left);
+      r->set_child(1, right);
+      root_ = r;
+      return;
+    }
+    const size_type i = left->position;
+    if (x->count < internal_capacity)
+    {
+      insert_key_child(x, i, sep, right);
+      return;
+    }
+
+    // x 已满：x 保留前 s 个分隔键，第 s 个上移，其余移入新节点 y，再把 sep 插入对应的一半
+    const size_type cap = internal_capacity;
+    const size_type s = i == 0 ? 0 : (i == cap ? cap - 1 : cap / 2);
+    internal_ptr y = *spare++;
+    key_type *xk = x->keys();
+    key_type *yk = y->keys();
+    for (size_type k = s + 1; k < cap; ++k)
+    {
+      key_allocator::construct(yk + k - s - 1, tinystl::move(xk[k]));
+      key_allocator::destroy(xk + k);
+    }
+    for (size_type k = s + 1; k <= cap; ++k)
+      y->set_child(k - s - 1, x->children[k]);
+    y->count = static_cast<unsigned short>(cap - s - 1);
+    key_type up(tinystl::move(xk[s]));
+    key_allocator::destroy(xk + s);
+    x->count = static_cast<unsigned short>(s);
+    if (i <= s)
+      insert_key_child(x, i, sep, right);
+    else
+      insert_key_child(y, i - s - 1, sep, right);
+    insert_into_parent(x, up, y, spare);
+  }
+
+  // 在未满的内部节点 x 中插入分隔键 sep（下标 i）与子节点 right（下标 i + 1）
+  template <class T, class Compare>
+  void btree<T, Compare>::insert_key_child(internal_ptr x, size_type i, key_type &sep,
+                                           base_ptr right)
+  {
+    key_type *k = x->keys();
+    for (size_type j = x->count; j > i; --j)
+    {
+      key_allocator::construct(k + j, tinystl::move(k[j - 1]));
+      key_allocator::destroy(k + j - 1);
+    }
+    key_allocator::construct(k + i, tinystl::move(sep));
+    for (size_type j = x->count + 1; j > i + 1; --j)
+      x->set_child(j, x->children[j - 1]);
+    x->set_child(i + 1, right);
+    ++x->count;
+  }
+
+  // 以输入迭代器插入，逐个插入
+  template <class T, class Compare>
+  template <class InputIterator>
+  void btree<T, Compare>::insert_range(InputIterator first, InputIterator last, bool unique,
+                                       input_iterator_tag)
+  {
+    for (; first != last; ++first)
+    {
+      if (unique)
+        emplace_unique_use_hint(cend(), *first);
+      else
+        emplace_multi_use_hint(cend(), *first);
+    }
+  }
+
+  // 以前向迭代器插入，空树且区间有序时自底向上建树，否则逐个插入
+  template <class T, class Compare>
+  template <class ForwardIterator>
+  void btree<T, Compare>::insert_range(ForwardIterator first, ForwardIterator last, bool unique,
+                                       forward_iterator_tag)
+  {
+    if (first == last)
+      return;
+    if (empty())
+    {
+      bool sorted = true;
+      size_type n = 1;
+      ForwardIterator cur = first;
+      for (ForwardIterator prev = first; ++cur != last; ++prev)
+      {
+        if (key_comp_(value_traits::get_key(*cur), value_traits::get_key(*prev)))
+        {
+          sorted = false;
+          break;
+        }
+        if (!unique || key_comp_(value_traits::get_key(*prev), value_traits::get_key(*cur)))
+          ++n;
+      }
+      if (sorted)
+      {
+        bulk_load(first, n, unique);
+        return;
+      }
+    }
+    insert_range(first, last, unique, input_iterator_tag());
+  }
+
+  // 从有序区间自底向上建树，n 为要保存的元素个数，unique 时跳过与前一个元素等价的元素
+  // 元素平均分配到各叶节点，每层的节点也平均分配子节点，除个别节点外全部填满
+  template <class T, class Compare>
+  template <class ForwardIterator>
+  void btree<T, Compare>::bulk_load(ForwardIterator first, size_type n, bool unique)
+  {
+    TINYSTL_DEBUG(empty());
+    if (n == 0)
+      return;
+    const size_type nleaf = (n + leaf_capacity - 1) / leaf_capacity;
+    base_ptr *level = base_ptr_allocator::allocate(nleaf);
+    internal_ptr *inner = nullptr;
+    size_type ninner = 0;
+    try
+    {
+      inner = internal_ptr_allocator::allocate(nleaf);
+
+      // 叶节点层
+      const T *prev = nullptr;
+      for (size_type j = 0; j < nleaf; ++j)
+      {
+        leaf_ptr p = create_leaf();
+        link_leaf_after(header_->prev, p);
+        level[j] = p;
+        const size_type m = n / nleaf + (j < n % nleaf ? 1 : 0);
+        for (; p->count < m; ++first)
+        {
+          if (unique && prev != nullptr &&
+              !key_comp_(value_traits::get_key(*prev), value_traits::get_key(*first)))
+            continue;
+          data_allocator::construct(p->values() + p->count, *first);
+          prev = p->values() + p->count;
+          ++p->count;
+        }
+      }
+
+      // 内部节点层，直到只剩一个节点
+      size_type c = nleaf;
+      while (c > 1)
+      {
+        const size_type np = (c + internal_capacity) / (internal_capacity + 1);
+        size_type src = 0;
+        for (size_type j = 0; j < np; ++j)
+        {
+          internal_ptr x = create_internal();
+          inner[ninner++] = x;
+          const size_type m = c / np + (j < c % np ? 1 : 0);
+          x->set_child(0, level[src]);
+          for (size_type k = 1; k < m; ++k)
+          {
+            key_allocator::construct(x->keys() + x->count,
+                                     value_traits::get_key(leftmost_leaf(level[src + k])->values()[0]));
+            ++x->count;
+            x->set_child(k, level[src + k]);
+          }
+          src += m;
+          level[j] = x;
+        }
+        c = np;
+      }
+      root_ = level[0];
+      size_ = n;
+    }
+    catch (...)
+    {
+      for (size_type j = 0; j < ninner; ++j)
+        destroy_internal(inner[j]);
+      link_ptr cur = header_->next;
+      while (cur != header_)
+      {
+        link_ptr next = cur->next;
+        destroy_leaf(cur->as_leaf());
+        cur = next;
+      }
+      header_->unlink();
+      root_ = nullptr;
+      size_ = 0;
+      if (inner != nullptr)
+        internal_ptr_allocator::deallocate(inner, nleaf);
+      base_ptr_allocator::deallocate(level, nleaf);
+      throw;
+    }
+    internal_ptr_allocator::deallocate(inner, nleaf);
+    base_ptr_allocator::deallocate(level, nleaf);
+  }
+
+  // 删除内部节点 x 的分隔键 i 与子节点 i + 1
+  template <class T, class Compare>
+  void btree<T, Compare>::erase_key_child(internal_ptr x, size_type i)
+  {
+    key_type *k = x->keys();
+    key_allocator::destroy(k + i);
+    for (size_type j = i + 1; j < x->count; ++j)
+    {
+      key_allocator::construct(k + j - 1, tinystl::move(k[j]));
+      key_allocator::destroy(k + j);
+    }
+    for (size_type j = i + 2; j <= x->count; ++j)
+      x->set_child(j - 1, x->children[j]);
+    --x->count;
+  }
+
+  // 叶节点 p 在下标 i 处删除了一个元素后调整树的形状，返回原来 i 之后的元素的位置
+  // 过空的叶节点优先与兄弟节点合并，放不下时从兄弟节点借一个元素
+  template <class T, class Compare>
+  typename btree<T, Compare>::iterator
+  btree<T, Compare>::rebalance_leaf(leaf_ptr p, size_type i)
+  {
+    if (p == root_)
+    {
+      if (p->count == 0)
+      {
+        unlink_leaf(p);
+        destroy_leaf(p);
+        root_ = nullptr;
+        return end();
+      }
+      return make_iterator(p, i);
+    }
+    if (p->count >= leaf_min)
+      return make_iterator(p, i);
+
+    internal_ptr x = p->parent;
+    const size_type pos = p->position;
+    if (pos > 0)
+    {
+      leaf_ptr l = x->children[pos - 1]->as_leaf();
+      if (l->count + p->count <= leaf_capacity)
+      { // 把 p 并入 l
+        T *dst = l->values() + l->count;
+        T *src = p->values();
+        for (size_type k = 0; k < p->count; ++k)
+        {
+          data_allocator::construct(dst + k, tinystl::move(src[k]));
+          data_allocator::destroy(src + k);
+        }
+        i += l->count;
+        l->count = static_cast<unsigned short>(l->count + p->count);
+        p->count = 0;
+        unlink_leaf(p);
+        erase_key_child(x, pos - 1);
+        destroy_leaf(p);
+        rebalance_internal(x);
+        return make_iterator(l, i);
+      }
+      // 从 l 借最后一个元素
+      T *lv = l->values();
+      T *v = p->values();
+      key_type sep(value_traits::get_key(lv[l->count - 1]));
+      for (size_type k = p->count; k > 0; --k)
+      {
+        data_allocator::construct(v + k, tinystl::move(v[k - 1]));
+        data_allocator::destroy(v + k - 1);
+      }
+      data_allocator::construct(v, tinystl::move(lv[l->count - 1]));
+      data_allocator::destroy(lv + l->count - 1);
+      --l->count;
+      ++p->count;
+      x->keys()[pos - 1] = tinystl::move(sep);
+      return make_iterator(p, i + 1);
+    }
+
+    leaf_ptr r = x->children[pos + 1]->as_leaf();
+    if (r->count + p->count <= leaf_capacity)
+    { // 把 r 并入 p
+      T *dst = p->values() + p->count;
+      T *src = r->values();
+      for (size_type k = 0; k < r->count; ++k)
+      {
+        data_allocator::construct(dst + k, tinystl::move(src[k]));
+        data_allocator::destroy(src + k);
+      }
+      p->count = static_cast<unsigned short>(p->count + r->count);
+      r->count = 0;
+      unlink_leaf(r);
+      erase_key_child(x, pos);
+      destroy_leaf(r);
+      rebalance_internal(x);
+      return make_iterator(p, i);
+    }
+    // 从 r 借第一个元素
+    T *rv = r->values();
+    T *v = p->values();
+    key_type sep(value_traits::get_key(rv[1]));
+    data_allocator::construct(v + p->count, tinystl::move(rv[0]));
+    data_allocator::destroy(rv);
+    for (size_type k = 1; k < r->count; ++k)
+    {
+      data_allocator::construct(rv + k - 1, tinystl::move(rv[k]));
+      data_allocator::destroy(rv + k);
+    }
+    --r->count;
+    ++p->count;
+    x->keys()[pos] = tinystl::move(sep);
+    return make_iterator(p, i);
+  }
+
+  // 内部节点 x 删除了一个分隔键后调整树的形状，必要时逐层向上
+  template <class T, class Compare>
+  void btree<T, Compare>::rebalance_internal(internal_ptr x)
+  {
+    while (true)
+    {
+      if (x == root_)
+      {
+        if (x->count == 0)
+        { // 根节点只剩一个子节点，树降低一层
+          root_ = x->children[0];
+          root_->parent = nullptr;
+          root_->position = 0;
+          internal_allocator::deallocate(x, 1);
+        }
+        return;
+      }
+      if (x->count >= internal_min)
+        return;
+
+      internal_ptr px = x->parent;
+      const size_type pos = x->position;
+      internal_ptr l = pos > 0 ? px->children[pos - 1]->as_internal() : x;
+      internal_ptr r = pos > 0 ? x : px->children[pos + 1]->as_internal();
+      const size_type sep = l->position;
+
+      if (static_cast<size_type>(l->count) + static_cast<size_type>(r->count) + 1 <= internal_capacity)
+      { // 把 r 连同父节点中的分隔键并入 l
+        key_type *lk = l->keys();
+        key_type *rk = r->keys();
+        key_allocator::construct(lk + l->count, tinystl::move(px->keys()[sep]));
+        for (size_type k = 0; k < r->count; ++k)
+        {
+          key_allocator::construct(lk + l->count + 1 + k, tinystl::move(rk[k]));
+          key_allocator::destroy(rk + k);
+        }
+        for (size_type k = 0; k <= r->count; ++k)
+          l->set_child(l->count + 1 + k, r->children[k]);
+        l->count = static_cast<unsigned short>(l->count + r->count + 1);
+        r->count = 0;
+        erase_key_child(px, sep);
+        internal_allocator::deallocate(r, 1);
+        x = px;
+        continue;
+      }
+
+      key_type *xk = x->keys();
+      key_type *pk = px->keys() + sep;
+      if (x == r)
+      { // 经由父节点从 l 右旋一个分隔键与子节点
+        for (size_type k = x->count; k > 0; --k)
+        {
+          key_allocator::construct(xk + k, tinystl::move(xk[k - 1]));
+          key_allocator::destroy(xk + k - 1);
+        }
+        for (size_type k = x->count + 1; k > 0; --k)
+          x->set_child(k, x->children[k - 1]);
+        key_allocator::construct(xk, tinystl::move(*pk));
+        x->set_child(0, l->children[l->count]);
+        ++x->count;
+        *pk = tinystl::move(l->keys()[l->count - 1]);
+        key_allocator::destroy(l->keys() + l->count - 1);
+        --l->count;
+      }
+      else
+      { // 经由父节点从 r 左旋一个分隔键与子节点
+        key_type *rk = r->keys();
+        key_allocator::construct(xk + x->count, tinystl::move(*pk));
+        x->set_child(x->count + 1, r->children[0]);
+        ++x->count;
+        *pk = tinystl::move(rk[0]);
+        key_allocator::destroy(rk);
+        for (size_type k = 1; k < r->count; ++k)
+        {
+          key_allocator::construct(rk + k - 1, tinystl::move(rk[k]));
+          key_allocator::destroy(rk + k);
+        }
+        for (size_type k = 1; k <= r->count; ++k)
+          r->set_child(k - 1, r->children[k]);
+        --r->count;
+      }
+      return;
+    }
+  }
+
+  // 重载比较操作符
+  template <class T, class Compare>
+  bool operator==(const btree<T, Compare> &lhs, const btree<T, Compare> &rhs)
+  {
+    return lhs.size() == rhs.size() && tinystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+  }
+
+  template <class T, class Compare>
+  bool operator<(const btree<T, Compare> &lhs, const btree<T, Compare> &rhs)
+  {
+    return tinystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+
+  template <class T, class Compare>
+  bool operator!=(const btree<T, Compare> &lhs, const btree<T, Compare> &rhs)
+  {
+    return !(lhs == rhs);
+  }
+
+  template <class T, class Compare>
+  bool operator>(const btree<T, Compare> &lhs, const btree<T, Compare> &rhs)
+  {
+    return rhs < lhs;
+  }
+
+  template <class T, class Compare>
+  bool operator<=(const btree<T, Compare> &lhs, const btree<T, Compare> &rhs)
+  {
+    return !(rhs < lhs);
+  }
+
+  template <class T, class Compare>
+  bool operator>=(const btree<T, Compare> &lhs, const btree<T, Compare> &rhs)
+  {
+    return !(lhs < rhs);
+  }
+
+  // 重载 tinystl 的 swap
+  template <class T, class Compare>
+  void swap(btree<T, Compare> &lhs, btree<T, Compare> &rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+} // namespace tinystl
+
+#endif // !TINYSTL_BTREE_H_
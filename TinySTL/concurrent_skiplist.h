@@ -0,0 +1,764 @@
+#ifndef TINYSTL_CONCURRENT_SKIPLIST_H_
+#define TINYSTL_CONCURRENT_SKIPLIST_H_
+
+// 这个头文件包含并发跳表 concurrent_skiplist，以及以它为底层的两个模板类
+// concurrent_skiplist_map : 映射，元素具有键值和实值，键值不允许重复，可以被多个线程同时读写
+// concurrent_skiplist_set : 集合，键值即实值，键值不允许重复，可以被多个线程同时读写
+// 算法为 Herlihy、Lev、Luchangco 与 Shavit 的 lazy skip list (SIROCCO 2007)
+
+// notes:
+//
+// 1. 查找不加锁，也不写任何共享数据；插入和删除只锁住各层的前驱节点，互不相交的修改可以并行
+// 2. 删除先给节点打上删除标记（逻辑删除），再在锁的保护下从各层摘下，然后交给 epoch_domain 延迟释放
+//    读者在 epoch_guard 的保护下访问节点，所以摘下的节点在读者离开之前不会被释放，见 epoch.h
+// 3. 迭代器内部持有一个临界区，按键值升序遍历，跳过已经逻辑删除的节点
+//    遍历与并发修改交错时是弱一致的：不会访问已释放的内存，但不一定看到遍历开始之后的修改
+//    迭代器只能在创建它的线程上使用和销毁
+// 4. 元素插入之后不能修改，实值需要更新时先 erase 再 insert，或者以原子类型作为实值
+// 5. size() 是近似值，与并发的插入删除之间没有同步
+// 6. 节点按层数分配大小不同的内存，层数以 1/4 的概率递增，最多 SKIPLIST_MAX_LEVEL 层
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+#include <initializer_list>
+
+#include "functional.h"
+#include "allocator.h"
+#include "construct.h"
+#include "iterator.h"
+#include "utils.h"
+#include "epoch.h"
+#include "exceptdef.h"
+
+namespace tinystl
+{
+// 跳表的最大层数
+#ifndef SKIPLIST_MAX_LEVEL
+#define SKIPLIST_MAX_LEVEL 20
+#endif
+
+// 节点锁在让出 CPU 之前的自旋次数
+#ifndef SKIPLIST_SPIN_COUNT
+#define SKIPLIST_SPIN_COUNT 64
+#endif
+
+  // 跳表节点，next 数组的实际长度为 top_level，随节点一起分配
+  template <class T>
+  struct skiplist_node
+  {
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    int top_level;
+    std::atomic<bool> marked;       // 已经逻辑删除
+    std::atomic<bool> fully_linked; // 已经链接到所有层
+    std::atomic<bool> locked;
+    std::atomic<skiplist_node *> next[1];
+
+    T *value_ptr() noexcept { return reinterpret_cast<T *>(&storage); }
+    T &value() noexcept { return *value_ptr(); }
+
+    void lock() noexcept
+    {
+      int spin = 0;
+      while (locked.exchange(true, std::memory_order_acquire))
+      {
+        if (++spin == SKIPLIST_SPIN_COUNT)
+        {
+          spin = 0;
+          std::this_thread::yield();
+        }
+      }
+    }
+    void unlock() noexcept { locked.store(false, std::memory_order_release); }
+  };
+
+  // 跳表的值的萃取，与 rb_tree 相同，map 的元素为 pair，键值为 first
+  template <class T, bool IsMap = tinystl::is_pair<T>::value>
+  struct skiplist_value_traits
+  {
+    typedef T key_type;
+    static const key_type &get_key(const T &value) { return value; }
+  };
+
+  template <class T>
+  struct skiplist_value_traits<T, true>
+  {
+    typedef typename std::remove_cv<typename T::first_type>::type key_type;
+    static const key_type &get_key(const T &value) { return value.first; }
+  };
+
+  // 跳表的迭代器，构造时进入临界区，析构时离开
+  template <class T>
+  struct skiplist_iterator : public tinystl::iterator<forward_iterator_tag, T>
+  {
+    typedef skiplist_node<T> node_type;
+    typedef const T *pointer;
+    typedef const T &reference;
+    typedef skiplist_iterator<T> self;
+
+    node_type *node_; // 为空时代表尾后位置
+
+    skiplist_iterator() : node_(nullptr) { epoch_domain::instance().enter(); }
+    explicit skiplist_iterator(node_type *n) : node_(n) { epoch_domain::instance().enter(); }
+    skiplist_iterator(const self &rhs) : node_(rhs.node_) { epoch_domain::instance().enter(); }
+    self &operator=(const self &rhs)
+    {
+      node_ = rhs.node_;
+      return *this;
+    }
+    ~skiplist_iterator() { epoch_domain::instance().leave(); }
+
+    reference operator*() const { return node_->value(); }
+    pointer operator->() const { return node_->value_ptr(); }
+
+    // 沿第 0 层前进，跳过逻辑删除或尚未链接完成的节点
+    self &operator++()
+    {
+      do
+      {
+        node_ = node_->next[0].load(std::memory_order_acquire);
+      } while (node_ != nullptr && (node_->marked.load(std::memory_order_acquire) ||
+                                    !node_->fully_linked.load(std::memory_order_acquire)));
+      return *this;
+    }
+    self operator++(int)
+    {
+      self tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    friend bool operator==(const self &lhs, const self &rhs) { return lhs.node_ == rhs.node_; }
+    friend bool operator!=(const self &lhs, const self &rhs) { return lhs.node_ != rhs.node_; }
+  };
+
+  // 模板类 concurrent_skiplist
+  // 参数一代表数据类型，参数二代表键值比较类型
+  template <class T, class Compare>
+  class concurrent_skiplist
+  {
+  public:
+    typedef skiplist_value_traits<T> value_traits;
+    typedef typename value_traits::key_type key_type;
+    typedef T value_type;
+    typedef Compare key_compare;
+
+    typedef skiplist_node<T> node_type;
+    typedef node_type *node_ptr;
+    typedef tinystl::allocator<T> allocator_type;
+    typedef tinystl::allocator<T> data_allocator;
+    typedef tinystl::allocator<node_type> node_allocator;
+
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef const T &reference;
+    typedef const T &const_reference;
+    typedef skiplist_iterator<T> iterator;
+    typedef skiplist_iterator<T> const_iterator;
+
+  private:
+    node_ptr head_;            // 哨兵节点，有 SKIPLIST_MAX_LEVEL 层，不保存元素
+    std::atomic<int> height_; // 所有节点中最高的层数，只增不减，查找从这一层开始
+    key_compare key_comp_;
+    char pad0_[TINYSTL_CACHELINE_SIZE];
+    std::atomic<size_type> size_;
+    char pad1_[TINYSTL_CACHELINE_SIZE - sizeof(std::atomic<size_type>)];
+
+  public:
+    // 构造、析构函数
+    concurrent_skiplist() : head_(nullptr), height_(1), key_comp_(), size_(0)
+    {
+      head_ = allocate_node(SKIPLIST_MAX_LEVEL);
+    }
+
+    concurrent_skiplist(const concurrent_skiplist &) = delete;
+    concurrent_skiplist &operator=(const concurrent_skiplist &) = delete;
+
+    // 析构时不应再有其他线程访问，剩余节点直接释放
+    ~concurrent_skiplist();
+
+  public:
+    // 迭代器相关操作
+    iterator begin() const
+    {
+      iterator it; // 先进入临界区再读取节点
+      it.node_ = first_live(head_->next[0].load(std::memory_order_acquire));
+      return it;
+    }
+    iterator end() const { return iterator(); }
+
+    // 容量相关操作
+    bool empty() const noexcept { return size() == 0; }
+    size_type size() const noexcept { return size_.load(std::memory_order_relaxed); }
+    size_type max_size() const noexcept { return static_cast<size_type>(-1) / sizeof(node_type); }
+
+    key_compare key_comp() const { return key_comp_; }
+    allocator_type get_allocator() const { return allocator_type(); }
+
+    // 插入删除相关操作
+
+    template <class... Args>
+    tinystl::pair<iterator, bool> emplace(Args &&...args);
+
+    size_type erase(const key_type &key);
+
+    // 查找相关操作
+
+    iterator find(const key_type &key) const;
+    bool contains(const key_type &key) const;
+    size_type count(const key_type &key) const { return contains(key) ? 1 : 0; }
+    iterator lower_bound(const key_type &key) const;
+    iterator upper_bound(const key_type &key) const;
+
+  private:
+    // helper functions
+    const key_type &key_of(node_ptr p) const { return value_traits::get_key(p->value()); }
+    static bool is_live(node_ptr p) noexcept
+    {
+      return p->fully_linked.load(std::memory_order_acquire) && !p->marked.load(std::memory_order_acquire);
+    }
+    static node_ptr first_live(node_ptr p) noexcept
+    {
+      while (p != nullptr && !is_live(p))
+        p = p->next[0].load(std::memory_order_acquire);
+      return p;
+    }
+
+    static int random_level() noexcept;
+    static node_ptr allocate_node(int level);
+    static void deallocate_node(node_ptr p) noexcept;
+    static void destroy_node(void *p);
+
+    int find_position(const key_type &key, node_ptr *preds, node_ptr *succs) const;
+    static void unlock_preds(node_ptr *preds, int highest) noexcept;
+  };
+
+  /*****************************************************************************************/
+
+  template <class T, class Compare>
+  concurrent_skiplist<T, Compare>::~concurrent_skiplist()
+  {
+    node_ptr p = head_->next[0].load(std::memory_order_relaxed);
+    while (p != nullptr)
+    {
+      node_ptr next = p->next[0].load(std::memory_order_relaxed);
+      destroy_node(p);
+      p = next;
+    }
+    deallocate_node(head_);
+  }
+
+  // 插入元素，键值已存在时返回已有元素的迭代器与 false
+  template <class T, class Compare>
+  template <class... Args>
+  tinystl::pair<typename concurrent_skiplist<T, Compare>::iterator, bool>
+  concurrent_skiplist<T, Compare>::
+      emplace(Args &&...args)
+  {
+    const int top = random_level();
+    node_ptr x = allocate_node(top);
+    try
+    {
+      data_allocator::construct(x->value_ptr(), tinystl::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+      deallocate_node(x);
+      throw;
+    }
+    const key_type &key = key_of(x);
+    int h = height_.load(std::memory_order_relaxed);
+    while (h < top && !height_.compare_exchange_weak(h, top, std::memory_order_relaxed))
+    {
+    }
+
+    epoch_guard guard;
+    node_ptr preds[SKIPLIST_MAX_LEVEL];
+    node_ptr succs[SKIPLIST_MAX_LEVEL];
+    while (true)
+    {
+      const int found = find_position(key, preds, succs);
+      if (found != -1)
+      {
+        node_ptr y = succs[found];
+        if (!y->marked.load(std::memory_order_acquire))
+        { // 等待并发的插入完成
+          while (!y->fully_linked.load(std::memory_order_acquire))
+            std::this_thread::yield();
+          destroy_node(x);
+          return tinystl::make_pair(iterator(y), false);
+        }
+        continue; // 已有的节点正在被删除，重试
+      }
+
+      // 自底向上锁住各层的前驱，并确认前驱与后继没有变化
+      int highest = -1;
+      bool valid = true;
+      node_ptr prev = nullptr;
+      for (int level = 0; valid && level < top; ++level)
+      {
+        node_ptr pred = preds[level];
+        node_ptr succ = succs[level];
+        if (pred != prev)
+        {
+          pred->lock();
+          highest = level;
+          prev = pred;
+        }
+        valid = !pred->marked.load(std::memory_order_acquire) &&
+                (succ == nullptr || !succ->marked.load(std::memory_order_acquire)) &&
+                pred->next[level].load(std::memory_order_acquire) == succ;
+      }
+      if (!valid)
+      {
+        unlock_preds(preds, highest);
+        continue;
+      }
+
+      for (int level = 0; level < top; ++level)
+        x->next[level].store(succs[level], std::memory_order_relaxed);
+      for (int level = 0; level < top; ++level)
+        preds[level]->next[level].store(x, std::memory_order_release);
+      x->fully_linked.store(true, std::memory_order_release);
+      unlock_preds(preds, highest);
+      size_.fetch_add(1, std::memory_order_relaxed);
+      return tinystl::make_pair(iterator(x), true);
+    }
+  }
+
+  // 删除键值为 key 的元素，返回删除的个数
+  template <class T, class Compare>
+  typename concurrent_skiplist<T, Compare>::size_type
+  concurrent_skiplist<T, Compare>::
+      erase(const key_type &key)
+  {
+    epoch_guard guard;
+    node_ptr preds[SKIPLIST_MAX_LEVEL];
+    node_ptr succs[SKIPLIST_MAX_LEVEL];
+    node_ptr victim = nullptr;
+    bool is_marked = false;
+    int top = -1;
+    while (true)
+    {
+      const int found = find_position(key, preds, succs);
+      if (found != -1)
+        victim = succs[found];
+      // 只删除在最高层上找到、已经链接完成、尚未标记的节点，这样 preds 覆盖了它的所有层
+      if (!is_marked &&
+          (found == -1 || !victim->fully_linked.load(std::memory_order_acquire) ||
+           victim->top_level - 1 != found || victim->marked.load(std::memory_order_acquire)))
+        return 0;
+
+      if (!is_marked)
+      {
+        top = victim->top_level;
+        victim->lock();
+        if (victim->marked.load(std::memory_order_relaxed))
+        { // 被其他线程抢先删除
+          victim->unlock();
+          return 0;
+        }
+        victim->marked.store(true, std::memory_order_release);
+        is_marked = true;
+      }
+
+      int highest = -1;
+      bool valid = true;
+      node_ptr prev = nullptr;
+      for (int level = 0; valid && level < top; ++level)
+      {
+        node_ptr pred = preds[level];
+        if (pred != prev)
+        {
+          pred->lock();
+          highest = level;
+          prev = pred;
+        }
+        valid = !pred->marked.load(std::memory_order_acquire) &&
+                pred->next[level].load(std::memory_order_acquire) == victim;
+      }
+      if (!valid)
+      {
+        unlock_preds(preds, highest);
+        continue;
+      }
+
+      for (int level = top - 1; level >= 0; --level)
+        preds[level]->next[level].store(victim->next[level].load(std::memory_order_relaxed),
+                                        std::memory_order_release);
+      victim->unlock();
+      unlock_preds(preds, highest);
+      size_.fetch_sub(1, std::memory_order_relaxed);
+      epoch_domain::instance().retire(victim, &destroy_node);
+      return 1;
+    }
+  }
+
+  // 不加锁地查找，只返回未被删除的元素
+  template <class T, class Compare>
+  typename concurrent_skiplist<T, Compare>::iterator
+  concurrent_skiplist<T, Compare>::
+      find(const key_type &key) const
+  {
+    iterator it = lower_bound(key);
+    if (it.node_ != nullptr && key_comp_(key, key_of(it.node_)))
+      it.node_ = nullptr;
+    return it;
+  }
+
+  template <class T, class Compare>
+  bool concurrent_skiplist<T, Compare>::contains(const key_type &key) const
+  {
+    epoch_guard guard;
+    node_ptr pred = head_;
+    for (int level = height_.load(std::memory_order_relaxed) - 1; level >= 0; --level)
+    {
+      node_ptr curr = pred->next[level].load(std::memory_order_acquire);
+      while (curr != nullptr && key_comp_(key_of(curr), key))
+      {
+        pred = curr;
+        curr = pred->next[level].load(std::memory_order_acquire);
+      }
+      if (curr != nullptr && !key_comp_(key, key_of(curr)))
+        return is_live(curr);
+    }
+    return false;
+  }
+
+  // 第一个不小于 key 的未删除元素
+  template <class T, class Compare>
+  typename concurrent_skiplist<T, Compare>::iterator
+  concurrent_skiplist<T, Compare>::
+      lower_bound(const key_type &key) const
+  {
+    iterator it; // 先进入临界区再读取节点
+    node_ptr pred = head_;
+    node_ptr curr = nullptr;
+    for (int level = height_.load(std::memory_order_relaxed) - 1; level >= 0; --level)
+    {
+      curr = pred->next[level].load(std::memory_order_acquire);
+      while (curr != nullptr && key_comp_(key_of(curr), key))
+      {
+        pred = curr;
+        curr = pred->next[level].load(std::memory_order_acquire);
+      }
+    }
+    it.node_ = first_live(curr);
+    return it;
+  }
+
+  // 第一个大于 key 的未删除元素
+  template <class T, class Compare>
+  typename concurrent_skiplist<T, Compare>::iterator
+  concurrent_skiplist<T, Compare>::
+      upper_bound(const key_type &key) const
+  {
+    iterator it;
+    node_ptr pred = head_;
+    node_ptr curr = nullptr;
+    for (int level = height_.load(std::memory_order_relaxed) - 1; level >= 0; --level)
+    {
+      curr = pred->next[level].load(std::memory_order_acquire);
+      while (curr != nullptr && !key_comp_(key, key_of(curr)))
+      {
+        pred = curr;
+        curr = pred->next[level].load(std::memory_order_acquire);
+      }
+    }
+    it.node_ = first_live(curr);
+    return it;
+  }
+
+  /*****************************************************************************************/
+  // helper function
+
+  // 以 1/4 的概率增加一层，每个线程使用自己的 xorshift 随机数
+  template <class T, class Compare>
+  int concurrent_skiplist<T, Compare>::random_level() noexcept
+  {
+    static thread_local uint64_t seed =
+        0x9E3779B97F4A7C15ull ^ reinterpret_cast<uintptr_t>(&seed);
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    uint64_t r = seed;
+    int level = 1;
+    while (level < SKIPLIST_MAX_LEVEL && (r & 3) == 0)
+    {
+      ++level;
+      r >>= 2;
+    }
+    return level;
+  }
+
+  // 分配一个有 level 层的节点，元素未构造
+  template <class T, class Compare>
+  typename concurrent_skiplist<T, Compare>::node_ptr
+  concurrent_skiplist<T, Compare>::allocate_node(int level)
+  {
+    const size_t bytes = sizeof(node_type) + (level - 1) * sizeof(std::atomic<node_ptr>);
+    const size_t n = (bytes + sizeof(node_type) - 1) / sizeof(node_type);
+    node_ptr p = node_allocator::allocate(n);
+    p->top_level = level;
+    ::new (static_cast<void *>(&p->marked)) std::atomic<bool>(false);
+    ::new (static_cast<void *>(&p->fully_linked)) std::atomic<bool>(false);
+    ::new (static_cast<void *>(&p->locked)) std::atomic<bool>(false);
+    for (int i = 0; i < level; ++i)
+      ::new (static_cast<void *>(p->next + i)) std::atomic<node_ptr>(nullptr);
+    return p;
+  }
+
+  template <class T, class Compare>
+  void concurrent_skiplist<T, Compare>::deallocate_node(node_ptr p) noexcept
+  {
+    const size_t bytes = sizeof(node_type) + (p->top_level - 1) * sizeof(std::atomic<node_ptr>);
+    node_allocator::deallocate(p, (bytes + sizeof(node_type) - 1) / sizeof(node_type));
+  }
+
+  // 销毁元素并释放节点，也作为 retire 的释放函数
+  template <class T, class Compare>
+  void concurrent_skiplist<T, Compare>::destroy_node(void *p)
+  {
+    node_ptr x = static_cast<node_ptr>(p);
+    data_allocator::destroy(x->value_ptr());
+    deallocate_node(x);
+  }
+
+  // 记录 key 在 [0, height_) 层的前驱与后继，返回在最高哪一层找到了 key，没有找到时返回 -1
+  template <class T, class Compare>
+  int concurrent_skiplist<T, Compare>::find_position(const key_type &key, node_ptr *preds, node_ptr *succs) const
+  {
+    int found = -1;
+    node_ptr pred = head_;
+    for (int level = height_.load(std::memory_order_relaxed) - 1; level >= 0; --level)
+    {
+      node_ptr curr = pred->next[level].load(std::memory_order_acquire);
+      while (curr != nullptr && key_comp_(key_of(curr), key))
+      {
+        pred = curr;
+        curr = pred->next[level].load(std::memory_order_acquire);
+      }
+      if (found == -1 && curr != nullptr && !key_comp_(key, key_of(curr)))
+        found = level;
+      preds[level] = pred;
+      succs[level] = curr;
+    }
+    return found;
+  }
+
+  // 解锁 [0, highest] 层上各不相同的前驱
+  template <class T, class Compare>
+  void concurrent_skiplist<T, Compare>::unlock_preds(node_ptr *preds, int highest) noexcept
+  {
+    node_ptr prev = nullptr;
+    for (int level = 0; level <= highest; ++level)
+    {
+      if (preds[level] != prev)
+      {
+        preds[level]->unlock();
+        prev = preds[level];
+      }
+    }
+  }
+
+  /*****************************************************************************************/
+
+  // 模板类 concurrent_skiplist_map，键值不允许重复
+  // 参数一代表键值类型，参数二代表实值类型，参数三代表键值的比较方式，缺省使用 tinystl::less
+  template <class Key, class T, class Compare = tinystl::less<Key>>
+  class concurrent_skiplist_map
+  {
+  public:
+    // concurrent_skiplist_map 的嵌套型别定义
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef tinystl::pair<const Key, T> value_type;
+    typedef Compare key_compare;
+
+  private:
+    // 以 tinystl::concurrent_skiplist 作为底层机制
+    typedef tinystl::concurrent_skiplist<value_type, key_compare> base_type;
+    base_type list_;
+
+  public:
+    // 使用 concurrent_skiplist 的型别
+    typedef typename base_type::reference reference;
+    typedef typename base_type::const_reference const_reference;
+    typedef typename base_type::iterator iterator;
+    typedef typename base_type::const_iterator const_iterator;
+    typedef typename base_type::size_type size_type;
+    typedef typename base_type::difference_type difference_type;
+    typedef typename base_type::allocator_type allocator_type;
+
+  public:
+    concurrent_skiplist_map() = default;
+
+    template <class InputIterator>
+    concurrent_skiplist_map(InputIterator first, InputIterator last)
+    {
+      insert(first, last);
+    }
+    concurrent_skiplist_map(std::initializer_list<value_type> ilist)
+    {
+      insert(ilist.begin(), ilist.end());
+    }
+
+    concurrent_skiplist_map(const concurrent_skiplist_map &) = delete;
+    concurrent_skiplist_map &operator=(const concurrent_skiplist_map &) = delete;
+
+    // 相关接口
+
+    key_compare key_comp() const { return list_.key_comp(); }
+    allocator_type get_allocator() const { return list_.get_allocator(); }
+
+    // 迭代器相关
+    iterator begin() const { return list_.begin(); }
+    iterator end() const { return list_.end(); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    // 容量相关
+    bool empty() const noexcept { return list_.empty(); }
+    size_type size() const noexcept { return list_.size(); }
+    size_type max_size() const noexcept { return list_.max_size(); }
+
+    // 插入删除相关
+
+    template <class... Args>
+    pair<iterator, bool> emplace(Args &&...args)
+    {
+      return list_.emplace(tinystl::forward<Args>(args)...);
+    }
+
+    pair<iterator, bool> insert(const value_type &value) { return list_.emplace(value); }
+    pair<iterator, bool> insert(value_type &&value) { return list_.emplace(tinystl::move(value)); }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last)
+    {
+      for (; first != last; ++first)
+        list_.emplace(*first);
+    }
+
+    size_type erase(const key_type &key) { return list_.erase(key); }
+
+    // 查找相关
+
+    // 键值存在时把实值复制到 value 中
+    bool get(const key_type &key, mapped_type &value) const
+    {
+      const_iterator it = list_.find(key);
+      if (it == end())
+        return false;
+      value = it->second;
+      return true;
+    }
+
+    // 若键值不存在，at 会抛出一个异常，返回的是实值的副本
+    mapped_type at(const key_type &key) const
+    {
+      const_iterator it = list_.find(key);
+      THROW_OUT_OF_RANGE_IF(it == end(), "concurrent_skiplist_map<Key, T> no such element exists");
+      return it->second;
+    }
+
+    iterator find(const key_type &key) const { return list_.find(key); }
+    bool contains(const key_type &key) const { return list_.contains(key); }
+    size_type count(const key_type &key) const { return list_.count(key); }
+    iterator lower_bound(const key_type &key) const { return list_.lower_bound(key); }
+    iterator upper_bound(const key_type &key) const { return list_.upper_bound(key); }
+  };
+
+  // 模板类 concurrent_skiplist_set，键值不允许重复
+  // 参数一代表键值类型，参数二代表键值比较方式，缺省使用 tinystl::less
+  template <class Key, class Compare = tinystl::less<Key>>
+  class concurrent_skiplist_set
+  {
+  public:
+    // concurrent_skiplist_set 的型别定义
+    typedef Key key_type;
+    typedef Key value_type;
+    typedef Compare key_compare;
+    typedef Compare value_compare;
+
+  private:
+    // 以 tinystl::concurrent_skiplist 作为底层机制
+    typedef tinystl::concurrent_skiplist<value_type, key_compare> base_type;
+    base_type list_;
+
+  public:
+    // 使用 concurrent_skiplist 的型别
+    typedef typename base_type::reference reference;
+    typedef typename base_type::const_reference const_reference;
+    typedef typename base_type::iterator iterator;
+    typedef typename base_type::const_iterator const_iterator;
+    typedef typename base_type::size_type size_type;
+    typedef typename base_type::difference_type difference_type;
+    typedef typename base_type::allocator_type allocator_type;
+
+  public:
+    concurrent_skiplist_set() = default;
+
+    template <class InputIterator>
+    concurrent_skiplist_set(InputIterator first, InputIterator last)
+    {
+      insert(first, last);
+    }
+    concurrent_skiplist_set(std::initializer_list<value_type> ilist)
+    {
+      insert(ilist.begin(), ilist.end());
+    }
+
+    concurrent_skiplist_set(const concurrent_skiplist_set &) = delete;
+    concurrent_skiplist_set &operator=(const concurrent_skiplist_set &) = delete;
+
+    // 相关接口
+
+    key_compare key_comp() const { return list_.key_comp(); }
+    value_compare value_comp() const { return list_.key_comp(); }
+    allocator_type get_allocator() const { return list_.get_allocator(); }
+
+    // 迭代器相关
+    iterator begin() const { return list_.begin(); }
+    iterator end() const { return list_.end(); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    // 容量相关
+    bool empty() const noexcept { return list_.empty(); }
+    size_type size() const noexcept { return list_.size(); }
+    size_type max_size() const noexcept { return list_.max_size(); }
+
+    // 插入删除相关
+
+    template <class... Args>
+    pair<iterator, bool> emplace(Args &&...args)
+    {
+      return list_.emplace(tinystl::forward<Args>(args)...);
+    }
+
+    pair<iterator, bool> insert(const value_type &value) { return list_.emplace(value); }
+    pair<iterator, bool> insert(value_type &&value) { return list_.emplace(tinystl::move(value)); }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last)
+    {
+      for (; first != last; ++first)
+        list_.emplace(*first);
+    }
+
+    size_type erase(const key_type &key) { return list_.erase(key); }
+
+    // 查找相关
+
+    iterator find(const key_type &key) const { return list_.find(key); }
+    bool contains(const key_type &key) const { return list_.contains(key); }
+    size_type count(const key_type &key) const { return list_.count(key); }
+    iterator lower_bound(const key_type &key) const { return list_.lower_bound(key); }
+    iterator upper_bound(const key_type &key) const { return list_.upper_bound(key); }
+  };
+
+} // namespace tinystl
+
+#endif // !TINYSTL_CONCURRENT_SKIPLIST_H_
@@ -40,6 +40,12 @@ namespace tinystl
     }
   }
 
+  template <class Ty>
+  void destroy(Ty *pointer)
+  {
+    destroy_one(pointer, std::is_trivially_destructible<Ty>{});
+  }
+
   template <class ForwardIter>
   void destroy_cat(ForwardIter, ForwardIter, std::true_type) {}
 
@@ -50,12 +56,6 @@ namespace tinystl
       destroy(&*first);
   }
 
-  template <class Ty>
-  void destroy(Ty *pointer)
-  {
-    destroy_one(pointer, std::is_trivially_destructible<Ty>{});
-  }
-
   template <class ForwardIter>
   void destroy(ForwardIter first, ForwardIter last)
   {
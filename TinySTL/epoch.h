@@ -0,0 +1,338 @@
+#ifndef TINYSTL_EPOCH_H_
+#define TINYSTL_EPOCH_H_
+
+// 这个头文件包含基于纪元的内存回收（epoch-based reclamation）：epoch_domain 与 epoch_guard
+// 用于无锁或细粒度加锁的并发容器，读者不加锁地访问节点，写者把摘下的节点交给 retire 延迟释放
+
+// notes:
+//
+// 1. 全局纪元 epoch 单调递增，每个线程有一条记录，进入临界区时把当前纪元写进自己的记录
+// 2. 所有处于临界区的线程都已经看到当前纪元 e 时，纪元才能前进到 e + 1
+//    在纪元 e 退休的对象，到纪元 e + 2 时不会再被任何读者持有，可以释放
+// 3. 每个线程按 e % 3 把退休的对象放进三个桶中，只由本线程访问，不需要同步
+//    线程退出时剩余的对象交给 epoch_domain 统一保管，由之后推进纪元的线程或析构函数释放
+// 4. epoch_guard 是 RAII 的临界区，可以嵌套；临界区内读到的节点指针在离开临界区之前一直有效
+//    临界区属于线程，必须在进入它的线程上离开
+// 5. 释放函数中不能再调用 retire
+// 6. 进程中只有一个 epoch_domain，通过 epoch_domain::instance() 取得，所有并发容器共用
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "allocator.h"
+#include "vector.h"
+#include "exceptdef.h"
+
+namespace tinystl
+{
+// 缓存行大小，用于隔开会被不同线程频繁写入的数据
+#ifndef TINYSTL_CACHELINE_SIZE
+#define TINYSTL_CACHELINE_SIZE 64
+#endif
+
+// 每退休多少个对象尝试推进一次纪元
+#ifndef EPOCH_COLLECT_INTERVAL
+#define EPOCH_COLLECT_INTERVAL 64
+#endif
+
+  // 一个退休的对象及其释放函数
+  struct epoch_retired
+  {
+    void *ptr;
+    void (*deleter)(void *);
+  };
+
+  // 每个线程的记录，记录只追加到链表中，不会删除，线程退出后可以被新线程复用
+  struct epoch_record
+  {
+    // (纪元 << 1) | 是否处于临界区，被推进纪元的线程读取
+    std::atomic<uint64_t> state;
+    std::atomic<bool> in_use;
+    epoch_record *next;
+
+    // 以下只由拥有者线程访问
+    size_t nesting;
+    size_t retire_count;
+    uint64_t bucket_epoch[3];
+    tinystl::vector<epoch_retired> bucket[3];
+    char pad[TINYSTL_CACHELINE_SIZE]; // 与相邻的记录隔开
+
+    epoch_record() : state(0), in_use(true), next(nullptr), nesting(0), retire_count(0)
+    {
+      bucket_epoch[0] = bucket_epoch[1] = bucket_epoch[2] = 0;
+    }
+  };
+
+  class epoch_domain
+  {
+  public:
+    typedef epoch_record record_type;
+    typedef tinystl::allocator<epoch_record> record_allocator;
+
+  private:
+    std::atomic<uint64_t> epoch_;
+    char pad0_[TINYSTL_CACHELINE_SIZE - sizeof(std::atomic<uint64_t>)];
+
+    std::atomic<record_type *> records_; // 所有线程记录组成的链表
+
+    // 已退出线程留下的对象，按退休时的纪元保存
+    std::mutex orphan_lock_;
+    tinystl::vector<epoch_retired> orphans_;
+    tinystl::vector<uint64_t> orphan_epochs_;
+
+    // 每个线程持有的记录，线程退出时归还
+    struct thread_slot
+    {
+      record_type *rec;
+      thread_slot() : rec(nullptr) {}
+      ~thread_slot()
+      {
+        if (rec != nullptr)
+          epoch_domain::instance().release_record(rec);
+      }
+    };
+
+  public:
+    epoch_domain() : epoch_(2), records_(nullptr) {}
+
+    epoch_domain(const epoch_domain &) = delete;
+    epoch_domain &operator=(const epoch_domain &) = delete;
+
+    ~epoch_domain();
+
+    static epoch_domain &instance()
+    {
+      static epoch_domain domain;
+      return domain;
+    }
+
+  public:
+    uint64_t epoch() const noexcept { return epoch_.load(std::memory_order_relaxed); }
+
+    // 进入与离开临界区，可以嵌套
+    void enter()
+    {
+      record_type *rec = local_record();
+      if (rec->nesting++ == 0)
+      {
+        const uint64_t e = epoch_.load(std::memory_order_relaxed);
+        rec->state.store((e << 1) | 1, std::memory_order_relaxed);
+        // 先公开自己的纪元，再读取共享数据
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+      }
+    }
+
+    void leave() noexcept
+    {
+      record_type *rec = local_slot().rec;
+      TINYSTL_DEBUG(rec != nullptr && rec->nesting > 0);
+      if (--rec->nesting == 0)
+        rec->state.store(rec->state.load(std::memory_order_relaxed) & ~static_cast<uint64_t>(1),
+                         std::memory_order_release);
+    }
+
+    // 对象已经从数据结构中摘下，等到没有读者可能持有它时调用 deleter(p)
+    void retire(void *p, void (*deleter)(void *));
+
+    // 尝试推进纪元，成功时返回 true
+    bool try_advance();
+
+    // 推进纪元并释放本线程中已经安全的对象
+    void collect();
+
+    // 阻塞直到调用之前进入临界区的读者全部离开，然后释放本线程中所有退休的对象，不能在临界区内调用
+    void synchronize();
+
+  private:
+    // helper functions
+    static thread_slot &local_slot()
+    {
+      static thread_local thread_slot slot;
+      return slot;
+    }
+    record_type *local_record()
+    {
+      thread_slot &slot = local_slot();
+      if (slot.rec == nullptr)
+        slot.rec = acquire_record();
+      return slot.rec;
+    }
+
+    record_type *acquire_record();
+    void release_record(record_type *rec);
+    void reclaim(record_type *rec, uint64_t e);
+    void reclaim_orphans(uint64_t e);
+    static void free_bucket(tinystl::vector<epoch_retired> &bucket);
+  };
+
+  // 临界区，构造时进入，析构时离开
+  class epoch_guard
+  {
+  public:
+    epoch_guard() { epoch_domain::instance().enter(); }
+    ~epoch_guard() { epoch_domain::instance().leave(); }
+
+    epoch_guard(const epoch_guard &) = delete;
+    epoch_guard &operator=(const epoch_guard &) = delete;
+  };
+
+  /*****************************************************************************************/
+
+  // 析构函数，此时不应再有线程访问任何并发容器
+  inline epoch_domain::~epoch_domain()
+  {
+    free_bucket(orphans_);
+    record_type *rec = records_.load(std::memory_order_acquire);
+    while (rec != nullptr)
+    {
+      record_type *next = rec->next;
+      for (int i = 0; i < 3; ++i)
+        free_bucket(rec->bucket[i]);
+      record_allocator::destroy(rec);
+      record_allocator::deallocate(rec);
+      rec = next;
+    }
+  }
+
+  // 退休的对象放进当前纪元对应的桶，桶中原有的对象至少早了三个纪元，可以直接释放
+  inline void epoch_domain::retire(void *p, void (*deleter)(void *))
+  {
+    record_type *rec = local_record();
+    const uint64_t e = epoch_.load(std::memory_order_acquire);
+    const size_t i = static_cast<size_t>(e % 3);
+    if (rec->bucket_epoch[i] != e)
+    {
+      free_bucket(rec->bucket[i]);
+      rec->bucket_epoch[i] = e;
+    }
+    rec->bucket[i].push_back(epoch_retired{p, deleter});
+    if (++rec->retire_count % EPOCH_COLLECT_INTERVAL == 0)
+      collect();
+  }
+
+  // 所有处于临界区的线程都看到了当前纪元时，纪元加一
+  inline bool epoch_domain::try_advance()
+  {
+    uint64_t e = epoch_.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (record_type *rec = records_.load(std::memory_order_acquire); rec != nullptr; rec = rec->next)
+    {
+      const uint64_t s = rec->state.load(std::memory_order_acquire);
+      if ((s & 1) && (s >> 1) != e)
+        return false;
+    }
+    return epoch_.compare_exchange_strong(e, e + 1, std::memory_order_acq_rel, std::memory_order_relaxed);
+  }
+
+  inline void epoch_domain::collect()
+  {
+    try_advance();
+    const uint64_t e = epoch_.load(std::memory_order_acquire);
+    reclaim(local_record(), e);
+    reclaim_orphans(e);
+  }
+
+  // 纪元前进两次之后，调用之前进入临界区的读者都已经离开
+  inline void epoch_domain::synchronize()
+  {
+    record_type *rec = local_record();
+    TINYSTL_DEBUG(rec->nesting == 0);
+    const uint64_t target = epoch_.load(std::memory_order_acquire) + 2;
+    while (epoch_.load(std::memory_order_acquire) < target)
+    {
+      if (!try_advance())
+        std::this_thread::yield();
+    }
+    for (int i = 0; i < 3; ++i)
+      free_bucket(rec->bucket[i]);
+    reclaim_orphans(epoch_.load(std::memory_order_acquire));
+  }
+
+  /*****************************************************************************************/
+  // helper function
+
+  // 复用已退出线程的记录，没有时新建一条并插入链表头部
+  inline epoch_domain::record_type *epoch_domain::acquire_record()
+  {
+    for (record_type *rec = records_.load(std::memory_order_acquire); rec != nullptr; rec = rec->next)
+    {
+      bool expected = false;
+      if (!rec->in_use.load(std::memory_order_relaxed) &&
+          rec->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire))
+        return rec;
+    }
+    record_type *rec = record_allocator::allocate();
+    record_allocator::construct(rec);
+    record_type *head = records_.load(std::memory_order_relaxed);
+    do
+    {
+      rec->next = head;
+    } while (!records_.compare_exchange_weak(head, rec, std::memory_order_release, std::memory_order_relaxed));
+    return rec;
+  }
+
+  // 线程退出时把剩余的对象交给 epoch_domain，记录留给其他线程复用
+  inline void epoch_domain::release_record(record_type *rec)
+  {
+    {
+      std::lock_guard<std::mutex> lk(orphan_lock_);
+      for (int i = 0; i < 3; ++i)
+      {
+        for (size_t j = 0; j < rec->bucket[i].size(); ++j)
+        {
+          orphans_.push_back(rec->bucket[i][j]);
+          orphan_epochs_.push_back(rec->bucket_epoch[i]);
+        }
+        rec->bucket[i].clear();
+      }
+    }
+    rec->nesting = 0;
+    rec->state.store(0, std::memory_order_relaxed);
+    rec->in_use.store(false, std::memory_order_release);
+  }
+
+  // 释放本线程中退休时的纪元不晚于 e - 2 的对象
+  inline void epoch_domain::reclaim(record_type *rec, uint64_t e)
+  {
+    for (int i = 0; i < 3; ++i)
+    {
+      if (!rec->bucket[i].empty() && rec->bucket_epoch[i] + 2 <= e)
+        free_bucket(rec->bucket[i]);
+    }
+  }
+
+  inline void epoch_domain::reclaim_orphans(uint64_t e)
+  {
+    std::unique_lock<std::mutex> lk(orphan_lock_, std::try_to_lock);
+    if (!lk.owns_lock() || orphans_.empty())
+      return;
+    size_t j = 0;
+    for (size_t i = 0; i < orphans_.size(); ++i)
+    {
+      if (orphan_epochs_[i] + 2 <= e)
+      {
+        orphans_[i].deleter(orphans_[i].ptr);
+      }
+      else
+      {
+        orphans_[j] = orphans_[i];
+        orphan_epochs_[j] = orphan_epochs_[i];
+        ++j;
+      }
+    }
+    orphans_.erase(orphans_.begin() + j, orphans_.end());
+    orphan_epochs_.erase(orphan_epochs_.begin() + j, orphan_epochs_.end());
+  }
+
+  inline void epoch_domain::free_bucket(tinystl::vector<epoch_retired> &bucket)
+  {
+    for (size_t i = 0; i < bucket.size(); ++i)
+      bucket[i].deleter(bucket[i].ptr);
+    bucket.clear();
+  }
+
+} // namespace tinystl
+
+#endif // !TINYSTL_EPOCH_H_
@@ -0,0 +1,158 @@
+#ifndef TINYSTL_EYTZINGER_H_
+#define TINYSTL_EYTZINGER_H_
+
+// 这个头文件包含 Eytzinger（BFS）布局的一组辅助函数，供 frozen_set / frozen_map 使用
+
+// notes:
+//
+// 1. 有序序列按完全二叉树的层序存放在一个数组中，下标从 1 开始，节点 k 的左右孩子为 2k 与 2k + 1
+//    数组中第 k 个节点保存在 a[k - 1]，0 代表空节点，同时也用作尾后位置
+// 2. 查找时每一层只做 k = 2k + comp(a[k - 1], key)，没有分支，循环次数固定为树高
+//    走出树之后，最后一次向左转的节点就是结果：右移掉末尾连续的 1 以及一个 0
+// 3. 节点 k 往下四层的 16 个后代在数组中是连续的，对 int 这样的小键值正好是一个 cache line，
+//    所以每一层都预取 prefetch_stride * k 处的数据，把访存延迟与比较重叠起来
+// 4. 中序遍历的顺序就是原来的有序顺序，eytzinger_next / eytzinger_prev 均摊 O(1)
+
+#include <cstddef>
+
+#include "vector.h"
+
+namespace tinystl
+{
+
+  /*****************************************************************************************/
+  // helper function
+
+  // 末尾连续 1 的个数
+  inline size_t eytzinger_trailing_ones(size_t k) noexcept
+  {
+#if defined(__GNUC__)
+    return k == static_cast<size_t>(-1) ? sizeof(size_t) * 8
+                                        : static_cast<size_t>(__builtin_ctzll(~static_cast<unsigned long long>(k)));
+#else
+    size_t r = 0;
+    for (; k & 1; k >>= 1)
+      ++r;
+    return r;
+#endif
+  }
+
+  // 末尾连续 0 的个数，k 不为 0
+  inline size_t eytzinger_trailing_zeros(size_t k) noexcept
+  {
+#if defined(__GNUC__)
+    return static_cast<size_t>(__builtin_ctzll(static_cast<unsigned long long>(k)));
+#else
+    size_t r = 0;
+    for (; !(k & 1); k >>= 1)
+      ++r;
+    return r;
+#endif
+  }
+
+  // 预取 p 指向的数据，不支持的编译器上什么也不做
+  inline void eytzinger_prefetch(const void *p) noexcept
+  {
+#if defined(__GNUC__)
+    __builtin_prefetch(p);
+#else
+    (void)p;
+#endif
+  }
+
+  // 一个 64 字节的 cache line 能放下的元素个数，向下取到 2 的幂
+  template <class T>
+  struct eytzinger_prefetch_stride
+  {
+    static const size_t raw = sizeof(T) >= 64 ? 1 : 64 / sizeof(T);
+    static const size_t value = raw >= 16 ? 16 : raw >= 8 ? 8 : raw >= 4 ? 4 : raw >= 2 ? 2 : 1;
+  };
+
+  // 中序遍历的第一个节点与最后一个节点，n 为 0 时返回 0
+  inline size_t eytzinger_first(size_t n) noexcept
+  {
+    if (n == 0)
+      return 0;
+    size_t k = 1;
+    while (2 * k <= n)
+      k = 2 * k;
+    return k;
+  }
+
+  inline size_t eytzinger_last(size_t n) noexcept
+  {
+    if (n == 0)
+      return 0;
+    size_t k = 1;
+    while (2 * k + 1 <= n)
+      k = 2 * k + 1;
+    return k;
+  }
+
+  // 中序遍历的后继：有右子树时取右子树的最左节点，否则沿着右孩子一路往上，再上一层
+  inline size_t eytzinger_next(size_t k, size_t n) noexcept
+  {
+    if (2 * k + 1 <= n)
+    {
+      k = 2 * k + 1;
+      while (2 * k <= n)
+        k = 2 * k;
+      return k;
+    }
+    return k >> (eytzinger_trailing_ones(k) + 1);
+  }
+
+  // 中序遍历的前驱，k 为 0（尾后位置）时返回最后一个节点
+  inline size_t eytzinger_prev(size_t k, size_t n) noexcept
+  {
+    if (k == 0)
+      return eytzinger_last(n);
+    if (2 * k <= n)
+    {
+      k = 2 * k;
+      while (2 * k + 1 <= n)
+        k = 2 * k + 1;
+      return k;
+    }
+    return k >> (eytzinger_trailing_zeros(k) + 1);
+  }
+
+  // 第一个不小于 key 的节点，不存在时返回 0
+  template <class T, class K, class Compare>
+  size_t eytzinger_lower_bound(const T *a, size_t n, const K &key, Compare comp)
+  {
+    const size_t stride = eytzinger_prefetch_stride<T>::value;
+    size_t k = 1;
+    while (k <= n)
+    {
+      eytzinger_prefetch(a + (stride * k - 1));
+      k = 2 * k + static_cast<size_t>(comp(a[k - 1], key));
+    }
+    return k >> (eytzinger_trailing_ones(k) + 1);
+  }
+
+  // 第一个大于 key 的节点，不存在时返回 0
+  template <class T, class K, class Compare>
+  size_t eytzinger_upper_bound(const T *a, size_t n, const K &key, Compare comp)
+  {
+    const size_t stride = eytzinger_prefetch_stride<T>::value;
+    size_t k = 1;
+    while (k <= n)
+    {
+      eytzinger_prefetch(a + (stride * k - 1));
+      k = 2 * k + static_cast<size_t>(!comp(key, a[k - 1]));
+    }
+    return k >> (eytzinger_trailing_ones(k) + 1);
+  }
+
+  // 计算层序第 k 个节点在有序序列中的下标，结果保存在 rank[k - 1]
+  inline void eytzinger_ranks(size_t n, tinystl::vector<size_t> &rank)
+  {
+    rank.assign(n, 0);
+    size_t i = 0;
+    for (size_t k = eytzinger_first(n); k != 0; k = eytzinger_next(k, n))
+      rank[k - 1] = i++;
+  }
+
+} // namespace tinystl
+#endif // !TINYSTL_EYTZINGER_H_
@@ -0,0 +1,305 @@
+#ifndef TINYSTL_FLAT_HASH_SET_H_
+#define TINYSTL_FLAT_HASH_SET_H_
+
+// 这个头文件包含一个模板类 flat_hash_set
+// flat_hash_set : 集合，键值即实值，键值不允许重复，接口与 unordered_set 相同
+
+// notes:
+//
+// 1. 底层为开放寻址的 tinystl::flat_hashtable，元素直接存放在槽数组中，查找一般只访问一组控制字节和一个槽
+// 2. 插入可能使所有迭代器与元素的引用失效，这一点与 unordered_set 不同
+// 3. 没有 local_iterator 与节点句柄，max_load_factor 固定为 7/8
+
+#include "flat_hashtable.h"
+
+namespace tinystl
+{
+
+  // 模板类 flat_hash_set，键值不允许重复
+  // 参数一代表键值类型，参数二代表哈希函数，缺省使用 tinystl::hash
+  // 参数三代表键值比较方式，缺省使用 tinystl::equal_to
+  template <class Key, class Hash = tinystl::hash<Key>, class KeyEqual = tinystl::equal_to<Key>>
+  class flat_hash_set
+  {
+    typedef flat_hashtable<Key, Hash, KeyEqual> base_type;
+    base_type ht_;
+
+  public:
+    // 使用 flat_hashtable 的型别
+
+    typedef typename base_type::allocator_type allocator_type;
+    typedef typename base_type::key_type key_type;
+    typedef typename base_type::value_type value_type;
+    typedef typename base_type::hasher hasher;
+    typedef typename base_type::key_equal key_equal;
+
+    typedef typename base_type::size_type size_type;
+    typedef typename base_type::difference_type difference_type;
+    typedef typename base_type::const_pointer pointer;
+    typedef typename base_type::const_pointer const_pointer;
+    typedef typename base_type::const_reference reference;
+    typedef typename base_type::const_reference const_reference;
+
+    typedef typename base_type::const_iterator iterator;
+    typedef typename base_type::const_iterator const_iterator;
+
+    allocator_type get_allocator() const { return ht_.get_allocator(); }
+
+  public:
+    // 构造、复制、移动函数
+
+    flat_hash_set() : ht_(0, Hash(), KeyEqual()) {}
+    explicit flat_hash_set(size_type bucket_count, const Hash &hash = Hash(), const KeyEqual &equal = KeyEqual())
+        : ht_(bucket_count, hash, equal) {}
+
+    template <class InputIterator>
+    flat_hash_set(InputIterator first, InputIterator last,
+                  const size_type bucket_count = 0,
+                  const Hash &hash = Hash(),
+                  const KeyEqual &equal = KeyEqual())
+        : ht_(bucket_count, hash, equal)
+    {
+      ht_.insert_unique(first, last);
+    }
+
+    flat_hash_set(std::initializer_list<value_type> ilist,
+                  const size_type bucket_count = 0,
+                  const Hash &hash = Hash(),
+                  const KeyEqual &equal = KeyEqual())
+        : ht_(tinystl::max(bucket_count, static_cast<size_type>(ilist.size())), hash, equal)
+    {
+      ht_.insert_unique(ilist.begin(), ilist.end());
+    }
+
+    flat_hash_set(const flat_hash_set &rhs)
+        : ht_(rhs.ht_)
+    {
+    }
+    flat_hash_set(flat_hash_set &&rhs) noexcept
+        : ht_(tinystl::move(rhs.ht_))
+    {
+    }
+
+    flat_hash_set &operator=(const flat_hash_set &rhs)
+    {
+      ht_ = rhs.ht_;
+      return *this;
+    }
+    flat_hash_set &operator=(flat_hash_set &&rhs)
+    {
+      ht_ = tinystl::move(rhs.ht_);
+      return *this;
+    }
+
+    flat_hash_set &operator=(std::initializer_list<value_type> ilist)
+    {
+      ht_.clear();
+      ht_.reserve(ilist.size());
+      ht_.insert_unique(ilist.begin(), ilist.end());
+      return *this;
+    }
+
+    ~flat_hash_set() = default;
+
+    // iterator
+
+    iterator begin() const noexcept
+    {
+      return ht_.begin();
+    }
+    iterator end() const noexcept
+    {
+      return ht_.end();
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+      return ht_.cbegin();
+    }
+    const_iterator cend() const noexcept
+    {
+      return ht_.cend();
+    }
+
+    // container
+    bool empty() const noexcept { return ht_.empty(); }
+
+    size_type size() const noexcept { return ht_.size(); }
+    size_type max_size() const noexcept { return ht_.max_size(); }
+
+    // 修改容器操作
+
+    // emplace / emplace_hint
+
+    template <class... Args>
+    pair<iterator, bool> emplace(Args &&...args)
+    {
+      return ht_.emplace_unique(tinystl::forward<Args>(args)...);
+    }
+
+    // [note]: hint 对开放寻址的哈希表没有意义，忽略它
+    template <class... Args>
+    iterator emplace_hint(const_iterator /*hint*/, Args &&...args)
+    {
+      return ht_.emplace_unique(tinystl::forward<Args>(args)...).first;
+    }
+
+    // insert
+
+    pair<iterator, bool> insert(const value_type &value)
+    {
+      return ht_.insert_unique(value);
+    }
+    pair<iterator, bool> insert(value_type &&value)
+    {
+      return ht_.emplace_unique(tinystl::move(value));
+    }
+
+    iterator insert(const_iterator /*hint*/, const value_type &value)
+    {
+      return ht_.insert_unique(value).first;
+    }
+    iterator insert(const_iterator /*hint*/, value_type &&value)
+    {
+      return ht_.emplace_unique(tinystl::move(value)).first;
+    }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last)
+    {
+      ht_.insert_unique(first, last);
+    }
+    void insert(std::initializer_list<value_type> ilist)
+    {
+      ht_.insert_unique(ilist.begin(), ilist.end());
+    }
+
+    // erase / clear
+
+    void erase(const_iterator it)
+    {
+      ht_.erase(it);
+    }
+    void erase(const_iterator first, const_iterator last)
+    {
+      ht_.erase(first, last);
+    }
+
+    size_type erase(const key_type &key)
+    {
+      return ht_.erase_unique(key);
+    }
+
+    void clear()
+    {
+      ht_.clear();
+    }
+
+    // 键值已存在的元素留在 source 中
+    void merge(flat_hash_set &source)
+    {
+      ht_.merge_unique(source.ht_);
+    }
+    void merge(flat_hash_set &&source)
+    {
+      ht_.merge_unique(source.ht_);
+    }
+
+    void swap(flat_hash_set &other) noexcept
+    {
+      ht_.swap(other.ht_);
+    }
+
+    // 查找相关
+
+    size_type count(const key_type &key) const
+    {
+      return ht_.count(key);
+    }
+
+    iterator find(const key_type &key) const
+    {
+      return ht_.find(key);
+    }
+
+    pair<iterator, iterator> equal_range(const key_type &key) const
+    {
+      return ht_.equal_range(key);
+    }
+
+    // 异构查找，Hash 与 KeyEqual 都带有 is_transparent 标记时才参与重载决议
+
+    template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+                  tinystl::is_transparent<H>::value && tinystl::is_transparent<E>::value, int>::type = 0>
+    size_type count(const K &key) const
+    {
+      return ht_.count(key);
+    }
+
+    template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+                  tinystl::is_transparent<H>::value && tinystl::is_transparent<E>::value, int>::type = 0>
+    iterator find(const K &key) const
+    {
+      return ht_.find(key);
+    }
+
+    template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+                  tinystl::is_transparent<H>::value && tinystl::is_transparent<E>::value, int>::type = 0>
+    pair<iterator, iterator> equal_range(const K &key) const
+    {
+      return ht_.equal_range(key);
+    }
+
+    // bucket interface，每个槽视为一个 bucket
+
+    size_type bucket_count() const noexcept
+    {
+      return ht_.bucket_count();
+    }
+    size_type max_bucket_count() const noexcept
+    {
+      return ht_.max_bucket_count();
+    }
+
+    // hash policy
+
+    float load_factor() const noexcept { return ht_.load_factor(); }
+
+    float max_load_factor() const noexcept { return ht_.max_load_factor(); }
+    void max_load_factor(float /*ml*/) {} // 固定为 7/8
+
+    void rehash(size_type count) { ht_.rehash(count); }
+    void reserve(size_type count) { ht_.reserve(count); }
+
+    hasher hash_fcn() const { return ht_.hash_fcn(); }
+    key_equal key_eq() const { return ht_.key_eq(); }
+
+  public:
+    friend bool operator==(const flat_hash_set &lhs, const flat_hash_set &rhs)
+    {
+      if (lhs.size() != rhs.size())
+        return false;
+      for (const_iterator it = lhs.begin(); it != lhs.end(); ++it)
+      {
+        if (rhs.find(*it) == rhs.end())
+          return false;
+      }
+      return true;
+    }
+    friend bool operator!=(const flat_hash_set &lhs, const flat_hash_set &rhs)
+    {
+      return !(lhs == rhs);
+    }
+  };
+
+  // 重载 tinystl 的 swap
+  template <class Key, class Hash, class KeyEqual>
+  void swap(flat_hash_set<Key, Hash, KeyEqual> &lhs,
+            flat_hash_set<Key, Hash, KeyEqual> &rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+} // namespace tinystl
+
+#endif // !TINYSTL_FLAT_HASH_SET_H_
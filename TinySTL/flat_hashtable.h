@@ -0,0 +1,863 @@
+#ifndef TINYSTL_FLAT_HASHTABLE_H_
+#define TINYSTL_FLAT_HASHTABLE_H_
+
+// 这个头文件包含一个模板类 flat_hashtable
+// flat_hashtable : 开放寻址的哈希表，作为 flat_hash_map / flat_hash_set 的底层机制
+
+// notes:
+//
+// 1. 元素直接存放在槽数组中，没有节点；另有一个控制字节数组，每个槽一个字节，
+//    取值为空（empty）、已删除（deleted）或哈希值的低 7 位（H2），末尾多一个哨兵字节供迭代器停止
+// 2. 每 16 个槽为一组，查找时一次读入一组控制字节，有 SSE2 时用一条比较指令找出 H2 相同的槽，
+//    只对这些槽比较键值；组内有空槽时查找结束，否则按三角数序列探查下一组，容量为 2 的幂时可以遍历所有组
+// 3. 删除时若所在组中还有空槽，说明没有查找越过这一组，直接标记为空，否则标记为已删除（墓碑）
+// 4. 容量为 2 的幂且不小于 16，最大负载因子固定为 7/8，墓碑也计入负载；
+//    需要扩容时，若墓碑占了一半以上的负载则以原容量重建，否则容量加倍
+// 5. 重建时元素以移动构造 + 析构的方式搬动，要求元素的移动构造不抛出异常
+// 6. 插入可能引起重建，使所有迭代器失效；删除只使指向被删元素的迭代器失效
+// 7. 没有 bucket 链表，bucket_count() 返回槽数，不提供 local_iterator 与节点句柄
+// 8. 查找时在读控制字节的同时预取起始组的槽（至多 TINYSTL_FLAT_HASH_PREFETCH_LINES 条缓存行），
+//    命中时两次缓存缺失可以重叠，而不是先等控制字节再等槽
+
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TINYSTL_FLAT_HASH_SSE2 1
+#endif
+
+#include "functional.h"
+#include "hashtable.h"
+#include "memory.h"
+#include "utils.h"
+#include "exceptdef.h"
+
+namespace tinystl
+{
+  // 控制字节的取值，非负值表示槽中有元素，其值为哈希值的低 7 位
+  static constexpr int8_t flat_ctrl_empty = -128;
+  static constexpr int8_t flat_ctrl_deleted = -2;
+  static constexpr int8_t flat_ctrl_sentinel = -1;
+
+  // 一组的槽数，也是最小容量
+  static constexpr size_t flat_group_width = 16;
+
+// 查找时预取起始组的槽的缓存行数上限
+#ifndef TINYSTL_FLAT_HASH_PREFETCH_LINES
+#define TINYSTL_FLAT_HASH_PREFETCH_LINES 4
+#endif
+
+  // 空表共用的控制字节，只有一个哨兵，不会被写入
+  inline int8_t *flat_empty_ctrl() noexcept
+  {
+    static int8_t sentinel = flat_ctrl_sentinel;
+    return &sentinel;
+  }
+
+  // 最低的置位位置，x 不为 0
+  inline uint32_t flat_trailing_zeros(uint32_t x) noexcept
+  {
+#if defined(__GNUC__)
+    return static_cast<uint32_t>(__builtin_ctz(x));
+#else
+    uint32_t n = 0;
+    for (; (x & 1) == 0; x >>= 1)
+      ++n;
+    return n;
+#endif
+  }
+
+  inline void flat_prefetch(const void *p) noexcept
+  {
+#if defined(__GNUC__)
+    __builtin_prefetch(p);
+#else
+    (void)p;
+#endif
+  }
+
+  // 把用户的哈希值打散，低 7 位作为 H2，其余位决定起始组
+  inline size_t flat_hash_mix(size_t h) noexcept
+  {
+    const uint64_t x = static_cast<uint64_t>(h) * 0x9E3779B97F4A7C15ull;
+    return static_cast<size_t>(x ^ (x >> 32));
+  }
+
+  // 一组控制字节，match 系列函数返回符合条件的槽组成的位掩码，第 i 位对应组内第 i 个槽
+  struct flat_group
+  {
+#ifdef TINYSTL_FLAT_HASH_SSE2
+    __m128i ctrl;
+
+    explicit flat_group(const int8_t *p)
+        : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p))) {}
+
+    uint32_t match(int8_t h2) const
+    {
+      return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+    }
+    uint32_t match_empty() const
+    {
+      return match(flat_ctrl_empty);
+    }
+    // 空与已删除都小于哨兵
+    uint32_t match_empty_or_deleted() const
+    {
+      return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(flat_ctrl_sentinel), ctrl)));
+    }
+#else
+    const int8_t *ctrl;
+
+    explicit flat_group(const int8_t *p) : ctrl(p) {}
+
+    uint32_t match(int8_t h2) const
+    {
+      uint32_t m = 0;
+      for (size_t i = 0; i < flat_group_width; ++i)
+        m |= static_cast<uint32_t>(ctrl[i] == h2) << i;
+      return m;
+    }
+    uint32_t match_empty() const
+    {
+      return match(flat_ctrl_empty);
+    }
+    uint32_t match_empty_or_deleted() const
+    {
+      uint32_t m = 0;
+      for (size_t i = 0; i < flat_group_width; ++i)
+        m |= static_cast<uint32_t>(ctrl[i] < flat_ctrl_sentinel) << i;
+      return m;
+    }
+#endif
+  };
+
+  // flat_hashtable 的迭代器，由控制字节和槽两个指针组成，end() 指向哨兵
+  template <class T, class Ref, class Ptr>
+  struct flat_ht_iterator : public iterator<forward_iterator_tag, T>
+  {
+    typedef flat_ht_iterator<T, T &, T *> iterator;
+    typedef flat_ht_iterator<T, const T &, const T *> const_iterator;
+    typedef flat_ht_iterator self;
+
+    typedef T value_type;
+    typedef Ptr pointer;
+    typedef Ref reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    const int8_t *ctrl_;
+    T *slot_;
+
+    flat_ht_iterator() noexcept : ctrl_(nullptr), slot_(nullptr) {}
+    flat_ht_iterator(const int8_t *c, T *s) noexcept : ctrl_(c), slot_(s) {}
+    flat_ht_iterator(const iterator &rhs) noexcept
+        : ctrl_(rhs.ctrl_), slot_(rhs.slot_) {}
+
+    reference operator*() const { return *slot_; }
+    pointer operator->() const { return slot_; }
+
+    self &operator++()
+    {
+      TINYSTL_DEBUG(*ctrl_ != flat_ctrl_sentinel);
+      ++ctrl_;
+      ++slot_;
+      skip_empty_or_deleted();
+      return *this;
+    }
+    self operator++(int)
+    {
+      self tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    // 跳过没有元素的槽，停在下一个元素或哨兵上
+    void skip_empty_or_deleted()
+    {
+      while (*ctrl_ < flat_ctrl_sentinel)
+      {
+        ++ctrl_;
+        ++slot_;
+      }
+    }
+
+    bool operator==(const self &rhs) const { return ctrl_ == rhs.ctrl_; }
+    bool operator!=(const self &rhs) const { return ctrl_ != rhs.ctrl_; }
+  };
+
+  // 模板类 flat_hashtable，键值不允许重复
+  // 参数一代表数据类型，参数二代表哈希函数，参数三代表键值相等的比较函数
+  template <class T, class Hash, class KeyEqual>
+  class flat_hashtable
+  {
+  public:
+    // flat_hashtable 的型别定义
+    typedef ht_value_traits<T> value_traits;
+    typedef typename value_traits::key_type key_type;
+    typedef typename value_traits::mapped_type mapped_type;
+    typedef typename value_traits::value_type value_type;
+    typedef Hash hasher;
+    typedef KeyEqual key_equal;
+
+    typedef tinystl::allocator<T> allocator_type;
+    typedef tinystl::allocator<T> data_allocator;
+    typedef tinystl::allocator<int8_t> ctrl_allocator;
+
+    typedef typename allocator_type::pointer pointer;
+    typedef typename allocator_type::const_pointer const_pointer;
+    typedef typename allocator_type::reference reference;
+    typedef typename allocator_type::const_reference const_reference;
+    typedef typename allocator_type::size_type size_type;
+    typedef typename allocator_type::difference_type difference_type;
+
+    typedef flat_ht_iterator<T, T &, T *> iterator;
+    typedef flat_ht_iterator<T, const T &, const T *> const_iterator;
+
+    static constexpr size_type group_width = flat_group_width;
+
+    allocator_type get_allocator() const { return allocator_type(); }
+
+  private:
+    // 用以下七个数据表现 flat_hashtable
+    int8_t *ctrl_;          // 控制字节，共 capacity_ + 1 个，最后一个为哨兵
+    pointer slots_;         // 槽数组
+    size_type capacity_;    // 槽数，为 0 或 2 的幂
+    size_type size_;        // 元素个数
+    size_type growth_left_; // 不扩容还能占用的空槽数
+    hasher hash_;
+    key_equal equal_;
+
+  public:
+    // 构造、复制、移动、析构函数
+    explicit flat_hashtable(size_type count = 0,
+                            const Hash &hash = Hash(),
+                            const KeyEqual &equal = KeyEqual())
+        : ctrl_(flat_empty_ctrl()), slots_(nullptr), capacity_(0), size_(0), growth_left_(0),
+          hash_(hash), equal_(equal)
+    {
+      if (count != 0)
+        resize(capacity_for(count));
+    }
+
+    flat_hashtable(const flat_hashtable &rhs);
+    flat_hashtable(flat_hashtable &&rhs) noexcept
+        : ctrl_(rhs.ctrl_), slots_(rhs.slots_), capacity_(rhs.capacity_), size_(rhs.size_),
+          growth_left_(rhs.growth_left_), hash_(rhs.hash_), equal_(rhs.equal_)
+    {
+      rhs.reset();
+    }
+
+    flat_hashtable &operator=(const flat_hashtable &rhs)
+    {
+      if (this != &rhs)
+      {
+        flat_hashtable tmp(rhs);
+        swap(tmp);
+      }
+      return *this;
+    }
+    flat_hashtable &operator=(flat_hashtable &&rhs) noexcept
+    {
+      if (this != &rhs)
+      {
+        release();
+        swap(rhs);
+      }
+      return *this;
+    }
+
+    ~flat_hashtable() { release(); }
+
+    // 迭代器相关操作
+    iterator begin() noexcept
+    {
+      iterator it(ctrl_, slots_);
+      it.skip_empty_or_deleted();
+      return it;
+    }
+    const_iterator begin() const noexcept
+    {
+      const_iterator it(ctrl_, slots_);
+      it.skip_empty_or_deleted();
+      return it;
+    }
+    iterator end() noexcept { return iterator(ctrl_ + capacity_, slots_ + capacity_); }
+    const_iterator end() const noexcept { return const_iterator(ctrl_ + capacity_, slots_ + capacity_); }
+
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    // 容量相关操作
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type max_size() const noexcept { return static_cast<size_type>(-1) / (sizeof(T) + 1); }
+
+    // 修改容器相关操作
+
+    template <class... Args>
+    pair<iterator, bool> emplace_unique(Args &&...args);
+
+    // 键值不存在时才用 args 构造实值，只用于映射
+    template <class K, class... Args>
+    pair<iterator, bool> try_emplace(K &&key, Args &&...args);
+
+    pair<iterator, bool> insert_unique(const value_type &value);
+    pair<iterator, bool> insert_unique(value_type &&value)
+    {
+      return emplace_unique(tinystl::move(value));
+    }
+
+    template <class InputIter>
+    void insert_unique(InputIter first, InputIter last)
+    {
+      for (; first != last; ++first)
+        insert_unique(*first);
+    }
+
+    // erase / clear
+
+    void erase(const_iterator position)
+    {
+      TINYSTL_DEBUG(position != cend());
+      erase_at(static_cast<size_type>(position.ctrl_ - ctrl_));
+    }
+    void erase(const_iterator first, const_iterator last);
+
+    template <class K>
+    size_type erase_unique(const K &key)
+    {
+      const size_type i = find_index(key);
+      if (i == capacity_)
+        return 0;
+      erase_at(i);
+      return 1;
+    }
+
+    void clear();
+
+    // 把 source 中键值不重复的元素移到本容器中
+    void merge_unique(flat_hashtable &source);
+
+    void swap(flat_hashtable &rhs) noexcept;
+
+    // 查找相关操作，参数类型 K 通常为 key_type，由容器在哈希函数与比较函数带有 is_transparent 时放开
+
+    template <class K>
+    iterator find(const K &key)
+    {
+      const size_type i = find_index(key);
+      return iterator(ctrl_ + i, slots_ + i);
+    }
+    template <class K>
+    const_iterator find(const K &key) const
+    {
+      const size_type i = find_index(key);
+      return const_iterator(ctrl_ + i, slots_ + i);
+    }
+
+    template <class K>
+    size_type count(const K &key) const
+    {
+      return find_index(key) == capacity_ ? 0 : 1;
+    }
+
+    template <class K>
+    pair<iterator, iterator> equal_range(const K &key)
+    {
+      iterator it = find(key);
+      iterator last = it;
+      if (it != end())
+        ++last;
+      return tinystl::make_pair(it, last);
+    }
+    template <class K>
+    pair<const_iterator, const_iterator> equal_range(const K &key) const
+    {
+      const_iterator it = find(key);
+      const_iterator last = it;
+      if (it != end())
+        ++last;
+      return tinystl::make_pair(it, last);
+    }
+
+    // 容量与负载因子
+    size_type bucket_count() const noexcept { return capacity_; }
+    size_type max_bucket_count() const noexcept { return max_size(); }
+
+    float load_factor() const noexcept
+    {
+      return capacity_ != 0 ? static_cast<float>(size_) / capacity_ : 0.0f;
+    }
+    float max_load_factor() const noexcept { return 0.875f; }
+
+    void rehash(size_type count);
+    void reserve(size_type count)
+    {
+      const size_type cap = capacity_for(count);
+      if (cap > capacity_)
+        resize(cap);
+    }
+
+    hasher hash_fcn() const { return hash_; }
+    key_equal key_eq() const { return equal_; }
+
+  private:
+    // helper functions
+
+    template <class K>
+    size_t hash_of(const K &key) const
+    {
+      return flat_hash_mix(hash_(key));
+    }
+    static int8_t h2(size_t h) noexcept { return static_cast<int8_t>(h & 0x7F); }
+    static size_t h1(size_t h) noexcept { return h >> 7; }
+
+    // 预取第 g 组的槽，元素较大时只预取开头的几条缓存行
+    void prefetch_slots(size_type g) const noexcept
+    {
+      static constexpr size_type bytes = group_width * sizeof(T);
+      static constexpr size_type lines = (bytes + 63) / 64 < TINYSTL_FLAT_HASH_PREFETCH_LINES
+                                             ? (bytes + 63) / 64
+                                             : TINYSTL_FLAT_HASH_PREFETCH_LINES;
+      const char *p = reinterpret_cast<const char *>(slots_ + g * group_width);
+      for (size_type i = 0; i < lines; ++i)
+        flat_prefetch(p + 64 * i);
+    }
+
+    // 容量为 cap 时最多容纳的元素个数
+    static size_type max_load(size_type cap) noexcept { return cap - cap / 8; }
+
+    // 容纳 n 个元素所需的最小容量
+    size_type capacity_for(size_type n) const
+    {
+      THROW_LENGTH_ERROR_IF(n > max_size() / 2, "flat_hashtable<T>'s size too big");
+      size_type cap = group_width;
+      while (max_load(cap) < n)
+        cap <<= 1;
+      return cap;
+    }
+
+    template <class K>
+    size_type find_index(const K &key) const;
+    template <class K>
+    pair<size_type, bool> find_or_prepare_insert(const K &key);
+    size_type find_first_non_full(size_t h) const;
+    size_type prepare_insert(size_t h);
+
+    template <class... Args>
+    void construct_at(size_type i, Args &&...args);
+    void erase_at(size_type i);
+    void erase_meta(size_type i);
+
+    void rehash_and_grow();
+    void resize(size_type new_cap);
+    void copy_from(const flat_hashtable &rhs);
+    void destroy_all() noexcept;
+    void release() noexcept;
+    void reset() noexcept;
+  };
+
+  /*****************************************************************************************/
+
+  // 复制构造函数，键值不会重复，不需要比较
+  template <class T, class Hash, class KeyEqual>
+  flat_hashtable<T, Hash, KeyEqual>::
+      flat_hashtable(const flat_hashtable &rhs)
+      : ctrl_(flat_empty_ctrl()), slots_(nullptr), capacity_(0), size_(0), growth_left_(0),
+        hash_(rhs.hash_), equal_(rhs.equal_)
+  {
+    if (rhs.size_ != 0)
+    {
+      try
+      {
+        copy_from(rhs);
+      }
+      catch (...)
+      {
+        release();
+        throw;
+      }
+    }
+  }
+
+  // 就地构造元素，键值不允许重复
+  template <class T, class Hash, class KeyEqual>
+  template <class... Args>
+  pair<typename flat_hashtable<T, Hash, KeyEqual>::iterator, bool>
+  flat_hashtable<T, Hash, KeyEqual>::
+      emplace_unique(Args &&...args)
+  {
+    value_type tmp(tinystl::forward<Args>(args)...);
+    const pair<size_type, bool> r = find_or_prepare_insert(value_traits::get_key(tmp));
+    if (r.second)
+      construct_at(r.first, tinystl::move(tmp));
+    return tinystl::make_pair(iterator(ctrl_ + r.first, slots_ + r.first), r.second);
+  }
+
+  // 键值不存在时构造 (key, mapped_type(args...))，键值已存在时不构造任何对象
+  template <class T, class Hash, class KeyEqual>
+  template <class K, class... Args>
+  pair<typename flat_hashtable<T, Hash, KeyEqual>::iterator, bool>
+  flat_hashtable<T, Hash, KeyEqual>::
+      try_emplace(K &&key, Args &&...args)
+  {
+    const pair<size_type, bool> r = find_or_prepare_insert(key);
+    if (r.second)
+      construct_at(r.first, tinystl::forward<K>(key), mapped_type(tinystl::forward<Args>(args)...));
+    return tinystl::make_pair(iterator(ctrl_ + r.first, slots_ + r.first), r.second);
+  }
+
+  // 插入元素，键值已存在时不复制元素
+  template <class T, class Hash, class KeyEqual>
+  pair<typename flat_hashtable<T, Hash, KeyEqual>::iterator, bool>
+  flat_hashtable<T, Hash, KeyEqual>::
+      insert_unique(const value_type &value)
+  {
+    const pair<size_type, bool> r = find_or_prepare_insert(value_traits::get_key(value));
+    if (r.second)
+      construct_at(r.first, value);
+    return tinystl::make_pair(iterator(ctrl_ + r.first, slots_ + r.first), r.second);
+  }
+
+  // 删除 [first, last) 内的元素，删除不会移动其他元素
+  template <class T, class Hash, class KeyEqual>
+  void flat_hashtable<T, Hash, KeyEqual>::
+      erase(const_iterator first, const_iterator last)
+  {
+    while (first != last)
+    {
+      const_iterator next = first;
+      ++next;
+      erase(first);
+      first = next;
+    }
+  }
+
+  // 清空元素，保留容量
+  template <class T, class Hash, class KeyEqual>
+  void flat_hashtable<T, Hash, KeyEqual>::
+      clear()
+  {
+    if (capacity_ == 0)
+      return;
+    destroy_all();
+    std::memset(ctrl_, static_cast<unsigned char>(flat_ctrl_empty), capacity_);
+    size_ = 0;
+    growth_left_ = max_load(capacity_);
+  }
+
+  template <class T, class Hash, class KeyEqual>
+  void flat_hashtable<T, Hash, KeyEqual>::
+      merge_unique(flat_hashtable &source)
+  {
+    if (&source == this)
+      return;
+    for (size_type j = 0; j < source.capacity_; ++j)
+    {
+      if (source.ctrl_[j] < 0)
+        continue;
+      const pair<size_type, bool> r = find_or_prepare_insert(value_traits::get_key(source.slots_[j]));
+      if (r.second)
+      {
+        construct_at(r.first, tinystl::move(source.slots_[j]));
+        source.erase_at(j);
+      }
+    }
+  }
+
+  template <class T, class Hash, class KeyEqual>
+  void flat_hashtable<T, Hash, KeyEqual>::
+      swap(flat_hashtable &rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      tinystl::swap(ctrl_, rhs.ctrl_);
+      tinystl::swap(slots_, rhs.slots_);
+      tinystl::swap(capacity_, rhs.capacity_);
+      tinystl::swap(size_, rhs.size_);
+      tinystl::swap(growth_left_, rhs.growth_left_);
+      tinystl::swap(hash_, rhs.hash_);
+      tinystl::swap(equal_, rhs.equal_);
+    }
+  }
+
+  // 重建为至少 count 个槽且能容纳当前元素的容量，count 与元素个数都为 0 时释放空间
+  template <class T, class Hash, class KeyEqual>
+  void flat_hashtable<T, Hash, KeyEqual>::
+      rehash(size_type count)
+  {
+    if (count == 0 && size_ == 0)
+    {
+      release();
+      return;
+    }
+    size_type cap = capacity_for(size_);
+    while (cap < count)
+      cap <<= 1;
+    if (cap != capacity_ || growth_left_ != max_load(capacity_) - size_)
+      resize(cap);
+  }
+
+  /*****************************************************************************************/
+  // helper function
+
+  // 查找键值为 key 的元素所在的槽，没有时返回 capacity_
+  template <class T, class Hash, class KeyEqual>
+  template <class K>
+  typename flat_hashtable<T, Hash, KeyEqual>::size_type
+  flat_hashtable<T, Hash, KeyEqual>::
+      find_index(const K &key) const
+  {
+    if (size_ == 0)
+      return capacity_;
+    const size_t h = hash_of(key);
+    const int8_t tag = h2(h);
+    const size_type group_mask = capacity_ / group_width - 1;
+    size_type g = h1(h) & group_mask;
+    prefetch_slots(g);
+    for (size_type stride = 1;; ++stride)
+    {
+      const flat_group group(ctrl_ + g * group_width);
+      for (uint32_t m = group.match(tag); m != 0; m &= m - 1)
+      {
+        const size_type i = g * group_width + flat_trailing_zeros(m);
+        if (equal_(value_traits::get_key(slots_[i]), key))
+          return i;
+      }
+      if (group.match_empty() != 0)
+        return capacity_;
+      g = (g + stride) & group_mask;
+    }
+  }
+
+  // 键值存在时返回 (所在的槽, false)，否则占用一个槽并返回 (槽, true)，调用者负责在槽中构造元素
+  template <class T, class Hash, class KeyEqual>
+  template <class K>
+  pair<typename flat_hashtable<T, Hash, KeyEqual>::size_type, bool>
+  flat_hashtable<T, Hash, KeyEqual>::
+      find_or_prepare_insert(const K &key)
+  {
+    const size_t h = hash_of(key);
+    if (capacity_ != 0)
+    {
+      const int8_t tag = h2(h);
+      const size_type group_mask = capacity_ / group_width - 1;
+      size_type g = h1(h) & group_mask;
+      prefetch_slots(g);
+      for (size_type stride = 1;; ++stride)
+      {
+        const flat_group group(ctrl_ + g * group_width);
+        for (uint32_t m = group.match(tag); m != 0; m &= m - 1)
+        {
+          const size_type i = g * group_width + flat_trailing_zeros(m);
+          if (equal_(value_traits::get_key(slots_[i]), key))
+            return tinystl::make_pair(i, false);
+        }
+        if (group.match_empty() != 0)
+          break;
+        g = (g + stride) & group_mask;
+      }
+    }
+    return tinystl::make_pair(prepare_insert(h), true);
+  }
+
+  // 沿探查序列找到第一个空的或已删除的槽，负载因子保证一定存在
+  template <class T, class Hash, class KeyEqual>
+  typename flat_hashtable<T, Hash, KeyEqual>::size_type
+  flat_hashtable<T, Hash, KeyEqual>::
+      find_first_non_full(size_t h) const
+  {
+    const size_type group_mask = capacity_ / group_width - 1;
+    size_type g = h1(h) & group_mask;
+    for (size_type stride = 1;; ++stride)
+    {
+      const uint32_t m = flat_group(ctrl_ + g * group_width).match_empty_or_deleted();
+      if (m != 0)
+        return g * group_width + flat_trailing_zeros(m);
+      g = (g + stride) & group_mask;
+    }
+  }
+
+  // 为哈希值为 h 的新元素占用一个槽，复用墓碑不消耗负载，没有余量时先重建
+  template <class T, class Hash, class KeyEqual>
+  typename flat_hashtable<T, Hash, KeyEqual>::size_type
+  flat_hashtable<T, Hash, KeyEqual>::
+      prepare_insert(size_t h)
+  {
+    size_type i = capacity_ != 0 ? find_first_non_full(h) : 0;
+    if (capacity_ == 0 || (growth_left_ == 0 && ctrl_[i] != flat_ctrl_deleted))
+    {
+      rehash_and_grow();
+      i = find_first_non_full(h);
+    }
+    if (ctrl_[i] == flat_ctrl_empty)
+      --growth_left_;
+    ctrl_[i] = h2(h);
+    ++size_;
+    return i;
+  }
+
+  // 在已占用的槽 i 中构造元素，失败时归还这个槽
+  template <class T, class Hash, class KeyEqual>
+  template <class... Args>
+  void flat_hashtable<T, Hash, KeyEqual>::
+      construct_at(size_type i, Args &&...args)
+  {
+    try
+    {
+      data_allocator::construct(slots_ + i, tinystl::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+      erase_meta(i);
+      --size_;
+      throw;
+    }
+  }
+
+  template <class T, class Hash, class KeyEqual>
+  void flat_hashtable<T, Hash, KeyEqual>::
+      erase_at(size_type i)
+  {
+    data_allocator::destroy(slots_ + i);
+    erase_meta(i);
+    --size_;
+  }
+
+  // 所在组中还有空槽时，没有查找会越过这一组，可以直接标记为空
+  template <class T, class Hash, class KeyEqual>
+  void flat_hashtable<T, Hash, KeyEqual>::
+      erase_meta(size_type i)
+  {
+    const size_type g = i & ~(group_width - 1);
+    if (flat_group(ctrl_ + g).match_empty() != 0)
+    {
+      ctrl_[i] = flat_ctrl_empty;
+      ++growth_left_;
+    }
+    else
+    {
+      ctrl_[i] = flat_ctrl_deleted;
+    }
+  }
+
+  template <class T, class Hash, class KeyEqual>
+  void flat_hashtable<T, Hash, KeyEqual>::
+      rehash_and_grow()
+  {
+    if (capacity_ == 0)
+      resize(group_width);
+    else if (size_ <= max_load(capacity_) / 2)
+      resize(capacity_); // 墓碑占了一半以上的负载，原容量重建即可
+    else
+      resize(capacity_ * 2);
+  }
+
+  // 分配 new_cap 个槽，把元素搬过去，同时清除所有墓碑
+  template <class T, class Hash, class KeyEqual>
+  void flat_hashtable<T, Hash, KeyEqual>::
+      resize(size_type new_cap)
+  {
+    TINYSTL_DEBUG(new_cap >= group_width && (new_cap & (new_cap - 1)) == 0);
+    TINYSTL_DEBUG(max_load(new_cap) >= size_);
+    THROW_LENGTH_ERROR_IF(new_cap > max_size(), "flat_hashtable<T>'s size too big");
+    int8_t *new_ctrl = ctrl_allocator::allocate(new_cap + 1);
+    pointer new_slots = nullptr;
+    try
+    {
+      new_slots = data_allocator::allocate(new_cap);
+    }
+    catch (...)
+    {
+      ctrl_allocator::deallocate(new_ctrl, new_cap + 1);
+      throw;
+    }
+    std::memset(new_ctrl, static_cast<unsigned char>(flat_ctrl_empty), new_cap);
+    new_ctrl[new_cap] = flat_ctrl_sentinel;
+
+    int8_t *old_ctrl = ctrl_;
+    pointer old_slots = slots_;
+    const size_type old_cap = capacity_;
+    ctrl_ = new_ctrl;
+    slots_ = new_slots;
+    capacity_ = new_cap;
+    for (size_type j = 0; j < old_cap; ++j)
+    {
+      if (old_ctrl[j] < 0)
+        continue;
+      const size_t h = hash_of(value_traits::get_key(old_slots[j]));
+      const size_type i = find_first_non_full(h);
+      ctrl_[i] = h2(h);
+      data_allocator::construct(slots_ + i, tinystl::move(old_slots[j]));
+      data_allocator::destroy(old_slots + j);
+    }
+    growth_left_ = max_load(capacity_) - size_;
+    if (old_cap != 0)
+    {
+      ctrl_allocator::deallocate(old_ctrl, old_cap + 1);
+      data_allocator::deallocate(old_slots, old_cap);
+    }
+  }
+
+  // 本容器为空表时复制 rhs 的元素
+  template <class T, class Hash, class KeyEqual>
+  void flat_hashtable<T, Hash, KeyEqual>::
+      copy_from(const flat_hashtable &rhs)
+  {
+    resize(capacity_for(rhs.size_));
+    for (size_type j = 0; j < rhs.capacity_; ++j)
+    {
+      if (rhs.ctrl_[j] < 0)
+        continue;
+      const size_t h = hash_of(value_traits::get_key(rhs.slots_[j]));
+      const size_type i = find_first_non_full(h);
+      data_allocator::construct(slots_ + i, rhs.slots_[j]);
+      ctrl_[i] = h2(h);
+      ++size_;
+      --growth_left_;
+    }
+  }
+
+  template <class T, class Hash, class KeyEqual>
+  void flat_hashtable<T, Hash, KeyEqual>::
+      destroy_all() noexcept
+  {
+    if (size_ == 0)
+      return;
+    for (size_type i = 0; i < capacity_; ++i)
+    {
+      if (ctrl_[i] >= 0)
+        data_allocator::destroy(slots_ + i);
+    }
+  }
+
+  // 销毁所有元素并释放空间，回到空表
+  template <class T, class Hash, class KeyEqual>
+  void flat_hashtable<T, Hash, KeyEqual>::
+      release() noexcept
+  {
+    if (capacity_ != 0)
+    {
+      destroy_all();
+      ctrl_allocator::deallocate(ctrl_, capacity_ + 1);
+      data_allocator::deallocate(slots_, capacity_);
+    }
+    reset();
+  }
+
+  template <class T, class Hash, class KeyEqual>
+  void flat_hashtable<T, Hash, KeyEqual>::
+      reset() noexcept
+  {
+    ctrl_ = flat_empty_ctrl();
+    slots_ = nullptr;
+    capacity_ = 0;
+    size_ = 0;
+    growth_left_ = 0;
+  }
+
+} // namespace tinystl
+
+#endif // !TINYSTL_FLAT_HASHTABLE_H_
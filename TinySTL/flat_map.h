@@ -0,0 +1,1057 @@
+#ifndef TINYSTL_FLAT_MAP_H_
+#define TINYSTL_FLAT_MAP_H_
+
+// 这个头文件包含两个模板类 flat_map 和 flat_multimap
+// flat_map      : 映射，元素具有键值和实值，键值不允许重复，接口与 map 相同
+// flat_multimap : 映射，元素具有键值和实值，键值允许重复，接口与 multimap 相同
+
+// notes:
+//
+// 1. 键值与实值分别有序地存放在两个 tinystl::vector 中，下标一一对应
+//    查找只在键值数组上二分，遍历是线性的内存扫描，每个元素没有额外开销
+// 2. 由于键值与实值分开存放，解引用迭代器得到的是代理对象 pair<const Key&, T&>，而不是 value_type&
+//    it->first / it->second、rbegin()->first 以及 auto kv = *it 的用法与 map 一致，但不能写 auto &kv = *it
+//    operator-> 返回保存代理对象的 pointer 类型，reverse_iterator 对非原生指针的 pointer 会转交给它
+// 3. 单个插入删除需要移动插入点之后的元素，复杂度为 O(n)，适合读多写少的场景
+// 4. 区间插入先把新元素追加到尾部，再对新元素排序，最后与原有元素归并，复杂度为 O(n + m log m)
+// 5. 任何插入删除都可能使所有迭代器失效，这一点与 map 不同
+// 6. 额外提供 reserve / capacity / shrink_to_fit 以及 keys() / values()，用来访问底层的 vector
+
+#include "functional.h"
+#include "algo.h"
+#include "iterator.h"
+#include "vector.h"
+#include "exceptdef.h"
+#include <initializer_list>
+
+namespace tinystl
+{
+
+  // flat_map 的迭代器，同时指向键值数组与实值数组的同一下标
+  // Mapped 为 T 时是 iterator，为 const T 时是 const_iterator
+  template <class Key, class T, class Mapped>
+  struct flat_map_iterator : public tinystl::iterator<random_access_iterator_tag, tinystl::pair<const Key, T>>
+  {
+    typedef tinystl::pair<const Key &, Mapped &> reference;
+    typedef ptrdiff_t difference_type;
+    typedef flat_map_iterator<Key, T, T> iterator;
+    typedef flat_map_iterator<Key, T, const T> const_iterator;
+    typedef flat_map_iterator<Key, T, Mapped> self;
+
+    // operator-> 返回的代理，保存一个 reference
+    struct pointer
+    {
+      reference ref;
+      const reference *operator->() const { return &ref; }
+    };
+
+    const Key *key_;
+    Mapped *value_;
+
+    // 构造函数
+    flat_map_iterator() : key_(nullptr), value_(nullptr) {}
+    flat_map_iterator(const Key *k, Mapped *v) : key_(k), value_(v) {}
+    flat_map_iterator(const iterator &rhs) : key_(rhs.key_), value_(rhs.value_) {}
+
+    // 重载操作符
+    reference operator*() const { return reference(*key_, *value_); }
+    pointer operator->() const { return pointer{operator*()}; }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    self &operator++()
+    {
+      ++key_;
+      ++value_;
+      return *this;
+    }
+    self operator++(int)
+    {
+      self tmp = *this;
+      ++*this;
+      return tmp;
+    }
+    self &operator--()
+    {
+      --key_;
+      --value_;
+      return *this;
+    }
+    self operator--(int)
+    {
+      self tmp = *this;
+      --*this;
+      return tmp;
+    }
+
+    self &operator+=(difference_type n)
+    {
+      key_ += n;
+      value_ += n;
+      return *this;
+    }
+    self &operator-=(difference_type n) { return *this += -n; }
+    self operator+(difference_type n) const
+    {
+      self tmp = *this;
+      return tmp += n;
+    }
+    self operator-(difference_type n) const
+    {
+      self tmp = *this;
+      return tmp -= n;
+    }
+
+    friend self operator+(difference_type n, const self &it) { return it + n; }
+    friend difference_type operator-(const self &lhs, const self &rhs) { return lhs.key_ - rhs.key_; }
+    friend bool operator==(const self &lhs, const self &rhs) { return lhs.key_ == rhs.key_; }
+    friend bool operator!=(const self &lhs, const self &rhs) { return lhs.key_ != rhs.key_; }
+    friend bool operator<(const self &lhs, const self &rhs) { return lhs.key_ < rhs.key_; }
+    friend bool operator>(const self &lhs, const self &rhs) { return rhs < lhs; }
+    friend bool operator<=(const self &lhs, const self &rhs) { return !(rhs < lhs); }
+    friend bool operator>=(const self &lhs, const self &rhs) { return !(lhs < rhs); }
+  };
+
+  // 模板类 flat_map，键值不允许重复
+  // 参数一代表键值类型，参数二代表实值类型，参数三代表键值的比较方式，缺省使用 tinystl::less
+  template <class Key, class T, class Compare = tinystl::less<Key>>
+  class flat_map
+  {
+  public:
+    // flat_map 的嵌套型别定义
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef tinystl::pair<const Key, T> value_type;
+    typedef Compare key_compare;
+    typedef tinystl::vector<Key> key_container_type;
+    typedef tinystl::vector<T> mapped_container_type;
+
+    // 定义一个 functor，用来进行元素比较
+    class value_compare : public binary_function<value_type, value_type, bool>
+    {
+      friend class flat_map<Key, T, Compare>;
+
+    private:
+      Compare comp;
+      value_compare(Compare c) : comp(c) {}
+
+    public:
+      bool operator()(const value_type &lhs, const value_type &rhs) const
+      {
+        return comp(lhs.first, rhs.first); // 比较键值的大小
+      }
+    };
+
+    typedef flat_map_iterator<Key, T, T> iterator;
+    typedef flat_map_iterator<Key, T, const T> const_iterator;
+    typedef typename iterator::pointer pointer;
+    typedef typename const_iterator::pointer const_pointer;
+    typedef typename iterator::reference reference;
+    typedef typename const_iterator::reference const_reference;
+    typedef tinystl::reverse_iterator<iterator> reverse_iterator;
+    typedef tinystl::reverse_iterator<const_iterator> const_reverse_iterator;
+    typedef typename key_container_type::size_type size_type;
+    typedef typename key_container_type::difference_type difference_type;
+    typedef tinystl::allocator<value_type> allocator_type;
+
+  private:
+    key_container_type keys_;      // 按 comp_ 升序排列的键值
+    mapped_container_type values_; // 与 keys_ 下标对应的实值
+    key_compare comp_;
+
+  public:
+    // 构造、复制、移动、赋值函数
+
+    flat_map() = default;
+
+    template <class InputIterator>
+    flat_map(InputIterator first, InputIterator last)
+        : keys_(), values_(), comp_()
+    {
+      insert(first, last);
+    }
+
+    flat_map(std::initializer_list<value_type> ilist)
+        : keys_(), values_(), comp_()
+    {
+      insert(ilist.begin(), ilist.end());
+    }
+
+    flat_map(const flat_map &rhs)
+        : keys_(rhs.keys_), values_(rhs.values_), comp_(rhs.comp_)
+    {
+    }
+    flat_map(flat_map &&rhs) noexcept
+        : keys_(tinystl::move(rhs.keys_)), values_(tinystl::move(rhs.values_)), comp_(rhs.comp_)
+    {
+    }
+
+    flat_map &operator=(const flat_map &rhs)
+    {
+      if (this != &rhs)
+      {
+        flat_map tmp(rhs);
+        swap(tmp);
+      }
+      return *this;
+    }
+    flat_map &operator=(flat_map &&rhs)
+    {
+      keys_ = tinystl::move(rhs.keys_);
+      values_ = tinystl::move(rhs.values_);
+      comp_ = rhs.comp_;
+      return *this;
+    }
+
+    flat_map &operator=(std::initializer_list<value_type> ilist)
+    {
+      clear();
+      insert(ilist.begin(), ilist.end());
+      return *this;
+    }
+
+    // 相关接口
+
+    key_compare key_comp() const { return comp_; }
+    value_compare value_comp() const { return value_compare(comp_); }
+    allocator_type get_allocator() const { return allocator_type(); }
+    const key_container_type &keys() const noexcept { return keys_; }
+    const mapped_container_type &values() const noexcept { return values_; }
+
+    // 迭代器相关
+
+    iterator begin() noexcept { return make_iterator(0); }
+    const_iterator begin() const noexcept { return make_iterator(0); }
+    iterator end() noexcept { return make_iterator(size()); }
+    const_iterator end() const noexcept { return make_iterator(size()); }
+
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // 容量相关
+    bool empty() const noexcept { return keys_.empty(); }
+    size_type size() const noexcept { return keys_.size(); }
+    size_type max_size() const noexcept { return tinystl::min(keys_.max_size(), values_.max_size()); }
+    size_type capacity() const noexcept { return keys_.capacity(); }
+    void reserve(size_type n)
+    {
+      keys_.reserve(n);
+      values_.reserve(n);
+    }
+    void shrink_to_fit()
+    {
+      keys_.shrink_to_fit();
+      values_.shrink_to_fit();
+    }
+
+    // 访问元素相关
+
+    // 若键值不存在，at 会抛出一个异常
+    mapped_type &at(const key_type &key)
+    {
+      iterator it = find(key);
+      THROW_OUT_OF_RANGE_IF(it == end(), "flat_map<Key, T> no such element exists");
+      return *it.value_;
+    }
+    const mapped_type &at(const key_type &key) const
+    {
+      const_iterator it = find(key);
+      THROW_OUT_OF_RANGE_IF(it == end(), "flat_map<Key, T> no such element exists");
+      return *it.value_;
+    }
+
+    mapped_type &operator[](const key_type &key)
+    {
+      const size_type i = lower_index(key);
+      if (i == size() || comp_(key, keys_[i]))
+        emplace_at(i, key, T{});
+      return values_[i];
+    }
+    mapped_type &operator[](key_type &&key)
+    {
+      const size_type i = lower_index(key);
+      if (i == size() || comp_(key, keys_[i]))
+        emplace_at(i, tinystl::move(key), T{});
+      return values_[i];
+    }
+
+    // 插入删除相关
+
+    template <class... Args>
+    pair<iterator, bool> emplace(Args &&...args)
+    {
+      value_type value(tinystl::forward<Args>(args)...);
+      return insert_value(value.first, tinystl::move(value.second));
+    }
+
+    template <class... Args>
+    iterator emplace_hint(iterator hint, Args &&...args)
+    {
+      value_type value(tinystl::forward<Args>(args)...);
+      return insert_value_use_hint(hint, value.first, tinystl::move(value.second));
+    }
+
+    pair<iterator, bool> insert(const value_type &value)
+    {
+      return insert_value(value.first, value.second);
+    }
+    pair<iterator, bool> insert(value_type &&value)
+    {
+      return insert_value(value.first, tinystl::move(value.second));
+    }
+
+    iterator insert(iterator hint, const value_type &value)
+    {
+      return insert_value_use_hint(hint, value.first, value.second);
+    }
+    iterator insert(iterator hint, value_type &&value)
+    {
+      return insert_value_use_hint(hint, value.first, tinystl::move(value.second));
+    }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last)
+    {
+      const size_type n = size();
+      append(first, last);
+      merge_tail(n);
+    }
+
+    iterator erase(const_iterator position)
+    {
+      const size_type i = index_of(position);
+      keys_.erase(keys_.begin() + i);
+      values_.erase(values_.begin() + i);
+      return make_iterator(i);
+    }
+    size_type erase(const key_type &key)
+    {
+      iterator it = find(key);
+      if (it == end())
+        return 0;
+      erase(it);
+      return 1;
+    }
+    iterator erase(const_iterator first, const_iterator last)
+    {
+      const size_type i = index_of(first);
+      const size_type j = index_of(last);
+      keys_.erase(keys_.begin() + i, keys_.begin() + j);
+      values_.erase(values_.begin() + i, values_.begin() + j);
+      return make_iterator(i);
+    }
+
+    void clear()
+    {
+      keys_.clear();
+      values_.clear();
+    }
+
+    // flat_map 相关操作
+
+    iterator find(const key_type &key)
+    {
+      const size_type i = lower_index(key);
+      return (i == size() || comp_(key, keys_[i])) ? end() : make_iterator(i);
+    }
+    const_iterator find(const key_type &key) const
+    {
+      const size_type i = lower_index(key);
+      return (i == size() || comp_(key, keys_[i])) ? end() : make_iterator(i);
+    }
+
+    size_type count(const key_type &key) const { return find(key) != end() ? 1 : 0; }
+
+    iterator lower_bound(const key_type &key) { return make_iterator(lower_index(key)); }
+    const_iterator lower_bound(const key_type &key) const { return make_iterator(lower_index(key)); }
+
+    iterator upper_bound(const key_type &key) { return make_iterator(upper_index(key)); }
+    const_iterator upper_bound(const key_type &key) const { return make_iterator(upper_index(key)); }
+
+    pair<iterator, iterator>
+    equal_range(const key_type &key)
+    {
+      iterator it = find(key);
+      return it == end() ? pair<iterator, iterator>(it, it) : pair<iterator, iterator>(it, it + 1);
+    }
+
+    pair<const_iterator, const_iterator>
+    equal_range(const key_type &key) const
+    {
+      const_iterator it = find(key);
+      return it == end() ? pair<const_iterator, const_iterator>(it, it)
+                         : pair<const_iterator, const_iterator>(it, it + 1);
+    }
+
+    void swap(flat_map &rhs) noexcept
+    {
+      keys_.swap(rhs.keys_);
+      values_.swap(rhs.values_);
+      tinystl::swap(comp_, rhs.comp_);
+    }
+
+  private:
+    // helper functions
+    iterator make_iterator(size_type i) noexcept
+    {
+      return iterator(keys_.data() + i, values_.data() + i);
+    }
+    const_iterator make_iterator(size_type i) const noexcept
+    {
+      return const_iterator(keys_.data() + i, values_.data() + i);
+    }
+    size_type index_of(const_iterator it) const noexcept
+    {
+      return static_cast<size_type>(it.key_ - keys_.data());
+    }
+    size_type lower_index(const key_type &key) const
+    {
+      return static_cast<size_type>(tinystl::lower_bound(keys_.begin(), keys_.end(), key, comp_) - keys_.begin());
+    }
+    size_type upper_index(const key_type &key) const
+    {
+      return static_cast<size_type>(tinystl::upper_bound(keys_.begin(), keys_.end(), key, comp_) - keys_.begin());
+    }
+
+    template <class K, class M>
+    void emplace_at(size_type i, K &&key, M &&value);
+    template <class K, class M>
+    pair<iterator, bool> insert_value(K &&key, M &&value);
+    template <class K, class M>
+    iterator insert_value_use_hint(iterator hint, K &&key, M &&value);
+    template <class InputIterator>
+    void append(InputIterator first, InputIterator last);
+    void merge_tail(size_type n);
+
+  public:
+    friend bool operator==(const flat_map &lhs, const flat_map &rhs)
+    {
+      return lhs.keys_ == rhs.keys_ && lhs.values_ == rhs.values_;
+    }
+    friend bool operator<(const flat_map &lhs, const flat_map &rhs)
+    {
+      return tinystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+  };
+
+  /*****************************************************************************************/
+  // helper function
+
+  // 在下标 i 处同时插入键值与实值，实值插入失败时撤销键值的插入
+  template <class Key, class T, class Compare>
+  template <class K, class M>
+  void flat_map<Key, T, Compare>::emplace_at(size_type i, K &&key, M &&value)
+  {
+    keys_.emplace(keys_.begin() + i, tinystl::forward<K>(key));
+    try
+    {
+      values_.emplace(values_.begin() + i, tinystl::forward<M>(value));
+    }
+    catch (...)
+    {
+      keys_.erase(keys_.begin() + i);
+      throw;
+    }
+  }
+
+  // 二分查找插入点，键值已存在时不插入
+  template <class Key, class T, class Compare>
+  template <class K, class M>
+  pair<typename flat_map<Key, T, Compare>::iterator, bool>
+  flat_map<Key, T, Compare>::insert_value(K &&key, M &&value)
+  {
+    const size_type i = lower_index(key);
+    if (i != size() && !comp_(key, keys_[i]))
+      return tinystl::make_pair(make_iterator(i), false);
+    emplace_at(i, tinystl::forward<K>(key), tinystl::forward<M>(value));
+    return tinystl::make_pair(make_iterator(i), true);
+  }
+
+  // hint 正好是插入点时省去二分查找
+  template <class Key, class T, class Compare>
+  template <class K, class M>
+  typename flat_map<Key, T, Compare>::iterator
+  flat_map<Key, T, Compare>::insert_value_use_hint(iterator hint, K &&key, M &&value)
+  {
+    const size_type i = index_of(hint);
+    if ((i == 0 || comp_(keys_[i - 1], key)) && (i == size() || comp_(key, keys_[i])))
+    {
+      emplace_at(i, tinystl::forward<K>(key), tinystl::forward<M>(value));
+      return make_iterator(i);
+    }
+    return insert_value(tinystl::forward<K>(key), tinystl::forward<M>(value)).first;
+  }
+
+  // 把 [first, last) 追加到尾部，失败时去掉已追加的元素
+  template <class Key, class T, class Compare>
+  template <class InputIterator>
+  void flat_map<Key, T, Compare>::append(InputIterator first, InputIterator last)
+  {
+    const size_type n = size();
+    try
+    {
+      for (; first != last; ++first)
+      {
+        keys_.emplace_back((*first).first);
+        values_.emplace_back((*first).second);
+      }
+    }
+    catch (...)
+    {
+      keys_.erase(keys_.begin() + n, keys_.end());
+      values_.erase(values_.begin() + n, values_.end());
+      throw;
+    }
+  }
+
+  // [0, n) 为原有的有序元素，[n, size()) 为新追加的元素
+  // 对新元素的下标稳定排序后与原有元素归并到新的数组，键值相等时保留原有元素或先追加的元素
+  template <class Key, class T, class Compare>
+  void flat_map<Key, T, Compare>::merge_tail(size_type n)
+  {
+    const size_type total = size();
+    if (n == total)
+      return;
+    // 新元素已经严格递增并且都大于原有元素，例如从有序区间构造
+    size_type i = n + 1;
+    while (i < total && comp_(keys_[i - 1], keys_[i]))
+      ++i;
+    if (i == total && (n == 0 || comp_(keys_[n - 1], keys_[n])))
+      return;
+
+    tinystl::vector<size_type> order(total - n);
+    for (size_type j = 0; j < order.size(); ++j)
+      order[j] = n + j;
+    try
+    {
+      tinystl::stable_sort(order.begin(), order.end(), [this](size_type a, size_type b)
+                           { return comp_(keys_[a], keys_[b]); });
+    }
+    catch (...)
+    {
+      keys_.erase(keys_.begin() + n, keys_.end());
+      values_.erase(values_.begin() + n, values_.end());
+      throw;
+    }
+
+    key_container_type new_keys;
+    mapped_container_type new_values;
+    new_keys.reserve(total);
+    new_values.reserve(total);
+    try
+    {
+      size_type first = 0, second = 0;
+      const size_type m = order.size();
+      while (first != n || second != m)
+      {
+        const size_type cur = (second == m || (first != n && !comp_(keys_[order[second]], keys_[first])))
+                                  ? first++
+                                  : order[second++];
+        if (!new_keys.empty() && !comp_(new_keys.back(), keys_[cur]))
+          continue;
+        new_keys.push_back(tinystl::move(keys_[cur]));
+        new_values.push_back(tinystl::move(values_[cur]));
+      }
+    }
+    catch (...)
+    {
+      // 部分元素已被移走，无法恢复原状
+      clear();
+      throw;
+    }
+    keys_.swap(new_keys);
+    values_.swap(new_values);
+  }
+
+  template <class Key, class T, class Compare>
+  bool operator!=(const flat_map<Key, T, Compare> &lhs, const flat_map<Key, T, Compare> &rhs)
+  {
+    return !(lhs == rhs);
+  }
+
+  template <class Key, class T, class Compare>
+  bool operator>(const flat_map<Key, T, Compare> &lhs, const flat_map<Key, T, Compare> &rhs)
+  {
+    return rhs < lhs;
+  }
+
+  template <class Key, class T, class Compare>
+  bool operator<=(const flat_map<Key, T, Compare> &lhs, const flat_map<Key, T, Compare> &rhs)
+  {
+    return !(rhs < lhs);
+  }
+
+  template <class Key, class T, class Compare>
+  bool operator>=(const flat_map<Key, T, Compare> &lhs, const flat_map<Key, T, Compare> &rhs)
+  {
+    return !(lhs < rhs);
+  }
+
+  // 重载 tinystl 的 swap
+  template <class Key, class T, class Compare>
+  void swap(flat_map<Key, T, Compare> &lhs, flat_map<Key, T, Compare> &rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+  /*****************************************************************************************/
+
+  // 模板类 flat_multimap，键值允许重复
+  // 参数一代表键值类型，参数二代表实值类型，参数三代表键值的比较方式，缺省使用 tinystl::less
+  template <class Key, class T, class Compare = tinystl::less<Key>>
+  class flat_multimap
+  {
+  public:
+    // flat_multimap 的型别定义
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef tinystl::pair<const Key, T> value_type;
+    typedef Compare key_compare;
+    typedef tinystl::vector<Key> key_container_type;
+    typedef tinystl::vector<T> mapped_container_type;
+
+    // 定义一个 functor，用来进行元素比较
+    class value_compare : public binary_function<value_type, value_type, bool>
+    {
+      friend class flat_multimap<Key, T, Compare>;
+
+    private:
+      Compare comp;
+      value_compare(Compare c) : comp(c) {}
+
+    public:
+      bool operator()(const value_type &lhs, const value_type &rhs) const
+      {
+        return comp(lhs.first, rhs.first); // 比较键值的大小
+      }
+    };
+
+    typedef flat_map_iterator<Key, T, T> iterator;
+    typedef flat_map_iterator<Key, T, const T> const_iterator;
+    typedef typename iterator::pointer pointer;
+    typedef typename const_iterator::pointer const_pointer;
+    typedef typename iterator::reference reference;
+    typedef typename const_iterator::reference const_reference;
+    typedef tinystl::reverse_iterator<iterator> reverse_iterator;
+    typedef tinystl::reverse_iterator<const_iterator> const_reverse_iterator;
+    typedef typename key_container_type::size_type size_type;
+    typedef typename key_container_type::difference_type difference_type;
+    typedef tinystl::allocator<value_type> allocator_type;
+
+  private:
+    key_container_type keys_;      // 按 comp_ 升序排列的键值，相等的键值按插入顺序排列
+    mapped_container_type values_; // 与 keys_ 下标对应的实值
+    key_compare comp_;
+
+  public:
+    // 构造、复制、移动函数
+
+    flat_multimap() = default;
+
+    template <class InputIterator>
+    flat_multimap(InputIterator first, InputIterator last)
+        : keys_(), values_(), comp_()
+    {
+      insert(first, last);
+    }
+
+    flat_multimap(std::initializer_list<value_type> ilist)
+        : keys_(), values_(), comp_()
+    {
+      insert(ilist.begin(), ilist.end());
+    }
+
+    flat_multimap(const flat_multimap &rhs)
+        : keys_(rhs.keys_), values_(rhs.values_), comp_(rhs.comp_)
+    {
+    }
+    flat_multimap(flat_multimap &&rhs) noexcept
+        : keys_(tinystl::move(rhs.keys_)), values_(tinystl::move(rhs.values_)), comp_(rhs.comp_)
+    {
+    }
+
+    flat_multimap &operator=(const flat_multimap &rhs)
+    {
+      if (this != &rhs)
+      {
+        flat_multimap tmp(rhs);
+        swap(tmp);
+      }
+      return *this;
+    }
+    flat_multimap &operator=(flat_multimap &&rhs)
+    {
+      keys_ = tinystl::move(rhs.keys_);
+      values_ = tinystl::move(rhs.values_);
+      comp_ = rhs.comp_;
+      return *this;
+    }
+
+    flat_multimap &operator=(std::initializer_list<value_type> ilist)
+    {
+      clear();
+      insert(ilist.begin(), ilist.end());
+      return *this;
+    }
+
+    // 相关接口
+
+    key_compare key_comp() const { return comp_; }
+    value_compare value_comp() const { return value_compare(comp_); }
+    allocator_type get_allocator() const { return allocator_type(); }
+    const key_container_type &keys() const noexcept { return keys_; }
+    const mapped_container_type &values() const noexcept { return values_; }
+
+    // 迭代器相关
+
+    iterator begin() noexcept { return make_iterator(0); }
+    const_iterator begin() const noexcept { return make_iterator(0); }
+    iterator end() noexcept { return make_iterator(size()); }
+    const_iterator end() const noexcept { return make_iterator(size()); }
+
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // 容量相关
+    bool empty() const noexcept { return keys_.empty(); }
+    size_type size() const noexcept { return keys_.size(); }
+    size_type max_size() const noexcept { return tinystl::min(keys_.max_size(), values_.max_size()); }
+    size_type capacity() const noexcept { return keys_.capacity(); }
+    void reserve(size_type n)
+    {
+      keys_.reserve(n);
+      values_.reserve(n);
+    }
+    void shrink_to_fit()
+    {
+      keys_.shrink_to_fit();
+      values_.shrink_to_fit();
+    }
+
+    // 插入删除操作
+
+    template <class... Args>
+    iterator emplace(Args &&...args)
+    {
+      value_type value(tinystl::forward<Args>(args)...);
+      return insert_value(value.first, tinystl::move(value.second));
+    }
+
+    template <class... Args>
+    iterator emplace_hint(iterator hint, Args &&...args)
+    {
+      value_type value(tinystl::forward<Args>(args)...);
+      return insert_value_use_hint(hint, value.first, tinystl::move(value.second));
+    }
+
+    iterator insert(const value_type &value)
+    {
+      return insert_value(value.first, value.second);
+    }
+    iterator insert(value_type &&value)
+    {
+      return insert_value(value.first, tinystl::move(value.second));
+    }
+
+    iterator insert(iterator hint, const value_type &value)
+    {
+      return insert_value_use_hint(hint, value.first, value.second);
+    }
+    iterator insert(iterator hint, value_type &&value)
+    {
+      return insert_value_use_hint(hint, value.first, tinystl::move(value.second));
+    }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last)
+    {
+      const size_type n = size();
+      append(first, last);
+      merge_tail(n);
+    }
+
+    iterator erase(const_iterator position)
+    {
+      const size_type i = index_of(position);
+      keys_.erase(keys_.begin() + i);
+      values_.erase(values_.begin() + i);
+      return make_iterator(i);
+    }
+    size_type erase(const key_type &key)
+    {
+      pair<iterator, iterator> p = equal_range(key);
+      const size_type n = static_cast<size_type>(p.second - p.first);
+      erase(p.first, p.second);
+      return n;
+    }
+    iterator erase(const_iterator first, const_iterator last)
+    {
+      const size_type i = index_of(first);
+      const size_type j = index_of(last);
+      keys_.erase(keys_.begin() + i, keys_.begin() + j);
+      values_.erase(values_.begin() + i, values_.begin() + j);
+      return make_iterator(i);
+    }
+
+    void clear()
+    {
+      keys_.clear();
+      values_.clear();
+    }
+
+    // flat_multimap 相关操作
+
+    iterator find(const key_type &key)
+    {
+      const size_type i = lower_index(key);
+      return (i == size() || comp_(key, keys_[i])) ? end() : make_iterator(i);
+    }
+    const_iterator find(const key_type &key) const
+    {
+      const size_type i = lower_index(key);
+      return (i == size() || comp_(key, keys_[i])) ? end() : make_iterator(i);
+    }
+
+    size_type count(const key_type &key) const { return upper_index(key) - lower_index(key); }
+
+    iterator lower_bound(const key_type &key) { return make_iterator(lower_index(key)); }
+    const_iterator lower_bound(const key_type &key) const { return make_iterator(lower_index(key)); }
+
+    iterator upper_bound(const key_type &key) { return make_iterator(upper_index(key)); }
+    const_iterator upper_bound(const key_type &key) const { return make_iterator(upper_index(key)); }
+
+    pair<iterator, iterator>
+    equal_range(const key_type &key)
+    {
+      return pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+    }
+
+    pair<const_iterator, const_iterator>
+    equal_range(const key_type &key) const
+    {
+      return pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+    }
+
+    void swap(flat_multimap &rhs) noexcept
+    {
+      keys_.swap(rhs.keys_);
+      values_.swap(rhs.values_);
+      tinystl::swap(comp_, rhs.comp_);
+    }
+
+  private:
+    // helper functions
+    iterator make_iterator(size_type i) noexcept
+    {
+      return iterator(keys_.data() + i, values_.data() + i);
+    }
+    const_iterator make_iterator(size_type i) const noexcept
+    {
+      return const_iterator(keys_.data() + i, values_.data() + i);
+    }
+    size_type index_of(const_iterator it) const noexcept
+    {
+      return static_cast<size_type>(it.key_ - keys_.data());
+    }
+    size_type lower_index(const key_type &key) const
+    {
+      return static_cast<size_type>(tinystl::lower_bound(keys_.begin(), keys_.end(), key, comp_) - keys_.begin());
+    }
+    size_type upper_index(const key_type &key) const
+    {
+      return static_cast<size_type>(tinystl::upper_bound(keys_.begin(), keys_.end(), key, comp_) - keys_.begin());
+    }
+
+    template <class K, class M>
+    void emplace_at(size_type i, K &&key, M &&value);
+    template <class K, class M>
+    iterator insert_value(K &&key, M &&value);
+    template <class K, class M>
+    iterator insert_value_use_hint(iterator hint, K &&key, M &&value);
+    template <class InputIterator>
+    void append(InputIterator first, InputIterator last);
+    void merge_tail(size_type n);
+
+  public:
+    friend bool operator==(const flat_multimap &lhs, const flat_multimap &rhs)
+    {
+      return lhs.keys_ == rhs.keys_ && lhs.values_ == rhs.values_;
+    }
+    friend bool operator<(const flat_multimap &lhs, const flat_multimap &rhs)
+    {
+      return tinystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+  };
+
+  /*****************************************************************************************/
+  // helper function
+
+  // 在下标 i 处同时插入键值与实值，实值插入失败时撤销键值的插入
+  template <class Key, class T, class Compare>
+  template <class K, class M>
+  void flat_multimap<Key, T, Compare>::emplace_at(size_type i, K &&key, M &&value)
+  {
+    keys_.emplace(keys_.begin() + i, tinystl::forward<K>(key));
+    try
+    {
+      values_.emplace(values_.begin() + i, tinystl::forward<M>(value));
+    }
+    catch (...)
+    {
+      keys_.erase(keys_.begin() + i);
+      throw;
+    }
+  }
+
+  // 新元素排在相等元素的最后
+  template <class Key, class T, class Compare>
+  template <class K, class M>
+  typename flat_multimap<Key, T, Compare>::iterator
+  flat_multimap<Key, T, Compare>::insert_value(K &&key, M &&value)
+  {
+    const size_type i = upper_index(key);
+    emplace_at(i, tinystl::forward<K>(key), tinystl::forward<M>(value));
+    return make_iterator(i);
+  }
+
+  // hint 满足 *(hint - 1) <= key <= *hint 时直接在 hint 处插入
+  template <class Key, class T, class Compare>
+  template <class K, class M>
+  typename flat_multimap<Key, T, Compare>::iterator
+  flat_multimap<Key, T, Compare>::insert_value_use_hint(iterator hint, K &&key, M &&value)
+  {
+    const size_type i = index_of(hint);
+    if ((i == 0 || !comp_(key, keys_[i - 1])) && (i == size() || !comp_(keys_[i], key)))
+    {
+      emplace_at(i, tinystl::forward<K>(key), tinystl::forward<M>(value));
+      return make_iterator(i);
+    }
+    return insert_value(tinystl::forward<K>(key), tinystl::forward<M>(value));
+  }
+
+  // 把 [first, last) 追加到尾部，失败时去掉已追加的元素
+  template <class Key, class T, class Compare>
+  template <class InputIterator>
+  void flat_multimap<Key, T, Compare>::append(InputIterator first, InputIterator last)
+  {
+    const size_type n = size();
+    try
+    {
+      for (; first != last; ++first)
+      {
+        keys_.emplace_back((*first).first);
+        values_.emplace_back((*first).second);
+      }
+    }
+    catch (...)
+    {
+      keys_.erase(keys_.begin() + n, keys_.end());
+      values_.erase(values_.begin() + n, values_.end());
+      throw;
+    }
+  }
+
+  // [0, n) 为原有的有序元素，[n, size()) 为新追加的元素
+  // 对新元素的下标稳定排序后与原有元素归并到新的数组，键值相等时原有元素在前
+  template <class Key, class T, class Compare>
+  void flat_multimap<Key, T, Compare>::merge_tail(size_type n)
+  {
+    const size_type total = size();
+    if (n == total)
+      return;
+    // 新元素已经有序并且不小于原有元素，例如从有序区间构造
+    size_type i = n + 1;
+    while (i < total && !comp_(keys_[i], keys_[i - 1]))
+      ++i;
+    if (i == total && (n == 0 || !comp_(keys_[n], keys_[n - 1])))
+      return;
+
+    tinystl::vector<size_type> order(total - n);
+    for (size_type j = 0; j < order.size(); ++j)
+      order[j] = n + j;
+    try
+    {
+      tinystl::stable_sort(order.begin(), order.end(), [this](size_type a, size_type b)
+                           { return comp_(keys_[a], keys_[b]); });
+    }
+    catch (...)
+    {
+      keys_.erase(keys_.begin() + n, keys_.end());
+      values_.erase(values_.begin() + n, values_.end());
+      throw;
+    }
+
+    key_container_type new_keys;
+    mapped_container_type new_values;
+    new_keys.reserve(total);
+    new_values.reserve(total);
+    try
+    {
+      size_type first = 0, second = 0;
+      const size_type m = order.size();
+      while (first != n || second != m)
+      {
+        const size_type cur = (second == m || (first != n && !comp_(keys_[order[second]], keys_[first])))
+                                  ? first++
+                                  : order[second++];
+        new_keys.push_back(tinystl::move(keys_[cur]));
+        new_values.push_back(tinystl::move(values_[cur]));
+      }
+    }
+    catch (...)
+    {
+      // 部分元素已被移走，无法恢复原状
+      clear();
+      throw;
+    }
+    keys_.swap(new_keys);
+    values_.swap(new_values);
+  }
+
+  template <class Key, class T, class Compare>
+  bool operator!=(const flat_multimap<Key, T, Compare> &lhs, const flat_multimap<Key, T, Compare> &rhs)
+  {
+    return !(lhs == rhs);
+  }
+
+  template <class Key, class T, class Compare>
+  bool operator>(const flat_multimap<Key, T, Compare> &lhs, const flat_multimap<Key, T, Compare> &rhs)
+  {
+    return rhs < lhs;
+  }
+
+  template <class Key, class T, class Compare>
+  bool operator<=(const flat_multimap<Key, T, Compare> &lhs, const flat_multimap<Key, T, Compare> &rhs)
+  {
+    return !(rhs < lhs);
+  }
+
+  template <class Key, class T, class Compare>
+  bool operator>=(const flat_multimap<Key, T, Compare> &lhs, const flat_multimap<Key, T, Compare> &rhs)
+  {
+    return !(lhs < rhs);
+  }
+
+  // 重载 tinystl 的 swap
+  template <class Key, class T, class Compare>
+  void swap(flat_multimap<Key, T, Compare> &lhs, flat_multimap<Key, T, Compare> &rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+} // namespace tinystl
+
+#endif // !TINYSTL_FLAT_MAP_H_
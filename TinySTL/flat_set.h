@@ -0,0 +1,675 @@
+#ifndef TINYSTL_FLAT_SET_H_
+#define TINYSTL_FLAT_SET_H_
+
+// 这个头文件包含两个模板类 flat_set 和 flat_multiset
+// flat_set      : 集合，键值即实值，键值不允许重复，接口与 set 相同
+// flat_multiset : 集合，键值即实值，键值允许重复，接口与 multiset 相同
+
+// notes:
+//
+// 1. 元素有序地存放在一个 tinystl::vector 中，查找使用二分，遍历是线性的内存扫描，每个元素没有额外开销
+// 2. 单个插入删除需要移动插入点之后的元素，复杂度为 O(n)，适合读多写少的场景
+// 3. 区间插入先把新元素追加到尾部，再对新元素排序，最后与原有元素归并，复杂度为 O(n + m log m)
+// 4. 任何插入删除都可能使所有迭代器失效，这一点与 set 不同
+// 5. 额外提供 reserve / capacity / shrink_to_fit 以及 keys()，用来访问底层的 vector
+
+#include "functional.h"
+#include "algo.h"
+#include "vector.h"
+#include "exceptdef.h"
+#include <initializer_list>
+
+namespace tinystl
+{
+
+  // 模板类 flat_set，键值不允许重复
+  // 参数一代表键值类型，参数二代表键值比较方式，缺省使用 tinystl::less
+  template <class Key, class Compare = tinystl::less<Key>>
+  class flat_set
+  {
+  public:
+    // flat_set 的型别定义
+    typedef Key key_type;
+    typedef Key value_type;
+    typedef Compare key_compare;
+    typedef Compare value_compare;
+    typedef tinystl::vector<Key> container_type;
+
+  private:
+    container_type keys_; // 按 comp_ 升序排列的元素
+    key_compare comp_;
+
+  public:
+    // 元素不允许修改，迭代器都是 const 的
+    typedef typename container_type::const_pointer pointer;
+    typedef typename container_type::const_pointer const_pointer;
+    typedef typename container_type::const_reference reference;
+    typedef typename container_type::const_reference const_reference;
+    typedef typename container_type::const_iterator iterator;
+    typedef typename container_type::const_iterator const_iterator;
+    typedef typename container_type::const_reverse_iterator reverse_iterator;
+    typedef typename container_type::const_reverse_iterator const_reverse_iterator;
+    typedef typename container_type::size_type size_type;
+    typedef typename container_type::difference_type difference_type;
+    typedef typename container_type::allocator_type allocator_type;
+
+  public:
+    // 构造、复制、移动函数
+    flat_set() = default;
+
+    template <class InputIterator>
+    flat_set(InputIterator first, InputIterator last)
+        : keys_(), comp_()
+    {
+      insert(first, last);
+    }
+    flat_set(std::initializer_list<value_type> ilist)
+        : keys_(), comp_()
+    {
+      insert(ilist.begin(), ilist.end());
+    }
+
+    flat_set(const flat_set &rhs)
+        : keys_(rhs.keys_), comp_(rhs.comp_)
+    {
+    }
+    flat_set(flat_set &&rhs) noexcept
+        : keys_(tinystl::move(rhs.keys_)), comp_(rhs.comp_)
+    {
+    }
+
+    flat_set &operator=(const flat_set &rhs)
+    {
+      keys_ = rhs.keys_;
+      comp_ = rhs.comp_;
+      return *this;
+    }
+    flat_set &operator=(flat_set &&rhs)
+    {
+      keys_ = tinystl::move(rhs.keys_);
+      comp_ = rhs.comp_;
+      return *this;
+    }
+    flat_set &operator=(std::initializer_list<value_type> ilist)
+    {
+      keys_.clear();
+      insert(ilist.begin(), ilist.end());
+      return *this;
+    }
+
+    // 相关接口
+
+    key_compare key_comp() const { return comp_; }
+    value_compare value_comp() const { return comp_; }
+    allocator_type get_allocator() const { return allocator_type(); }
+    const container_type &keys() const noexcept { return keys_; }
+
+    // 迭代器相关
+
+    iterator begin() noexcept { return keys_.cbegin(); }
+    const_iterator begin() const noexcept { return keys_.cbegin(); }
+    iterator end() noexcept { return keys_.cend(); }
+    const_iterator end() const noexcept { return keys_.cend(); }
+
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // 容量相关
+    bool empty() const noexcept { return keys_.empty(); }
+    size_type size() const noexcept { return keys_.size(); }
+    size_type max_size() const noexcept { return keys_.max_size(); }
+    size_type capacity() const noexcept { return keys_.capacity(); }
+    void reserve(size_type n) { keys_.reserve(n); }
+    void shrink_to_fit() { keys_.shrink_to_fit(); }
+
+    // 插入删除操作
+
+    template <class... Args>
+    pair<iterator, bool> emplace(Args &&...args)
+    {
+      return insert(value_type(tinystl::forward<Args>(args)...));
+    }
+
+    template <class... Args>
+    iterator emplace_hint(iterator hint, Args &&...args)
+    {
+      return insert(hint, value_type(tinystl::forward<Args>(args)...));
+    }
+
+    pair<iterator, bool> insert(const value_type &value)
+    {
+      return insert_value(value);
+    }
+    pair<iterator, bool> insert(value_type &&value)
+    {
+      return insert_value(tinystl::move(value));
+    }
+
+    iterator insert(iterator hint, const value_type &value)
+    {
+      return insert_value_use_hint(hint, value);
+    }
+    iterator insert(iterator hint, value_type &&value)
+    {
+      return insert_value_use_hint(hint, tinystl::move(value));
+    }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last)
+    {
+      const size_type n = keys_.size();
+      try
+      {
+        for (; first != last; ++first)
+          keys_.emplace_back(*first);
+      }
+      catch (...)
+      {
+        keys_.erase(keys_.begin() + n, keys_.end());
+        throw;
+      }
+      merge_tail(n);
+    }
+
+    iterator erase(iterator position) { return keys_.erase(position); }
+    size_type erase(const key_type &key)
+    {
+      iterator it = find(key);
+      if (it == end())
+        return 0;
+      keys_.erase(it);
+      return 1;
+    }
+    iterator erase(iterator first, iterator last) { return keys_.erase(first, last); }
+
+    void clear() { keys_.clear(); }
+
+    // flat_set 相关操作
+
+    iterator find(const key_type &key)
+    {
+      iterator it = lower_bound(key);
+      return (it == end() || comp_(key, *it)) ? end() : it;
+    }
+    const_iterator find(const key_type &key) const
+    {
+      const_iterator it = lower_bound(key);
+      return (it == end() || comp_(key, *it)) ? end() : it;
+    }
+
+    size_type count(const key_type &key) const { return find(key) != end() ? 1 : 0; }
+
+    iterator lower_bound(const key_type &key) { return tinystl::lower_bound(begin(), end(), key, comp_); }
+    const_iterator lower_bound(const key_type &key) const { return tinystl::lower_bound(begin(), end(), key, comp_); }
+
+    iterator upper_bound(const key_type &key) { return tinystl::upper_bound(begin(), end(), key, comp_); }
+    const_iterator upper_bound(const key_type &key) const { return tinystl::upper_bound(begin(), end(), key, comp_); }
+
+    pair<iterator, iterator>
+    equal_range(const key_type &key)
+    {
+      iterator it = find(key);
+      return it == end() ? pair<iterator, iterator>(it, it) : pair<iterator, iterator>(it, it + 1);
+    }
+
+    pair<const_iterator, const_iterator>
+    equal_range(const key_type &key) const
+    {
+      const_iterator it = find(key);
+      return it == end() ? pair<const_iterator, const_iterator>(it, it)
+                         : pair<const_iterator, const_iterator>(it, it + 1);
+    }
+
+    void swap(flat_set &rhs) noexcept
+    {
+      keys_.swap(rhs.keys_);
+      tinystl::swap(comp_, rhs.comp_);
+    }
+
+  private:
+    // helper functions
+    template <class V>
+    pair<iterator, bool> insert_value(V &&value);
+    template <class V>
+    iterator insert_value_use_hint(iterator hint, V &&value);
+    void merge_tail(size_type n);
+
+  public:
+    friend bool operator==(const flat_set &lhs, const flat_set &rhs) { return lhs.keys_ == rhs.keys_; }
+    friend bool operator<(const flat_set &lhs, const flat_set &rhs) { return lhs.keys_ < rhs.keys_; }
+  };
+
+  /*****************************************************************************************/
+  // helper function
+
+  // 二分查找插入点，键值已存在时不插入
+  template <class Key, class Compare>
+  template <class V>
+  pair<typename flat_set<Key, Compare>::iterator, bool>
+  flat_set<Key, Compare>::insert_value(V &&value)
+  {
+    iterator pos = lower_bound(value);
+    if (pos != end() && !comp_(value, *pos))
+      return tinystl::make_pair(pos, false);
+    return tinystl::make_pair(iterator(keys_.insert(pos, tinystl::forward<V>(value))), true);
+  }
+
+  // hint 正好是插入点时省去二分查找
+  template <class Key, class Compare>
+  template <class V>
+  typename flat_set<Key, Compare>::iterator
+  flat_set<Key, Compare>::insert_value_use_hint(iterator hint, V &&value)
+  {
+    if ((hint == begin() || comp_(*(hint - 1), value)) &&
+        (hint == end() || comp_(value, *hint)))
+      return keys_.insert(hint, tinystl::forward<V>(value));
+    return insert_value(tinystl::forward<V>(value)).first;
+  }
+
+  // [0, n) 为原有的有序元素，[n, size()) 为新追加的元素
+  // 对新元素稳定排序后与原有元素归并，键值相等时保留原有元素或先追加的元素
+  template <class Key, class Compare>
+  void flat_set<Key, Compare>::merge_tail(size_type n)
+  {
+    if (n == keys_.size())
+      return;
+    auto first = keys_.begin();
+    auto mid = first + n;
+    auto last = keys_.end();
+    try
+    {
+      tinystl::stable_sort(mid, last, comp_);
+    }
+    catch (...)
+    {
+      keys_.erase(mid, last);
+      throw;
+    }
+    if (n == 0 || comp_(*(mid - 1), *mid))
+    {
+      // 新元素全部排在原有元素之后，只需去掉新元素中的重复
+      auto result = mid;
+      for (auto cur = mid + 1; cur != last; ++cur)
+      {
+        if (comp_(*result, *cur) && ++result != cur)
+          *result = tinystl::move(*cur);
+      }
+      keys_.erase(result + 1, last);
+      return;
+    }
+    container_type tmp;
+    tmp.reserve(keys_.size());
+    try
+    {
+      auto first2 = mid;
+      while (first != mid || first2 != last)
+      {
+        auto cur = (first2 == last || (first != mid && !comp_(*first2, *first))) ? first++ : first2++;
+        if (tmp.empty() || comp_(tmp.back(), *cur))
+          tmp.push_back(tinystl::move(*cur));
+      }
+    }
+    catch (...)
+    {
+      // 部分元素已被移走，无法恢复原状
+      keys_.clear();
+      throw;
+    }
+    keys_.swap(tmp);
+  }
+
+  template <class Key, class Compare>
+  bool operator!=(const flat_set<Key, Compare> &lhs, const flat_set<Key, Compare> &rhs)
+  {
+    return !(lhs == rhs);
+  }
+
+  template <class Key, class Compare>
+  bool operator>(const flat_set<Key, Compare> &lhs, const flat_set<Key, Compare> &rhs)
+  {
+    return rhs < lhs;
+  }
+
+  template <class Key, class Compare>
+  bool operator<=(const flat_set<Key, Compare> &lhs, const flat_set<Key, Compare> &rhs)
+  {
+    return !(rhs < lhs);
+  }
+
+  template <class Key, class Compare>
+  bool operator>=(const flat_set<Key, Compare> &lhs, const flat_set<Key, Compare> &rhs)
+  {
+    return !(lhs < rhs);
+  }
+
+  // 重载 tinystl 的 swap
+  template <class Key, class Compare>
+  void swap(flat_set<Key, Compare> &lhs, flat_set<Key, Compare> &rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+  /*****************************************************************************************/
+
+  // 模板类 flat_multiset，键值允许重复
+  // 参数一代表键值类型，参数二代表键值比较方式，缺省使用 tinystl::less
+  template <class Key, class Compare = tinystl::less<Key>>
+  class flat_multiset
+  {
+  public:
+    // flat_multiset 的型别定义
+    typedef Key key_type;
+    typedef Key value_type;
+    typedef Compare key_compare;
+    typedef Compare value_compare;
+    typedef tinystl::vector<Key> container_type;
+
+  private:
+    container_type keys_; // 按 comp_ 升序排列的元素，相等的元素按插入顺序排列
+    key_compare comp_;
+
+  public:
+    // 元素不允许修改，迭代器都是 const 的
+    typedef typename container_type::const_pointer pointer;
+    typedef typename container_type::const_pointer const_pointer;
+    typedef typename container_type::const_reference reference;
+    typedef typename container_type::const_reference const_reference;
+    typedef typename container_type::const_iterator iterator;
+    typedef typename container_type::const_iterator const_iterator;
+    typedef typename container_type::const_reverse_iterator reverse_iterator;
+    typedef typename container_type::const_reverse_iterator const_reverse_iterator;
+    typedef typename container_type::size_type size_type;
+    typedef typename container_type::difference_type difference_type;
+    typedef typename container_type::allocator_type allocator_type;
+
+  public:
+    // 构造、复制、移动函数
+    flat_multiset() = default;
+
+    template <class InputIterator>
+    flat_multiset(InputIterator first, InputIterator last)
+        : keys_(), comp_()
+    {
+      insert(first, last);
+    }
+    flat_multiset(std::initializer_list<value_type> ilist)
+        : keys_(), comp_()
+    {
+      insert(ilist.begin(), ilist.end());
+    }
+
+    flat_multiset(const flat_multiset &rhs)
+        : keys_(rhs.keys_), comp_(rhs.comp_)
+    {
+    }
+    flat_multiset(flat_multiset &&rhs) noexcept
+        : keys_(tinystl::move(rhs.keys_)), comp_(rhs.comp_)
+    {
+    }
+
+    flat_multiset &operator=(const flat_multiset &rhs)
+    {
+      keys_ = rhs.keys_;
+      comp_ = rhs.comp_;
+      return *this;
+    }
+    flat_multiset &operator=(flat_multiset &&rhs)
+    {
+      keys_ = tinystl::move(rhs.keys_);
+      comp_ = rhs.comp_;
+      return *this;
+    }
+    flat_multiset &operator=(std::initializer_list<value_type> ilist)
+    {
+      keys_.clear();
+      insert(ilist.begin(), ilist.end());
+      return *this;
+    }
+
+    // 相关接口
+
+    key_compare key_comp() const { return comp_; }
+    value_compare value_comp() const { return comp_; }
+    allocator_type get_allocator() const { return allocator_type(); }
+    const container_type &keys() const noexcept { return keys_; }
+
+    // 迭代器相关
+
+    iterator begin() noexcept { return keys_.cbegin(); }
+    const_iterator begin() const noexcept { return keys_.cbegin(); }
+    iterator end() noexcept { return keys_.cend(); }
+    const_iterator end() const noexcept { return keys_.cend(); }
+
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // 容量相关
+    bool empty() const noexcept { return keys_.empty(); }
+    size_type size() const noexcept { return keys_.size(); }
+    size_type max_size() const noexcept { return keys_.max_size(); }
+    size_type capacity() const noexcept { return keys_.capacity(); }
+    void reserve(size_type n) { keys_.reserve(n); }
+    void shrink_to_fit() { keys_.shrink_to_fit(); }
+
+    // 插入删除操作
+
+    template <class... Args>
+    iterator emplace(Args &&...args)
+    {
+      return insert(value_type(tinystl::forward<Args>(args)...));
+    }
+
+    template <class... Args>
+    iterator emplace_hint(iterator hint, Args &&...args)
+    {
+      return insert(hint, value_type(tinystl::forward<Args>(args)...));
+    }
+
+    // 新元素排在相等元素的最后
+    iterator insert(const value_type &value)
+    {
+      return keys_.insert(upper_bound(value), value);
+    }
+    iterator insert(value_type &&value)
+    {
+      const_iterator pos = upper_bound(value);
+      return keys_.insert(pos, tinystl::move(value));
+    }
+
+    iterator insert(iterator hint, const value_type &value)
+    {
+      return keys_.insert(hint_position(hint, value), value);
+    }
+    iterator insert(iterator hint, value_type &&value)
+    {
+      const_iterator pos = hint_position(hint, value);
+      return keys_.insert(pos, tinystl::move(value));
+    }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last)
+    {
+      const size_type n = keys_.size();
+      try
+      {
+        for (; first != last; ++first)
+          keys_.emplace_back(*first);
+      }
+      catch (...)
+      {
+        keys_.erase(keys_.begin() + n, keys_.end());
+        throw;
+      }
+      merge_tail(n);
+    }
+
+    iterator erase(iterator position) { return keys_.erase(position); }
+    size_type erase(const key_type &key)
+    {
+      pair<iterator, iterator> p = equal_range(key);
+      const size_type n = static_cast<size_type>(p.second - p.first);
+      keys_.erase(p.first, p.second);
+      return n;
+    }
+    iterator erase(iterator first, iterator last) { return keys_.erase(first, last); }
+
+    void clear() { keys_.clear(); }
+
+    // flat_multiset 相关操作
+
+    iterator find(const key_type &key)
+    {
+      iterator it = lower_bound(key);
+      return (it == end() || comp_(key, *it)) ? end() : it;
+    }
+    const_iterator find(const key_type &key) const
+    {
+      const_iterator it = lower_bound(key);
+      return (it == end() || comp_(key, *it)) ? end() : it;
+    }
+
+    size_type count(const key_type &key) const
+    {
+      pair<const_iterator, const_iterator> p = equal_range(key);
+      return static_cast<size_type>(p.second - p.first);
+    }
+
+    iterator lower_bound(const key_type &key) { return tinystl::lower_bound(begin(), end(), key, comp_); }
+    const_iterator lower_bound(const key_type &key) const { return tinystl::lower_bound(begin(), end(), key, comp_); }
+
+    iterator upper_bound(const key_type &key) { return tinystl::upper_bound(begin(), end(), key, comp_); }
+    const_iterator upper_bound(const key_type &key) const { return tinystl::upper_bound(begin(), end(), key, comp_); }
+
+    pair<iterator, iterator>
+    equal_range(const key_type &key)
+    {
+      iterator first = lower_bound(key);
+      return pair<iterator, iterator>(first, tinystl::upper_bound(first, end(), key, comp_));
+    }
+
+    pair<const_iterator, const_iterator>
+    equal_range(const key_type &key) const
+    {
+      const_iterator first = lower_bound(key);
+      return pair<const_iterator, const_iterator>(first, tinystl::upper_bound(first, end(), key, comp_));
+    }
+
+    void swap(flat_multiset &rhs) noexcept
+    {
+      keys_.swap(rhs.keys_);
+      tinystl::swap(comp_, rhs.comp_);
+    }
+
+  private:
+    // helper functions
+    const_iterator hint_position(iterator hint, const value_type &value) const;
+    void merge_tail(size_type n);
+
+  public:
+    friend bool operator==(const flat_multiset &lhs, const flat_multiset &rhs) { return lhs.keys_ == rhs.keys_; }
+    friend bool operator<(const flat_multiset &lhs, const flat_multiset &rhs) { return lhs.keys_ < rhs.keys_; }
+  };
+
+  /*****************************************************************************************/
+  // helper function
+
+  // hint 满足 *(hint - 1) <= value <= *hint 时直接在 hint 处插入，否则插在相等元素的最后
+  template <class Key, class Compare>
+  typename flat_multiset<Key, Compare>::const_iterator
+  flat_multiset<Key, Compare>::hint_position(iterator hint, const value_type &value) const
+  {
+    if ((hint == begin() || !comp_(value, *(hint - 1))) &&
+        (hint == end() || !comp_(*hint, value)))
+      return hint;
+    return upper_bound(value);
+  }
+
+  // [0, n) 为原有的有序元素，[n, size()) 为新追加的元素
+  // 对新元素稳定排序后与原有元素归并，键值相等时原有元素在前
+  template <class Key, class Compare>
+  void flat_multiset<Key, Compare>::merge_tail(size_type n)
+  {
+    if (n == keys_.size())
+      return;
+    auto first = keys_.begin();
+    auto mid = first + n;
+    auto last = keys_.end();
+    try
+    {
+      tinystl::stable_sort(mid, last, comp_);
+    }
+    catch (...)
+    {
+      keys_.erase(mid, last);
+      throw;
+    }
+    if (n == 0 || !comp_(*mid, *(mid - 1)))
+      return;
+    container_type tmp;
+    tmp.reserve(keys_.size());
+    try
+    {
+      auto first2 = mid;
+      while (first != mid || first2 != last)
+      {
+        auto cur = (first2 == last || (first != mid && !comp_(*first2, *first))) ? first++ : first2++;
+        tmp.push_back(tinystl::move(*cur));
+      }
+    }
+    catch (...)
+    {
+      // 部分元素已被移走，无法恢复原状
+      keys_.clear();
+      throw;
+    }
+    keys_.swap(tmp);
+  }
+
+  template <class Key, class Compare>
+  bool operator!=(const flat_multiset<Key, Compare> &lhs, const flat_multiset<Key, Compare> &rhs)
+  {
+    return !(lhs == rhs);
+  }
+
+  template <class Key, class Compare>
+  bool operator>(const flat_multiset<Key, Compare> &lhs, const flat_multiset<Key, Compare> &rhs)
+  {
+    return rhs < lhs;
+  }
+
+  template <class Key, class Compare>
+  bool operator<=(const flat_multiset<Key, Compare> &lhs, const flat_multiset<Key, Compare> &rhs)
+  {
+    return !(rhs < lhs);
+  }
+
+  template <class Key, class Compare>
+  bool operator>=(const flat_multiset<Key, Compare> &lhs, const flat_multiset<Key, Compare> &rhs)
+  {
+    return !(lhs < rhs);
+  }
+
+  // 重载 tinystl 的 swap
+  template <class Key, class Compare>
+  void swap(flat_multiset<Key, Compare> &lhs, flat_multiset<Key, Compare> &rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+} // namespace tinystl
+
+#endif // !TINYSTL_FLAT_SET_H_
@@ -0,0 +1,813 @@
+#ifndef TINYSTL_FORWARD_LIST_H_
+#define TINYSTL_FORWARD_LIST_H_
+
+// 这个头文件包含一个模板类 forward_list
+// forward_list : 单向链表，每个结点只有一个 next 指针
+
+// notes:
+//
+// 1. 与 list 相比每个结点少一个指针，每次链接操作少写一个指针
+// 2. 插入 / 删除都作用于给定位置之后，before_begin() 返回第一个元素之前的位置
+// 3. 与 std::forward_list 一样不保存元素个数，因此不提供 size()
+// 4. 结点通过模板参数 NodeAlloc 分配，缺省为 allocator<forward_list_node<T>>，
+//    可以换成结点池，只要求提供静态的 allocate(1) 与 deallocate(p)
+
+#include <initializer_list>
+
+#include "algobase.h"
+#include "allocator.h"
+#include "iterator.h"
+#include "memory.h"
+#include "utils.h"
+#include "exceptdef.h"
+
+namespace tinystl
+{
+  template <class T>
+  struct forward_list_node;
+  template <class T>
+  struct forward_list_node_base;
+
+  template <class T>
+  struct forward_list_node_traits
+  {
+    typedef forward_list_node_base<T> *base_ptr;
+    typedef forward_list_node<T> *node_ptr;
+  };
+
+  // forward_list 结点的链接部分，头结点只包含这一部分
+  template <class T>
+  struct forward_list_node_base
+  {
+    typedef typename forward_list_node_traits<T>::base_ptr base_ptr;
+    typedef typename forward_list_node_traits<T>::node_ptr node_ptr;
+
+    base_ptr next;
+
+    node_ptr as_node() { return static_cast<node_ptr>(this); }
+  };
+
+  template <class T>
+  struct forward_list_node : public forward_list_node_base<T>
+  {
+    typedef typename forward_list_node_traits<T>::base_ptr base_ptr;
+
+    T value;
+
+    base_ptr as_base() { return static_cast<base_ptr>(this); }
+  };
+
+  // forward_list 迭代器
+  template <class T>
+  struct forward_list_iterator : public tinystl::iterator<tinystl::forward_iterator_tag, T>
+  {
+    typedef T value_type;
+    typedef T *pointer;
+    typedef T &reference;
+    typedef typename forward_list_node_traits<T>::base_ptr base_ptr;
+    typedef forward_list_iterator<T> self;
+
+    base_ptr node_;
+
+    forward_list_iterator() noexcept : node_(nullptr) {}
+    forward_list_iterator(base_ptr x) noexcept : node_(x) {}
+
+    reference operator*() const { return node_->as_node()->value; }
+    pointer operator->() const { return &(operator*()); }
+
+    self &operator++()
+    {
+      TINYSTL_DEBUG(node_ != nullptr);
+      node_ = node_->next;
+      return *this;
+    }
+    self operator++(int)
+    {
+      self tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const self &rhs) const { return node_ == rhs.node_; }
+    bool operator!=(const self &rhs) const { return node_ != rhs.node_; }
+  };
+
+  template <class T>
+  struct forward_list_const_iterator : public tinystl::iterator<tinystl::forward_iterator_tag, T>
+  {
+    typedef T value_type;
+    typedef const T *pointer;
+    typedef const T &reference;
+    typedef typename forward_list_node_traits<T>::base_ptr base_ptr;
+    typedef forward_list_const_iterator<T> self;
+
+    base_ptr node_;
+
+    forward_list_const_iterator() noexcept : node_(nullptr) {}
+    forward_list_const_iterator(base_ptr x) noexcept : node_(x) {}
+    forward_list_const_iterator(const forward_list_iterator<T> &rhs) noexcept : node_(rhs.node_) {}
+
+    reference operator*() const { return node_->as_node()->value; }
+    pointer operator->() const { return &(operator*()); }
+
+    self &operator++()
+    {
+      TINYSTL_DEBUG(node_ != nullptr);
+      node_ = node_->next;
+      return *this;
+    }
+    self operator++(int)
+    {
+      self tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const self &rhs) const { return node_ == rhs.node_; }
+    bool operator!=(const self &rhs) const { return node_ != rhs.node_; }
+  };
+
+  // 模板类 forward_list
+  // 模板参数 T 代表数据类型，NodeAlloc 代表结点的分配器
+  template <class T, class NodeAlloc = tinystl::allocator<forward_list_node<T>>>
+  class forward_list
+  {
+  public:
+    typedef tinystl::allocator<T> allocator_type;
+    typedef tinystl::allocator<T> data_allocator;
+    typedef NodeAlloc node_allocator;
+
+    typedef typename allocator_type::value_type value_type;
+    typedef typename allocator_type::pointer pointer;
+    typedef typename allocator_type::const_pointer const_pointer;
+    typedef typename allocator_type::reference reference;
+    typedef typename allocator_type::const_reference const_reference;
+    typedef typename allocator_type::size_type size_type;
+    typedef typename allocator_type::difference_type difference_type;
+
+    typedef forward_list_iterator<T> iterator;
+    typedef forward_list_const_iterator<T> const_iterator;
+
+    typedef forward_list_node_base<T> base_type;
+    typedef typename forward_list_node_traits<T>::base_ptr base_ptr;
+    typedef typename forward_list_node_traits<T>::node_ptr node_ptr;
+
+    allocator_type get_allocator() { return allocator_type(); }
+
+  private:
+    base_type head_; // 头结点，head_.next 指向第一个元素
+
+  public:
+    // 构造、复制、移动、析构函数
+    forward_list() noexcept { head_.next = nullptr; }
+
+    explicit forward_list(size_type n)
+    {
+      head_.next = nullptr;
+      fill_init(n, value_type());
+    }
+
+    forward_list(size_type n, const value_type &value)
+    {
+      head_.next = nullptr;
+      fill_init(n, value);
+    }
+
+    template <class Iter, typename std::enable_if<
+                              tinystl::is_input_iterator<Iter>::value, int>::type = 0>
+    forward_list(Iter first, Iter last)
+    {
+      head_.next = nullptr;
+      copy_init(first, last);
+    }
+
+    forward_list(std::initializer_list<value_type> ilist)
+    {
+      head_.next = nullptr;
+      copy_init(ilist.begin(), ilist.end());
+    }
+
+    forward_list(const forward_list &rhs)
+    {
+      head_.next = nullptr;
+      copy_init(rhs.begin(), rhs.end());
+    }
+
+    forward_list(forward_list &&rhs) noexcept
+    {
+      head_.next = rhs.head_.next;
+      rhs.head_.next = nullptr;
+    }
+
+    forward_list &operator=(const forward_list &rhs)
+    {
+      if (this != &rhs)
+        assign(rhs.begin(), rhs.end());
+      return *this;
+    }
+
+    forward_list &operator=(forward_list &&rhs) noexcept
+    {
+      if (this != &rhs)
+      {
+        clear();
+        head_.next = rhs.head_.next;
+        rhs.head_.next = nullptr;
+      }
+      return *this;
+    }
+
+    forward_list &operator=(std::initializer_list<value_type> ilist)
+    {
+      assign(ilist.begin(), ilist.end());
+      return *this;
+    }
+
+    ~forward_list() { clear(); }
+
+  public:
+    // 迭代器相关操作
+    iterator before_begin() noexcept { return iterator(&head_); }
+    const_iterator before_begin() const noexcept { return const_iterator(header()); }
+    iterator begin() noexcept { return iterator(head_.next); }
+    const_iterator begin() const noexcept { return const_iterator(head_.next); }
+    iterator end() noexcept { return iterator(nullptr); }
+    const_iterator end() const noexcept { return const_iterator(nullptr); }
+
+    const_iterator cbefore_begin() const noexcept { return before_begin(); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    // 容量相关操作
+    bool empty() const noexcept { return head_.next == nullptr; }
+    size_type max_size() const noexcept { return static_cast<size_type>(-1); }
+
+    // 访问元素相关操作
+    reference front()
+    {
+      TINYSTL_DEBUG(!empty());
+      return *begin();
+    }
+    const_reference front() const
+    {
+      TINYSTL_DEBUG(!empty());
+      return *begin();
+    }
+
+    // 调整容器相关操作
+
+    // assign
+    void assign(size_type n, const value_type &value) { fill_assign(n, value); }
+    template <class Iter, typename std::enable_if<
+                              tinystl::is_input_iterator<Iter>::value, int>::type = 0>
+    void assign(Iter first, Iter last) { copy_assign(first, last); }
+    void assign(std::initializer_list<value_type> ilist) { copy_assign(ilist.begin(), ilist.end()); }
+
+    // emplace_front / emplace_after
+    template <class... Args>
+    void emplace_front(Args &&...args)
+    {
+      emplace_after(cbefore_begin(), tinystl::forward<Args>(args)...);
+    }
+
+    template <class... Args>
+    iterator emplace_after(const_iterator pos, Args &&...args)
+    {
+      node_ptr p = create_node(tinystl::forward<Args>(args)...);
+      link_after(pos.node_, p->as_base(), p->as_base());
+      return iterator(p->as_base());
+    }
+
+    // push_front / pop_front
+    void push_front(const value_type &value) { emplace_front(value); }
+    void push_front(value_type &&value) { emplace_front(tinystl::move(value)); }
+
+    void pop_front()
+    {
+      TINYSTL_DEBUG(!empty());
+      erase_after(cbefore_begin());
+    }
+
+    // insert_after
+    iterator insert_after(const_iterator pos, const value_type &value) { return emplace_after(pos, value); }
+    iterator insert_after(const_iterator pos, value_type &&value) { return emplace_after(pos, tinystl::move(value)); }
+    iterator insert_after(const_iterator pos, size_type n, const value_type &value);
+    template <class Iter, typename std::enable_if<
+                              tinystl::is_input_iterator<Iter>::value, int>::type = 0>
+    iterator insert_after(const_iterator pos, Iter first, Iter last);
+    iterator insert_after(const_iterator pos, std::initializer_list<value_type> ilist)
+    {
+      return insert_after(pos, ilist.begin(), ilist.end());
+    }
+
+    // erase_after / clear
+    iterator erase_after(const_iterator pos);
+    iterator erase_after(const_iterator first, const_iterator last);
+
+    void clear() { erase_after(cbefore_begin(), cend()); }
+
+    // resize
+    void resize(size_type new_size) { resize(new_size, value_type()); }
+    void resize(size_type new_size, const value_type &value);
+
+    void swap(forward_list &rhs) noexcept
+    {
+      tinystl::swap(head_.next, rhs.head_.next);
+    }
+
+    // forward_list 相关操作
+
+    void splice_after(const_iterator pos, forward_list &other);
+    void splice_after(const_iterator pos, forward_list &other, const_iterator it);
+    void splice_after(const_iterator pos, forward_list &other,
+                      const_iterator first, const_iterator last);
+
+    void remove(const value_type &value)
+    {
+      remove_if([&](const value_type &v)
+                { return v == value; });
+    }
+    template <class UnaryPredicate>
+    void remove_if(UnaryPredicate pred);
+
+    void unique()
+    {
+      unique([](const value_type &a, const value_type &b)
+             { return a == b; });
+    }
+    template <class BinaryPredicate>
+    void unique(BinaryPredicate pred);
+
+    void merge(forward_list &other)
+    {
+      merge(other, [](const value_type &a, const value_type &b)
+            { return a < b; });
+    }
+    template <class Compare>
+    void merge(forward_list &other, Compare comp);
+
+    void sort()
+    {
+      sort([](const value_type &a, const value_type &b)
+           { return a < b; });
+    }
+    template <class Compare>
+    void sort(Compare comp);
+
+    void reverse() noexcept;
+
+  private:
+    // helper functions
+
+    base_ptr header() const noexcept { return const_cast<base_ptr>(&head_); }
+
+    // create / destroy node
+    template <class... Args>
+    node_ptr create_node(Args &&...args);
+    void destroy_node(node_ptr p);
+
+    // initialize / assign
+    void fill_init(size_type n, const value_type &value);
+    template <class Iter>
+    void copy_init(Iter first, Iter last);
+    void fill_assign(size_type n, const value_type &value);
+    template <class Iter>
+    void copy_assign(Iter first, Iter last);
+
+    // 把 [first, last] 的结点连接在 pos 之后
+    static void link_after(base_ptr pos, base_ptr first, base_ptr last) noexcept
+    {
+      last->next = pos->next;
+      pos->next = first;
+    }
+
+    // sort / merge
+    template <class Compare>
+    static void merge_chain(base_ptr &a, base_ptr b, Compare &comp);
+  };
+
+  /*****************************************************************************************/
+
+  // 在 pos 之后插入 n 个元素
+  template <class T, class NodeAlloc>
+  typename forward_list<T, NodeAlloc>::iterator
+  forward_list<T, NodeAlloc>::insert_after(const_iterator pos, size_type n, const value_type &value)
+  {
+    base_ptr cur = pos.node_;
+    for (; n > 0; --n)
+      cur = emplace_after(const_iterator(cur), value).node_;
+    return iterator(cur);
+  }
+
+  // 在 pos 之后插入 [first, last) 内的元素，返回指向最后一个插入元素的迭代器
+  template <class T, class NodeAlloc>
+  template <class Iter, typename std::enable_if<
+                            tinystl::is_input_iterator<Iter>::value, int>::type>
+  typename forward_list<T, NodeAlloc>::iterator
+  forward_list<T, NodeAlloc>::insert_after(const_iterator pos, Iter first, Iter last)
+  {
+    base_ptr cur = pos.node_;
+    for (; first != last; ++first)
+      cur = emplace_after(const_iterator(cur), *first).node_;
+    return iterator(cur);
+  }
+
+  // 删除 pos 之后的一个元素
+  template <class T, class NodeAlloc>
+  typename forward_list<T, NodeAlloc>::iterator
+  forward_list<T, NodeAlloc>::erase_after(const_iterator pos)
+  {
+    TINYSTL_DEBUG(pos.node_ != nullptr && pos.node_->next != nullptr);
+    base_ptr n = pos.node_->next;
+    pos.node_->next = n->next;
+    destroy_node(n->as_node());
+    return iterator(pos.node_->next);
+  }
+
+  // 删除 (first, last) 内的元素
+  template <class T, class NodeAlloc>
+  typename forward_list<T, NodeAlloc>::iterator
+  forward_list<T, NodeAlloc>::erase_after(const_iterator first, const_iterator last)
+  {
+    base_ptr cur = first.node_->next;
+    first.node_->next = last.node_;
+    while (cur != last.node_)
+    {
+      base_ptr next = cur->next;
+      destroy_node(cur->as_node());
+      cur = next;
+    }
+    return iterator(last.node_);
+  }
+
+  // 重置容器大小
+  template <class T, class NodeAlloc>
+  void forward_list<T, NodeAlloc>::resize(size_type new_size, const value_type &value)
+  {
+    base_ptr prev = &head_;
+    for (; new_size > 0 && prev->next != nullptr; --new_size)
+      prev = prev->next;
+    if (new_size == 0)
+      erase_after(const_iterator(prev), cend());
+    else
+      insert_after(const_iterator(prev), new_size, value);
+  }
+
+  // 将 other 的全部元素接合于 pos 之后
+  template <class T, class NodeAlloc>
+  void forward_list<T, NodeAlloc>::splice_after(const_iterator pos, forward_list &other)
+  {
+    TINYSTL_DEBUG(this != &other);
+    if (!other.empty())
+    {
+      base_ptr first = other.head_.next;
+      base_ptr last = first;
+      while (last->next != nullptr)
+        last = last->next;
+      other.head_.next = nullptr;
+      link_after(pos.node_, first, last);
+    }
+  }
+
+  // 将 other 中 it 之后的一个元素接合于 pos 之后
+  template <class T, class NodeAlloc>
+  void forward_list<T, NodeAlloc>::splice_after(const_iterator pos, forward_list &,
+                                     const_iterator it)
+  {
+    base_ptr n = it.node_->next;
+    if (pos.node_ == it.node_ || pos.node_ == n)
+      return;
+    it.node_->next = n->next;
+    link_after(pos.node_, n, n);
+  }
+
+  // 将 other 中 (first, last) 内的元素接合于 pos 之后
+  template <class T, class NodeAlloc>
+  void forward_list<T, NodeAlloc>::splice_after(const_iterator pos, forward_list &,
+                                     const_iterator first, const_iterator last)
+  {
+    if (first == last || first.node_->next == last.node_)
+      return;
+    base_ptr f = first.node_->next;
+    base_ptr l = f;
+    while (l->next != last.node_)
+      l = l->next;
+    first.node_->next = last.node_;
+    link_after(pos.node_, f, l);
+  }
+
+  // 将一元操作 pred 为 true 的所有元素移除
+  template <class T, class NodeAlloc>
+  template <class UnaryPredicate>
+  void forward_list<T, NodeAlloc>::remove_if(UnaryPredicate pred)
+  {
+    base_ptr prev = &head_;
+    while (prev->next != nullptr)
+    {
+      if (pred(prev->next->as_node()->value))
+        erase_after(const_iterator(prev));
+      else
+        prev = prev->next;
+    }
+  }
+
+  // 移除相邻的满足 pred 为 true 的重复元素
+  template <class T, class NodeAlloc>
+  template <class BinaryPredicate>
+  void forward_list<T, NodeAlloc>::unique(BinaryPredicate pred)
+  {
+    base_ptr cur = head_.next;
+    if (cur == nullptr)
+      return;
+    while (cur->next != nullptr)
+    {
+      if (pred(cur->as_node()->value, cur->next->as_node()->value))
+        erase_after(const_iterator(cur));
+      else
+        cur = cur->next;
+    }
+  }
+
+  // 与另一个有序 forward_list 合并，相等时本容器的元素在前
+  template <class T, class NodeAlloc>
+  template <class Compare>
+  void forward_list<T, NodeAlloc>::merge(forward_list &other, Compare comp)
+  {
+    if (this != &other)
+    {
+      base_ptr b = other.head_.next;
+      other.head_.next = nullptr;
+      merge_chain(head_.next, b, comp);
+    }
+  }
+
+  // 自底向上的归并排序，不分配内存且保持稳定
+  // bins[i] 为空或是一条长度为 2^i 的有序链
+  template <class T, class NodeAlloc>
+  template <class Compare>
+  void forward_list<T, NodeAlloc>::sort(Compare comp)
+  {
+    if (head_.next == nullptr || head_.next->next == nullptr)
+      return;
+
+    base_ptr bins[64] = {};
+    size_type fill = 0;
+    base_ptr carry = nullptr;
+    base_ptr result = nullptr;
+    base_ptr cur = head_.next;
+    head_.next = nullptr;
+    try
+    {
+      while (cur != nullptr)
+      {
+        carry = cur;
+        cur = cur->next;
+        carry->next = nullptr;
+        size_type i = 0;
+        for (; i < fill && bins[i] != nullptr; ++i)
+        { // bins[i] 中的元素在 carry 之前，相等时排在前面
+          base_ptr c = carry;
+          carry = nullptr;
+          merge_chain(bins[i], c, comp);
+          carry = bins[i];
+          bins[i] = nullptr;
+        }
+        bins[i] = carry;
+        carry = nullptr;
+        if (i == fill)
+          ++fill;
+      }
+      // 从短到长合并，编号越大的 bin 中的元素越靠前
+      for (size_type i = 0; i < fill; ++i)
+      {
+        if (bins[i] == nullptr)
+          continue;
+        base_ptr r = result;
+        result = nullptr;
+        merge_chain(bins[i], r, comp);
+        result = bins[i];
+        bins[i] = nullptr;
+      }
+    }
+    catch (...)
+    {
+      // comp 抛出异常：把所有链首尾相接放回容器，元素不丢失但顺序不确定
+      base_ptr chains[3] = {carry, cur, result};
+      base_ptr tail = &head_;
+      for (size_type i = 0; i < 3 + fill; ++i)
+      {
+        base_ptr c = i < 3 ? chains[i] : bins[i - 3];
+        if (c == nullptr)
+          continue;
+        tail->next = c;
+        while (tail->next != nullptr)
+          tail = tail->next;
+      }
+      throw;
+    }
+    head_.next = result;
+  }
+
+  // 将 forward_list 反转
+  template <class T, class NodeAlloc>
+  void forward_list<T, NodeAlloc>::reverse() noexcept
+  {
+    base_ptr prev = nullptr;
+    base_ptr cur = head_.next;
+    while (cur != nullptr)
+    {
+      base_ptr next = cur->next;
+      cur->next = prev;
+      prev = cur;
+      cur = next;
+    }
+    head_.next = prev;
+  }
+
+  /*****************************************************************************************/
+  // helper function
+
+  // 创建结点
+  template <class T, class NodeAlloc>
+  template <class... Args>
+  typename forward_list<T, NodeAlloc>::node_ptr
+  forward_list<T, NodeAlloc>::create_node(Args &&...args)
+  {
+    node_ptr p = node_allocator::allocate(1);
+    try
+    {
+      data_allocator::construct(tinystl::address_of(p->value), tinystl::forward<Args>(args)...);
+      p->next = nullptr;
+    }
+    catch (...)
+    {
+      node_allocator::deallocate(p);
+      throw;
+    }
+    return p;
+  }
+
+  // 销毁结点
+  template <class T, class NodeAlloc>
+  void forward_list<T, NodeAlloc>::destroy_node(node_ptr p)
+  {
+    data_allocator::destroy(tinystl::address_of(p->value));
+    node_allocator::deallocate(p);
+  }
+
+  // 用 n 个元素初始化容器
+  template <class T, class NodeAlloc>
+  void forward_list<T, NodeAlloc>::fill_init(size_type n, const value_type &value)
+  {
+    try
+    {
+      insert_after(cbefore_begin(), n, value);
+    }
+    catch (...)
+    {
+      clear();
+      throw;
+    }
+  }
+
+  // 以 [first, last) 初始化容器
+  template <class T, class NodeAlloc>
+  template <class Iter>
+  void forward_list<T, NodeAlloc>::copy_init(Iter first, Iter last)
+  {
+    try
+    {
+      insert_after(cbefore_begin(), first, last);
+    }
+    catch (...)
+    {
+      clear();
+      throw;
+    }
+  }
+
+  // 用 n 个元素为容器赋值
+  template <class T, class NodeAlloc>
+  void forward_list<T, NodeAlloc>::fill_assign(size_type n, const value_type &value)
+  {
+    base_ptr prev = &head_;
+    for (; n > 0 && prev->next != nullptr; --n)
+    {
+      prev = prev->next;
+      prev->as_node()->value = value;
+    }
+    if (n > 0)
+      insert_after(const_iterator(prev), n, value);
+    else
+      erase_after(const_iterator(prev), cend());
+  }
+
+  // 复制 [first, last) 为容器赋值
+  template <class T, class NodeAlloc>
+  template <class Iter>
+  void forward_list<T, NodeAlloc>::copy_assign(Iter first, Iter last)
+  {
+    base_ptr prev = &head_;
+    for (; first != last && prev->next != nullptr; ++first)
+    {
+      prev = prev->next;
+      prev->as_node()->value = *first;
+    }
+    if (first != last)
+      insert_after(const_iterator(prev), first, last);
+    else
+      erase_after(const_iterator(prev), cend());
+  }
+
+  // 合并两条以 nullptr 结尾的有序链，结果写回 a，相等时 a 中的元素在前
+  // comp 抛出异常时 a 仍然包含两条链的全部结点
+  template <class T, class NodeAlloc>
+  template <class Compare>
+  void forward_list<T, NodeAlloc>::merge_chain(base_ptr &a, base_ptr b, Compare &comp)
+  {
+    base_type head;
+    base_ptr tail = &head;
+    base_ptr x = a;
+    try
+    {
+      while (x != nullptr && b != nullptr)
+      {
+        if (comp(b->as_node()->value, x->as_node()->value))
+        {
+          tail->next = b;
+          b = b->next;
+        }
+        else
+        {
+          tail->next = x;
+          x = x->next;
+        }
+        tail = tail->next;
+      }
+    }
+    catch (...)
+    {
+      tail->next = x;
+      while (tail->next != nullptr)
+        tail = tail->next;
+      tail->next = b;
+      a = head.next;
+      throw;
+    }
+    tail->next = x != nullptr ? x : b;
+    a = head.next;
+  }
+
+  // 重载比较操作符
+  template <class T, class NodeAlloc>
+  bool operator==(const forward_list<T, NodeAlloc> &lhs, const forward_list<T, NodeAlloc> &rhs)
+  {
+    auto f1 = lhs.cbegin();
+    auto f2 = rhs.cbegin();
+    auto l1 = lhs.cend();
+    auto l2 = rhs.cend();
+    for (; f1 != l1 && f2 != l2 && *f1 == *f2; ++f1, ++f2)
+      ;
+    return f1 == l1 && f2 == l2;
+  }
+
+  template <class T, class NodeAlloc>
+  bool operator!=(const forward_list<T, NodeAlloc> &lhs, const forward_list<T, NodeAlloc> &rhs)
+  {
+    return !(lhs == rhs);
+  }
+
+  template <class T, class NodeAlloc>
+  bool operator<(const forward_list<T, NodeAlloc> &lhs, const forward_list<T, NodeAlloc> &rhs)
+  {
+    return tinystl::lexicographical_compare(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend());
+  }
+
+  template <class T, class NodeAlloc>
+  bool operator>(const forward_list<T, NodeAlloc> &lhs, const forward_list<T, NodeAlloc> &rhs)
+  {
+    return rhs < lhs;
+  }
+
+  template <class T, class NodeAlloc>
+  bool operator<=(const forward_list<T, NodeAlloc> &lhs, const forward_list<T, NodeAlloc> &rhs)
+  {
+    return !(rhs < lhs);
+  }
+
+  template <class T, class NodeAlloc>
+  bool operator>=(const forward_list<T, NodeAlloc> &lhs, const forward_list<T, NodeAlloc> &rhs)
+  {
+    return !(lhs < rhs);
+  }
+
+  // 重载 tinystl 的 swap
+  template <class T, class NodeAlloc>
+  void swap(forward_list<T, NodeAlloc> &lhs, forward_list<T, NodeAlloc> &rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+} // namespace tinystl
+
+#endif // !TINYSTL_FORWARD_LIST_H_
@@ -0,0 +1,346 @@
+#ifndef TINYSTL_FROZEN_MAP_H_
+#define TINYSTL_FROZEN_MAP_H_
+
+// 这个头文件包含模板类 frozen_map
+// frozen_map : 只读映射，元素具有键值和实值，键值不允许重复，构造之后不能插入删除
+
+// notes:
+//
+// 1. 构造时把元素按键值排序、去重，键值按 Eytzinger（BFS）布局存放在一个 tinystl::vector 中，见 eytzinger.h
+//    实值按同样的顺序存放在另一个 tinystl::vector 中，查找只访问键值数组，cache line 里没有实值
+// 2. find / lower_bound / upper_bound 是无分支的查找，并预取后几层的节点
+// 3. 构造的输入已经按键值严格递增时（例如来自 map 或 flat_map）省去排序，复杂度为 O(n)，否则为 O(n log n)
+//    键值相等的元素只保留最先出现的一个
+// 4. 与 flat_map 一样，解引用迭代器得到的是代理对象 pair<const Key&, T&>，实值可以通过迭代器或 at() 修改
+// 5. 迭代器按照键值升序遍历，是双向迭代器，每一步均摊 O(1)
+
+#include "functional.h"
+#include "algo.h"
+#include "iterator.h"
+#include "vector.h"
+#include "eytzinger.h"
+#include "exceptdef.h"
+#include <initializer_list>
+
+namespace tinystl
+{
+
+  // frozen_map 的迭代器，同时指向键值数组与实值数组的同一层序下标，下标为 0 代表尾后位置
+  // Mapped 为 T 时是 iterator，为 const T 时是 const_iterator
+  template <class Key, class T, class Mapped>
+  struct frozen_map_iterator : public tinystl::iterator<bidirectional_iterator_tag, tinystl::pair<const Key, T>>
+  {
+    typedef tinystl::pair<const Key &, Mapped &> reference;
+    typedef frozen_map_iterator<Key, T, T> iterator;
+    typedef frozen_map_iterator<Key, T, const T> const_iterator;
+    typedef frozen_map_iterator<Key, T, Mapped> self;
+
+    // operator-> 返回的代理，保存一个 reference
+    struct pointer
+    {
+      reference ref;
+      const reference *operator->() const { return &ref; }
+    };
+
+    const Key *key_;
+    Mapped *value_;
+    size_t n_;
+    size_t k_;
+
+    // 构造函数
+    frozen_map_iterator() : key_(nullptr), value_(nullptr), n_(0), k_(0) {}
+    frozen_map_iterator(const Key *key, Mapped *value, size_t n, size_t k)
+        : key_(key), value_(value), n_(n), k_(k) {}
+    frozen_map_iterator(const iterator &rhs)
+        : key_(rhs.key_), value_(rhs.value_), n_(rhs.n_), k_(rhs.k_) {}
+
+    // 重载操作符
+    reference operator*() const { return reference(key_[k_ - 1], value_[k_ - 1]); }
+    pointer operator->() const { return pointer{operator*()}; }
+
+    self &operator++()
+    {
+      k_ = tinystl::eytzinger_next(k_, n_);
+      return *this;
+    }
+    self operator++(int)
+    {
+      self tmp = *this;
+      ++*this;
+      return tmp;
+    }
+    self &operator--()
+    {
+      k_ = tinystl::eytzinger_prev(k_, n_);
+      return *this;
+    }
+    self operator--(int)
+    {
+      self tmp = *this;
+      --*this;
+      return tmp;
+    }
+
+    friend bool operator==(const self &lhs, const self &rhs) { return lhs.k_ == rhs.k_; }
+    friend bool operator!=(const self &lhs, const self &rhs) { return lhs.k_ != rhs.k_; }
+  };
+
+  // 模板类 frozen_map
+  // 参数一代表键值类型，参数二代表实值类型，参数三代表键值的比较方式，缺省使用 tinystl::less
+  template <class Key, class T, class Compare = tinystl::less<Key>>
+  class frozen_map
+  {
+  public:
+    // frozen_map 的嵌套型别定义
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef tinystl::pair<const Key, T> value_type;
+    typedef Compare key_compare;
+    typedef tinystl::vector<Key> key_container_type;
+    typedef tinystl::vector<T> mapped_container_type;
+
+    typedef frozen_map_iterator<Key, T, T> iterator;
+    typedef frozen_map_iterator<Key, T, const T> const_iterator;
+    typedef typename iterator::pointer pointer;
+    typedef typename const_iterator::pointer const_pointer;
+    typedef typename iterator::reference reference;
+    typedef typename const_iterator::reference const_reference;
+    typedef tinystl::reverse_iterator<iterator> reverse_iterator;
+    typedef tinystl::reverse_iterator<const_iterator> const_reverse_iterator;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef tinystl::allocator<value_type> allocator_type;
+
+  private:
+    key_container_type keys_;      // Eytzinger 布局的键值
+    mapped_container_type values_; // 与 keys_ 下标对应的实值
+    key_compare comp_;
+
+  public:
+    // 构造、复制、移动、赋值函数
+
+    frozen_map() = default;
+
+    template <class InputIterator>
+    frozen_map(InputIterator first, InputIterator last, const key_compare &comp = key_compare())
+        : keys_(), values_(), comp_(comp)
+    {
+      build(first, last);
+    }
+
+    frozen_map(std::initializer_list<value_type> ilist, const key_compare &comp = key_compare())
+        : keys_(), values_(), comp_(comp)
+    {
+      build(ilist.begin(), ilist.end());
+    }
+
+    frozen_map(const frozen_map &rhs)
+        : keys_(rhs.keys_), values_(rhs.values_), comp_(rhs.comp_)
+    {
+    }
+    frozen_map(frozen_map &&rhs) noexcept
+        : keys_(tinystl::move(rhs.keys_)), values_(tinystl::move(rhs.values_)), comp_(rhs.comp_)
+    {
+    }
+
+    frozen_map &operator=(const frozen_map &rhs)
+    {
+      if (this != &rhs)
+      {
+        frozen_map tmp(rhs);
+        swap(tmp);
+      }
+      return *this;
+    }
+    frozen_map &operator=(frozen_map &&rhs)
+    {
+      keys_ = tinystl::move(rhs.keys_);
+      values_ = tinystl::move(rhs.values_);
+      comp_ = rhs.comp_;
+      return *this;
+    }
+
+    // 相关接口
+
+    key_compare key_comp() const { return comp_; }
+    allocator_type get_allocator() const { return allocator_type(); }
+    // 底层数组，按层序排列
+    const key_container_type &keys() const noexcept { return keys_; }
+    const mapped_container_type &values() const noexcept { return values_; }
+
+    // 迭代器相关
+
+    iterator begin() noexcept { return make_iterator(tinystl::eytzinger_first(size())); }
+    const_iterator begin() const noexcept { return make_iterator(tinystl::eytzinger_first(size())); }
+    iterator end() noexcept { return make_iterator(0); }
+    const_iterator end() const noexcept { return make_iterator(0); }
+
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // 容量相关
+    bool empty() const noexcept { return keys_.empty(); }
+    size_type size() const noexcept { return keys_.size(); }
+    size_type max_size() const noexcept { return tinystl::min(keys_.max_size(), values_.max_size()); }
+
+    // 访问元素相关
+
+    // 若键值不存在，at 会抛出一个异常
+    mapped_type &at(const key_type &key)
+    {
+      const size_type k = find_index(key);
+      THROW_OUT_OF_RANGE_IF(k == 0, "frozen_map<Key, T> no such element exists");
+      return values_[k - 1];
+    }
+    const mapped_type &at(const key_type &key) const
+    {
+      const size_type k = find_index(key);
+      THROW_OUT_OF_RANGE_IF(k == 0, "frozen_map<Key, T> no such element exists");
+      return values_[k - 1];
+    }
+
+    // frozen_map 相关操作
+
+    iterator find(const key_type &key) { return make_iterator(find_index(key)); }
+    const_iterator find(const key_type &key) const { return make_iterator(find_index(key)); }
+
+    size_type count(const key_type &key) const { return find_index(key) != 0 ? 1 : 0; }
+    bool contains(const key_type &key) const { return find_index(key) != 0; }
+
+    iterator lower_bound(const key_type &key)
+    {
+      return make_iterator(tinystl::eytzinger_lower_bound(keys_.data(), size(), key, comp_));
+    }
+    const_iterator lower_bound(const key_type &key) const
+    {
+      return make_iterator(tinystl::eytzinger_lower_bound(keys_.data(), size(), key, comp_));
+    }
+
+    iterator upper_bound(const key_type &key)
+    {
+      return make_iterator(tinystl::eytzinger_upper_bound(keys_.data(), size(), key, comp_));
+    }
+    const_iterator upper_bound(const key_type &key) const
+    {
+      return make_iterator(tinystl::eytzinger_upper_bound(keys_.data(), size(), key, comp_));
+    }
+
+    pair<iterator, iterator>
+    equal_range(const key_type &key)
+    {
+      iterator it = find(key);
+      if (it == end())
+        return pair<iterator, iterator>(it, it);
+      iterator next = it;
+      return pair<iterator, iterator>(it, ++next);
+    }
+
+    pair<const_iterator, const_iterator>
+    equal_range(const key_type &key) const
+    {
+      const_iterator it = find(key);
+      if (it == end())
+        return pair<const_iterator, const_iterator>(it, it);
+      const_iterator next = it;
+      return pair<const_iterator, const_iterator>(it, ++next);
+    }
+
+    void swap(frozen_map &rhs) noexcept
+    {
+      keys_.swap(rhs.keys_);
+      values_.swap(rhs.values_);
+      tinystl::swap(comp_, rhs.comp_);
+    }
+
+  private:
+    // helper functions
+    iterator make_iterator(size_type k) noexcept
+    {
+      return iterator(keys_.data(), values_.data(), size(), k);
+    }
+    const_iterator make_iterator(size_type k) const noexcept
+    {
+      return const_iterator(keys_.data(), values_.data(), size(), k);
+    }
+    // 键值所在的层序下标，不存在时返回 0
+    size_type find_index(const key_type &key) const
+    {
+      const size_type k = tinystl::eytzinger_lower_bound(keys_.data(), size(), key, comp_);
+      return (k == 0 || comp_(key, keys_[k - 1])) ? 0 : k;
+    }
+
+    template <class InputIterator>
+    void build(InputIterator first, InputIterator last);
+
+  public:
+    friend bool operator==(const frozen_map &lhs, const frozen_map &rhs)
+    {
+      return lhs.keys_ == rhs.keys_ && lhs.values_ == rhs.values_;
+    }
+    friend bool operator!=(const frozen_map &lhs, const frozen_map &rhs) { return !(lhs == rhs); }
+  };
+
+  /*****************************************************************************************/
+  // helper function
+
+  // 复制到临时数组中按键值排序去重，再按层序把键值与实值分别搬到 keys_ / values_
+  template <class Key, class T, class Compare>
+  template <class InputIterator>
+  void frozen_map<Key, T, Compare>::build(InputIterator first, InputIterator last)
+  {
+    typedef tinystl::pair<Key, T> entry;
+    tinystl::vector<entry> sorted;
+    for (; first != last; ++first)
+      sorted.emplace_back(first->first, first->second);
+    size_type n = sorted.size();
+    const key_compare comp = comp_;
+    size_type i = 1;
+    while (i < n && comp(sorted[i - 1].first, sorted[i].first))
+      ++i;
+    if (i < n)
+    {
+      // 稳定排序保证去重时留下的是最先出现的元素
+      tinystl::stable_sort(sorted.begin(), sorted.end(),
+                           [comp](const entry &a, const entry &b)
+                           { return comp(a.first, b.first); });
+      size_type j = 1;
+      for (i = 1; i < n; ++i)
+      {
+        if (comp(sorted[j - 1].first, sorted[i].first))
+        {
+          if (i != j)
+            sorted[j] = tinystl::move(sorted[i]);
+          ++j;
+        }
+      }
+      sorted.erase(sorted.begin() + j, sorted.end());
+      n = j;
+    }
+
+    tinystl::vector<size_t> rank;
+    tinystl::eytzinger_ranks(n, rank);
+    keys_.reserve(n);
+    values_.reserve(n);
+    for (size_type k = 0; k < n; ++k)
+    {
+      keys_.emplace_back(tinystl::move(sorted[rank[k]].first));
+      values_.emplace_back(tinystl::move(sorted[rank[k]].second));
+    }
+  }
+
+  // 重载 tinystl 的 swap
+  template <class Key, class T, class Compare>
+  void swap(frozen_map<Key, T, Compare> &lhs, frozen_map<Key, T, Compare> &rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+} // namespace tinystl
+#endif // !TINYSTL_FROZEN_MAP_H_
@@ -0,0 +1,266 @@
+#ifndef TINYSTL_FROZEN_SET_H_
+#define TINYSTL_FROZEN_SET_H_
+
+// 这个头文件包含模板类 frozen_set
+// frozen_set : 只读集合，键值即实值，键值不允许重复，构造之后不能插入删除
+
+// notes:
+//
+// 1. 构造时把元素排序、去重，再按 Eytzinger（BFS）布局存放在一个 tinystl::vector 中，见 eytzinger.h
+// 2. find / lower_bound / upper_bound 是无分支的查找，并预取后几层的节点，
+//    与 set 相比没有指针追逐，与有序数组上的二分查找相比前几层始终在 cache 中，分支预测也不会失败
+// 3. 构造的输入已经严格递增时（例如来自 set 或 flat_set）省去排序，复杂度为 O(n)，否则为 O(n log n)
+//    键值相等的元素只保留最先出现的一个
+// 4. 迭代器按照键值升序遍历，是双向迭代器，每一步均摊 O(1)，但不像 flat_set 那样是连续的内存扫描
+
+#include "functional.h"
+#include "algo.h"
+#include "iterator.h"
+#include "vector.h"
+#include "eytzinger.h"
+#include <initializer_list>
+
+namespace tinystl
+{
+
+  // frozen_set 的迭代器，保存数组首地址、元素个数与层序下标，下标为 0 代表尾后位置
+  template <class Key>
+  struct frozen_set_iterator : public tinystl::iterator<bidirectional_iterator_tag, Key>
+  {
+    typedef const Key *pointer;
+    typedef const Key &reference;
+    typedef frozen_set_iterator<Key> self;
+
+    const Key *base_;
+    size_t n_;
+    size_t k_;
+
+    // 构造函数
+    frozen_set_iterator() : base_(nullptr), n_(0), k_(0) {}
+    frozen_set_iterator(const Key *base, size_t n, size_t k) : base_(base), n_(n), k_(k) {}
+
+    // 重载操作符
+    reference operator*() const { return base_[k_ - 1]; }
+    pointer operator->() const { return &(operator*()); }
+
+    self &operator++()
+    {
+      k_ = tinystl::eytzinger_next(k_, n_);
+      return *this;
+    }
+    self operator++(int)
+    {
+      self tmp = *this;
+      ++*this;
+      return tmp;
+    }
+    self &operator--()
+    {
+      k_ = tinystl::eytzinger_prev(k_, n_);
+      return *this;
+    }
+    self operator--(int)
+    {
+      self tmp = *this;
+      --*this;
+      return tmp;
+    }
+
+    friend bool operator==(const self &lhs, const self &rhs) { return lhs.k_ == rhs.k_; }
+    friend bool operator!=(const self &lhs, const self &rhs) { return lhs.k_ != rhs.k_; }
+  };
+
+  // 模板类 frozen_set
+  // 参数一代表键值类型，参数二代表键值比较方式，缺省使用 tinystl::less
+  template <class Key, class Compare = tinystl::less<Key>>
+  class frozen_set
+  {
+  public:
+    // frozen_set 的型别定义
+    typedef Key key_type;
+    typedef Key value_type;
+    typedef Compare key_compare;
+    typedef Compare value_compare;
+    typedef tinystl::vector<Key> container_type;
+
+    // 元素不允许修改，迭代器都是 const 的
+    typedef const Key *pointer;
+    typedef const Key *const_pointer;
+    typedef const Key &reference;
+    typedef const Key &const_reference;
+    typedef frozen_set_iterator<Key> iterator;
+    typedef frozen_set_iterator<Key> const_iterator;
+    typedef tinystl::reverse_iterator<iterator> reverse_iterator;
+    typedef tinystl::reverse_iterator<const_iterator> const_reverse_iterator;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef tinystl::allocator<Key> allocator_type;
+
+  private:
+    container_type keys_; // Eytzinger 布局的元素
+    key_compare comp_;
+
+  public:
+    // 构造、复制、移动函数
+    frozen_set() = default;
+
+    template <class InputIterator>
+    frozen_set(InputIterator first, InputIterator last, const key_compare &comp = key_compare())
+        : keys_(), comp_(comp)
+    {
+      build(first, last);
+    }
+    frozen_set(std::initializer_list<value_type> ilist, const key_compare &comp = key_compare())
+        : keys_(), comp_(comp)
+    {
+      build(ilist.begin(), ilist.end());
+    }
+
+    frozen_set(const frozen_set &rhs)
+        : keys_(rhs.keys_), comp_(rhs.comp_)
+    {
+    }
+    frozen_set(frozen_set &&rhs) noexcept
+        : keys_(tinystl::move(rhs.keys_)), comp_(rhs.comp_)
+    {
+    }
+
+    frozen_set &operator=(const frozen_set &rhs)
+    {
+      keys_ = rhs.keys_;
+      comp_ = rhs.comp_;
+      return *this;
+    }
+    frozen_set &operator=(frozen_set &&rhs)
+    {
+      keys_ = tinystl::move(rhs.keys_);
+      comp_ = rhs.comp_;
+      return *this;
+    }
+
+    // 相关接口
+
+    key_compare key_comp() const { return comp_; }
+    value_compare value_comp() const { return comp_; }
+    allocator_type get_allocator() const { return allocator_type(); }
+    // 底层数组，按层序排列
+    const container_type &keys() const noexcept { return keys_; }
+
+    // 迭代器相关
+
+    const_iterator begin() const noexcept { return make_iterator(tinystl::eytzinger_first(size())); }
+    const_iterator end() const noexcept { return make_iterator(0); }
+
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // 容量相关
+    bool empty() const noexcept { return keys_.empty(); }
+    size_type size() const noexcept { return keys_.size(); }
+    size_type max_size() const noexcept { return keys_.max_size(); }
+
+    // frozen_set 相关操作
+
+    const_iterator find(const key_type &key) const
+    {
+      const size_type k = tinystl::eytzinger_lower_bound(keys_.data(), size(), key, comp_);
+      return (k == 0 || comp_(key, keys_[k - 1])) ? end() : make_iterator(k);
+    }
+
+    size_type count(const key_type &key) const { return find(key) != end() ? 1 : 0; }
+    bool contains(const key_type &key) const { return find(key) != end(); }
+
+    const_iterator lower_bound(const key_type &key) const
+    {
+      return make_iterator(tinystl::eytzinger_lower_bound(keys_.data(), size(), key, comp_));
+    }
+    const_iterator upper_bound(const key_type &key) const
+    {
+      return make_iterator(tinystl::eytzinger_upper_bound(keys_.data(), size(), key, comp_));
+    }
+
+    pair<const_iterator, const_iterator>
+    equal_range(const key_type &key) const
+    {
+      const_iterator it = find(key);
+      if (it == end())
+        return pair<const_iterator, const_iterator>(it, it);
+      const_iterator next = it;
+      return pair<const_iterator, const_iterator>(it, ++next);
+    }
+
+    void swap(frozen_set &rhs) noexcept
+    {
+      keys_.swap(rhs.keys_);
+      tinystl::swap(comp_, rhs.comp_);
+    }
+
+  private:
+    // helper functions
+    const_iterator make_iterator(size_type k) const noexcept
+    {
+      return const_iterator(keys_.data(), size(), k);
+    }
+
+    template <class InputIterator>
+    void build(InputIterator first, InputIterator last);
+
+  public:
+    friend bool operator==(const frozen_set &lhs, const frozen_set &rhs) { return lhs.keys_ == rhs.keys_; }
+    friend bool operator!=(const frozen_set &lhs, const frozen_set &rhs) { return !(lhs == rhs); }
+  };
+
+  /*****************************************************************************************/
+  // helper function
+
+  // 复制到临时数组中排序去重，再按层序搬到 keys_
+  template <class Key, class Compare>
+  template <class InputIterator>
+  void frozen_set<Key, Compare>::build(InputIterator first, InputIterator last)
+  {
+    container_type sorted;
+    for (; first != last; ++first)
+      sorted.emplace_back(*first);
+    size_type n = sorted.size();
+    size_type i = 1;
+    while (i < n && comp_(sorted[i - 1], sorted[i]))
+      ++i;
+    if (i < n)
+    {
+      // 稳定排序保证去重时留下的是最先出现的元素
+      tinystl::stable_sort(sorted.begin(), sorted.end(), comp_);
+      size_type j = 1;
+      for (i = 1; i < n; ++i)
+      {
+        if (comp_(sorted[j - 1], sorted[i]))
+        {
+          if (i != j)
+            sorted[j] = tinystl::move(sorted[i]);
+          ++j;
+        }
+      }
+      sorted.erase(sorted.begin() + j, sorted.end());
+      n = j;
+    }
+
+    tinystl::vector<size_t> rank;
+    tinystl::eytzinger_ranks(n, rank);
+    keys_.reserve(n);
+    for (size_type k = 0; k < n; ++k)
+      keys_.emplace_back(tinystl::move(sorted[rank[k]]));
+  }
+
+  // 重载 tinystl 的 swap
+  template <class Key, class Compare>
+  void swap(frozen_set<Key, Compare> &lhs, frozen_set<Key, Compare> &rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+} // namespace tinystl
+#endif // !TINYSTL_FROZEN_SET_H_
@@ -3,6 +3,11 @@
 
 // 这个头文件包含了 tinystl 的函数对象与哈希函数
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "utils.h"
 
 namespace tinystl
 {
@@ -17,34 +22,280 @@ namespace tinystl
   };
 
   // 函数对象：小于
-  template <class T>
+  template <class T = void>
   struct less : public binary_function<T, T, bool>
   {
     bool operator()(const T &x, const T &y) const { return x < y; }
   };
 
+  // less<void> 可以比较任意两个支持 < 的对象，用于关联容器的异构查找
+  template <>
+  struct less<void>
+  {
+    typedef void is_transparent;
+
+    template <class T, class U>
+    bool operator()(const T &x, const U &y) const { return x < y; }
+  };
+
    // 函数对象：等于
-  template <class T>
+  template <class T = void>
   struct equal_to : public binary_function<T, T, bool>
   {
     bool operator()(const T &x, const T &y) const { return x == y; }
   };
 
+  // equal_to<void> 可以比较任意两个支持 == 的对象，用于无序容器的异构查找
+  template <>
+  struct equal_to<void>
+  {
+    typedef void is_transparent;
+
+    template <class T, class U>
+    bool operator()(const T &x, const U &y) const { return x == y; }
+  };
+
   /*****************************************************************************************/
   // 哈希函数对象
 
-  // 对于大部分类型，hash function 什么都不做
+  // notes:
+  //
+  // 1. 整数、指针与浮点数先转成 64 位整数，再经过 hash_mix 混合（两次乘法与三次移位异或），
+  //    只取低位的 bucket 策略与开放寻址的表也能得到均匀的分布
+  // 2. 浮点数把 -0.0 与 0.0 视为相同，所有 NaN 视为相同
+  // 3. 字节串使用 wyhash（final 4），每 48 个字节做三次乘法，16 字节以内的短串只读两次
+  //    结果与字节序有关，不要把哈希值持久化或跨机器传递
+  // 4. 对于没有特化的类型，hash 什么都不做，需要自行提供哈希函数
+
+  // wyhash 使用的常数
+  static constexpr uint64_t hash_secret[4] = {
+      0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull};
+
+  // 计算 a * b 的 128 位乘积，低 64 位存入 a，高 64 位存入 b
+  inline void hash_mum(uint64_t &a, uint64_t &b) noexcept
+  {
+#ifdef __SIZEOF_INT128__
+    const unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+    a = static_cast<uint64_t>(r);
+    b = static_cast<uint64_t>(r >> 64);
+#else
+    const uint64_t ha = a >> 32, hb = b >> 32;
+    const uint64_t la = static_cast<uint32_t>(a), lb = static_cast<uint32_t>(b);
+    const uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    const uint64_t t = rl + (rm0 << 32);
+    uint64_t c = t < rl;
+    const uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    a = lo;
+    b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+  }
+
+  inline uint64_t hash_mum_xor(uint64_t a, uint64_t b) noexcept
+  {
+    hash_mum(a, b);
+    return a ^ b;
+  }
+
+  // 把一个 64 位整数混合为哈希值，使用 splitmix64 的终结函数
+  // 每个输入位翻转时每个输出位翻转的概率都接近 1/2，单次 128 位乘法做不到这一点
+  inline size_t hash_mix(uint64_t x) noexcept
+  {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return static_cast<size_t>(x);
+  }
+
+  // helper function
+  inline uint64_t hash_read8(const unsigned char *p) noexcept
+  {
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+    return v;
+  }
+  inline uint64_t hash_read4(const unsigned char *p) noexcept
+  {
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+  }
+  // 1 到 3 个字节
+  inline uint64_t hash_read3(const unsigned char *p, size_t k) noexcept
+  {
+    return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[k >> 1]) << 8) | p[k - 1];
+  }
+
+  // 计算 [p, p + len) 这段字节的哈希值
+  inline size_t hash_bytes(const void *key, size_t len, uint64_t seed = 0) noexcept
+  {
+    const unsigned char *p = static_cast<const unsigned char *>(key);
+    seed ^= hash_mum_xor(seed ^ hash_secret[0], hash_secret[1]);
+    uint64_t a, b;
+    if (len <= 16)
+    {
+      if (len >= 4)
+      {
+        a = (hash_read4(p) << 32) | hash_read4(p + ((len >> 3) << 2));
+        b = (hash_read4(p + len - 4) << 32) | hash_read4(p + len - 4 - ((len >> 3) << 2));
+      }
+      else if (len > 0)
+      {
+        a = hash_read3(p, len);
+        b = 0;
+      }
+      else
+      {
+        a = b = 0;
+      }
+    }
+    else
+    {
+      size_t i = len;
+      if (i > 48)
+      { // 三条独立的乘法链
+        uint64_t see1 = seed, see2 = seed;
+        do
+        {
+          seed = hash_mum_xor(hash_read8(p) ^ hash_secret[1], hash_read8(p + 8) ^ seed);
+          see1 = hash_mum_xor(hash_read8(p + 16) ^ hash_secret[2], hash_read8(p + 24) ^ see1);
+          see2 = hash_mum_xor(hash_read8(p + 32) ^ hash_secret[3], hash_read8(p + 40) ^ see2);
+          p += 48;
+          i -= 48;
+        } while (i > 48);
+        seed ^= see1 ^ see2;
+      }
+      while (i > 16)
+      {
+        seed = hash_mum_xor(hash_read8(p) ^ hash_secret[1], hash_read8(p + 8) ^ seed);
+        i -= 16;
+        p += 16;
+      }
+      // 最后 16 个字节，可能与已经处理过的部分重叠
+      a = hash_read8(p + i - 16);
+      b = hash_read8(p + i - 8);
+    }
+    a ^= hash_secret[1];
+    b ^= seed;
+    hash_mum(a, b);
+    return static_cast<size_t>(hash_mum_xor(a ^ hash_secret[0] ^ len, b ^ hash_secret[1]));
+  }
+
   template <class Key>
   struct hash
   {
   };
 
+  // 把 v 的哈希值合并到 seed 中，结果与合并的顺序有关
+  template <class T>
+  inline void hash_combine(size_t &seed, const T &v)
+  {
+    const uint64_t h = static_cast<uint64_t>(tinystl::hash<T>()(v));
+    seed = hash_mix(static_cast<uint64_t>(seed) * 0x9E3779B97F4A7C15ull + h);
+  }
+
+  // 指针，按地址计算，对齐造成的低位 0 由 hash_mix 混合掉
   template <class T>
   struct hash<T *>
   {
     size_t operator()(T *p) const noexcept
     {
-      return reinterpret_cast<size_t>(p);
+      return hash_mix(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(p)));
+    }
+  };
+
+  // 整数
+#define TINYSTL_INTEGER_HASH_FCN(Type)                       \
+  template <>                                                \
+  struct hash<Type>                                          \
+  {                                                          \
+    size_t operator()(Type val) const noexcept               \
+    {                                                        \
+      return hash_mix(static_cast<uint64_t>(val));           \
+    }                                                        \
+  };
+
+  TINYSTL_INTEGER_HASH_FCN(bool)
+  TINYSTL_INTEGER_HASH_FCN(char)
+  TINYSTL_INTEGER_HASH_FCN(signed char)
+  TINYSTL_INTEGER_HASH_FCN(unsigned char)
+  TINYSTL_INTEGER_HASH_FCN(wchar_t)
+  TINYSTL_INTEGER_HASH_FCN(char16_t)
+  TINYSTL_INTEGER_HASH_FCN(char32_t)
+  TINYSTL_INTEGER_HASH_FCN(short)
+  TINYSTL_INTEGER_HASH_FCN(unsigned short)
+  TINYSTL_INTEGER_HASH_FCN(int)
+  TINYSTL_INTEGER_HASH_FCN(unsigned int)
+  TINYSTL_INTEGER_HASH_FCN(long)
+  TINYSTL_INTEGER_HASH_FCN(unsigned long)
+  TINYSTL_INTEGER_HASH_FCN(long long)
+  TINYSTL_INTEGER_HASH_FCN(unsigned long long)
+
+#undef TINYSTL_INTEGER_HASH_FCN
+
+  // 浮点数，-0.0 与 0.0 相等，所有 NaN 视为相同
+  template <>
+  struct hash<float>
+  {
+    size_t operator()(float val) const noexcept
+    {
+      if (val == 0.0f)
+        return hash_mix(0);
+      if (val != val)
+        return hash_mix(0x7fc00000u);
+      uint32_t bits;
+      std::memcpy(&bits, &val, sizeof(bits));
+      return hash_mix(bits);
+    }
+  };
+
+  template <>
+  struct hash<double>
+  {
+    size_t operator()(double val) const noexcept
+    {
+      if (val == 0.0)
+        return hash_mix(0);
+      if (val != val)
+        return hash_mix(0x7ff8000000000000ull);
+      uint64_t bits;
+      std::memcpy(&bits, &val, sizeof(bits));
+      return hash_mix(bits);
+    }
+  };
+
+  // long double 的填充字节没有定义，转换为 double 后计算，相等的值仍然得到相同的哈希值
+  template <>
+  struct hash<long double>
+  {
+    size_t operator()(long double val) const noexcept
+    {
+      return hash<double>()(static_cast<double>(val));
+    }
+  };
+
+  // 字符串，按字符的字节计算
+  template <class CharT, class Traits, class Alloc>
+  struct hash<std::basic_string<CharT, Traits, Alloc>>
+  {
+    size_t operator()(const std::basic_string<CharT, Traits, Alloc> &s) const noexcept
+    {
+      return hash_bytes(s.data(), s.size() * sizeof(CharT));
+    }
+  };
+
+  // pair，依次合并两个成员的哈希值
+  template <class T1, class T2>
+  struct hash<pair<T1, T2>>
+  {
+    size_t operator()(const pair<T1, T2> &p) const
+    {
+      size_t seed = 0;
+      hash_combine(seed, p.first);
+      hash_combine(seed, p.second);
+      return seed;
     }
   };
 } // namespace tinystl
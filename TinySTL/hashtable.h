@@ -1,27 +1,43 @@
 #ifndef TINYSTL_HASHTABLE_H_
 #define TINYSTL_HASHTABLE_H_
 
+#include <cstdint>
 #include <initializer_list>
 
 #include "functional.h"
 #include "memory.h"
+#include "node_handle.h"
 #include "vector.h"
 #include "utils.h"
 #include "exceptdef.h"
 
 namespace tinystl
 {
+  // 节点中保存的完整哈希值，CacheHash 为 false 时为空基类，不占空间
+  template <bool CacheHash>
+  struct ht_hash_code_base
+  {
+  };
+
+  template <>
+  struct ht_hash_code_base<true>
+  {
+    size_t hash_code;
+  };
+
   // hashtable 节点的定义
-  template <class T>
-  struct hashtable_node
+  template <class T, bool CacheHash = false>
+  struct hashtable_node : public ht_hash_code_base<CacheHash>
   {
     hashtable_node *next;
     T value;
 
     hashtable_node() = default;
     hashtable_node(const T &n) : next(nullptr), value(n) {}
-    hashtable_node(const hashtable_node &node) : next(node.next), value(node.value) {}
-    hashtable_node(hashtable_node &&node) : next(node.next), value(tinystl::move(node.value))
+    hashtable_node(const hashtable_node &node)
+        : ht_hash_code_base<CacheHash>(node), next(node.next), value(node.value) {}
+    hashtable_node(hashtable_node &&node)
+        : ht_hash_code_base<CacheHash>(node), next(node.next), value(tinystl::move(node.value))
     {
       node.next = nullptr;
     }
@@ -91,32 +107,47 @@ namespace tinystl
     }
   };
 
+  // 是否在节点中保存键值的哈希值
+  // 保存后，rehash 与迭代器跨越 bucket 时不必重新计算哈希值，查找时先比较哈希值再调用 KeyEqual，
+  // 代价是每个节点多一个 size_t。缺省对标量以外的键值类型（例如字符串）保存，可以为具体的类型特化
+  template <class Key, class Hash>
+  struct ht_cache_hash_code : public m_bool_constant<!std::is_scalar<Key>::value>
+  {
+  };
+
+  template <class T, class Hash>
+  struct ht_node_traits
+  {
+    static constexpr bool cache_hash = ht_cache_hash_code<typename ht_value_traits<T>::key_type, Hash>::value;
+    typedef hashtable_node<T, cache_hash> node_type;
+  };
+
   // forward declaration
 
-  template <class T, class HashFun, class KeyEqual>
+  template <class T, class HashFun, class KeyEqual, class BucketPolicy>
   class hashtable;
 
-  template <class T, class HashFun, class KeyEqual>
+  template <class T, class HashFun, class KeyEqual, class BucketPolicy>
   struct ht_iterator;
 
-  template <class T, class HashFun, class KeyEqual>
+  template <class T, class HashFun, class KeyEqual, class BucketPolicy>
   struct ht_const_iterator;
 
-  template <class T>
+  template <class T, bool CacheHash>
   struct ht_local_iterator;
 
-  template <class T>
+  template <class T, bool CacheHash>
   struct ht_const_local_iterator;
 
   // ht_iterator
-  template <class T, class Hash, class KeyEqual>
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
   struct ht_iterator_base : public tinystl::iterator<tinystl::forward_iterator_tag, T>
   {
-    typedef tinystl::hashtable<T, Hash, KeyEqual> hashtable;
-    typedef ht_iterator_base<T, Hash, KeyEqual> base;
-    typedef tinystl::ht_iterator<T, Hash, KeyEqual> iterator;
-    typedef tinystl::ht_const_iterator<T, Hash, KeyEqual> const_iterator;
-    typedef hashtable_node<T> *node_ptr;
+    typedef tinystl::hashtable<T, Hash, KeyEqual, BucketPolicy> hashtable;
+    typedef ht_iterator_base<T, Hash, KeyEqual, BucketPolicy> base;
+    typedef tinystl::ht_iterator<T, Hash, KeyEqual, BucketPolicy> iterator;
+    typedef tinystl::ht_const_iterator<T, Hash, KeyEqual, BucketPolicy> const_iterator;
+    typedef typename ht_node_traits<T, Hash>::node_type *node_ptr;
     typedef hashtable *contain_ptr;
     typedef const node_ptr const_node_ptr;
     typedef const contain_ptr const_contain_ptr;
@@ -133,10 +164,10 @@ namespace tinystl
     bool operator!=(const base &rhs) const { return node != rhs.node; }
   };
 
-  template <class T, class Hash, class KeyEqual>
-  struct ht_iterator : public ht_iterator_base<T, Hash, KeyEqual>
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  struct ht_iterator : public ht_iterator_base<T, Hash, KeyEqual, BucketPolicy>
   {
-    typedef ht_iterator_base<T, Hash, KeyEqual> base;
+    typedef ht_iterator_base<T, Hash, KeyEqual, BucketPolicy> base;
     typedef typename base::hashtable hashtable;
     typedef typename base::iterator iterator;
     typedef typename base::const_iterator const_iterator;
@@ -192,12 +223,12 @@ namespace tinystl
 
     iterator &operator++()
     {
-      tinystl_DEBUG(node != nullptr);
+      TINYSTL_DEBUG(node != nullptr);
       const node_ptr old = node;
       node = node->next;
       if (node == nullptr)
       { // 如果下一个位置为空，跳到下一个 bucket 的起始处
-        auto index = ht->hash(value_traits::get_key(old->value));
+        auto index = ht->bucket_of(old);
         while (!node && ++index < ht->bucket_size_)
           node = ht->buckets_[index];
       }
@@ -211,10 +242,10 @@ namespace tinystl
     }
   };
 
-  template <class T, class Hash, class KeyEqual>
-  struct ht_const_iterator : public ht_iterator_base<T, Hash, KeyEqual>
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  struct ht_const_iterator : public ht_iterator_base<T, Hash, KeyEqual, BucketPolicy>
   {
-    typedef ht_iterator_base<T, Hash, KeyEqual> base;
+    typedef ht_iterator_base<T, Hash, KeyEqual, BucketPolicy> base;
     typedef typename base::hashtable hashtable;
     typedef typename base::iterator iterator;
     typedef typename base::const_iterator const_iterator;
@@ -270,12 +301,12 @@ namespace tinystl
 
     const_iterator &operator++()
     {
-      tinystl_DEBUG(node != nullptr);
+      TINYSTL_DEBUG(node != nullptr);
       const node_ptr old = node;
       node = node->next;
       if (node == nullptr)
       { // 如果下一个位置为空，跳到下一个 bucket 的起始处
-        auto index = ht->hash(value_traits::get_key(old->value));
+        auto index = ht->bucket_of(old);
         while (!node && ++index < ht->bucket_size_)
         {
           node = ht->buckets_[index];
@@ -292,7 +323,7 @@ namespace tinystl
   };
 
   // local iterator
-  template <class T>
+  template <class T, bool CacheHash>
   struct ht_local_iterator : public tinystl::iterator<tinystl::forward_iterator_tag, T>
   {
     typedef T value_type;
@@ -300,11 +331,11 @@ namespace tinystl
     typedef value_type &reference;
     typedef size_t size_type;
     typedef ptrdiff_t difference_type;
-    typedef hashtable_node<T> *node_ptr;
+    typedef hashtable_node<T, CacheHash> *node_ptr;
 
-    typedef ht_local_iterator<T> self;
-    typedef ht_local_iterator<T> local_iterator;
-    typedef ht_const_local_iterator<T> const_local_iterator;
+    typedef ht_local_iterator<T, CacheHash> self;
+    typedef ht_local_iterator<T, CacheHash> local_iterator;
+    typedef ht_const_local_iterator<T, CacheHash> const_local_iterator;
     node_ptr node;
 
     ht_local_iterator(node_ptr n)
@@ -325,7 +356,7 @@ namespace tinystl
 
     self &operator++()
     {
-      tinystl_DEBUG(node != nullptr);
+      TINYSTL_DEBUG(node != nullptr);
       node = node->next;
       return *this;
     }
@@ -341,7 +372,7 @@ namespace tinystl
     bool operator!=(const self &other) const { return node != other.node; }
   };
 
-  template <class T>
+  template <class T, bool CacheHash>
   struct ht_const_local_iterator : public tinystl::iterator<tinystl::forward_iterator_tag, T>
   {
     typedef T value_type;
@@ -349,11 +380,11 @@ namespace tinystl
     typedef const value_type &reference;
     typedef size_t size_type;
     typedef ptrdiff_t difference_type;
-    typedef const hashtable_node<T> *node_ptr;
+    typedef const hashtable_node<T, CacheHash> *node_ptr;
 
-    typedef ht_const_local_iterator<T> self;
-    typedef ht_local_iterator<T> local_iterator;
-    typedef ht_const_local_iterator<T> const_local_iterator;
+    typedef ht_const_local_iterator<T, CacheHash> self;
+    typedef ht_local_iterator<T, CacheHash> local_iterator;
+    typedef ht_const_local_iterator<T, CacheHash> const_local_iterator;
 
     node_ptr node;
 
@@ -375,7 +406,7 @@ namespace tinystl
 
     self &operator++()
     {
-      tinystl_DEBUG(node != nullptr);
+      TINYSTL_DEBUG(node != nullptr);
       node = node->next;
       return *this;
     }
@@ -494,13 +525,113 @@ namespace tinystl
     return pos == last ? *(last - 1) : *pos;
   }
 
+  /*****************************************************************************************/
+  // bucket 策略，决定 bucket 的数量以及哈希值到 bucket 下标的映射
+  // 每个策略提供以下接口，hashtable 在 bucket 数量改变时调用 reset，之后每次定位 bucket 都调用 index：
+  //   static size_t next_size(size_t n) : 不小于 n 的合法 bucket 数量
+  //   static size_t max_size()          : 最大的 bucket 数量
+  //   void reset(size_t n)              : bucket 数量变为 n，预先计算映射需要的常数
+  //   size_t index(size_t h) const      : 把哈希值 h 映射到 [0, n)
+
+  // ht_prime_policy : 缺省策略，bucket 数量取自 ht_prime_list，用取模映射
+  // 对哈希值的质量没有要求，但每次映射都是一次整数除法，64 位下需要数十个周期
+  struct ht_prime_policy
+  {
+    size_t n_;
+
+    ht_prime_policy() noexcept : n_(1) {}
+
+    static size_t next_size(size_t n) { return ht_next_prime(n); }
+    static size_t max_size() noexcept { return ht_prime_list[PRIME_NUM - 1]; }
+
+    void reset(size_t n) noexcept { n_ = n; }
+    size_t index(size_t h) const noexcept { return h % n_; }
+  };
+
+  // ht_fastmod_policy : bucket 数量同样取自 ht_prime_list，但不超过 2^32，
+  // 用 Lemire 的 fastmod 代替除法：预先计算 m = 2^64 / n + 1，之后 a % n 等于 ((m * a) mod 2^64) * n 的高 64 位
+  // 哈希值先折叠为 32 位，取模的结果与 % 完全相同，没有 128 位整数时退化为 %
+  struct ht_fastmod_policy
+  {
+    uint64_t m_;
+    uint32_t n_;
+
+    ht_fastmod_policy() noexcept : m_(0), n_(1) {}
+
+    static size_t next_size(size_t n)
+    {
+      const size_t p = ht_next_prime(n);
+      return p < max_size() ? p : max_size();
+    }
+    static size_t max_size() noexcept
+    {
+      return static_cast<size_t>(4294967291u); // 小于 2^32 的最大质数
+    }
+
+    void reset(size_t n) noexcept
+    {
+      n_ = static_cast<uint32_t>(n);
+      m_ = n_ != 0 ? UINT64_MAX / n_ + 1 : 0;
+    }
+
+    size_t index(size_t h) const noexcept
+    {
+      const uint32_t a = static_cast<uint32_t>(static_cast<uint64_t>(h) ^ (static_cast<uint64_t>(h) >> 32));
+#ifdef __SIZEOF_INT128__
+      const uint64_t lowbits = m_ * a;
+      return static_cast<size_t>((static_cast<unsigned __int128>(lowbits) * n_) >> 64);
+#else
+      return a % n_;
+#endif
+    }
+  };
+
+  // ht_power2_policy : bucket 数量为 2 的幂，用掩码取低位映射
+  // 只取低位时哈希值的高位不起作用，所以先做一次乘法与移位异或，把高位混入低位，
+  // 这样恒等哈希的连续整数或者低位相同的指针也能均匀分布
+  struct ht_power2_policy
+  {
+    size_t mask_;
+
+    ht_power2_policy() noexcept : mask_(0) {}
+
+    static size_t next_size(size_t n)
+    {
+      size_t p = 16;
+      while (p < n && p < max_size())
+        p <<= 1;
+      return p;
+    }
+    static size_t max_size() noexcept
+    {
+      return (static_cast<size_t>(-1) >> 1) + 1;
+    }
+
+    void reset(size_t n) noexcept { mask_ = n - 1; }
+
+    size_t index(size_t h) const noexcept
+    {
+#ifdef SYSTEM_64
+      h *= static_cast<size_t>(0x9E3779B97F4A7C15ull);
+      h ^= h >> 32;
+#else
+      h *= static_cast<size_t>(0x9E3779B9u);
+      h ^= h >> 16;
+#endif
+      return h & mask_;
+    }
+  };
+
+  /*****************************************************************************************/
+
   // 模板类 hashtable
   // 参数一代表数据类型，参数二代表哈希函数，参数三代表键值相等的比较函数
-  template <class T, class Hash, class KeyEqual>
+  // 参数四代表 bucket 策略，缺省使用 ht_prime_policy
+  template <class T, class Hash, class KeyEqual, class BucketPolicy = tinystl::ht_prime_policy>
   class hashtable
   {
-    friend struct tinystl::ht_iterator<T, Hash, KeyEqual>;
-    friend struct tinystl::ht_const_iterator<T, Hash, KeyEqual>;
+    friend struct tinystl::ht_iterator<T, Hash, KeyEqual, BucketPolicy>;
+    friend struct tinystl::ht_const_iterator<T, Hash, KeyEqual, BucketPolicy>;
 
   public:
     // hashtable 的型别定义
@@ -511,7 +642,10 @@ namespace tinystl
     typedef Hash hasher;
     typedef KeyEqual key_equal;
 
-    typedef hashtable_node<T> node_type;
+    // 为 true 时节点中保存哈希值，见 ht_cache_hash_code
+    static constexpr bool cache_hash = ht_node_traits<T, Hash>::cache_hash;
+
+    typedef typename ht_node_traits<T, Hash>::node_type node_type;
     typedef node_type *node_ptr;
     typedef tinystl::vector<node_ptr> bucket_type;
 
@@ -526,31 +660,83 @@ namespace tinystl
     typedef typename allocator_type::size_type size_type;
     typedef typename allocator_type::difference_type difference_type;
 
-    typedef tinystl::ht_iterator<T, Hash, KeyEqual> iterator;
-    typedef tinystl::ht_const_iterator<T, Hash, KeyEqual> const_iterator;
-    typedef tinystl::ht_local_iterator<T> local_iterator;
-    typedef tinystl::ht_const_local_iterator<T> const_local_iterator;
+    typedef tinystl::ht_iterator<T, Hash, KeyEqual, BucketPolicy> iterator;
+    typedef tinystl::ht_const_iterator<T, Hash, KeyEqual, BucketPolicy> const_iterator;
+    typedef tinystl::ht_local_iterator<T, cache_hash> local_iterator;
+    typedef tinystl::ht_const_local_iterator<T, cache_hash> const_local_iterator;
+
+    typedef tinystl::node_handle<node_type, value_type> node_handle_type;
+    typedef tinystl::node_insert_return<iterator, node_handle_type> insert_return_type;
 
     allocator_type get_allocator() const { return allocator_type(); }
 
   private:
-    // 用以下六个参数来表现 hashtable
+    // 用以下七个参数来表现 hashtable
     bucket_type buckets_;
     size_type bucket_size_;
+    BucketPolicy policy_; // 与 bucket_size_ 对应的映射方式
     size_type size_;
     float mlf_;
     hasher hash_;
     key_equal equal_;
 
   private:
-    bool is_equal(const key_type &key1, const key_type &key2)
+    template <class K1, class K2>
+    bool is_equal(const K1 &key1, const K2 &key2) const
     {
       return equal_(key1, key2);
     }
 
-    bool is_equal(const key_type &key1, const key_type &key2) const
+    // 节点 p 的键值是否等于 key，code 为 key 的哈希值，节点保存了哈希值时先比较哈希值
+    template <class K>
+    bool node_equal(const node_type *p, size_t code, const K &key) const
     {
-      return equal_(key1, key2);
+      return node_equal_dispatch(p, code, key, m_bool_constant<cache_hash>());
+    }
+    template <class K>
+    bool node_equal_dispatch(const node_type *p, size_t code, const K &key, m_true_type) const
+    {
+      return p->hash_code == code && is_equal(value_traits::get_key(p->value), key);
+    }
+    template <class K>
+    bool node_equal_dispatch(const node_type *p, size_t, const K &key, m_false_type) const
+    {
+      return is_equal(value_traits::get_key(p->value), key);
+    }
+
+    // 节点 p 的哈希值，节点没有保存时重新计算
+    size_t node_hash(const node_type *p) const
+    {
+      return node_hash_dispatch(p, m_bool_constant<cache_hash>());
+    }
+    size_t node_hash_dispatch(const node_type *p, m_true_type) const { return p->hash_code; }
+    size_t node_hash_dispatch(const node_type *p, m_false_type) const
+    {
+      return hash_(value_traits::get_key(p->value));
+    }
+
+    // 保存哈希值，节点不保存哈希值时什么都不做
+    void store_hash(node_type *p, size_t code) const
+    {
+      store_hash_dispatch(p, code, m_bool_constant<cache_hash>());
+    }
+    void store_hash_dispatch(node_type *p, size_t code, m_true_type) const { p->hash_code = code; }
+    void store_hash_dispatch(node_type *, size_t, m_false_type) const {}
+
+    void copy_hash(node_type *to, const node_type *from) const
+    {
+      copy_hash_dispatch(to, from, m_bool_constant<cache_hash>());
+    }
+    void copy_hash_dispatch(node_type *to, const node_type *from, m_true_type) const
+    {
+      to->hash_code = from->hash_code;
+    }
+    void copy_hash_dispatch(node_type *, const node_type *, m_false_type) const {}
+
+    // 节点 p 所在的 bucket
+    size_type bucket_of(const node_type *p) const
+    {
+      return policy_.index(node_hash(p));
     }
 
     const_iterator M_cit(node_ptr node) const noexcept
@@ -606,6 +792,7 @@ namespace tinystl
     }
     hashtable(hashtable &&rhs) noexcept
         : bucket_size_(rhs.bucket_size_),
+          policy_(rhs.policy_),
           size_(rhs.size_),
           mlf_(rhs.mlf_),
           hash_(rhs.hash_),
@@ -719,7 +906,7 @@ namespace tinystl
     }
     iterator insert_unique_use_hint(const_iterator /*hint*/, value_type &&value)
     {
-      return emplace_unique(tinystl::move(value));
+      return emplace_unique(tinystl::move(value)).first;
     }
 
     template <class InputIter>
@@ -744,52 +931,80 @@ namespace tinystl
 
     void clear();
 
+    // 节点句柄，节点在容器之间转移时只重新链接，不分配内存也不复制元素
+
+    node_handle_type extract(const_iterator position);
+    node_handle_type extract(const key_type &key);
+
+    insert_return_type insert_unique(node_handle_type &&nh);
+    iterator insert_multi(node_handle_type &&nh);
+
+    // [note]: 同 emplace_hint，插入失败时节点仍由 nh 持有
+    iterator insert_unique_use_hint(const_iterator /*hint*/, node_handle_type &&nh);
+    iterator insert_multi_use_hint(const_iterator /*hint*/, node_handle_type &&nh)
+    {
+      return insert_multi(tinystl::move(nh));
+    }
+
+    // 把 source 中的节点移入本表，用于键值不重复的表时，键值已存在的节点留在 source 中
+    void merge_unique(hashtable &source);
+    void merge_multi(hashtable &source);
+
     void swap(hashtable &rhs) noexcept;
 
     // 查找相关操作
+    // 参数类型 K 通常为 key_type，哈希函数与相等比较函数都带有 is_transparent 标记时，
+    // 容器可以直接传入其它类型，它的哈希值必须与等价的键值相同
 
-    size_type count(const key_type &key) const;
+    template <class K>
+    size_type count(const K &key) const;
 
-    iterator find(const key_type &key);
-    const_iterator find(const key_type &key) const;
+    template <class K>
+    iterator find(const K &key);
+    template <class K>
+    const_iterator find(const K &key) const;
 
-    pair<iterator, iterator> equal_range_multi(const key_type &key);
-    pair<const_iterator, const_iterator> equal_range_multi(const key_type &key) const;
+    template <class K>
+    pair<iterator, iterator> equal_range_multi(const K &key);
+    template <class K>
+    pair<const_iterator, const_iterator> equal_range_multi(const K &key) const;
 
-    pair<iterator, iterator> equal_range_unique(const key_type &key);
-    pair<const_iterator, const_iterator> equal_range_unique(const key_type &key) const;
+    template <class K>
+    pair<iterator, iterator> equal_range_unique(const K &key);
+    template <class K>
+    pair<const_iterator, const_iterator> equal_range_unique(const K &key) const;
 
     // bucket interface
 
     local_iterator begin(size_type n) noexcept
     {
-      tinystl_DEBUG(n < size_);
+      TINYSTL_DEBUG(n < bucket_size_);
       return buckets_[n];
     }
     const_local_iterator begin(size_type n) const noexcept
     {
-      tinystl_DEBUG(n < size_);
+      TINYSTL_DEBUG(n < bucket_size_);
       return buckets_[n];
     }
     const_local_iterator cbegin(size_type n) const noexcept
     {
-      tinystl_DEBUG(n < size_);
+      TINYSTL_DEBUG(n < bucket_size_);
       return buckets_[n];
     }
 
     local_iterator end(size_type n) noexcept
     {
-      tinystl_DEBUG(n < size_);
+      TINYSTL_DEBUG(n < bucket_size_);
       return nullptr;
     }
     const_local_iterator end(size_type n) const noexcept
     {
-      tinystl_DEBUG(n < size_);
+      TINYSTL_DEBUG(n < bucket_size_);
       return nullptr;
     }
     const_local_iterator cend(size_type n) const noexcept
     {
-      tinystl_DEBUG(n < size_);
+      TINYSTL_DEBUG(n < bucket_size_);
       return nullptr;
     }
 
@@ -799,7 +1014,7 @@ namespace tinystl
     }
     size_type max_bucket_count() const noexcept
     {
-      return ht_prime_list[PRIME_NUM - 1];
+      return BucketPolicy::max_size();
     }
 
     size_type bucket_size(size_type n) const noexcept;
@@ -846,11 +1061,12 @@ namespace tinystl
     template <class... Args>
     node_ptr create_node(Args &&...args);
     void destroy_node(node_ptr n);
+    void unlink_node(node_ptr p);
 
     // hash
     size_type next_size(size_type n) const;
-    size_type hash(const key_type &key, size_type n) const;
-    size_type hash(const key_type &key) const;
+    template <class K>
+    size_type hash(const K &key) const;
     void rehash_if_need(size_type n);
 
     // insert
@@ -879,9 +1095,9 @@ namespace tinystl
 
   /*****************************************************************************************/
   // 复制赋值运算符
-  template <class T, class Hash, class KeyEqual>
-  hashtable<T, Hash, KeyEqual> &
-  hashtable<T, Hash, KeyEqual>::
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  hashtable<T, Hash, KeyEqual, BucketPolicy> &
+  hashtable<T, Hash, KeyEqual, BucketPolicy>::
   operator=(const hashtable &rhs)
   {
     if (this != &rhs)
@@ -893,9 +1109,9 @@ namespace tinystl
   }
 
   // 移动赋值运算符
-  template <class T, class Hash, class KeyEqual>
-  hashtable<T, Hash, KeyEqual> &
-  hashtable<T, Hash, KeyEqual>::
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  hashtable<T, Hash, KeyEqual, BucketPolicy> &
+  hashtable<T, Hash, KeyEqual, BucketPolicy>::
   operator=(hashtable &&rhs) noexcept
   {
     hashtable tmp(tinystl::move(rhs));
@@ -905,10 +1121,10 @@ namespace tinystl
 
   // 就地构造元素，键值允许重复
   // 强异常安全保证
-  template <class T, class Hash, class KeyEqual>
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
   template <class... Args>
-  typename hashtable<T, Hash, KeyEqual>::iterator
-  hashtable<T, Hash, KeyEqual>::
+  typename hashtable<T, Hash, KeyEqual, BucketPolicy>::iterator
+  hashtable<T, Hash, KeyEqual, BucketPolicy>::
       emplace_multi(Args &&...args)
   {
     auto np = create_node(tinystl::forward<Args>(args)...);
@@ -927,10 +1143,10 @@ namespace tinystl
 
   // 就地构造元素，键值允许重复
   // 强异常安全保证
-  template <class T, class Hash, class KeyEqual>
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
   template <class... Args>
-  pair<typename hashtable<T, Hash, KeyEqual>::iterator, bool>
-  hashtable<T, Hash, KeyEqual>::
+  pair<typename hashtable<T, Hash, KeyEqual, BucketPolicy>::iterator, bool>
+  hashtable<T, Hash, KeyEqual, BucketPolicy>::
       emplace_unique(Args &&...args)
   {
     auto np = create_node(tinystl::forward<Args>(args)...);
@@ -944,24 +1160,29 @@ namespace tinystl
       destroy_node(np);
       throw;
     }
-    return insert_node_unique(np);
+    auto res = insert_node_unique(np);
+    if (!res.second)
+      destroy_node(np);
+    return res;
   }
 
   // 在不需要重建表格的情况下插入新节点，键值不允许重复
-  template <class T, class Hash, class KeyEqual>
-  pair<typename hashtable<T, Hash, KeyEqual>::iterator, bool>
-  hashtable<T, Hash, KeyEqual>::
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  pair<typename hashtable<T, Hash, KeyEqual, BucketPolicy>::iterator, bool>
+  hashtable<T, Hash, KeyEqual, BucketPolicy>::
       insert_unique_noresize(const value_type &value)
   {
-    const auto n = hash(value_traits::get_key(value));
+    const size_t code = hash_(value_traits::get_key(value));
+    const auto n = policy_.index(code);
     auto first = buckets_[n];
     for (auto cur = first; cur; cur = cur->next)
     {
-      if (is_equal(value_traits::get_key(cur->value), value_traits::get_key(value)))
+      if (node_equal(cur, code, value_traits::get_key(value)))
         return tinystl::make_pair(iterator(cur, this), false);
     }
     // 让新节点成为链表的第一个节点
     auto tmp = create_node(value);
+    store_hash(tmp, code);
     tmp->next = first;
     buckets_[n] = tmp;
     ++size_;
@@ -969,17 +1190,19 @@ namespace tinystl
   }
 
   // 在不需要重建表格的情况下插入新节点，键值允许重复
-  template <class T, class Hash, class KeyEqual>
-  typename hashtable<T, Hash, KeyEqual>::iterator
-  hashtable<T, Hash, KeyEqual>::
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  typename hashtable<T, Hash, KeyEqual, BucketPolicy>::iterator
+  hashtable<T, Hash, KeyEqual, BucketPolicy>::
       insert_multi_noresize(const value_type &value)
   {
-    const auto n = hash(value_traits::get_key(value));
+    const size_t code = hash_(value_traits::get_key(value));
+    const auto n = policy_.index(code);
     auto first = buckets_[n];
     auto tmp = create_node(value);
+    store_hash(tmp, code);
     for (auto cur = first; cur; cur = cur->next)
     {
-      if (is_equal(value_traits::get_key(cur->value), value_traits::get_key(value)))
+      if (node_equal(cur, code, value_traits::get_key(value)))
       { // 如果链表中存在相同键值的节点就马上插入，然后返回
         tmp->next = cur->next;
         cur->next = tmp;
@@ -995,55 +1218,30 @@ namespace tinystl
   }
 
   // 删除迭代器所指的节点
-  template <class T, class Hash, class KeyEqual>
-  void hashtable<T, Hash, KeyEqual>::
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  void hashtable<T, Hash, KeyEqual, BucketPolicy>::
       erase(const_iterator position)
   {
     auto p = position.node;
     if (p)
     {
-      const auto n = hash(value_traits::get_key(p->value));
-      auto cur = buckets_[n];
-      if (cur == p)
-      { // p 位于链表头部
-        buckets_[n] = cur->next;
-        destroy_node(cur);
-        --size_;
-      }
-      else
-      {
-        auto next = cur->next;
-        while (next)
-        {
-          if (next == p)
-          {
-            cur->next = next->next;
-            destroy_node(next);
-            --size_;
-            break;
-          }
-          else
-          {
-            cur = next;
-            next = cur->next;
-          }
-        }
-      }
+      unlink_node(p);
+      destroy_node(p);
     }
   }
 
   // 删除[first, last)内的节点
-  template <class T, class Hash, class KeyEqual>
-  void hashtable<T, Hash, KeyEqual>::
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  void hashtable<T, Hash, KeyEqual, BucketPolicy>::
       erase(const_iterator first, const_iterator last)
   {
     if (first.node == last.node)
       return;
     auto first_bucket = first.node
-                            ? hash(value_traits::get_key(first.node->value))
+                            ? bucket_of(first.node)
                             : bucket_size_;
     auto last_bucket = last.node
-                           ? hash(value_traits::get_key(last.node->value))
+                           ? bucket_of(last.node)
                            : bucket_size_;
     if (first_bucket == last_bucket)
     { // 如果在 bucket 在同一个位置
@@ -1065,9 +1263,9 @@ namespace tinystl
   }
 
   // 删除键值为 key 的节点
-  template <class T, class Hash, class KeyEqual>
-  typename hashtable<T, Hash, KeyEqual>::size_type
-  hashtable<T, Hash, KeyEqual>::
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  typename hashtable<T, Hash, KeyEqual, BucketPolicy>::size_type
+  hashtable<T, Hash, KeyEqual, BucketPolicy>::
       erase_multi(const key_type &key)
   {
     auto p = equal_range_multi(key);
@@ -1079,16 +1277,17 @@ namespace tinystl
     return 0;
   }
 
-  template <class T, class Hash, class KeyEqual>
-  typename hashtable<T, Hash, KeyEqual>::size_type
-  hashtable<T, Hash, KeyEqual>::
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  typename hashtable<T, Hash, KeyEqual, BucketPolicy>::size_type
+  hashtable<T, Hash, KeyEqual, BucketPolicy>::
       erase_unique(const key_type &key)
   {
-    const auto n = hash(key);
+    const size_t code = hash_(key);
+    const auto n = policy_.index(code);
     auto first = buckets_[n];
     if (first)
     {
-      if (is_equal(value_traits::get_key(first->value), key))
+      if (node_equal(first, code, key))
       {
         buckets_[n] = first->next;
         destroy_node(first);
@@ -1100,7 +1299,7 @@ namespace tinystl
         auto next = first->next;
         while (next)
         {
-          if (is_equal(value_traits::get_key(next->value), key))
+          if (node_equal(next, code, key))
           {
             first->next = next->next;
             destroy_node(next);
@@ -1116,8 +1315,8 @@ namespace tinystl
   }
 
   // 清空 hashtable
-  template <class T, class Hash, class KeyEqual>
-  void hashtable<T, Hash, KeyEqual>::
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  void hashtable<T, Hash, KeyEqual, BucketPolicy>::
       clear()
   {
     if (size_ != 0)
@@ -1138,9 +1337,9 @@ namespace tinystl
   }
 
   // 在某个 bucket 节点的个数
-  template <class T, class Hash, class KeyEqual>
-  typename hashtable<T, Hash, KeyEqual>::size_type
-  hashtable<T, Hash, KeyEqual>::
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  typename hashtable<T, Hash, KeyEqual, BucketPolicy>::size_type
+  hashtable<T, Hash, KeyEqual, BucketPolicy>::
       bucket_size(size_type n) const noexcept
   {
     size_type result = 0;
@@ -1152,11 +1351,11 @@ namespace tinystl
   }
 
   // 重新对元素进行一遍哈希，插入到新的位置
-  template <class T, class Hash, class KeyEqual>
-  void hashtable<T, Hash, KeyEqual>::
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  void hashtable<T, Hash, KeyEqual, BucketPolicy>::
       rehash(size_type count)
   {
-    auto n = ht_next_prime(count);
+    auto n = next_size(count);
     if (n > bucket_size_)
     {
       replace_bucket(n);
@@ -1172,63 +1371,68 @@ namespace tinystl
   }
 
   // 查找键值为 key 的节点，返回其迭代器
-  template <class T, class Hash, class KeyEqual>
-  typename hashtable<T, Hash, KeyEqual>::iterator
-  hashtable<T, Hash, KeyEqual>::
-      find(const key_type &key)
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  template <class K>
+  typename hashtable<T, Hash, KeyEqual, BucketPolicy>::iterator
+  hashtable<T, Hash, KeyEqual, BucketPolicy>::
+      find(const K &key)
   {
-    const auto n = hash(key);
-    node_ptr first = buckets_[n];
-    for (; first && !is_equal(value_traits::get_key(first->value), key); first = first->next)
+    const size_t code = hash_(key);
+    node_ptr first = buckets_[policy_.index(code)];
+    for (; first && !node_equal(first, code, key); first = first->next)
     {
     }
     return iterator(first, this);
   }
 
-  template <class T, class Hash, class KeyEqual>
-  typename hashtable<T, Hash, KeyEqual>::const_iterator
-  hashtable<T, Hash, KeyEqual>::
-      find(const key_type &key) const
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  template <class K>
+  typename hashtable<T, Hash, KeyEqual, BucketPolicy>::const_iterator
+  hashtable<T, Hash, KeyEqual, BucketPolicy>::
+      find(const K &key) const
   {
-    const auto n = hash(key);
-    node_ptr first = buckets_[n];
-    for (; first && !is_equal(value_traits::get_key(first->value), key); first = first->next)
+    const size_t code = hash_(key);
+    node_ptr first = buckets_[policy_.index(code)];
+    for (; first && !node_equal(first, code, key); first = first->next)
     {
     }
     return M_cit(first);
   }
 
   // 查找键值为 key 出现的次数
-  template <class T, class Hash, class KeyEqual>
-  typename hashtable<T, Hash, KeyEqual>::size_type
-  hashtable<T, Hash, KeyEqual>::
-      count(const key_type &key) const
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  template <class K>
+  typename hashtable<T, Hash, KeyEqual, BucketPolicy>::size_type
+  hashtable<T, Hash, KeyEqual, BucketPolicy>::
+      count(const K &key) const
   {
-    const auto n = hash(key);
+    const size_t code = hash_(key);
     size_type result = 0;
-    for (node_ptr cur = buckets_[n]; cur; cur = cur->next)
+    for (node_ptr cur = buckets_[policy_.index(code)]; cur; cur = cur->next)
     {
-      if (is_equal(value_traits::get_key(cur->value), key))
+      if (node_equal(cur, code, key))
         ++result;
     }
     return result;
   }
 
   // 查找与键值 key 相等的区间，返回一个 pair，指向相等区间的首尾
-  template <class T, class Hash, class KeyEqual>
-  pair<typename hashtable<T, Hash, KeyEqual>::iterator,
-       typename hashtable<T, Hash, KeyEqual>::iterator>
-  hashtable<T, Hash, KeyEqual>::
-      equal_range_multi(const key_type &key)
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  template <class K>
+  pair<typename hashtable<T, Hash, KeyEqual, BucketPolicy>::iterator,
+       typename hashtable<T, Hash, KeyEqual, BucketPolicy>::iterator>
+  hashtable<T, Hash, KeyEqual, BucketPolicy>::
+      equal_range_multi(const K &key)
   {
-    const auto n = hash(key);
+    const size_t code = hash_(key);
+    const auto n = policy_.index(code);
     for (node_ptr first = buckets_[n]; first; first = first->next)
     {
-      if (is_equal(value_traits::get_key(first->value), key))
+      if (node_equal(first, code, key))
       { // 如果出现相等的键值
         for (node_ptr second = first->next; second; second = second->next)
         {
-          if (!is_equal(value_traits::get_key(second->value), key))
+          if (!node_equal(second, code, key))
             return tinystl::make_pair(iterator(first, this), iterator(second, this));
         }
         for (auto m = n + 1; m < bucket_size_; ++m)
@@ -1242,20 +1446,22 @@ namespace tinystl
     return tinystl::make_pair(end(), end());
   }
 
-  template <class T, class Hash, class KeyEqual>
-  pair<typename hashtable<T, Hash, KeyEqual>::const_iterator,
-       typename hashtable<T, Hash, KeyEqual>::const_iterator>
-  hashtable<T, Hash, KeyEqual>::
-      equal_range_multi(const key_type &key) const
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  template <class K>
+  pair<typename hashtable<T, Hash, KeyEqual, BucketPolicy>::const_iterator,
+       typename hashtable<T, Hash, KeyEqual, BucketPolicy>::const_iterator>
+  hashtable<T, Hash, KeyEqual, BucketPolicy>::
+      equal_range_multi(const K &key) const
   {
-    const auto n = hash(key);
+    const size_t code = hash_(key);
+    const auto n = policy_.index(code);
     for (node_ptr first = buckets_[n]; first; first = first->next)
     {
-      if (is_equal(value_traits::get_key(first->value), key))
+      if (node_equal(first, code, key))
       {
         for (node_ptr second = first->next; second; second = second->next)
         {
-          if (!is_equal(value_traits::get_key(second->value), key))
+          if (!node_equal(second, code, key))
             return tinystl::make_pair(M_cit(first), M_cit(second));
         }
         for (auto m = n + 1; m < bucket_size_; ++m)
@@ -1269,16 +1475,18 @@ namespace tinystl
     return tinystl::make_pair(cend(), cend());
   }
 
-  template <class T, class Hash, class KeyEqual>
-  pair<typename hashtable<T, Hash, KeyEqual>::iterator,
-       typename hashtable<T, Hash, KeyEqual>::iterator>
-  hashtable<T, Hash, KeyEqual>::
-      equal_range_unique(const key_type &key)
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  template <class K>
+  pair<typename hashtable<T, Hash, KeyEqual, BucketPolicy>::iterator,
+       typename hashtable<T, Hash, KeyEqual, BucketPolicy>::iterator>
+  hashtable<T, Hash, KeyEqual, BucketPolicy>::
+      equal_range_unique(const K &key)
   {
-    const auto n = hash(key);
+    const size_t code = hash_(key);
+    const auto n = policy_.index(code);
     for (node_ptr first = buckets_[n]; first; first = first->next)
     {
-      if (is_equal(value_traits::get_key(first->value), key))
+      if (node_equal(first, code, key))
       {
         if (first->next)
           return tinystl::make_pair(iterator(first, this), iterator(first->next, this));
@@ -1293,16 +1501,18 @@ namespace tinystl
     return tinystl::make_pair(end(), end());
   }
 
-  template <class T, class Hash, class KeyEqual>
-  pair<typename hashtable<T, Hash, KeyEqual>::const_iterator,
-       typename hashtable<T, Hash, KeyEqual>::const_iterator>
-  hashtable<T, Hash, KeyEqual>::
-      equal_range_unique(const key_type &key) const
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  template <class K>
+  pair<typename hashtable<T, Hash, KeyEqual, BucketPolicy>::const_iterator,
+       typename hashtable<T, Hash, KeyEqual, BucketPolicy>::const_iterator>
+  hashtable<T, Hash, KeyEqual, BucketPolicy>::
+      equal_range_unique(const K &key) const
   {
-    const auto n = hash(key);
+    const size_t code = hash_(key);
+    const auto n = policy_.index(code);
     for (node_ptr first = buckets_[n]; first; first = first->next)
     {
-      if (is_equal(value_traits::get_key(first->value), key))
+      if (node_equal(first, code, key))
       {
         if (first->next)
           return tinystl::make_pair(M_cit(first), M_cit(first->next));
@@ -1317,15 +1527,133 @@ namespace tinystl
     return tinystl::make_pair(cend(), cend());
   }
 
+  // 从表中摘下 position 处的节点，由返回的句柄持有
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  typename hashtable<T, Hash, KeyEqual, BucketPolicy>::node_handle_type
+  hashtable<T, Hash, KeyEqual, BucketPolicy>::
+      extract(const_iterator position)
+  {
+    auto p = position.node;
+    if (p == nullptr)
+      return node_handle_type();
+    unlink_node(p);
+    return node_handle_type(p);
+  }
+
+  // 摘下一个键值等于 key 的节点，不存在时返回空的句柄
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  typename hashtable<T, Hash, KeyEqual, BucketPolicy>::node_handle_type
+  hashtable<T, Hash, KeyEqual, BucketPolicy>::
+      extract(const key_type &key)
+  {
+    return extract(M_cit(find(key).node));
+  }
+
+  // 插入句柄持有的节点，键值不允许重复，插入失败时节点留在返回值的 node 中
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  typename hashtable<T, Hash, KeyEqual, BucketPolicy>::insert_return_type
+  hashtable<T, Hash, KeyEqual, BucketPolicy>::
+      insert_unique(node_handle_type &&nh)
+  {
+    if (nh.empty())
+      return insert_return_type{end(), false, node_handle_type()};
+    auto it = find(value_traits::get_key(nh.ptr_->value));
+    if (it.node != nullptr)
+      return insert_return_type{it, false, tinystl::move(nh)};
+    rehash_if_need(1);
+    return insert_return_type{insert_node_unique(nh.release()).first, true, node_handle_type()};
+  }
+
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  typename hashtable<T, Hash, KeyEqual, BucketPolicy>::iterator
+  hashtable<T, Hash, KeyEqual, BucketPolicy>::
+      insert_unique_use_hint(const_iterator /*hint*/, node_handle_type &&nh)
+  {
+    if (nh.empty())
+      return end();
+    auto it = find(value_traits::get_key(nh.ptr_->value));
+    if (it.node != nullptr)
+      return it;
+    rehash_if_need(1);
+    return insert_node_unique(nh.release()).first;
+  }
+
+  // 插入句柄持有的节点，键值允许重复
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  typename hashtable<T, Hash, KeyEqual, BucketPolicy>::iterator
+  hashtable<T, Hash, KeyEqual, BucketPolicy>::
+      insert_multi(node_handle_type &&nh)
+  {
+    if (nh.empty())
+      return end();
+    rehash_if_need(1);
+    return insert_node_multi(nh.release());
+  }
+
+  // 把 source 中键值在本表中不存在的节点移入本表
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  void hashtable<T, Hash, KeyEqual, BucketPolicy>::
+      merge_unique(hashtable &source)
+  {
+    if (this == &source)
+      return;
+    for (size_type i = 0; i < source.bucket_size_; ++i)
+    {
+      node_ptr prev = nullptr;
+      node_ptr cur = source.buckets_[i];
+      while (cur != nullptr)
+      {
+        rehash_if_need(1);
+        node_ptr next = cur->next;
+        if (insert_node_unique(cur).second)
+        { // 插入成功后再从 source 中断开
+          if (prev == nullptr)
+            source.buckets_[i] = next;
+          else
+            prev->next = next;
+          --source.size_;
+        }
+        else
+        { // 键值已存在，节点留在 source 中
+          prev = cur;
+        }
+        cur = next;
+      }
+    }
+  }
+
+  // 把 source 中的所有节点移入本表
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  void hashtable<T, Hash, KeyEqual, BucketPolicy>::
+      merge_multi(hashtable &source)
+  {
+    if (this == &source)
+      return;
+    rehash_if_need(source.size_);
+    for (size_type i = 0; i < source.bucket_size_; ++i)
+    {
+      node_ptr cur = source.buckets_[i];
+      source.buckets_[i] = nullptr;
+      while (cur != nullptr)
+      {
+        node_ptr next = cur->next;
+        insert_node_multi(cur);
+        --source.size_;
+        cur = next;
+      }
+    }
+  }
+
   // 交换 hashtable
-  template <class T, class Hash, class KeyEqual>
-  void hashtable<T, Hash, KeyEqual>::
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  void hashtable<T, Hash, KeyEqual, BucketPolicy>::
       swap(hashtable &rhs) noexcept
   {
     if (this != &rhs)
     {
       buckets_.swap(rhs.buckets_);
       tinystl::swap(bucket_size_, rhs.bucket_size_);
+      tinystl::swap(policy_, rhs.policy_);
       tinystl::swap(size_, rhs.size_);
       tinystl::swap(mlf_, rhs.mlf_);
       tinystl::swap(hash_, rhs.hash_);
@@ -1337,8 +1665,8 @@ namespace tinystl
   // helper function
 
   // init 函数
-  template <class T, class Hash, class KeyEqual>
-  void hashtable<T, Hash, KeyEqual>::
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  void hashtable<T, Hash, KeyEqual, BucketPolicy>::
       init(size_type n)
   {
     const auto bucket_nums = next_size(n);
@@ -1354,11 +1682,12 @@ namespace tinystl
       throw;
     }
     bucket_size_ = buckets_.size();
+    policy_.reset(bucket_size_);
   }
 
   // copy_init 函数
-  template <class T, class Hash, class KeyEqual>
-  void hashtable<T, Hash, KeyEqual>::
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  void hashtable<T, Hash, KeyEqual, BucketPolicy>::
       copy_init(const hashtable &ht)
   {
     bucket_size_ = 0;
@@ -1372,16 +1701,19 @@ namespace tinystl
         if (cur)
         { // 如果某 bucket 存在链表
           auto copy = create_node(cur->value);
+          copy_hash(copy, cur);
           buckets_[i] = copy;
           for (auto next = cur->next; next; cur = next, next = cur->next)
           { //复制链表
             copy->next = create_node(next->value);
             copy = copy->next;
+            copy_hash(copy, next);
           }
           copy->next = nullptr;
         }
       }
       bucket_size_ = ht.bucket_size_;
+      policy_ = ht.policy_;
       mlf_ = ht.mlf_;
       size_ = ht.size_;
     }
@@ -1392,10 +1724,10 @@ namespace tinystl
   }
 
   // create_node 函数
-  template <class T, class Hash, class KeyEqual>
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
   template <class... Args>
-  typename hashtable<T, Hash, KeyEqual>::node_ptr
-  hashtable<T, Hash, KeyEqual>::
+  typename hashtable<T, Hash, KeyEqual, BucketPolicy>::node_ptr
+  hashtable<T, Hash, KeyEqual, BucketPolicy>::
       create_node(Args &&...args)
   {
     node_ptr tmp = node_allocator::allocate(1);
@@ -1413,8 +1745,8 @@ namespace tinystl
   }
 
   // destroy_node 函数
-  template <class T, class Hash, class KeyEqual>
-  void hashtable<T, Hash, KeyEqual>::
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  void hashtable<T, Hash, KeyEqual, BucketPolicy>::
       destroy_node(node_ptr node)
   {
     data_allocator::destroy(tinystl::address_of(node->value));
@@ -1422,34 +1754,48 @@ namespace tinystl
     node = nullptr;
   }
 
-  // next_size 函数
-  template <class T, class Hash, class KeyEqual>
-  typename hashtable<T, Hash, KeyEqual>::size_type
-  hashtable<T, Hash, KeyEqual>::next_size(size_type n) const
+  // 把节点 p 从所在 bucket 的链表中断开，p 必须属于本表
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  void hashtable<T, Hash, KeyEqual, BucketPolicy>::
+      unlink_node(node_ptr p)
   {
-    return ht_next_prime(n);
+    const auto n = bucket_of(p);
+    auto cur = buckets_[n];
+    if (cur == p)
+    { // p 位于链表头部
+      buckets_[n] = cur->next;
+    }
+    else
+    {
+      while (cur->next != p)
+        cur = cur->next;
+      cur->next = p->next;
+    }
+    p->next = nullptr;
+    --size_;
   }
 
-  // hash 函数
-  template <class T, class Hash, class KeyEqual>
-  typename hashtable<T, Hash, KeyEqual>::size_type
-  hashtable<T, Hash, KeyEqual>::
-      hash(const key_type &key, size_type n) const
+  // next_size 函数
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  typename hashtable<T, Hash, KeyEqual, BucketPolicy>::size_type
+  hashtable<T, Hash, KeyEqual, BucketPolicy>::next_size(size_type n) const
   {
-    return hash_(key) % n;
+    return BucketPolicy::next_size(n);
   }
 
-  template <class T, class Hash, class KeyEqual>
-  typename hashtable<T, Hash, KeyEqual>::size_type
-  hashtable<T, Hash, KeyEqual>::
-      hash(const key_type &key) const
+  // hash 函数
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  template <class K>
+  typename hashtable<T, Hash, KeyEqual, BucketPolicy>::size_type
+  hashtable<T, Hash, KeyEqual, BucketPolicy>::
+      hash(const K &key) const
   {
-    return hash_(key) % bucket_size_;
+    return policy_.index(hash_(key));
   }
 
   // rehash_if_need 函数
-  template <class T, class Hash, class KeyEqual>
-  void hashtable<T, Hash, KeyEqual>::
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  void hashtable<T, Hash, KeyEqual, BucketPolicy>::
       rehash_if_need(size_type n)
   {
     if (static_cast<float>(size_ + n) > (float)bucket_size_ * max_load_factor())
@@ -1457,9 +1803,9 @@ namespace tinystl
   }
 
   // copy_insert
-  template <class T, class Hash, class KeyEqual>
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
   template <class InputIter>
-  void hashtable<T, Hash, KeyEqual>::
+  void hashtable<T, Hash, KeyEqual, BucketPolicy>::
       copy_insert_multi(InputIter first, InputIter last, tinystl::input_iterator_tag)
   {
     rehash_if_need(tinystl::distance(first, last));
@@ -1467,9 +1813,9 @@ namespace tinystl
       insert_multi_noresize(*first);
   }
 
-  template <class T, class Hash, class KeyEqual>
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
   template <class ForwardIter>
-  void hashtable<T, Hash, KeyEqual>::
+  void hashtable<T, Hash, KeyEqual, BucketPolicy>::
       copy_insert_multi(ForwardIter first, ForwardIter last, tinystl::forward_iterator_tag)
   {
     size_type n = tinystl::distance(first, last);
@@ -1478,9 +1824,9 @@ namespace tinystl
       insert_multi_noresize(*first);
   }
 
-  template <class T, class Hash, class KeyEqual>
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
   template <class InputIter>
-  void hashtable<T, Hash, KeyEqual>::
+  void hashtable<T, Hash, KeyEqual, BucketPolicy>::
       copy_insert_unique(InputIter first, InputIter last, tinystl::input_iterator_tag)
   {
     rehash_if_need(tinystl::distance(first, last));
@@ -1488,9 +1834,9 @@ namespace tinystl
       insert_unique_noresize(*first);
   }
 
-  template <class T, class Hash, class KeyEqual>
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
   template <class ForwardIter>
-  void hashtable<T, Hash, KeyEqual>::
+  void hashtable<T, Hash, KeyEqual, BucketPolicy>::
       copy_insert_unique(ForwardIter first, ForwardIter last, tinystl::forward_iterator_tag)
   {
     size_type n = tinystl::distance(first, last);
@@ -1500,22 +1846,25 @@ namespace tinystl
   }
 
   // insert_node 函数
-  template <class T, class Hash, class KeyEqual>
-  typename hashtable<T, Hash, KeyEqual>::iterator
-  hashtable<T, Hash, KeyEqual>::
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  typename hashtable<T, Hash, KeyEqual, BucketPolicy>::iterator
+  hashtable<T, Hash, KeyEqual, BucketPolicy>::
       insert_node_multi(node_ptr np)
   {
-    const auto n = hash(value_traits::get_key(np->value));
+    const size_t code = hash_(value_traits::get_key(np->value));
+    store_hash(np, code);
+    const auto n = policy_.index(code);
     auto cur = buckets_[n];
     if (cur == nullptr)
     {
+      np->next = nullptr;
       buckets_[n] = np;
       ++size_;
       return iterator(np, this);
     }
     for (; cur; cur = cur->next)
     {
-      if (is_equal(value_traits::get_key(cur->value), value_traits::get_key(np->value)))
+      if (node_equal(cur, code, value_traits::get_key(np->value)))
       {
         np->next = cur->next;
         cur->next = np;
@@ -1530,22 +1879,25 @@ namespace tinystl
   }
 
   // insert_node_unique 函数
-  template <class T, class Hash, class KeyEqual>
-  pair<typename hashtable<T, Hash, KeyEqual>::iterator, bool>
-  hashtable<T, Hash, KeyEqual>::
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  pair<typename hashtable<T, Hash, KeyEqual, BucketPolicy>::iterator, bool>
+  hashtable<T, Hash, KeyEqual, BucketPolicy>::
       insert_node_unique(node_ptr np)
   {
-    const auto n = hash(value_traits::get_key(np->value));
+    const size_t code = hash_(value_traits::get_key(np->value));
+    store_hash(np, code);
+    const auto n = policy_.index(code);
     auto cur = buckets_[n];
     if (cur == nullptr)
     {
+      np->next = nullptr;
       buckets_[n] = np;
       ++size_;
       return tinystl::make_pair(iterator(np, this), true);
     }
     for (; cur; cur = cur->next)
     {
-      if (is_equal(value_traits::get_key(cur->value), value_traits::get_key(np->value)))
+      if (node_equal(cur, code, value_traits::get_key(np->value)))
       {
         return tinystl::make_pair(iterator(cur, this), false);
       }
@@ -1557,24 +1909,29 @@ namespace tinystl
   }
 
   // replace_bucket 函数
-  template <class T, class Hash, class KeyEqual>
-  void hashtable<T, Hash, KeyEqual>::
+  // 把所有节点重新链接到 bucket_count 个 bucket 中，不复制节点
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  void hashtable<T, Hash, KeyEqual, BucketPolicy>::
       replace_bucket(size_type bucket_count)
   {
     bucket_type bucket(bucket_count);
+    BucketPolicy policy;
+    policy.reset(bucket_count);
     if (size_ != 0)
     {
       for (size_type i = 0; i < bucket_size_; ++i)
       {
-        for (auto first = buckets_[i]; first; first = first->next)
+        for (auto first = buckets_[i]; first;)
         {
-          auto tmp = create_node(first->value);
-          const auto n = hash(value_traits::get_key(first->value), bucket_count);
+          auto tmp = first;
+          first = first->next;
+          const size_t code = node_hash(tmp);
+          const auto n = policy.index(code);
           auto f = bucket[n];
           bool is_inserted = false;
           for (auto cur = f; cur; cur = cur->next)
           {
-            if (is_equal(value_traits::get_key(cur->value), value_traits::get_key(first->value)))
+            if (node_equal(cur, code, value_traits::get_key(tmp->value)))
             {
               tmp->next = cur->next;
               cur->next = tmp;
@@ -1588,16 +1945,18 @@ namespace tinystl
             bucket[n] = tmp;
           }
         }
+        buckets_[i] = nullptr;
       }
     }
     buckets_.swap(bucket);
     bucket_size_ = buckets_.size();
+    policy_ = policy;
   }
 
   // erase_bucket 函数
   // 在第 n 个 bucket 内，删除 [first, last) 的节点
-  template <class T, class Hash, class KeyEqual>
-  void hashtable<T, Hash, KeyEqual>::
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  void hashtable<T, Hash, KeyEqual, BucketPolicy>::
       erase_bucket(size_type n, node_ptr first, node_ptr last)
   {
     auto cur = buckets_[n];
@@ -1623,8 +1982,8 @@ namespace tinystl
 
   // erase_bucket 函数
   // 在第 n 个 bucket 内，删除 [buckets_[n], last) 的节点
-  template <class T, class Hash, class KeyEqual>
-  void hashtable<T, Hash, KeyEqual>::
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  void hashtable<T, Hash, KeyEqual, BucketPolicy>::
       erase_bucket(size_type n, node_ptr last)
   {
     auto cur = buckets_[n];
@@ -1639,8 +1998,8 @@ namespace tinystl
   }
 
   // equal_to 函数
-  template <class T, class Hash, class KeyEqual>
-  bool hashtable<T, Hash, KeyEqual>::equal_to_multi(const hashtable &other)
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  bool hashtable<T, Hash, KeyEqual, BucketPolicy>::equal_to_multi(const hashtable &other)
   {
     if (size_ != other.size_)
       return false;
@@ -1656,8 +2015,8 @@ namespace tinystl
     return true;
   }
 
-  template <class T, class Hash, class KeyEqual>
-  bool hashtable<T, Hash, KeyEqual>::equal_to_unique(const hashtable &other)
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  bool hashtable<T, Hash, KeyEqual, BucketPolicy>::equal_to_unique(const hashtable &other)
   {
     if (size_ != other.size_)
       return false;
@@ -1671,9 +2030,9 @@ namespace tinystl
   }
 
   // 重载 tinystl 的 swap
-  template <class T, class Hash, class KeyEqual>
-  void swap(hashtable<T, Hash, KeyEqual> &lhs,
-            hashtable<T, Hash, KeyEqual> &rhs) noexcept
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  void swap(hashtable<T, Hash, KeyEqual, BucketPolicy> &lhs,
+            hashtable<T, Hash, KeyEqual, BucketPolicy> &rhs) noexcept
   {
     lhs.swap(rhs);
   }
@@ -0,0 +1,414 @@
+#ifndef TINYSTL_INTERVAL_MAP_H_
+#define TINYSTL_INTERVAL_MAP_H_
+
+// 这个头文件包含模板类 interval_map
+// interval_map : 区间映射，键值为闭区间 [low, high]，允许重复，支持查询与给定区间相交的所有元素
+
+// notes:
+//
+// 1. 底层为 rb_tree，按 (low, high) 的字典序排列，节点更新策略为 rb_tree_interval_update，
+//    每个节点额外保存子树中区间右端点的最大值，插入、删除、旋转时随树的结构一起维护
+// 2. 相交查询 [a, b] 是带剪枝的中序遍历：子树的最大右端点小于 a 时整棵跳过，
+//    遇到左端点大于 b 的元素时结束，复杂度为 O(log n + k log(n / k))，k 为结果个数
+// 3. 点查询（stabbing query）即 a == b 的相交查询
+// 4. 节点中保存右端点的副本，Key 必须是可平凡复制的类型，例如整数、时间戳、IP 地址
+// 5. 其余接口与 multimap 相同，键值不能修改，实值可以通过迭代器修改
+
+#include "functional.h"
+#include "rb_tree.h"
+#include "vector.h"
+#include "exceptdef.h"
+#include <initializer_list>
+#include <type_traits>
+
+namespace tinystl
+{
+
+  // 带子树最大右端点的节点，T 为 pair<const pair<Key, Key>, Mapped>
+  template <class T, class Key>
+  struct rb_tree_interval_node : public rb_tree_node<T>
+  {
+    static_assert(std::is_trivially_copyable<Key>::value, "interval endpoint must be trivially copyable");
+
+    Key max_high; // 以该节点为根的子树中区间右端点的最大值
+  };
+
+  // 维护子树中区间右端点的最大值
+  template <class Key, class Compare>
+  struct rb_tree_interval_update
+  {
+    static constexpr bool order_statistics = false;
+
+    template <class T>
+    struct node
+    {
+      typedef rb_tree_interval_node<T, Key> type;
+    };
+
+    template <class T>
+    static rb_tree_interval_node<T, Key> *cast(rb_tree_node_base<T> *x) noexcept
+    {
+      return static_cast<rb_tree_interval_node<T, Key> *>(x);
+    }
+
+    // m 与以 x 为根的子树的最大右端点中较大的一个
+    template <class T>
+    static const Key &max_with(const Key &m, rb_tree_node_base<T> *x) noexcept
+    {
+      return (x != nullptr && Compare()(m, cast(x)->max_high)) ? cast(x)->max_high : m;
+    }
+
+    template <class T>
+    static void recompute(rb_tree_node_base<T> *x) noexcept
+    {
+      auto p = cast(x);
+      p->max_high = max_with(max_with(p->value.first.second, x->left), x->right);
+    }
+
+    template <class T>
+    static void rotate(rb_tree_node_base<T> *x, rb_tree_node_base<T> *y) noexcept
+    {
+      recompute(x);
+      recompute(y);
+    }
+
+    // 沿 x 到根的路径向上更新，祖先的最大值不小于新区间的右端点时停止
+    template <class T>
+    static void insert(rb_tree_node_base<T> *x, rb_tree_node_base<T> *root) noexcept
+    {
+      const Key high = cast(x)->value.first.second;
+      cast(x)->max_high = high;
+      while (x != root)
+      {
+        x = x->parent();
+        if (!Compare()(cast(x)->max_high, high))
+          break;
+        cast(x)->max_high = high;
+      }
+    }
+
+    // 摘下之前无法确定新的最大值，在 unlink 中重新计算
+    template <class T>
+    static void erase(rb_tree_node_base<T> *, rb_tree_node_base<T> *) noexcept {}
+
+    // 从 xp 开始向上重新计算，直到根节点
+    template <class T>
+    static void unlink(rb_tree_node_base<T> *xp, rb_tree_node_base<T> *root) noexcept
+    {
+      for (; xp != nullptr; xp = xp->parent())
+      {
+        recompute(xp);
+        if (xp == root)
+          break;
+      }
+    }
+
+    template <class T>
+    static void copy(rb_tree_node_base<T> *dst, rb_tree_node_base<T> *src) noexcept
+    {
+      cast(dst)->max_high = cast(src)->max_high;
+    }
+
+    // 从 x 开始向上重新计算，直到独立子树的根
+    template <class T>
+    static void propagate(rb_tree_node_base<T> *x) noexcept
+    {
+      for (; x != nullptr; x = x->parent())
+        recompute(x);
+    }
+  };
+
+  // 按 (low, high) 的字典序比较两个区间
+  template <class Key, class Compare>
+  struct interval_less : public binary_function<tinystl::pair<Key, Key>, tinystl::pair<Key, Key>, bool>
+  {
+    bool operator()(const tinystl::pair<Key, Key> &lhs, const tinystl::pair<Key, Key> &rhs) const
+    {
+      Compare comp;
+      return comp(lhs.first, rhs.first) || (!comp(rhs.first, lhs.first) && comp(lhs.second, rhs.second));
+    }
+  };
+
+  // 模板类 interval_map，键值允许重复
+  // 参数一代表区间端点的类型，参数二代表实值类型，参数三代表端点的比较方式，缺省使用 tinystl::less
+  template <class Key, class T, class Compare = tinystl::less<Key>>
+  class interval_map
+  {
+  public:
+    // interval_map 的嵌套型别定义
+    typedef Key endpoint_type;
+    typedef tinystl::pair<Key, Key> interval_type;
+    typedef interval_type key_type;
+    typedef T mapped_type;
+    typedef tinystl::pair<const interval_type, T> value_type;
+    typedef Compare endpoint_compare;
+    typedef tinystl::interval_less<Key, Compare> key_compare;
+
+  private:
+    // 以 tinystl::rb_tree 作为底层机制
+    typedef tinystl::rb_tree<value_type, key_compare, rb_tree_interval_update<Key, Compare>> base_type;
+    base_type tree_;
+
+  public:
+    // 使用 rb_tree 的型别
+    typedef typename base_type::pointer pointer;
+    typedef typename base_type::const_pointer const_pointer;
+    typedef typename base_type::reference reference;
+    typedef typename base_type::const_reference const_reference;
+    typedef typename base_type::iterator iterator;
+    typedef typename base_type::const_iterator const_iterator;
+    typedef typename base_type::reverse_iterator reverse_iterator;
+    typedef typename base_type::const_reverse_iterator const_reverse_iterator;
+    typedef typename base_type::size_type size_type;
+    typedef typename base_type::difference_type difference_type;
+    typedef typename base_type::allocator_type allocator_type;
+
+  public:
+    // 构造、复制、移动函数
+
+    interval_map() = default;
+
+    template <class InputIterator>
+    interval_map(InputIterator first, InputIterator last)
+        : tree_()
+    {
+      insert(first, last);
+    }
+
+    interval_map(std::initializer_list<value_type> ilist)
+        : tree_()
+    {
+      insert(ilist.begin(), ilist.end());
+    }
+
+    interval_map(const interval_map &rhs)
+        : tree_(rhs.tree_)
+    {
+    }
+    interval_map(interval_map &&rhs) noexcept
+        : tree_(tinystl::move(rhs.tree_))
+    {
+    }
+
+    interval_map &operator=(const interval_map &rhs)
+    {
+      tree_ = rhs.tree_;
+      return *this;
+    }
+    interval_map &operator=(interval_map &&rhs)
+    {
+      tree_ = tinystl::move(rhs.tree_);
+      return *this;
+    }
+
+    // 相关接口
+
+    key_compare key_comp() const { return tree_.key_comp(); }
+    endpoint_compare endpoint_comp() const { return endpoint_compare(); }
+    allocator_type get_allocator() const { return tree_.get_allocator(); }
+
+    // 迭代器相关
+
+    iterator begin() noexcept { return tree_.begin(); }
+    const_iterator begin() const noexcept { return tree_.begin(); }
+    iterator end() noexcept { return tree_.end(); }
+    const_iterator end() const noexcept { return tree_.end(); }
+
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // 容量相关
+    bool empty() const noexcept { return tree_.empty(); }
+    size_type size() const noexcept { return tree_.size(); }
+    size_type max_size() const noexcept { return tree_.max_size(); }
+
+    // 插入删除操作
+
+    // 区间必须满足 low <= high
+    iterator insert(const Key &low, const Key &high, const T &value)
+    {
+      TINYSTL_DEBUG(!Compare()(high, low));
+      return tree_.emplace_multi(interval_type(low, high), value);
+    }
+    iterator insert(const Key &low, const Key &high, T &&value)
+    {
+      TINYSTL_DEBUG(!Compare()(high, low));
+      return tree_.emplace_multi(interval_type(low, high), tinystl::move(value));
+    }
+
+    iterator insert(const value_type &value)
+    {
+      TINYSTL_DEBUG(!Compare()(value.first.second, value.first.first));
+      return tree_.insert_multi(value);
+    }
+    iterator insert(value_type &&value)
+    {
+      TINYSTL_DEBUG(!Compare()(value.first.second, value.first.first));
+      return tree_.insert_multi(tinystl::move(value));
+    }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last)
+    {
+      for (; first != last; ++first)
+        insert(*first);
+    }
+
+    void erase(iterator position) { tree_.erase(position); }
+    size_type erase(const interval_type &key) { return tree_.erase_multi(key); }
+    void erase(iterator first, iterator last) { tree_.erase(first, last); }
+
+    void clear() { tree_.clear(); }
+
+    // 按区间精确查找
+
+    iterator find(const interval_type &key) { return tree_.find(key); }
+    const_iterator find(const interval_type &key) const { return tree_.find(key); }
+
+    size_type count(const interval_type &key) const { return tree_.count_multi(key); }
+
+    pair<iterator, iterator>
+    equal_range(const interval_type &key)
+    {
+      return tree_.equal_range_multi(key);
+    }
+    pair<const_iterator, const_iterator>
+    equal_range(const interval_type &key) const
+    {
+      return tree_.equal_range_multi(key);
+    }
+
+    // 相交查询
+
+    // 按区间顺序对每个与 [low, high] 相交的元素调用 f(value_type&)
+    template <class Function>
+    void for_each_overlap(const Key &low, const Key &high, Function f)
+    {
+      visit_overlaps(low, high, [&f](iterator it)
+                     {
+        f(*it);
+        return true; });
+    }
+
+    // 与 [low, high] 相交的所有元素的迭代器，按区间顺序排列
+    tinystl::vector<iterator> overlaps(const Key &low, const Key &high)
+    {
+      tinystl::vector<iterator> result;
+      visit_overlaps(low, high, [&result](iterator it)
+                     {
+        result.push_back(it);
+        return true; });
+      return result;
+    }
+    tinystl::vector<const_iterator> overlaps(const Key &low, const Key &high) const
+    {
+      tinystl::vector<const_iterator> result;
+      const_cast<interval_map *>(this)->visit_overlaps(low, high, [&result](iterator it)
+                                                        {
+        result.push_back(it);
+        return true; });
+      return result;
+    }
+
+    // 第一个与 [low, high] 相交的元素，不存在时返回 end()
+    iterator find_overlap(const Key &low, const Key &high)
+    {
+      iterator result = end();
+      visit_overlaps(low, high, [&result](iterator it)
+                     {
+        result = it;
+        return false; });
+      return result;
+    }
+    const_iterator find_overlap(const Key &low, const Key &high) const
+    {
+      return const_cast<interval_map *>(this)->find_overlap(low, high);
+    }
+
+    bool overlaps_any(const Key &low, const Key &high) const
+    {
+      return find_overlap(low, high) != end();
+    }
+
+    // 点查询，包含 point 的所有元素
+    tinystl::vector<iterator> stab(const Key &point) { return overlaps(point, point); }
+    tinystl::vector<const_iterator> stab(const Key &point) const { return overlaps(point, point); }
+
+    template <class Function>
+    void for_each_containing(const Key &point, Function f)
+    {
+      for_each_overlap(point, point, f);
+    }
+
+    void swap(interval_map &rhs) noexcept { tree_.swap(rhs.tree_); }
+
+  private:
+    // helper functions
+    template <class Visit>
+    void visit_overlaps(const Key &low, const Key &high, Visit visit);
+
+  public:
+    friend bool operator==(const interval_map &lhs, const interval_map &rhs) { return lhs.tree_ == rhs.tree_; }
+    friend bool operator<(const interval_map &lhs, const interval_map &rhs) { return lhs.tree_ < rhs.tree_; }
+  };
+
+  /*****************************************************************************************/
+  // helper function
+
+  // 子树的最大右端点小于 low 时跳过整棵子树，左端点大于 high 时之后的元素都不会相交
+  template <class Key, class T, class Compare>
+  template <class Visit>
+  void interval_map<Key, T, Compare>::visit_overlaps(const Key &low, const Key &high, Visit visit)
+  {
+    typedef typename base_type::node_ptr node_ptr;
+    Compare comp;
+    tree_.visit_pruned(
+        [&](node_ptr x)
+        { return comp(x->max_high, low); },
+        [&](node_ptr x)
+        { return comp(high, x->value.first.first); },
+        [&](iterator it)
+        { return comp(it->first.second, low) || visit(it); });
+  }
+
+  // 重载比较操作符
+  template <class Key, class T, class Compare>
+  bool operator!=(const interval_map<Key, T, Compare> &lhs, const interval_map<Key, T, Compare> &rhs)
+  {
+    return !(lhs == rhs);
+  }
+
+  template <class Key, class T, class Compare>
+  bool operator>(const interval_map<Key, T, Compare> &lhs, const interval_map<Key, T, Compare> &rhs)
+  {
+    return rhs < lhs;
+  }
+
+  template <class Key, class T, class Compare>
+  bool operator<=(const interval_map<Key, T, Compare> &lhs, const interval_map<Key, T, Compare> &rhs)
+  {
+    return !(rhs < lhs);
+  }
+
+  template <class Key, class T, class Compare>
+  bool operator>=(const interval_map<Key, T, Compare> &lhs, const interval_map<Key, T, Compare> &rhs)
+  {
+    return !(lhs < rhs);
+  }
+
+  // 重载 tinystl 的 swap
+  template <class Key, class T, class Compare>
+  void swap(interval_map<Key, T, Compare> &lhs, interval_map<Key, T, Compare> &rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+} // namespace tinystl
+#endif // !TINYSTL_INTERVAL_MAP_H_
@@ -0,0 +1,360 @@
+#ifndef TINYSTL_INTRUSIVE_LIST_H_
+#define TINYSTL_INTRUSIVE_LIST_H_
+
+// 这个头文件包含一个模板类 intrusive_list
+// intrusive_list : 侵入式双向链表，链接指针保存在元素自身的 hook 成员中
+
+// notes:
+//
+// 1. 容器不分配也不复制元素，只负责链接 / 断开元素中的 hook
+// 2. 元素的生命周期由使用者管理，元素析构前必须先从链表中移除
+// 3. 一个元素可以有多个 hook，从而同时属于多个 intrusive_list
+// 4. 链接逻辑与 list 共用 list.h 中的 list_link_nodes / list_unlink_nodes
+
+#include <cstddef>
+#include <type_traits>
+
+#include "iterator.h"
+#include "list.h"
+#include "utils.h"
+#include "exceptdef.h"
+
+namespace tinystl
+{
+  // 嵌入到元素中的 hook，未链接时 prev / next 指向自身
+  struct intrusive_list_hook : public list_node_base<intrusive_list_hook>
+  {
+    typedef list_node_base<intrusive_list_hook> base_type;
+
+    intrusive_list_hook() noexcept { base_type::unlink(); }
+
+    // 复制元素时不复制链接关系
+    intrusive_list_hook(const intrusive_list_hook &) noexcept { base_type::unlink(); }
+    intrusive_list_hook &operator=(const intrusive_list_hook &) noexcept { return *this; }
+
+    ~intrusive_list_hook() { TINYSTL_DEBUG(!is_linked()); }
+
+    bool is_linked() const noexcept { return next != static_cast<const base_type *>(this); }
+  };
+
+  // 在 hook 与所属元素之间转换，hook 在元素中的偏移由成员指针得到
+  // 成员指针不能指向虚基类中的成员，所以即使 T 不是 standard-layout，hook 相对 T 的偏移也是固定的
+  template <class T, intrusive_list_hook T::*Hook>
+  struct intrusive_list_traits
+  {
+    typedef list_node_base<intrusive_list_hook> *base_ptr;
+
+    // 在一块按 T 对齐的真实存储上取成员地址再相减，不经过空指针；编译器会把结果折叠为常量
+    static size_t offset() noexcept
+    {
+      typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+      T *p = reinterpret_cast<T *>(&storage);
+      return static_cast<size_t>(reinterpret_cast<char *>(&(p->*Hook)) - reinterpret_cast<char *>(p));
+    }
+
+    static base_ptr to_node(T &value) noexcept
+    {
+      return &(value.*Hook);
+    }
+
+    static T *to_value(base_ptr node) noexcept
+    {
+      return reinterpret_cast<T *>(reinterpret_cast<char *>(static_cast<intrusive_list_hook *>(node)) - offset());
+    }
+  };
+
+  // intrusive_list 的迭代器
+  template <class T, intrusive_list_hook T::*Hook, class Ref, class Ptr>
+  struct intrusive_list_iterator : public iterator<bidirectional_iterator_tag, T>
+  {
+    typedef intrusive_list_iterator<T, Hook, T &, T *> iterator;
+    typedef intrusive_list_iterator<T, Hook, const T &, const T *> const_iterator;
+    typedef intrusive_list_iterator self;
+
+    typedef T value_type;
+    typedef Ptr pointer;
+    typedef Ref reference;
+    typedef intrusive_list_traits<T, Hook> traits;
+    typedef typename traits::base_ptr base_ptr;
+
+    base_ptr node_;
+
+    intrusive_list_iterator() noexcept : node_(nullptr) {}
+    explicit intrusive_list_iterator(base_ptr x) noexcept : node_(x) {}
+    intrusive_list_iterator(const iterator &rhs) noexcept : node_(rhs.node_) {}
+
+    reference operator*() const { return *traits::to_value(node_); }
+    pointer operator->() const { return &(operator*()); }
+
+    self &operator++()
+    {
+      TINYSTL_DEBUG(node_ != nullptr);
+      node_ = node_->next;
+      return *this;
+    }
+    self operator++(int)
+    {
+      self tmp = *this;
+      ++*this;
+      return tmp;
+    }
+    self &operator--()
+    {
+      TINYSTL_DEBUG(node_ != nullptr);
+      node_ = node_->prev;
+      return *this;
+    }
+    self operator--(int)
+    {
+      self tmp = *this;
+      --*this;
+      return tmp;
+    }
+
+    bool operator==(const self &rhs) const { return node_ == rhs.node_; }
+    bool operator!=(const self &rhs) const { return node_ != rhs.node_; }
+  };
+
+  // 模板类 intrusive_list
+  // 模板参数 T 代表元素类型，Hook 为元素中 intrusive_list_hook 成员的指针
+  template <class T, intrusive_list_hook T::*Hook>
+  class intrusive_list
+  {
+  public:
+    typedef T value_type;
+    typedef T *pointer;
+    typedef const T *const_pointer;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    typedef intrusive_list_iterator<T, Hook, T &, T *> iterator;
+    typedef intrusive_list_iterator<T, Hook, const T &, const T *> const_iterator;
+    typedef tinystl::reverse_iterator<iterator> reverse_iterator;
+    typedef tinystl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    typedef intrusive_list_traits<T, Hook> traits;
+    typedef typename traits::base_ptr base_ptr;
+
+  private:
+    intrusive_list_hook header_; // 头节点，header_.next 为第一个元素，header_.prev 为最后一个元素
+    size_type size_;
+
+  public:
+    // 构造、移动、析构函数
+    intrusive_list() noexcept : size_(0) {}
+
+    intrusive_list(const intrusive_list &) = delete;
+    intrusive_list &operator=(const intrusive_list &) = delete;
+
+    intrusive_list(intrusive_list &&rhs) noexcept : size_(0)
+    {
+      splice(end(), rhs);
+    }
+
+    intrusive_list &operator=(intrusive_list &&rhs) noexcept
+    {
+      if (this != &rhs)
+      {
+        clear();
+        splice(end(), rhs);
+      }
+      return *this;
+    }
+
+    // 析构时断开所有元素，元素本身不受影响
+    ~intrusive_list() { clear(); }
+
+  public:
+    // 迭代器相关操作
+    iterator begin() noexcept { return iterator(header_.next); }
+    const_iterator begin() const noexcept { return const_iterator(header_.next); }
+    iterator end() noexcept { return iterator(header()); }
+    const_iterator end() const noexcept { return const_iterator(header()); }
+
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // 容量相关操作
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+
+    // 访问元素相关操作
+    reference front()
+    {
+      TINYSTL_DEBUG(!empty());
+      return *begin();
+    }
+    const_reference front() const
+    {
+      TINYSTL_DEBUG(!empty());
+      return *begin();
+    }
+    reference back()
+    {
+      TINYSTL_DEBUG(!empty());
+      return *(--end());
+    }
+    const_reference back() const
+    {
+      TINYSTL_DEBUG(!empty());
+      return *(--end());
+    }
+
+    // 修改容器相关操作，元素在插入前必须处于未链接状态
+
+    iterator insert(const_iterator pos, reference value) noexcept
+    {
+      base_ptr n = traits::to_node(value);
+      TINYSTL_DEBUG(!static_cast<intrusive_list_hook *>(n)->is_linked());
+      list_link_nodes(pos.node_, n, n);
+      ++size_;
+      return iterator(n);
+    }
+
+    void push_front(reference value) noexcept { insert(cbegin(), value); }
+    void push_back(reference value) noexcept { insert(cend(), value); }
+
+    void pop_front() noexcept
+    {
+      TINYSTL_DEBUG(!empty());
+      erase(cbegin());
+    }
+    void pop_back() noexcept
+    {
+      TINYSTL_DEBUG(!empty());
+      erase(--cend());
+    }
+
+    iterator erase(const_iterator pos) noexcept;
+    iterator erase(const_iterator first, const_iterator last) noexcept;
+
+    // 从链表中移除 value，value 必须属于本链表
+    void erase(reference value) noexcept { erase(iterator_to(value)); }
+
+    void clear() noexcept;
+
+    void swap(intrusive_list &rhs) noexcept;
+
+    // list 相关操作
+
+    // 由元素得到指向它的迭代器，常数时间
+    iterator iterator_to(reference value) noexcept { return iterator(traits::to_node(value)); }
+    const_iterator iterator_to(const_reference value) const noexcept
+    {
+      return const_iterator(traits::to_node(const_cast<reference>(value)));
+    }
+
+    void splice(const_iterator pos, intrusive_list &other) noexcept;
+    void splice(const_iterator pos, intrusive_list &other, const_iterator it) noexcept;
+
+  private:
+    base_ptr header() const noexcept
+    {
+      return const_cast<intrusive_list_hook *>(&header_);
+    }
+  };
+
+  /*****************************************************************************************/
+
+  // 删除 pos 处的元素，被删除元素的 hook 恢复为未链接状态
+  template <class T, intrusive_list_hook T::*Hook>
+  typename intrusive_list<T, Hook>::iterator
+  intrusive_list<T, Hook>::erase(const_iterator pos) noexcept
+  {
+    TINYSTL_DEBUG(pos != cend());
+    base_ptr n = pos.node_;
+    base_ptr next = n->next;
+    list_unlink_nodes(n, n);
+    n->unlink();
+    --size_;
+    return iterator(next);
+  }
+
+  // 删除 [first, last) 内的元素
+  template <class T, intrusive_list_hook T::*Hook>
+  typename intrusive_list<T, Hook>::iterator
+  intrusive_list<T, Hook>::erase(const_iterator first, const_iterator last) noexcept
+  {
+    while (first != last)
+      first = erase(first);
+    return iterator(last.node_);
+  }
+
+  // 清空链表，所有元素的 hook 恢复为未链接状态
+  template <class T, intrusive_list_hook T::*Hook>
+  void intrusive_list<T, Hook>::clear() noexcept
+  {
+    base_ptr cur = header_.next;
+    while (cur != header())
+    {
+      base_ptr next = cur->next;
+      cur->unlink();
+      cur = next;
+    }
+    header_.unlink();
+    size_ = 0;
+  }
+
+  // 交换两个 intrusive_list
+  template <class T, intrusive_list_hook T::*Hook>
+  void intrusive_list<T, Hook>::swap(intrusive_list &rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      intrusive_list tmp;
+      tmp.splice(tmp.end(), rhs);
+      rhs.splice(rhs.end(), *this);
+      splice(end(), tmp);
+    }
+  }
+
+  // 将 other 的全部元素接合于 pos 之前
+  template <class T, intrusive_list_hook T::*Hook>
+  void intrusive_list<T, Hook>::splice(const_iterator pos, intrusive_list &other) noexcept
+  {
+    TINYSTL_DEBUG(this != &other);
+    if (!other.empty())
+    {
+      base_ptr f = other.header_.next;
+      base_ptr l = other.header_.prev;
+      list_unlink_nodes(f, l);
+      list_link_nodes(pos.node_, f, l);
+      size_ += other.size_;
+      other.size_ = 0;
+    }
+  }
+
+  // 将 other 中 it 所指的元素接合于 pos 之前
+  template <class T, intrusive_list_hook T::*Hook>
+  void intrusive_list<T, Hook>::splice(const_iterator pos, intrusive_list &other,
+                                       const_iterator it) noexcept
+  {
+    if (pos.node_ != it.node_ && pos.node_ != it.node_->next)
+    {
+      base_ptr n = it.node_;
+      list_unlink_nodes(n, n);
+      list_link_nodes(pos.node_, n, n);
+      ++size_;
+      --other.size_;
+    }
+  }
+
+  // 重载 tinystl 的 swap
+  template <class T, intrusive_list_hook T::*Hook>
+  void swap(intrusive_list<T, Hook> &lhs, intrusive_list<T, Hook> &rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+} // namespace tinystl
+
+#endif // !TINYSTL_INTRUSIVE_LIST_H_
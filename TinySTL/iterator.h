@@ -279,7 +279,12 @@ namespace tinystl
       auto tmp = current;
       return *--tmp;
     }
-    pointer operator->() const { return &(operator*()); }
+    // pointer 是原生指针时取 operator* 的地址；
+    // 否则 pointer 是代理类型（例如 flat_map 的迭代器），转交给正向迭代器的 operator->
+    pointer operator->() const
+    {
+      return arrow_dispatch(m_bool_constant<std::is_pointer<pointer>::value>());
+    }
     // 前进(++)变为后退(--)
     self &operator++()
     {
@@ -326,6 +331,14 @@ namespace tinystl
     {
       return *(*this + n);
     }
+
+  private:
+    pointer arrow_dispatch(m_true_type) const { return &(operator*()); }
+    pointer arrow_dispatch(m_false_type) const
+    {
+      auto tmp = current;
+      return (--tmp).operator->();
+    }
   };
 
   // 重载operator-
@@ -1,7 +1,9 @@
 #ifndef TINYSTL_LIST_H_
 #define TINYSTL_LIST_H_
 
+#include <atomic>
 #include <initializer_list>
+#include <utility>
 #include "allocator.h"
 #include "iterator.h"
 #include "memory.h"
@@ -15,6 +17,8 @@ namespace tinystl
   struct list_node;
   template <class T>
   struct list_node_base;
+  template <class T>
+  struct list_block;
 
   template <class T>
   struct node_traits
@@ -56,6 +60,7 @@ namespace tinystl
     typedef typename node_traits<T>::base_ptr base_ptr;
     typedef typename node_traits<T>::node_ptr node_ptr;
 
+    list_block<T> *block; // 所在的 compact 内存块，单独分配的结点为 nullptr
     T value;
 
     list_node() = default;
@@ -65,6 +70,36 @@ namespace tinystl
     node_ptr self() { return static_cast<T>(&*this); }
   };
 
+  // compact 分配的连续内存块，live 为块中尚未销毁的结点数，减为 0 时释放整块内存
+  // 块中的结点可以随 splice / merge 转移到其他 list，所以计数放在块中，并且是原子的
+  template <class T>
+  struct list_block
+  {
+    std::atomic<size_t> live;
+    size_t size;
+    list_node<T> *nodes;
+
+    list_block(size_t n, list_node<T> *p) : live(n), size(n), nodes(p) {}
+  };
+
+  // 在 pos 之前连接 [first, last] 的结点，list 与 intrusive_list 共用
+  template <class T>
+  void list_link_nodes(list_node_base<T> *pos, list_node_base<T> *first, list_node_base<T> *last)
+  {
+    pos->prev->next = first;
+    first->prev = pos->prev;
+    pos->prev = last;
+    last->next = pos;
+  }
+
+  // 把 [first, last] 的结点从所在链表中断开，结点自身的指针保持不变
+  template <class T>
+  void list_unlink_nodes(list_node_base<T> *first, list_node_base<T> *last)
+  {
+    first->prev->next = last->next;
+    last->next->prev = first->prev;
+  }
+
   // list 迭代器
   template <class T>
   struct list_iterator : public tinystl::iterator<tinystl::bidirectional_iterator_tag, T>
@@ -82,7 +117,8 @@ namespace tinystl
     list_iterator() = default;
     list_iterator(base_ptr x) : node_(x) {}
     list_iterator(node_ptr x) : node_(x->as_base()) {}
-    list_iterator(const list_iterator &rhs) : node_(rhs.node_) {}
+    list_iterator(const list_iterator &rhs) = default;
+    list_iterator &operator=(const list_iterator &rhs) = default;
 
     // 重载操作符
     reference operator*() const { return node_->as_node()->value; }
@@ -136,8 +172,8 @@ namespace tinystl
         : node_(x->as_base()) {}
     list_const_iterator(const list_iterator<T> &rhs)
         : node_(rhs.node_) {}
-    list_const_iterator(const list_const_iterator &rhs)
-        : node_(rhs.node_) {}
+    list_const_iterator(const list_const_iterator &rhs) = default;
+    list_const_iterator &operator=(const list_const_iterator &rhs) = default;
 
     reference operator*() const { return node_->as_node()->value; }
     pointer operator->() const { return &(operator*()); }
@@ -181,6 +217,7 @@ namespace tinystl
     typedef tinystl::allocator<T> data_allocator;
     typedef tinystl::allocator<list_node_base<T>> base_allocator;
     typedef tinystl::allocator<list_node<T>> node_allocator;
+    typedef tinystl::allocator<list_block<T>> block_allocator;
 
     typedef typename allocator_type::value_type value_type;
     typedef typename allocator_type::pointer pointer;
@@ -222,7 +259,8 @@ namespace tinystl
     list(std::initializer_list<T> ilist) { copy_init(ilist.begin(), ilist.end()); }
     list(const list &rhs) { copy_init(rhs.cbegin(), rhs.cend()); }
 
-    list(list &&rhs) noexcept : node_(rhs.node_), size_(rhs.size_)
+    list(list &&rhs) noexcept
+        : node_(rhs.node_), size_(rhs.size_)
     {
       rhs.node_ = nullptr;
       rhs.size_ = 0;
@@ -239,8 +277,11 @@ namespace tinystl
 
     list &operator=(list &&rhs) noexcept
     {
-      clear();
-      splice(end(), rhs);
+      if (this != &rhs)
+      {
+        clear();
+        swap(rhs);
+      }
       return *this;
     }
 
@@ -269,9 +310,9 @@ namespace tinystl
     const_iterator end() const noexcept { return node_; }
 
     reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
-    const_reverse_iterator rbegin() const noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
     reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
-    const_reverse_iterator rend() const noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
 
     const_iterator cbegin() const noexcept { return begin(); }
     const_iterator cend() const noexcept { return end(); }
@@ -279,7 +320,7 @@ namespace tinystl
     const_reverse_iterator crend() const noexcept { return rend(); }
 
     bool empty() const noexcept { return node_->next == node_; }
-    size_type size() const noexcept { return size; }
+    size_type size() const noexcept { return size_; }
     size_type max_size() const noexcept { return static_cast<size_type>(-1); }
 
     // 访问元素操作
@@ -436,8 +477,8 @@ namespace tinystl
 
     void swap(list &rhs) noexcept
     {
-      swap(node_, rhs.node_);
-      swap(size_, rhs.size_);
+      tinystl::swap(node_, rhs.node_);
+      tinystl::swap(size_, rhs.size_);
     }
 
     // list 相关操作
@@ -470,16 +511,20 @@ namespace tinystl
 
     void sort()
     {
-      list_sort(begin(), end(), size(), std::less<T>());
+      list_sort(std::less<T>());
     }
     template <class Compared>
     void sort(Compared comp)
     {
-      list_sort(begin(), end(), size(), comp);
+      list_sort(comp);
     }
 
     void reverse();
 
+    // 把所有结点按顺序重新分配到一块连续内存中并重新链接，所有迭代器失效
+    // 之后的 splice / merge 仍然只修改指针，块中的结点到了哪个 list 都可以单独销毁
+    void compact();
+
   private:
     // helper functioon
     // create / destory node
@@ -512,7 +557,10 @@ namespace tinystl
 
     // sort
     template <class Compared>
-    iterator list_sort(iterator first, iterator last, size_type n, Compared comp);
+    void list_sort(Compared comp);
+    template <class Compared>
+    static void merge_chain(base_ptr &a, base_ptr b, Compared &comp);
+    void relink_chain(base_ptr first);
   };
 
   template <class T>
@@ -522,7 +570,7 @@ namespace tinystl
     auto n = pos.node_;
     auto next = n->next;
     unlink_nodes(n, n);
-    destory_node(n->as_node());
+    destroy_node(n->as_node());
     --size_;
     return iterator(next);
   }
@@ -744,10 +792,59 @@ namespace tinystl
     auto e = end();
     while (i.node_ != e.node_)
     {
-      swap(i.node_->prev, i.node_->next);
+      tinystl::swap(i.node_->prev, i.node_->next);
       i.node_ = i.node_->prev;
     }
-    swap(e.node_->prev, e.node_->next);
+    tinystl::swap(e.node_->prev, e.node_->next);
+  }
+
+  // 压缩 list
+  // 元素的移动构造不抛出异常时移动元素，否则复制，复制失败时容器不变
+  template <class T>
+  void list<T>::compact()
+  {
+    if (size_ == 0)
+      return;
+    list_block<T> *header = block_allocator::allocate(1);
+    node_ptr block = nullptr;
+    size_type n = 0;
+    try
+    {
+      block = node_allocator::allocate(size_);
+      for (base_ptr p = node_->next; p != node_; p = p->next, ++n)
+      {
+        data_allocator::construct(tinystl::address_of(block[n].value),
+                                  std::move_if_noexcept(p->as_node()->value));
+        block[n].block = header;
+      }
+    }
+    catch (...)
+    {
+      for (size_type i = 0; i < n; ++i)
+        data_allocator::destroy(tinystl::address_of(block[i].value));
+      if (block != nullptr)
+        node_allocator::deallocate(block, size_);
+      block_allocator::deallocate(header);
+      throw;
+    }
+    block_allocator::construct(header, size_, block);
+    // 释放旧结点，旧的内存块在其中结点全部销毁时释放
+    for (base_ptr p = node_->next; p != node_;)
+    {
+      base_ptr next = p->next;
+      destroy_node(p->as_node());
+      p = next;
+    }
+    base_ptr prev = node_;
+    for (size_type i = 0; i < size_; ++i)
+    {
+      base_ptr cur = block[i].as_base();
+      cur->prev = prev;
+      prev->next = cur;
+      prev = cur;
+    }
+    prev->next = node_;
+    node_->prev = prev;
   }
 
   /*****************************************************************************************/
@@ -765,6 +862,7 @@ namespace tinystl
       data_allocator::construct(tinystl::address_of(p->value), tinystl::forward<Args>(args)...);
       p->prev = nullptr;
       p->next = nullptr;
+      p->block = nullptr;
     }
     catch (...)
     {
@@ -779,7 +877,17 @@ namespace tinystl
   void list<T>::destroy_node(node_ptr p)
   {
     data_allocator::destroy(tinystl::address_of(p->value));
-    node_allocator::deallocate(p);
+    list_block<T> *b = p->block;
+    if (b == nullptr)
+    {
+      node_allocator::deallocate(p);
+    }
+    else if (b->live.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    { // 块中最后一个结点，不论它此时在哪个 list 中，都由它释放整块内存
+      node_allocator::deallocate(b->nodes, b->size);
+      block_allocator::destroy(b);
+      block_allocator::deallocate(b);
+    }
   }
 
   // 用 n 个元素初始化容器
@@ -856,10 +964,7 @@ namespace tinystl
   template <class T>
   void list<T>::link_nodes(base_ptr pos, base_ptr first, base_ptr last)
   {
-    pos->prev->next = first;
-    first->prev = pos->prev;
-    pos->prev = last;
-    last->next = pos;
+    list_link_nodes(pos, first, last);
   }
 
   // 在头部连接 [first, last] 结点
@@ -886,8 +991,7 @@ namespace tinystl
   template <class T>
   void list<T>::unlink_nodes(base_ptr first, base_ptr last)
   {
-    first->prev->next = last->next;
-    last->next->prev = first->prev;
+    list_unlink_nodes(first, last);
   }
 
   // 用 n 个元素为容器赋值
@@ -1015,81 +1119,131 @@ namespace tinystl
     return r;
   }
 
-  // 对 list 进行归并排序，返回一个迭代器指向区间最小元素的位置
+  // 对 list 进行自底向上的归并排序，不分配内存且保持稳定
+  // bins[i] 为空或是一条长度为 2^i 的有序单向链（以 nullptr 结尾，只使用 next）
+  // 依次取下一个结点，像二进制加一那样与 bins 中的链合并，最后再恢复 prev 指针
   template <class T>
   template <class Compared>
-  typename list<T>::iterator
-  list<T>::list_sort(iterator f1, iterator l2, size_type n, Compared comp)
+  void list<T>::list_sort(Compared comp)
   {
-    if (n < 2)
-      return f1;
+    if (size_ < 2)
+      return;
 
-    if (n == 2)
+    base_ptr bins[64] = {};
+    size_type fill = 0;
+    base_ptr carry = nullptr;
+    base_ptr result = nullptr;
+    base_ptr cur = node_->next;
+    node_->prev->next = nullptr;
+    try
     {
-      if (comp(*--l2, *f1))
+      while (cur != nullptr)
       {
-        auto ln = l2.node_;
-        unlink_nodes(ln, ln);
-        link_nodes(f1.node_, ln, ln);
-        return l2;
+        carry = cur;
+        cur = cur->next;
+        carry->next = nullptr;
+        size_type i = 0;
+        for (; i < fill && bins[i] != nullptr; ++i)
+        { // bins[i] 中的元素在 carry 之前，相等时排在前面
+          base_ptr c = carry;
+          carry = nullptr;
+          merge_chain(bins[i], c, comp);
+          carry = bins[i];
+          bins[i] = nullptr;
+        }
+        bins[i] = carry;
+        carry = nullptr;
+        if (i == fill)
+          ++fill;
+      }
+      // 从短到长合并，编号越大的 bin 中的元素越靠前
+      for (size_type i = 0; i < fill; ++i)
+      {
+        if (bins[i] == nullptr)
+          continue;
+        base_ptr r = result;
+        result = nullptr;
+        merge_chain(bins[i], r, comp);
+        result = bins[i];
+        bins[i] = nullptr;
       }
-      return f1;
-    }
-
-    auto n2 = n / 2;
-    auto l1 = f1;
-    tinystl::advance(l1, n2);
-    auto result = f1 = list_sort(f1, l1, n2, comp); // 前半段的最小位置
-    auto f2 = l1 = list_sort(l1, l2, n - n2, comp); // 后半段的最小位置
-
-    // 把较小的一段区间移到前面
-    if (comp(*f2, *f1))
-    {
-      auto m = f2;
-      ++m;
-      for (; m != l2 && comp(*m, *f1); ++m)
-        ;
-      auto f = f2.node_;
-      auto l = m.node_->prev;
-      result = f2;
-      l1 = f2 = m;
-      unlink_nodes(f, l);
-      m = f1;
-      ++m;
-      link_nodes(f1.node_, f, l);
-      f1 = m;
-    }
-    else
-    {
-      ++f1;
     }
-
-    // 合并两段有序区间
-    while (f1 != l1 && f2 != l2)
+    catch (...)
     {
-      if (comp(*f2, *f1))
+      // comp 抛出异常：把所有链首尾相接放回容器，元素不丢失但顺序不确定
+      base_ptr chains[3] = {carry, cur, result};
+      base_ptr head = nullptr;
+      base_ptr tail = nullptr;
+      for (size_type i = 0; i < 3 + fill; ++i)
       {
-        auto m = f2;
-        ++m;
-        for (; m != l2 && comp(*m, *f1); ++m)
+        base_ptr c = i < 3 ? chains[i] : bins[i - 3];
+        if (c == nullptr)
+          continue;
+        if (tail == nullptr)
+          head = c;
+        else
+          tail->next = c;
+        for (tail = c; tail->next != nullptr; tail = tail->next)
           ;
-        auto f = f2.node_;
-        auto l = m.node_->prev;
-        if (l1 == f2)
-          l1 = m;
-        f2 = m;
-        unlink_nodes(f, l);
-        m = f1;
-        ++m;
-        link_nodes(f1.node_, f, l);
-        f1 = m;
       }
-      else
+      relink_chain(head);
+      throw;
+    }
+    relink_chain(result);
+  }
+
+  // 合并两条有序单向链，结果写回 a，相等时 a 中的元素在前
+  // comp 抛出异常时 a 仍然包含两条链的全部结点
+  template <class T>
+  template <class Compared>
+  void list<T>::merge_chain(base_ptr &a, base_ptr b, Compared &comp)
+  {
+    list_node_base<T> head;
+    base_ptr tail = head.self();
+    base_ptr x = a;
+    try
+    {
+      while (x != nullptr && b != nullptr)
       {
-        ++f1;
+        if (comp(b->as_node()->value, x->as_node()->value))
+        {
+          tail->next = b;
+          b = b->next;
+        }
+        else
+        {
+          tail->next = x;
+          x = x->next;
+        }
+        tail = tail->next;
       }
     }
-    return result;
+    catch (...)
+    {
+      tail->next = x;
+      while (tail->next != nullptr)
+        tail = tail->next;
+      tail->next = b;
+      a = head.next;
+      throw;
+    }
+    tail->next = x != nullptr ? x : b;
+    a = head.next;
+  }
+
+  // 以 first 开始的单向链重建双向环形链表
+  template <class T>
+  void list<T>::relink_chain(base_ptr first)
+  {
+    base_ptr prev = node_;
+    for (base_ptr p = first; p != nullptr; p = p->next)
+    {
+      p->prev = prev;
+      prev->next = p;
+      prev = p;
+    }
+    prev->next = node_;
+    node_->prev = prev;
   }
 
   // 重载比较操作符
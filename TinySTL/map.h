@@ -9,10 +9,12 @@
 
 namespace tinystl
 {
+  template <class Key, class T, class Compare, class NodeUpdate>
+  class multimap;
 
   // 模板类 map，键值不允许重复
   // 参数一代表键值类型，参数二代表实值类型，参数三代表键值的比较方式，缺省使用 tinystl::less
-  template <class Key, class T, class Compare = tinystl::less<Key>>
+  template <class Key, class T, class Compare = tinystl::less<Key>, class NodeUpdate = tinystl::rb_tree_null_update>
   class map
   {
   public:
@@ -25,7 +27,7 @@ namespace tinystl
     // 定义一个 functor，用来进行元素比较
     class value_compare : public binary_function<value_type, value_type, bool>
     {
-      friend class map<Key, T, Compare>;
+      friend class map<Key, T, Compare, NodeUpdate>;
 
     private:
       Compare comp;
@@ -40,12 +42,13 @@ namespace tinystl
 
   private:
     // 以 tinystl::rb_tree 作为底层机制
-    typedef tinystl::rb_tree<value_type, key_compare> base_type;
+    typedef tinystl::rb_tree<value_type, key_compare, NodeUpdate> base_type;
     base_type tree_;
 
   public:
     // 使用 rb_tree 的型别
-    typedef typename base_type::node_type node_type;
+    typedef typename base_type::node_handle_type node_type;
+    typedef typename base_type::insert_return_type insert_return_type;
     typedef typename base_type::pointer pointer;
     typedef typename base_type::const_pointer const_pointer;
     typedef typename base_type::reference reference;
@@ -248,6 +251,20 @@ namespace tinystl
 
     void clear() { tree_.clear(); }
 
+    // 节点句柄，在容器之间转移元素时只重新链接节点，不分配内存也不复制元素
+
+    node_type extract(iterator position) { return tree_.extract(position); }
+    node_type extract(const key_type &key) { return tree_.extract(key); }
+
+    insert_return_type insert(node_type &&nh) { return tree_.insert_unique(tinystl::move(nh)); }
+    iterator insert(iterator hint, node_type &&nh) { return tree_.insert_unique(hint, tinystl::move(nh)); }
+
+    // 键值已存在的元素留在 source 中
+    void merge(map &source) { tree_.merge_unique(source.tree_); }
+    void merge(map &&source) { tree_.merge_unique(source.tree_); }
+    void merge(multimap<Key, T, Compare, NodeUpdate> &source) { tree_.merge_unique(source.tree_); }
+    void merge(multimap<Key, T, Compare, NodeUpdate> &&source) { tree_.merge_unique(source.tree_); }
+
     // map 相关操作
 
     iterator find(const key_type &key) { return tree_.find(key); }
@@ -273,56 +290,119 @@ namespace tinystl
       return tree_.equal_range_unique(key);
     }
 
+    // 异构查找，Compare 带有 is_transparent 标记（如 tinystl::less<>）时才参与重载决议
+    // 与 key 等价的元素可能不止一个，count 与 equal_range 按区间计算
+
+    template <class K, class C = Compare, typename std::enable_if<
+                                              tinystl::is_transparent<C>::value, int>::type = 0>
+    iterator find(const K &key) { return tree_.find(key); }
+    template <class K, class C = Compare, typename std::enable_if<
+                                              tinystl::is_transparent<C>::value, int>::type = 0>
+    const_iterator find(const K &key) const { return tree_.find(key); }
+
+    template <class K, class C = Compare, typename std::enable_if<
+                                              tinystl::is_transparent<C>::value, int>::type = 0>
+    size_type count(const K &key) const { return tree_.count_multi(key); }
+
+    template <class K, class C = Compare, typename std::enable_if<
+                                              tinystl::is_transparent<C>::value, int>::type = 0>
+    iterator lower_bound(const K &key) { return tree_.lower_bound(key); }
+    template <class K, class C = Compare, typename std::enable_if<
+                                              tinystl::is_transparent<C>::value, int>::type = 0>
+    const_iterator lower_bound(const K &key) const { return tree_.lower_bound(key); }
+
+    template <class K, class C = Compare, typename std::enable_if<
+                                              tinystl::is_transparent<C>::value, int>::type = 0>
+    iterator upper_bound(const K &key) { return tree_.upper_bound(key); }
+    template <class K, class C = Compare, typename std::enable_if<
+                                              tinystl::is_transparent<C>::value, int>::type = 0>
+    const_iterator upper_bound(const K &key) const { return tree_.upper_bound(key); }
+
+    template <class K, class C = Compare, typename std::enable_if<
+                                              tinystl::is_transparent<C>::value, int>::type = 0>
+    pair<iterator, iterator>
+    equal_range(const K &key)
+    {
+      return tree_.equal_range_multi(key);
+    }
+    template <class K, class C = Compare, typename std::enable_if<
+                                              tinystl::is_transparent<C>::value, int>::type = 0>
+    pair<const_iterator, const_iterator>
+    equal_range(const K &key) const
+    {
+      return tree_.equal_range_multi(key);
+    }
+
     void swap(map &rhs) noexcept
     {
       tree_.swap(rhs.tree_);
     }
 
+    // 把元素重新分配到一块连续内存中以改善遍历的局部性，所有迭代器失效
+    void compact() { tree_.compact(); }
+
+    // 顺序统计：第 k 小的元素、小于 key 的元素个数、两个迭代器间的距离
+    // NodeUpdate 为 rb_tree_size_update 时为 O(log n)，否则退化为 O(n)
+    iterator nth(size_type k) { return tree_.nth(k); }
+    const_iterator nth(size_type k) const { return tree_.nth(k); }
+    size_type rank(const key_type &key) const { return tree_.rank(key); }
+    difference_type distance(const_iterator first, const_iterator last) const
+    {
+      return tree_.distance(first, last);
+    }
+
+    // 集合运算，other 的元素并入本容器或被销毁，完成后 other 为空
+    // 基于 rb_tree 的 split / join，复杂度为 O(m log(n / m + 1))，threads > 1 时并行执行
+    void set_union(map &other, size_type threads = 1) { tree_.union_unique(other.tree_, threads); }
+    void set_intersection(map &other, size_type threads = 1) { tree_.intersection_unique(other.tree_, threads); }
+    void set_difference(map &other, size_type threads = 1) { tree_.difference_unique(other.tree_, threads); }
+
   public:
+    friend class multimap<Key, T, Compare, NodeUpdate>;
     friend bool operator==(const map &lhs, const map &rhs) { return lhs.tree_ == rhs.tree_; }
     friend bool operator<(const map &lhs, const map &rhs) { return lhs.tree_ < rhs.tree_; }
   };
 
   // 重载比较操作符
-  template <class Key, class T, class Compare>
-  bool operator==(const map<Key, T, Compare> &lhs, const map<Key, T, Compare> &rhs)
+  template <class Key, class T, class Compare, class NodeUpdate>
+  bool operator==(const map<Key, T, Compare, NodeUpdate> &lhs, const map<Key, T, Compare, NodeUpdate> &rhs)
   {
     return lhs == rhs;
   }
 
-  template <class Key, class T, class Compare>
-  bool operator<(const map<Key, T, Compare> &lhs, const map<Key, T, Compare> &rhs)
+  template <class Key, class T, class Compare, class NodeUpdate>
+  bool operator<(const map<Key, T, Compare, NodeUpdate> &lhs, const map<Key, T, Compare, NodeUpdate> &rhs)
   {
     return lhs < rhs;
   }
 
-  template <class Key, class T, class Compare>
-  bool operator!=(const map<Key, T, Compare> &lhs, const map<Key, T, Compare> &rhs)
+  template <class Key, class T, class Compare, class NodeUpdate>
+  bool operator!=(const map<Key, T, Compare, NodeUpdate> &lhs, const map<Key, T, Compare, NodeUpdate> &rhs)
   {
     return !(lhs == rhs);
   }
 
-  template <class Key, class T, class Compare>
-  bool operator>(const map<Key, T, Compare> &lhs, const map<Key, T, Compare> &rhs)
+  template <class Key, class T, class Compare, class NodeUpdate>
+  bool operator>(const map<Key, T, Compare, NodeUpdate> &lhs, const map<Key, T, Compare, NodeUpdate> &rhs)
   {
     return rhs < lhs;
   }
 
-  template <class Key, class T, class Compare>
-  bool operator<=(const map<Key, T, Compare> &lhs, const map<Key, T, Compare> &rhs)
+  template <class Key, class T, class Compare, class NodeUpdate>
+  bool operator<=(const map<Key, T, Compare, NodeUpdate> &lhs, const map<Key, T, Compare, NodeUpdate> &rhs)
   {
     return !(rhs < lhs);
   }
 
-  template <class Key, class T, class Compare>
-  bool operator>=(const map<Key, T, Compare> &lhs, const map<Key, T, Compare> &rhs)
+  template <class Key, class T, class Compare, class NodeUpdate>
+  bool operator>=(const map<Key, T, Compare, NodeUpdate> &lhs, const map<Key, T, Compare, NodeUpdate> &rhs)
   {
     return !(lhs < rhs);
   }
 
   // 重载 tinystl 的 swap
-  template <class Key, class T, class Compare>
-  void swap(map<Key, T, Compare> &lhs, map<Key, T, Compare> &rhs) noexcept
+  template <class Key, class T, class Compare, class NodeUpdate>
+  void swap(map<Key, T, Compare, NodeUpdate> &lhs, map<Key, T, Compare, NodeUpdate> &rhs) noexcept
   {
     lhs.swap(rhs);
   }
@@ -331,7 +411,7 @@ namespace tinystl
 
   // 模板类 multimap，键值允许重复
   // 参数一代表键值类型，参数二代表实值类型，参数三代表键值的比较方式，缺省使用 tinystl::less
-  template <class Key, class T, class Compare = tinystl::less<Key>>
+  template <class Key, class T, class Compare = tinystl::less<Key>, class NodeUpdate = tinystl::rb_tree_null_update>
   class multimap
   {
   public:
@@ -344,7 +424,7 @@ namespace tinystl
     // 定义一个 functor，用来进行元素比较
     class value_compare : public binary_function<value_type, value_type, bool>
     {
-      friend class multimap<Key, T, Compare>;
+      friend class multimap<Key, T, Compare, NodeUpdate>;
 
     private:
       Compare comp;
@@ -359,12 +439,13 @@ namespace tinystl
 
   private:
     // 用 tinystl::rb_tree 作为底层机制
-    typedef tinystl::rb_tree<value_type, key_compare> base_type;
+    typedef tinystl::rb_tree<value_type, key_compare, NodeUpdate> base_type;
     base_type tree_;
 
   public:
     // 使用 rb_tree 的型别
-    typedef typename base_type::node_type node_type;
+    typedef typename base_type::node_handle_type node_type;
+    typedef typename base_type::insert_return_type insert_return_type;
     typedef typename base_type::pointer pointer;
     typedef typename base_type::const_pointer const_pointer;
     typedef typename base_type::reference reference;
@@ -529,6 +610,19 @@ namespace tinystl
 
     void clear() { tree_.clear(); }
 
+    // 节点句柄，在容器之间转移元素时只重新链接节点，不分配内存也不复制元素
+
+    node_type extract(iterator position) { return tree_.extract(position); }
+    node_type extract(const key_type &key) { return tree_.extract(key); }
+
+    iterator insert(node_type &&nh) { return tree_.insert_multi(tinystl::move(nh)); }
+    iterator insert(iterator hint, node_type &&nh) { return tree_.insert_multi(hint, tinystl::move(nh)); }
+
+    void merge(multimap &source) { tree_.merge_multi(source.tree_); }
+    void merge(multimap &&source) { tree_.merge_multi(source.tree_); }
+    void merge(map<Key, T, Compare, NodeUpdate> &source) { tree_.merge_multi(source.tree_); }
+    void merge(map<Key, T, Compare, NodeUpdate> &&source) { tree_.merge_multi(source.tree_); }
+
     // multimap 相关操作
 
     iterator find(const key_type &key) { return tree_.find(key); }
@@ -554,56 +648,113 @@ namespace tinystl
       return tree_.equal_range_multi(key);
     }
 
+    // 异构查找，Compare 带有 is_transparent 标记（如 tinystl::less<>）时才参与重载决议
+    // 与 key 等价的元素可能不止一个，count 与 equal_range 按区间计算
+
+    template <class K, class C = Compare, typename std::enable_if<
+                                              tinystl::is_transparent<C>::value, int>::type = 0>
+    iterator find(const K &key) { return tree_.find(key); }
+    template <class K, class C = Compare, typename std::enable_if<
+                                              tinystl::is_transparent<C>::value, int>::type = 0>
+    const_iterator find(const K &key) const { return tree_.find(key); }
+
+    template <class K, class C = Compare, typename std::enable_if<
+                                              tinystl::is_transparent<C>::value, int>::type = 0>
+    size_type count(const K &key) const { return tree_.count_multi(key); }
+
+    template <class K, class C = Compare, typename std::enable_if<
+                                              tinystl::is_transparent<C>::value, int>::type = 0>
+    iterator lower_bound(const K &key) { return tree_.lower_bound(key); }
+    template <class K, class C = Compare, typename std::enable_if<
+                                              tinystl::is_transparent<C>::value, int>::type = 0>
+    const_iterator lower_bound(const K &key) const { return tree_.lower_bound(key); }
+
+    template <class K, class C = Compare, typename std::enable_if<
+                                              tinystl::is_transparent<C>::value, int>::type = 0>
+    iterator upper_bound(const K &key) { return tree_.upper_bound(key); }
+    template <class K, class C = Compare, typename std::enable_if<
+                                              tinystl::is_transparent<C>::value, int>::type = 0>
+    const_iterator upper_bound(const K &key) const { return tree_.upper_bound(key); }
+
+    template <class K, class C = Compare, typename std::enable_if<
+                                              tinystl::is_transparent<C>::value, int>::type = 0>
+    pair<iterator, iterator>
+    equal_range(const K &key)
+    {
+      return tree_.equal_range_multi(key);
+    }
+    template <class K, class C = Compare, typename std::enable_if<
+                                              tinystl::is_transparent<C>::value, int>::type = 0>
+    pair<const_iterator, const_iterator>
+    equal_range(const K &key) const
+    {
+      return tree_.equal_range_multi(key);
+    }
+
     void swap(multimap &rhs) noexcept
     {
       tree_.swap(rhs.tree_);
     }
 
+    // 把元素重新分配到一块连续内存中以改善遍历的局部性，所有迭代器失效
+    void compact() { tree_.compact(); }
+
+    // 顺序统计：第 k 小的元素、小于 key 的元素个数、两个迭代器间的距离
+    // NodeUpdate 为 rb_tree_size_update 时为 O(log n)，否则退化为 O(n)
+    iterator nth(size_type k) { return tree_.nth(k); }
+    const_iterator nth(size_type k) const { return tree_.nth(k); }
+    size_type rank(const key_type &key) const { return tree_.rank(key); }
+    difference_type distance(const_iterator first, const_iterator last) const
+    {
+      return tree_.distance(first, last);
+    }
+
   public:
+    friend class map<Key, T, Compare, NodeUpdate>;
     friend bool operator==(const multimap &lhs, const multimap &rhs) { return lhs.tree_ == rhs.tree_; }
     friend bool operator<(const multimap &lhs, const multimap &rhs) { return lhs.tree_ < rhs.tree_; }
   };
 
   // 重载比较操作符
-  template <class Key, class T, class Compare>
-  bool operator==(const multimap<Key, T, Compare> &lhs, const multimap<Key, T, Compare> &rhs)
+  template <class Key, class T, class Compare, class NodeUpdate>
+  bool operator==(const multimap<Key, T, Compare, NodeUpdate> &lhs, const multimap<Key, T, Compare, NodeUpdate> &rhs)
   {
     return lhs == rhs;
   }
 
-  template <class Key, class T, class Compare>
-  bool operator<(const multimap<Key, T, Compare> &lhs, const multimap<Key, T, Compare> &rhs)
+  template <class Key, class T, class Compare, class NodeUpdate>
+  bool operator<(const multimap<Key, T, Compare, NodeUpdate> &lhs, const multimap<Key, T, Compare, NodeUpdate> &rhs)
   {
     return lhs < rhs;
   }
 
-  template <class Key, class T, class Compare>
-  bool operator!=(const multimap<Key, T, Compare> &lhs, const multimap<Key, T, Compare> &rhs)
+  template <class Key, class T, class Compare, class NodeUpdate>
+  bool operator!=(const multimap<Key, T, Compare, NodeUpdate> &lhs, const multimap<Key, T, Compare, NodeUpdate> &rhs)
   {
     return !(lhs == rhs);
   }
 
-  template <class Key, class T, class Compare>
-  bool operator>(const multimap<Key, T, Compare> &lhs, const multimap<Key, T, Compare> &rhs)
+  template <class Key, class T, class Compare, class NodeUpdate>
+  bool operator>(const multimap<Key, T, Compare, NodeUpdate> &lhs, const multimap<Key, T, Compare, NodeUpdate> &rhs)
   {
     return rhs < lhs;
   }
 
-  template <class Key, class T, class Compare>
-  bool operator<=(const multimap<Key, T, Compare> &lhs, const multimap<Key, T, Compare> &rhs)
+  template <class Key, class T, class Compare, class NodeUpdate>
+  bool operator<=(const multimap<Key, T, Compare, NodeUpdate> &lhs, const multimap<Key, T, Compare, NodeUpdate> &rhs)
   {
     return !(rhs < lhs);
   }
 
-  template <class Key, class T, class Compare>
-  bool operator>=(const multimap<Key, T, Compare> &lhs, const multimap<Key, T, Compare> &rhs)
+  template <class Key, class T, class Compare, class NodeUpdate>
+  bool operator>=(const multimap<Key, T, Compare, NodeUpdate> &lhs, const multimap<Key, T, Compare, NodeUpdate> &rhs)
   {
     return !(lhs < rhs);
   }
 
   // 重载 tinystl 的 swap
-  template <class Key, class T, class Compare>
-  void swap(multimap<Key, T, Compare> &lhs, multimap<Key, T, Compare> &rhs) noexcept
+  template <class Key, class T, class Compare, class NodeUpdate>
+  void swap(multimap<Key, T, Compare, NodeUpdate> &lhs, multimap<Key, T, Compare, NodeUpdate> &rhs) noexcept
   {
     lhs.swap(rhs);
   }
@@ -0,0 +1,427 @@
+#ifndef TINYSTL_MPMC_QUEUE_H_
+#define TINYSTL_MPMC_QUEUE_H_
+
+// 这个头文件包含一个有界的多生产者多消费者无锁队列 mpmc_queue
+// 算法参考 Dmitry Vyukov 的 bounded MPMC queue，每个槽位带有一个序号，
+// 生产者与消费者只在各自的位置计数器上竞争，不需要全局锁
+
+// notes:
+//
+// 1. try_push / try_pop 为无锁操作，队列满或空时立即返回 false
+// 2. push / pop 为阻塞操作，先自旋重试，仍不成功时在条件变量上等待
+// 3. try_push_n / try_pop_n 一次占用多个连续槽位，减少计数器上的竞争
+// 4. 为保证占用槽位后不会因异常而卡死队列，要求 T 的移动构造、移动赋值和析构不抛出异常
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "allocator.h"
+#include "construct.h"
+#include "utils.h"
+#include "exceptdef.h"
+
+namespace tinystl
+{
+// 缓存行大小，用于隔开会被不同线程频繁写入的数据
+#ifndef TINYSTL_CACHELINE_SIZE
+#define TINYSTL_CACHELINE_SIZE 64
+#endif
+
+// 阻塞操作在进入等待前的自旋次数
+#ifndef MPMC_QUEUE_SPIN_COUNT
+#define MPMC_QUEUE_SPIN_COUNT 128
+#endif
+
+  // mpmc_queue 的槽位：序号加上一块未初始化的存储空间
+  template <class T>
+  struct mpmc_queue_cell
+  {
+    std::atomic<size_t> seq;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+    T *value_ptr() noexcept { return reinterpret_cast<T *>(&storage); }
+  };
+
+  // 模板类 mpmc_queue
+  // 模板参数代表数据类型，容量在构造时给定，并向上取整为 2 的幂
+  template <class T>
+  class mpmc_queue
+  {
+    static_assert(std::is_nothrow_move_constructible<T>::value,
+                  "the value_type of mpmc_queue should be nothrow move constructible");
+    static_assert(std::is_nothrow_move_assignable<T>::value,
+                  "the value_type of mpmc_queue should be nothrow move assignable");
+    static_assert(std::is_nothrow_destructible<T>::value,
+                  "the value_type of mpmc_queue should be nothrow destructible");
+
+  public:
+    typedef T value_type;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef size_t size_type;
+
+    typedef mpmc_queue_cell<T> cell_type;
+    typedef tinystl::allocator<cell_type> cell_allocator;
+    typedef tinystl::allocator<T> data_allocator;
+
+  private:
+    // 只读数据、入队位置、出队位置分别放在不同的缓存行上，避免伪共享
+    cell_type *buffer_;
+    size_type mask_;
+    char pad0_[TINYSTL_CACHELINE_SIZE - sizeof(cell_type *) - sizeof(size_type)];
+
+    std::atomic<size_type> enqueue_pos_;
+    char pad1_[TINYSTL_CACHELINE_SIZE - sizeof(std::atomic<size_type>)];
+
+    std::atomic<size_type> dequeue_pos_;
+    char pad2_[TINYSTL_CACHELINE_SIZE - sizeof(std::atomic<size_type>)];
+
+    // 阻塞操作使用的等待设施，只有存在等待者时才会被生产者 / 消费者触碰
+    std::atomic<size_type> push_waiters_;
+    std::atomic<size_type> pop_waiters_;
+    std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+
+  public:
+    // 构造、析构函数
+    explicit mpmc_queue(size_type capacity);
+
+    mpmc_queue(const mpmc_queue &) = delete;
+    mpmc_queue &operator=(const mpmc_queue &) = delete;
+
+    ~mpmc_queue();
+
+  public:
+    // 容量相关操作
+    size_type capacity() const noexcept { return mask_ + 1; }
+
+    // 在并发修改时只是一个近似值
+    size_type size_approx() const noexcept
+    {
+      const size_type enq = enqueue_pos_.load(std::memory_order_relaxed);
+      const size_type deq = dequeue_pos_.load(std::memory_order_relaxed);
+      return enq > deq ? enq - deq : 0;
+    }
+    bool empty_approx() const noexcept { return size_approx() == 0; }
+
+    // 非阻塞操作
+
+    template <class... Args>
+    bool try_emplace(Args &&...args);
+
+    bool try_push(const value_type &value) { return try_emplace(value); }
+    bool try_push(value_type &&value) { return try_emplace(tinystl::move(value)); }
+
+    bool try_pop(value_type &value);
+
+    // 批量操作，返回实际放入 / 取出的元素个数
+    template <class ForwardIter>
+    size_type try_push_n(ForwardIter first, size_type n);
+
+    template <class OutputIter>
+    size_type try_pop_n(OutputIter result, size_type n);
+
+    // 阻塞操作
+
+    template <class... Args>
+    void emplace(Args &&...args);
+
+    void push(const value_type &value) { emplace(value); }
+    void push(value_type &&value) { emplace(tinystl::move(value)); }
+
+    void pop(value_type &value);
+
+  private:
+    // helper functions
+    bool enqueue(value_type &value);
+    bool dequeue(value_type &value);
+    void notify_not_empty(size_type n);
+    void notify_not_full(size_type n);
+  };
+
+  /*****************************************************************************************/
+
+  // 构造函数
+  template <class T>
+  mpmc_queue<T>::mpmc_queue(size_type capacity)
+      : enqueue_pos_(0), dequeue_pos_(0), push_waiters_(0), pop_waiters_(0)
+  {
+    THROW_LENGTH_ERROR_IF(capacity > (static_cast<size_type>(-1) >> 2),
+                          "mpmc_queue<T>'s capacity too big");
+    size_type n = 2;
+    while (n < capacity)
+      n <<= 1;
+    buffer_ = cell_allocator::allocate(n);
+    for (size_type i = 0; i < n; ++i)
+      ::new (static_cast<void *>(&buffer_[i].seq)) std::atomic<size_type>(i);
+    mask_ = n - 1;
+  }
+
+  // 析构函数，销毁队列中剩余的元素
+  template <class T>
+  mpmc_queue<T>::~mpmc_queue()
+  {
+    const size_type last = enqueue_pos_.load(std::memory_order_relaxed);
+    for (size_type pos = dequeue_pos_.load(std::memory_order_relaxed); pos != last; ++pos)
+      data_allocator::destroy(buffer_[pos & mask_].value_ptr());
+    cell_allocator::deallocate(buffer_, mask_ + 1);
+    buffer_ = nullptr;
+  }
+
+  // 尝试就地构造一个元素放入队尾，队列满时返回 false
+  // 元素先在占用槽位之前构造好，构造抛出异常时队列不受影响
+  template <class T>
+  template <class... Args>
+  bool mpmc_queue<T>::try_emplace(Args &&...args)
+  {
+    value_type tmp(tinystl::forward<Args>(args)...);
+    if (!enqueue(tmp))
+      return false;
+    notify_not_empty(1);
+    return true;
+  }
+
+  // 尝试从队头取出一个元素，队列空时返回 false
+  template <class T>
+  bool mpmc_queue<T>::try_pop(value_type &value)
+  {
+    if (!dequeue(value))
+      return false;
+    notify_not_full(1);
+    return true;
+  }
+
+  // 批量放入 [first, first + n) 内的元素，元素以移动的方式放入队列
+  // 一次 CAS 占用多个连续的空闲槽位，返回实际放入的个数
+  template <class T>
+  template <class ForwardIter>
+  typename mpmc_queue<T>::size_type
+  mpmc_queue<T>::try_push_n(ForwardIter first, size_type n)
+  {
+    if (n == 0)
+      return 0;
+    size_type pos = enqueue_pos_.load(std::memory_order_relaxed);
+    size_type k = 0;
+    for (;;)
+    {
+      // 统计从 pos 开始有多少个连续的空闲槽位
+      k = 0;
+      while (k < n && k <= mask_ &&
+             buffer_[(pos + k) & mask_].seq.load(std::memory_order_acquire) == pos + k)
+        ++k;
+      if (k == 0)
+      {
+        const size_type seq = buffer_[pos & mask_].seq.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos) < 0)
+          return 0; // 队列已满
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+        continue;
+      }
+      if (enqueue_pos_.compare_exchange_weak(pos, pos + k, std::memory_order_relaxed))
+        break;
+    }
+    for (size_type i = 0; i < k; ++i, ++first)
+    {
+      cell_type &cell = buffer_[(pos + i) & mask_];
+      data_allocator::construct(cell.value_ptr(), tinystl::move(*first));
+      cell.seq.store(pos + i + 1, std::memory_order_release);
+    }
+    notify_not_empty(k);
+    return k;
+  }
+
+  // 批量取出至多 n 个元素写入 result，返回实际取出的个数
+  template <class T>
+  template <class OutputIter>
+  typename mpmc_queue<T>::size_type
+  mpmc_queue<T>::try_pop_n(OutputIter result, size_type n)
+  {
+    if (n == 0)
+      return 0;
+    size_type pos = dequeue_pos_.load(std::memory_order_relaxed);
+    size_type k = 0;
+    for (;;)
+    {
+      // 统计从 pos 开始有多少个连续的已写入槽位
+      k = 0;
+      while (k < n && k <= mask_ &&
+             buffer_[(pos + k) & mask_].seq.load(std::memory_order_acquire) == pos + k + 1)
+        ++k;
+      if (k == 0)
+      {
+        const size_type seq = buffer_[pos & mask_].seq.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0)
+          return 0; // 队列为空
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+        continue;
+      }
+      if (dequeue_pos_.compare_exchange_weak(pos, pos + k, std::memory_order_relaxed))
+        break;
+    }
+    for (size_type i = 0; i < k; ++i, ++result)
+    {
+      cell_type &cell = buffer_[(pos + i) & mask_];
+      *result = tinystl::move(*cell.value_ptr());
+      data_allocator::destroy(cell.value_ptr());
+      cell.seq.store(pos + i + mask_ + 1, std::memory_order_release);
+    }
+    notify_not_full(k);
+    return k;
+  }
+
+  // 阻塞地放入一个元素，队列满时等待消费者取走元素
+  template <class T>
+  template <class... Args>
+  void mpmc_queue<T>::emplace(Args &&...args)
+  {
+    value_type tmp(tinystl::forward<Args>(args)...);
+    for (int i = 0; i < MPMC_QUEUE_SPIN_COUNT; ++i)
+    {
+      if (enqueue(tmp))
+      {
+        notify_not_empty(1);
+        return;
+      }
+      if (i >= MPMC_QUEUE_SPIN_COUNT / 2)
+        std::this_thread::yield();
+    }
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      push_waiters_.fetch_add(1, std::memory_order_seq_cst);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      while (!enqueue(tmp))
+        not_full_.wait(lock);
+      push_waiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    // 唤醒需要持有 mutex_，必须在释放锁之后进行
+    notify_not_empty(1);
+  }
+
+  // 阻塞地取出一个元素，队列空时等待生产者放入元素
+  template <class T>
+  void mpmc_queue<T>::pop(value_type &value)
+  {
+    for (int i = 0; i < MPMC_QUEUE_SPIN_COUNT; ++i)
+    {
+      if (dequeue(value))
+      {
+        notify_not_full(1);
+        return;
+      }
+      if (i >= MPMC_QUEUE_SPIN_COUNT / 2)
+        std::this_thread::yield();
+    }
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      pop_waiters_.fetch_add(1, std::memory_order_seq_cst);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      while (!dequeue(value))
+        not_empty_.wait(lock);
+      pop_waiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    notify_not_full(1);
+  }
+
+  /*****************************************************************************************/
+  // helper function
+
+  // 把 value 移动到队尾，队列满时返回 false 且 value 保持不变，不唤醒等待者
+  template <class T>
+  bool mpmc_queue<T>::enqueue(value_type &value)
+  {
+    cell_type *cell;
+    size_type pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;)
+    {
+      cell = &buffer_[pos & mask_];
+      const size_type seq = cell->seq.load(std::memory_order_acquire);
+      const intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (dif == 0)
+      { // 该槽位空闲，尝试占用它
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          break;
+      }
+      else if (dif < 0)
+      { // 队列已满
+        return false;
+      }
+      else
+      { // 其他生产者抢先一步，重新读取位置
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    data_allocator::construct(cell->value_ptr(), tinystl::move(value));
+    cell->seq.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  // 从队头取出一个元素放入 value，队列空时返回 false，不唤醒等待者
+  template <class T>
+  bool mpmc_queue<T>::dequeue(value_type &value)
+  {
+    cell_type *cell;
+    size_type pos = dequeue_pos_.load(std::memory_order_relaxed);
+    for (;;)
+    {
+      cell = &buffer_[pos & mask_];
+      const size_type seq = cell->seq.load(std::memory_order_acquire);
+      const intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+      if (dif == 0)
+      { // 该槽位已被写入，尝试占用它
+        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          break;
+      }
+      else if (dif < 0)
+      { // 队列为空
+        return false;
+      }
+      else
+      { // 其他消费者抢先一步，重新读取位置
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    value = tinystl::move(*cell->value_ptr());
+    data_allocator::destroy(cell->value_ptr());
+    // 槽位交还给下一轮的生产者
+    cell->seq.store(pos + mask_ + 1, std::memory_order_release);
+    return true;
+  }
+
+  // 放入元素后唤醒等待的消费者
+  // 与等待者一侧的 fence 配对：要么等待者看到新元素，要么这里看到等待者
+  template <class T>
+  void mpmc_queue<T>::notify_not_empty(size_type n)
+  {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (pop_waiters_.load(std::memory_order_relaxed) != 0)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (n == 1)
+        not_empty_.notify_one();
+      else
+        not_empty_.notify_all();
+    }
+  }
+
+  // 取出元素后唤醒等待的生产者
+  template <class T>
+  void mpmc_queue<T>::notify_not_full(size_type n)
+  {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (push_waiters_.load(std::memory_order_relaxed) != 0)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (n == 1)
+        not_full_.notify_one();
+      else
+        not_full_.notify_all();
+    }
+  }
+
+} // namespace tinystl
+
+#endif // !TINYSTL_MPMC_QUEUE_H_
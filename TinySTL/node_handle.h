@@ -0,0 +1,157 @@
+#ifndef TINYSTL_NODE_HANDLE_H_
+#define TINYSTL_NODE_HANDLE_H_
+
+// 这个头文件包含模板类 node_handle 与 node_insert_return
+// node_handle : 节点句柄，持有从关联容器中摘下的节点，用于 extract / insert(node_type&&) / merge
+
+// notes:
+//
+// 1. 节点在容器之间转移时只重新链接指针，不分配内存，也不复制或移动元素
+// 2. 句柄只能移动不能复制，析构时销毁仍持有的节点
+// 3. map 类容器的句柄提供 key() / mapped()，set 类容器的句柄提供 value()
+// 4. key() 返回非 const 引用，可以在重新插入之前修改键值
+
+#include "allocator.h"
+#include "memory.h"
+#include "utils.h"
+#include "type_traits.h"
+#include "exceptdef.h"
+
+namespace tinystl
+{
+  template <class T, class Compare, class NodeUpdate>
+  class rb_tree;
+
+  template <class T, class Hash, class KeyEqual, class BucketPolicy>
+  class hashtable;
+
+  // node_handle 的基类，按元素类型提供不同的访问接口
+  template <class Node, class T, bool IsMap = tinystl::is_pair<T>::value>
+  class node_handle_base
+  {
+  public:
+    typedef T value_type;
+
+    value_type &value() const
+    {
+      TINYSTL_DEBUG(ptr_ != nullptr);
+      return ptr_->value;
+    }
+
+  protected:
+    Node *ptr_;
+  };
+
+  template <class Node, class T>
+  class node_handle_base<Node, T, true>
+  {
+  public:
+    typedef typename std::remove_cv<typename T::first_type>::type key_type;
+    typedef typename T::second_type mapped_type;
+
+    key_type &key() const
+    {
+      TINYSTL_DEBUG(ptr_ != nullptr);
+      return const_cast<key_type &>(ptr_->value.first);
+    }
+    mapped_type &mapped() const
+    {
+      TINYSTL_DEBUG(ptr_ != nullptr);
+      return ptr_->value.second;
+    }
+
+  protected:
+    Node *ptr_;
+  };
+
+  // 模板类 node_handle
+  // 参数一代表节点类型，节点中的元素保存在 value 成员中，参数二代表元素类型
+  template <class Node, class T>
+  class node_handle : public node_handle_base<Node, T>
+  {
+    template <class T1, class Compare, class NodeUpdate>
+    friend class tinystl::rb_tree;
+    template <class T1, class Hash, class KeyEqual, class BucketPolicy>
+    friend class tinystl::hashtable;
+
+    typedef node_handle_base<Node, T> base_type;
+    typedef tinystl::allocator<T> data_allocator;
+    typedef tinystl::allocator<Node> node_allocator;
+
+  public:
+    typedef tinystl::allocator<T> allocator_type;
+
+    node_handle() noexcept { this->ptr_ = nullptr; }
+
+    node_handle(node_handle &&rhs) noexcept
+    {
+      this->ptr_ = rhs.ptr_;
+      rhs.ptr_ = nullptr;
+    }
+
+    node_handle &operator=(node_handle &&rhs) noexcept
+    {
+      if (this != &rhs)
+      {
+        reset();
+        this->ptr_ = rhs.ptr_;
+        rhs.ptr_ = nullptr;
+      }
+      return *this;
+    }
+
+    node_handle(const node_handle &) = delete;
+    node_handle &operator=(const node_handle &) = delete;
+
+    ~node_handle() { reset(); }
+
+    bool empty() const noexcept { return this->ptr_ == nullptr; }
+    explicit operator bool() const noexcept { return this->ptr_ != nullptr; }
+
+    allocator_type get_allocator() const { return allocator_type(); }
+
+    void swap(node_handle &rhs) noexcept
+    {
+      tinystl::swap(this->ptr_, rhs.ptr_);
+    }
+
+  private:
+    explicit node_handle(Node *p) noexcept { this->ptr_ = p; }
+
+    // 交出节点的所有权
+    Node *release() noexcept
+    {
+      Node *p = this->ptr_;
+      this->ptr_ = nullptr;
+      return p;
+    }
+
+    void reset() noexcept
+    {
+      if (this->ptr_ != nullptr)
+      {
+        data_allocator::destroy(tinystl::address_of(this->ptr_->value));
+        node_allocator::deallocate(this->ptr_);
+        this->ptr_ = nullptr;
+      }
+    }
+  };
+
+  // 重载 tinystl 的 swap
+  template <class Node, class T>
+  void swap(node_handle<Node, T> &lhs, node_handle<Node, T> &rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+  // insert(node_type&&) 的返回值，插入失败时节点仍由 node 持有
+  template <class Iterator, class NodeHandle>
+  struct node_insert_return
+  {
+    Iterator position;
+    bool inserted;
+    NodeHandle node;
+  };
+
+} // namespace tinystl
+#endif // !TINYSTL_NODE_HANDLE_H_
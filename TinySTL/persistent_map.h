@@ -0,0 +1,834 @@
+#ifndef TINYSTL_PERSISTENT_MAP_H_
+#define TINYSTL_PERSISTENT_MAP_H_
+
+// 这个头文件包含一个持久化的有序映射 persistent_map
+// 底层为 AVL 树，节点带有引用计数，修改时只复制从根到修改位置的路径（path copying），
+// 没有被修改的子树由新旧版本共享
+
+// notes:
+//
+// 1. snapshot() 与复制构造只增加根节点的引用计数，复杂度为 O(1)，之后原对象的修改不会影响快照
+// 2. insert / insert_or_assign / erase 最多复制 O(log n) 个节点，
+//    路径上只被本对象引用的节点直接原地修改，没有快照时与普通的平衡树一样不复制节点
+// 3. 引用计数为原子变量，不同的对象（包括互为快照的对象）可以在不同线程中同时读写，
+//    同一个对象的并发读写仍需外部同步
+// 4. 元素只能通过成员函数修改，迭代器与 at / find 只提供 const 访问
+// 5. 节点没有父指针，迭代器保存从根到当前节点的路径，对象被修改后它的迭代器失效，快照的迭代器不受影响
+
+#include <atomic>
+#include <initializer_list>
+
+#include "algobase.h"
+#include "functional.h"
+#include "allocator.h"
+#include "memory.h"
+#include "iterator.h"
+#include "utils.h"
+#include "exceptdef.h"
+
+namespace tinystl
+{
+
+  // persistent_map 的节点
+  template <class T>
+  struct persistent_map_node
+  {
+    typedef persistent_map_node<T> *node_ptr;
+
+    std::atomic<size_t> refs; // 引用计数：指向该节点的父节点与根指针的个数
+    node_ptr left;
+    node_ptr right;
+    unsigned char height; // 以该节点为根的子树的高度，叶节点为 1
+    T value;
+  };
+
+  // persistent_map 的迭代器，只提供 const 访问
+  template <class T>
+  struct persistent_map_iterator
+      : public tinystl::iterator<tinystl::bidirectional_iterator_tag, T, ptrdiff_t, const T *, const T &>
+  {
+    typedef persistent_map_node<T> *node_ptr;
+    typedef persistent_map_iterator<T> self;
+
+    // AVL 树高度为 h 时至少有 F(h + 2) - 1 个节点，高度 64 对应约 2.7e13 个节点，足够使用
+    static constexpr size_t max_height = 64;
+
+    node_ptr root;              // 所属版本的根节点
+    node_ptr path[max_height];  // 从根到当前节点的路径
+    size_t depth;               // 路径长度，为 0 时表示 end
+
+    persistent_map_iterator() : root(nullptr), depth(0) {}
+    explicit persistent_map_iterator(node_ptr r) : root(r), depth(0) {}
+
+    node_ptr node() const noexcept { return depth == 0 ? nullptr : path[depth - 1]; }
+
+    const T &operator*() const { return node()->value; }
+    const T *operator->() const { return &(operator*()); }
+
+    // 从 x 开始沿左（右）链下降到最小（最大）节点
+    void push_min(node_ptr x) noexcept
+    {
+      for (; x != nullptr; x = x->left)
+        path[depth++] = x;
+    }
+    void push_max(node_ptr x) noexcept
+    {
+      for (; x != nullptr; x = x->right)
+        path[depth++] = x;
+    }
+
+    self &operator++()
+    {
+      node_ptr x = path[depth - 1];
+      if (x->right != nullptr)
+      {
+        push_min(x->right);
+        return *this;
+      }
+      // 向上回溯，直到从左孩子返回
+      while (--depth != 0 && path[depth - 1]->right == x)
+        x = path[depth - 1];
+      return *this;
+    }
+    self operator++(int)
+    {
+      self tmp(*this);
+      ++*this;
+      return tmp;
+    }
+
+    self &operator--()
+    {
+      if (depth == 0)
+      { // end 的前一个为最大节点
+        push_max(root);
+        return *this;
+      }
+      node_ptr x = path[depth - 1];
+      if (x->left != nullptr)
+      {
+        push_max(x->left);
+        return *this;
+      }
+      while (--depth != 0 && path[depth - 1]->left == x)
+        x = path[depth - 1];
+      return *this;
+    }
+    self operator--(int)
+    {
+      self tmp(*this);
+      --*this;
+      return tmp;
+    }
+
+    friend bool operator==(const self &lhs, const self &rhs) { return lhs.node() == rhs.node(); }
+    friend bool operator!=(const self &lhs, const self &rhs) { return lhs.node() != rhs.node(); }
+  };
+
+  // 模板类 persistent_map，键值不允许重复
+  // 参数一代表键值类型，参数二代表实值类型，参数三代表键值的比较方式，缺省使用 tinystl::less
+  template <class Key, class T, class Compare = tinystl::less<Key>>
+  class persistent_map
+  {
+  public:
+    // persistent_map 的嵌套型别定义
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef tinystl::pair<const Key, T> value_type;
+    typedef Compare key_compare;
+
+    // 定义一个 functor，用来进行元素比较
+    class value_compare : public binary_function<value_type, value_type, bool>
+    {
+      friend class persistent_map<Key, T, Compare>;
+
+    private:
+      Compare comp;
+      value_compare(Compare c) : comp(c) {}
+
+    public:
+      bool operator()(const value_type &lhs, const value_type &rhs) const
+      {
+        return comp(lhs.first, rhs.first);
+      }
+    };
+
+    typedef persistent_map_node<value_type> node_type;
+    typedef node_type *node_ptr;
+
+    typedef tinystl::allocator<value_type> allocator_type;
+    typedef tinystl::allocator<value_type> data_allocator;
+    typedef tinystl::allocator<node_type> node_allocator;
+
+    typedef const value_type *pointer;
+    typedef const value_type *const_pointer;
+    typedef const value_type &reference;
+    typedef const value_type &const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    typedef persistent_map_iterator<value_type> iterator;
+    typedef persistent_map_iterator<value_type> const_iterator;
+    typedef tinystl::reverse_iterator<iterator> reverse_iterator;
+    typedef tinystl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+  private:
+    node_ptr root_;
+    size_type size_;
+    key_compare comp_;
+
+  public:
+    // 构造、复制、移动、析构函数
+
+    persistent_map() noexcept : root_(nullptr), size_(0), comp_() {}
+
+    template <class InputIterator>
+    persistent_map(InputIterator first, InputIterator last)
+        : root_(nullptr), size_(0), comp_()
+    {
+      try
+      {
+        for (; first != last; ++first)
+          insert(*first);
+      }
+      catch (...)
+      {
+        release(root_);
+        throw;
+      }
+    }
+
+    persistent_map(std::initializer_list<value_type> ilist)
+        : persistent_map(ilist.begin(), ilist.end())
+    {
+    }
+
+    // 复制只共享根节点，O(1)
+    persistent_map(const persistent_map &rhs) noexcept
+        : root_(retain(rhs.root_)), size_(rhs.size_), comp_(rhs.comp_)
+    {
+    }
+    persistent_map(persistent_map &&rhs) noexcept
+        : root_(rhs.root_), size_(rhs.size_), comp_(rhs.comp_)
+    {
+      rhs.root_ = nullptr;
+      rhs.size_ = 0;
+    }
+
+    persistent_map &operator=(const persistent_map &rhs) noexcept
+    {
+      if (this != &rhs)
+      {
+        node_ptr old = root_;
+        root_ = retain(rhs.root_);
+        size_ = rhs.size_;
+        comp_ = rhs.comp_;
+        release(old);
+      }
+      return *this;
+    }
+    persistent_map &operator=(persistent_map &&rhs) noexcept
+    {
+      if (this != &rhs)
+      {
+        release(root_);
+        root_ = rhs.root_;
+        size_ = rhs.size_;
+        comp_ = rhs.comp_;
+        rhs.root_ = nullptr;
+        rhs.size_ = 0;
+      }
+      return *this;
+    }
+
+    ~persistent_map() { release(root_); }
+
+    // 取得当前版本的快照，O(1)
+    persistent_map snapshot() const noexcept { return *this; }
+
+    // 相关接口
+
+    key_compare key_comp() const { return comp_; }
+    value_compare value_comp() const { return value_compare(comp_); }
+    allocator_type get_allocator() const { return allocator_type(); }
+
+    // 迭代器相关
+
+    const_iterator begin() const noexcept
+    {
+      const_iterator it(root_);
+      it.push_min(root_);
+      return it;
+    }
+    const_iterator end() const noexcept { return const_iterator(root_); }
+
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // 容量相关
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type max_size() const noexcept { return static_cast<size_type>(-1); }
+
+    // 访问元素相关
+
+    // 若键值不存在，at 会抛出一个异常
+    const mapped_type &at(const key_type &key) const
+    {
+      node_ptr x = find_node(key);
+      THROW_OUT_OF_RANGE_IF(x == nullptr, "persistent_map<Key, T> no such element exists");
+      return x->value.second;
+    }
+
+    // 修改相关，只复制被修改的路径上与其它版本共享的节点
+
+    // 键值不存在时插入，返回是否插入
+    bool insert(const value_type &value)
+    {
+      bool changed = false;
+      const bool owned = unique(root_);
+      root_ = link(root_, owned, insert_since(root_, owned, value, false, changed));
+      size_ += changed ? 1 : 0;
+      return changed;
+    }
+
+    // 键值不存在时插入，存在时修改实值，返回是否插入
+    bool insert_or_assign(const key_type &key, const mapped_type &obj)
+    {
+      bool changed = false;
+      const bool owned = unique(root_);
+      root_ = link(root_, owned, insert_since(root_, owned, value_type(key, obj), true, changed));
+      size_ += changed ? 1 : 0;
+      return changed;
+    }
+
+    // 删除键值为 key 的元素，返回删除的个数
+    size_type erase(const key_type &key)
+    {
+      bool changed = false;
+      const bool owned = unique(root_);
+      root_ = link(root_, owned, erase_since(root_, owned, key, changed));
+      size_ -= changed ? 1 : 0;
+      return changed ? 1 : 0;
+    }
+
+    void clear() noexcept
+    {
+      release(root_);
+      root_ = nullptr;
+      size_ = 0;
+    }
+
+    // persistent_map 相关操作
+
+    const_iterator find(const key_type &key) const
+    {
+      const_iterator it = lower_bound(key);
+      return (it == end() || comp_(key, it->first)) ? end() : it;
+    }
+
+    size_type count(const key_type &key) const { return find_node(key) != nullptr ? 1 : 0; }
+
+    // 最后一个不小于 key 的节点的路径即为下降路径的前缀
+    const_iterator lower_bound(const key_type &key) const
+    {
+      const_iterator it(root_);
+      size_t found = 0;
+      for (node_ptr x = root_; x != nullptr;)
+      {
+        it.path[it.depth++] = x;
+        if (!comp_(x->value.first, key))
+        {
+          found = it.depth;
+          x = x->left;
+        }
+        else
+        {
+          x = x->right;
+        }
+      }
+      it.depth = found;
+      return it;
+    }
+
+    const_iterator upper_bound(const key_type &key) const
+    {
+      const_iterator it(root_);
+      size_t found = 0;
+      for (node_ptr x = root_; x != nullptr;)
+      {
+        it.path[it.depth++] = x;
+        if (comp_(key, x->value.first))
+        {
+          found = it.depth;
+          x = x->left;
+        }
+        else
+        {
+          x = x->right;
+        }
+      }
+      it.depth = found;
+      return it;
+    }
+
+    pair<const_iterator, const_iterator>
+    equal_range(const key_type &key) const
+    {
+      const_iterator it = find(key);
+      auto next = it;
+      return it == end() ? tinystl::make_pair(it, it) : tinystl::make_pair(it, ++next);
+    }
+
+    void swap(persistent_map &rhs) noexcept
+    {
+      tinystl::swap(root_, rhs.root_);
+      tinystl::swap(size_, rhs.size_);
+      tinystl::swap(comp_, rhs.comp_);
+    }
+
+    // 两个版本是否共享同一个根节点，共享时内容一定相同
+    bool same_version(const persistent_map &rhs) const noexcept { return root_ == rhs.root_; }
+
+  private:
+    // node related
+    template <class... Args>
+    static node_ptr create_node(Args &&...args);
+    static node_ptr clone_node(node_ptr x);
+    static node_ptr retain(node_ptr x) noexcept;
+    static void release(node_ptr x) noexcept;
+    static bool unique(node_ptr x) noexcept;
+    static node_ptr link(node_ptr old, bool owned, node_ptr x) noexcept;
+
+    // AVL
+    static size_t height(node_ptr x) noexcept { return x == nullptr ? 0 : x->height; }
+    static void update_height(node_ptr x) noexcept;
+    static void own_child(node_ptr &c);
+    static node_ptr rotate_left(node_ptr x);
+    static node_ptr rotate_right(node_ptr x);
+    static node_ptr rebalance(node_ptr x) noexcept;
+    static node_ptr relink(node_ptr x, bool owned, bool left, node_ptr c, bool child_owned, node_ptr n);
+
+    // lookup / update
+    node_ptr find_node(const key_type &key) const;
+    node_ptr insert_since(node_ptr x, bool owned, const value_type &value, bool assign, bool &changed);
+    node_ptr erase_since(node_ptr x, bool owned, const key_type &key, bool &changed);
+    node_ptr erase_min(node_ptr x, bool owned, node_ptr &min);
+  };
+
+  /*****************************************************************************************/
+  // helper function
+
+  // 创建一个结点，引用计数为 1
+  template <class Key, class T, class Compare>
+  template <class... Args>
+  typename persistent_map<Key, T, Compare>::node_ptr
+  persistent_map<Key, T, Compare>::
+      create_node(Args &&...args)
+  {
+    node_ptr tmp = node_allocator::allocate(1);
+    try
+    {
+      data_allocator::construct(tinystl::address_of(tmp->value), tinystl::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+      node_allocator::deallocate(tmp);
+      throw;
+    }
+    ::new (static_cast<void *>(&tmp->refs)) std::atomic<size_t>(1);
+    tmp->left = nullptr;
+    tmp->right = nullptr;
+    tmp->height = 1;
+    return tmp;
+  }
+
+  // 复制一个结点，新节点与 x 共享两棵子树
+  template <class Key, class T, class Compare>
+  typename persistent_map<Key, T, Compare>::node_ptr
+  persistent_map<Key, T, Compare>::
+      clone_node(node_ptr x)
+  {
+    node_ptr tmp = create_node(x->value);
+    tmp->left = retain(x->left);
+    tmp->right = retain(x->right);
+    tmp->height = x->height;
+    return tmp;
+  }
+
+  template <class Key, class T, class Compare>
+  typename persistent_map<Key, T, Compare>::node_ptr
+  persistent_map<Key, T, Compare>::
+      retain(node_ptr x) noexcept
+  {
+    if (x != nullptr)
+      x->refs.fetch_add(1, std::memory_order_relaxed);
+    return x;
+  }
+
+  // 减少引用计数，减为 0 时销毁节点并释放它对子树的引用
+  template <class Key, class T, class Compare>
+  void persistent_map<Key, T, Compare>::
+      release(node_ptr x) noexcept
+  {
+    while (x != nullptr && x->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+      release(x->left);
+      node_ptr r = x->right;
+      data_allocator::destroy(tinystl::address_of(x->value));
+      node_allocator::deallocate(x);
+      x = r;
+    }
+  }
+
+  // 节点只被一个父节点（或根指针）引用
+  // 只有当父节点为本对象独占时，引用计数为 1 的节点才为本对象独占，由调用者保证
+  template <class Key, class T, class Compare>
+  bool persistent_map<Key, T, Compare>::
+      unique(node_ptr x) noexcept
+  {
+    return x != nullptr && x->refs.load(std::memory_order_acquire) == 1;
+  }
+
+  // 用更新得到的 x 替换原来的子树 old，owned 表示 old 是否为本对象独占
+  // 独占的子树是原地修改的，不需要调整引用计数；否则 x 是新复制的路径，释放对 old 的引用
+  template <class Key, class T, class Compare>
+  typename persistent_map<Key, T, Compare>::node_ptr
+  persistent_map<Key, T, Compare>::
+      link(node_ptr old, bool owned, node_ptr x) noexcept
+  {
+    if (x != old && !owned)
+      release(old);
+    return x;
+  }
+
+  template <class Key, class T, class Compare>
+  void persistent_map<Key, T, Compare>::
+      update_height(node_ptr x) noexcept
+  {
+    const size_t l = height(x->left);
+    const size_t r = height(x->right);
+    x->height = static_cast<unsigned char>((l > r ? l : r) + 1);
+  }
+
+  // 独占节点 c 所在的位置：c 被其它版本共享时换成它的复制
+  // 调用者必须独占 c 的父节点
+  template <class Key, class T, class Compare>
+  void persistent_map<Key, T, Compare>::
+      own_child(node_ptr &c)
+  {
+    if (c->refs.load(std::memory_order_acquire) != 1)
+    {
+      node_ptr tmp = clone_node(c);
+      release(c);
+      c = tmp;
+    }
+  }
+
+  // 左旋，x 与 x->right 必须为本对象独占，返回新的子树根
+  template <class Key, class T, class Compare>
+  typename persistent_map<Key, T, Compare>::node_ptr
+  persistent_map<Key, T, Compare>::
+      rotate_left(node_ptr x)
+  {
+    node_ptr y = x->right;
+    x->right = y->left;
+    y->left = x;
+    update_height(x);
+    update_height(y);
+    return y;
+  }
+
+  // 右旋，x 与 x->left 必须为本对象独占，返回新的子树根
+  template <class Key, class T, class Compare>
+  typename persistent_map<Key, T, Compare>::node_ptr
+  persistent_map<Key, T, Compare>::
+      rotate_right(node_ptr x)
+  {
+    node_ptr y = x->left;
+    x->left = y->right;
+    y->right = x;
+    update_height(x);
+    update_height(y);
+    return y;
+  }
+
+  // 使独占节点 x 恢复平衡，被旋转的孩子若与其它版本共享，先复制
+  // 复制失败时放弃这次旋转，树仍然有序，只是这一处暂时失去平衡，因此修改操作不会停在一半
+  template <class Key, class T, class Compare>
+  typename persistent_map<Key, T, Compare>::node_ptr
+  persistent_map<Key, T, Compare>::
+      rebalance(node_ptr x) noexcept
+  {
+    const size_t l = height(x->left);
+    const size_t r = height(x->right);
+    try
+    {
+      if (l > r + 1)
+      {
+        own_child(x->left);
+        if (height(x->left->left) < height(x->left->right))
+        {
+          own_child(x->left->right);
+          x->left = rotate_left(x->left);
+        }
+        return rotate_right(x);
+      }
+      if (r > l + 1)
+      {
+        own_child(x->right);
+        if (height(x->right->right) < height(x->right->left))
+        {
+          own_child(x->right->left);
+          x->right = rotate_right(x->right);
+        }
+        return rotate_left(x);
+      }
+    }
+    catch (...)
+    {
+    }
+    update_height(x);
+    return x;
+  }
+
+  // 用更新后的孩子 n 替换 x 的左（右）孩子 c，再恢复平衡，返回新的子树根
+  // x 不为本对象独占时先复制 x，复制失败则释放 n，本对象保持不变
+  template <class Key, class T, class Compare>
+  typename persistent_map<Key, T, Compare>::node_ptr
+  persistent_map<Key, T, Compare>::
+      relink(node_ptr x, bool owned, bool left, node_ptr c, bool child_owned, node_ptr n)
+  {
+    if (!owned)
+    {
+      try
+      {
+        x = clone_node(x);
+      }
+      catch (...)
+      {
+        release(n);
+        throw;
+      }
+    }
+    if (left)
+      x->left = link(c, child_owned, n);
+    else
+      x->right = link(c, child_owned, n);
+    return rebalance(x);
+  }
+
+  template <class Key, class T, class Compare>
+  typename persistent_map<Key, T, Compare>::node_ptr
+  persistent_map<Key, T, Compare>::
+      find_node(const key_type &key) const
+  {
+    node_ptr x = root_;
+    while (x != nullptr)
+    {
+      if (comp_(key, x->value.first))
+        x = x->left;
+      else if (comp_(x->value.first, key))
+        x = x->right;
+      else
+        return x;
+    }
+    return nullptr;
+  }
+
+  // insert_since 函数
+  // 在子树 x 中插入 value，assign 为 true 时键值已存在则修改实值，返回更新后的子树
+  // owned 表示 x 为本对象独占，可以原地修改；否则只在确实发生修改时复制 x
+  // 返回 x 本身表示子树没有变化或者被原地修改，changed 表示是否插入了新节点
+  template <class Key, class T, class Compare>
+  typename persistent_map<Key, T, Compare>::node_ptr
+  persistent_map<Key, T, Compare>::
+      insert_since(node_ptr x, bool owned, const value_type &value, bool assign, bool &changed)
+  {
+    if (x == nullptr)
+    {
+      changed = true;
+      return create_node(value);
+    }
+    const bool left = comp_(value.first, x->value.first);
+    if (left || comp_(x->value.first, value.first))
+    {
+      node_ptr c = left ? x->left : x->right;
+      const bool child_owned = owned && unique(c);
+      node_ptr n = insert_since(c, child_owned, value, assign, changed);
+      if (n == c && !changed)
+        return x;
+      return relink(x, owned, left, c, child_owned, n);
+    }
+    // 键值已存在
+    if (!assign)
+      return x;
+    if (owned)
+    {
+      x->value.second = value.second;
+      return x;
+    }
+    node_ptr y = create_node(value);
+    y->left = retain(x->left);
+    y->right = retain(x->right);
+    y->height = x->height;
+    return y;
+  }
+
+  // erase_since 函数
+  // 从子树 x 中删除键值为 key 的节点，参数与返回值的含义同 insert_since
+  template <class Key, class T, class Compare>
+  typename persistent_map<Key, T, Compare>::node_ptr
+  persistent_map<Key, T, Compare>::
+      erase_since(node_ptr x, bool owned, const key_type &key, bool &changed)
+  {
+    if (x == nullptr)
+      return nullptr;
+    const bool left = comp_(key, x->value.first);
+    if (left || comp_(x->value.first, key))
+    {
+      node_ptr c = left ? x->left : x->right;
+      const bool child_owned = owned && unique(c);
+      node_ptr n = erase_since(c, child_owned, key, changed);
+      if (!changed)
+        return x;
+      return relink(x, owned, left, c, child_owned, n);
+    }
+    if (x->left == nullptr || x->right == nullptr)
+    { // 至多一个孩子，由孩子顶替 x
+      node_ptr c = x->left != nullptr ? x->left : x->right;
+      retain(c);
+      if (owned)
+        release(x);
+      changed = true;
+      return c;
+    }
+    // 两个孩子，用右子树的最小节点 m 顶替 x
+    // 从 x 到 m 的路径都为本对象独占时直接摘下 m，否则先复制 m 的元素，此时尚未修改任何节点
+    node_ptr c = x->right;
+    const bool child_owned = owned && unique(c);
+    bool path_owned = child_owned;
+    node_ptr p = c;
+    for (; p->left != nullptr; p = p->left)
+      path_owned = path_owned && unique(p->left);
+    node_ptr y = path_owned ? nullptr : create_node(p->value);
+    node_ptr m = nullptr;
+    node_ptr r = nullptr;
+    try
+    {
+      r = erase_min(c, child_owned, m);
+    }
+    catch (...)
+    {
+      release(y);
+      throw;
+    }
+    if (y == nullptr)
+      y = m;
+    else
+      release(m);
+    if (owned)
+    {
+      y->left = x->left;
+      y->right = link(c, child_owned, r);
+      x->left = nullptr;
+      x->right = nullptr;
+      release(x);
+    }
+    else
+    { // x 仍被其它版本引用，保留它对两棵子树的引用
+      y->left = retain(x->left);
+      y->right = r;
+    }
+    changed = true;
+    return rebalance(y);
+  }
+
+  // erase_min 函数
+  // 从非空子树 x 中摘下最小节点写入 min，调用者获得 min 的一个引用，返回更新后的子树
+  // 最小节点为本对象独占时直接摘下，此时 min 的引用计数为 1
+  // 抛出异常时本对象保持不变，min 不持有引用
+  template <class Key, class T, class Compare>
+  typename persistent_map<Key, T, Compare>::node_ptr
+  persistent_map<Key, T, Compare>::
+      erase_min(node_ptr x, bool owned, node_ptr &min)
+  {
+    if (x->left == nullptr)
+    {
+      min = x;
+      node_ptr r = x->right;
+      if (owned)
+      {
+        x->right = nullptr;
+        return r;
+      }
+      retain(x);
+      return retain(r);
+    }
+    node_ptr c = x->left;
+    const bool child_owned = owned && unique(c);
+    node_ptr n = erase_min(c, child_owned, min);
+    try
+    {
+      return relink(x, owned, true, c, child_owned, n);
+    }
+    catch (...)
+    {
+      release(min);
+      min = nullptr;
+      throw;
+    }
+  }
+
+  // 重载比较操作符
+  template <class Key, class T, class Compare>
+  bool operator==(const persistent_map<Key, T, Compare> &lhs, const persistent_map<Key, T, Compare> &rhs)
+  {
+    return lhs.size() == rhs.size() &&
+           (lhs.same_version(rhs) || tinystl::equal(lhs.begin(), lhs.end(), rhs.begin()));
+  }
+
+  template <class Key, class T, class Compare>
+  bool operator<(const persistent_map<Key, T, Compare> &lhs, const persistent_map<Key, T, Compare> &rhs)
+  {
+    return tinystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+
+  template <class Key, class T, class Compare>
+  bool operator!=(const persistent_map<Key, T, Compare> &lhs, const persistent_map<Key, T, Compare> &rhs)
+  {
+    return !(lhs == rhs);
+  }
+
+  template <class Key, class T, class Compare>
+  bool operator>(const persistent_map<Key, T, Compare> &lhs, const persistent_map<Key, T, Compare> &rhs)
+  {
+    return rhs < lhs;
+  }
+
+  template <class Key, class T, class Compare>
+  bool operator<=(const persistent_map<Key, T, Compare> &lhs, const persistent_map<Key, T, Compare> &rhs)
+  {
+    return !(rhs < lhs);
+  }
+
+  template <class Key, class T, class Compare>
+  bool operator>=(const persistent_map<Key, T, Compare> &lhs, const persistent_map<Key, T, Compare> &rhs)
+  {
+    return !(lhs < rhs);
+  }
+
+  // 重载 tinystl 的 swap
+  template <class Key, class T, class Compare>
+  void swap(persistent_map<Key, T, Compare> &lhs, persistent_map<Key, T, Compare> &rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+} // namespace tinystl
+#endif // !TINYSTL_PERSISTENT_MAP_H_
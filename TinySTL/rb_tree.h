@@ -2,13 +2,19 @@
 #define TINYSTL_RB_TREE_H_
 
 #include <initializer_list>
+#include <utility>
+#include <cstdint>
 #include "algobase.h"
 #include <cassert>
 #include "allocator.h"
 #include "iterator.h"
 #include "memory.h"
+#include "node_handle.h"
 #include "type_traits.h"
 #include "exceptdef.h"
+#include <exception>
+#include <thread>
+#include <system_error>
 
 namespace tinystl
 {
@@ -123,10 +129,31 @@ namespace tinystl
     typedef rb_tree_node_base<T> *base_ptr;
     typedef rb_tree_node<T> *node_ptr;
 
-    base_ptr parent;  // 父节点
-    base_ptr left;    // 左子节点
-    base_ptr right;   // 右子节点
-    color_type color; // 节点颜色
+    // 父节点指针与颜色共用一个字：节点至少按指针大小对齐，指针的最低位总是 0，用来保存颜色
+    uintptr_t parent_color;
+    base_ptr left;  // 左子节点
+    base_ptr right; // 右子节点
+
+    base_ptr parent() const noexcept
+    {
+      return reinterpret_cast<base_ptr>(parent_color & ~static_cast<uintptr_t>(1));
+    }
+    void set_parent(base_ptr p) noexcept
+    {
+      parent_color = reinterpret_cast<uintptr_t>(p) | (parent_color & 1);
+    }
+    color_type color() const noexcept
+    {
+      return static_cast<color_type>(parent_color & 1);
+    }
+    void set_color(color_type c) noexcept
+    {
+      parent_color = (parent_color & ~static_cast<uintptr_t>(1)) | static_cast<uintptr_t>(c);
+    }
+    void set_parent_color(base_ptr p, color_type c) noexcept
+    {
+      parent_color = reinterpret_cast<uintptr_t>(p) | static_cast<uintptr_t>(c);
+    }
 
     base_ptr get_base_ptr()
     {
@@ -186,6 +213,129 @@ namespace tinystl
     typedef node_type *node_ptr;
   };
 
+  // rb tree 的节点更新策略
+  // 插入、删除、旋转以及整体建树改变树的结构时调用，用来维护节点上的附加信息
+  // node<T>::type 为实际分配的节点类型，必须以 rb_tree_node<T> 为基类
+
+  // 不维护附加信息，rb_tree 的缺省策略
+  struct rb_tree_null_update
+  {
+    static constexpr bool order_statistics = false;
+
+    template <class T>
+    struct node
+    {
+      typedef rb_tree_node<T> type;
+    };
+
+    // 以 x 为支点旋转之后，y 成为 x 的父节点
+    template <class NodePtr>
+    static void rotate(NodePtr, NodePtr) noexcept {}
+    // x 已链接到树中，尚未重新平衡
+    template <class NodePtr>
+    static void insert(NodePtr, NodePtr) noexcept {}
+    // y 即将从树中摘下
+    template <class NodePtr>
+    static void erase(NodePtr, NodePtr) noexcept {}
+    // 节点已经摘下，尚未重新平衡，xp 为实际摘下的位置的父节点，删除的是根节点时为空
+    template <class NodePtr>
+    static void unlink(NodePtr, NodePtr) noexcept {}
+    // dst 顶替了 src 的位置，或者是 src 的复制
+    template <class NodePtr>
+    static void copy(NodePtr, NodePtr) noexcept {}
+    // x 的子树已经建好
+    template <class NodePtr>
+    static void recompute(NodePtr) noexcept {}
+    // x 的子树发生了变化，x 位于一棵独立的子树中（根节点的父节点为空）
+    template <class NodePtr>
+    static void propagate(NodePtr) noexcept {}
+  };
+
+  // 带子树大小的节点
+  template <class T>
+  struct rb_tree_size_node : public rb_tree_node<T>
+  {
+    size_t size; // 以该节点为根的子树的节点数
+  };
+
+  // 维护子树大小，使 nth / rank / distance 的复杂度为 O(log n)
+  struct rb_tree_size_update
+  {
+    static constexpr bool order_statistics = true;
+
+    template <class T>
+    struct node
+    {
+      typedef rb_tree_size_node<T> type;
+    };
+
+    template <class T>
+    static size_t size(rb_tree_node_base<T> *x) noexcept
+    {
+      return x == nullptr ? 0 : static_cast<rb_tree_size_node<T> *>(x)->size;
+    }
+
+    template <class T>
+    static void set_size(rb_tree_node_base<T> *x, size_t n) noexcept
+    {
+      static_cast<rb_tree_size_node<T> *>(x)->size = n;
+    }
+
+    template <class T>
+    static void recompute(rb_tree_node_base<T> *x) noexcept
+    {
+      set_size(x, size(x->left) + size(x->right) + 1);
+    }
+
+    template <class T>
+    static void rotate(rb_tree_node_base<T> *x, rb_tree_node_base<T> *y) noexcept
+    {
+      recompute(x);
+      recompute(y);
+    }
+
+    // 从 x 到根的路径上每个节点的子树大小加一
+    template <class T>
+    static void insert(rb_tree_node_base<T> *x, rb_tree_node_base<T> *root) noexcept
+    {
+      set_size(x, 1);
+      while (x != root)
+      {
+        x = x->parent();
+        set_size(x, size(x) + 1);
+      }
+    }
+
+    // 从 y 的父节点到根的路径上每个节点的子树大小减一
+    template <class T>
+    static void erase(rb_tree_node_base<T> *y, rb_tree_node_base<T> *root) noexcept
+    {
+      while (y != root)
+      {
+        y = y->parent();
+        set_size(y, size(y) - 1);
+      }
+    }
+
+    // 子树大小已经在 erase 中更新
+    template <class T>
+    static void unlink(rb_tree_node_base<T> *, rb_tree_node_base<T> *) noexcept {}
+
+    template <class T>
+    static void copy(rb_tree_node_base<T> *dst, rb_tree_node_base<T> *src) noexcept
+    {
+      set_size(dst, size(src));
+    }
+
+    // 从 x 开始向上重新计算，直到独立子树的根
+    template <class T>
+    static void propagate(rb_tree_node_base<T> *x) noexcept
+    {
+      for (; x != nullptr; x = x->parent())
+        recompute(x);
+    }
+  };
+
   // rb tree 的迭代器设计
 
   template <class T>
@@ -206,11 +356,11 @@ namespace tinystl
       }
       else
       { // 如果没有右子节点
-        auto y = node->parent;
+        auto y = node->parent();
         while (y->right == node)
         {
           node = y;
-          y = y->parent;
+          y = y->parent();
         }
         if (node->right != y) // 应对“寻找根节点的下一节点，而根节点没有右子节点”的特殊情况
           node = y;
@@ -220,7 +370,7 @@ namespace tinystl
     // 使迭代器后退
     void dec()
     {
-      if (node->parent->parent == node && rb_tree_is_red(node))
+      if (node->parent()->parent() == node && rb_tree_is_red(node))
       {                     // 如果 node 为 header
         node = node->right; // 指向整棵树的 max 节点
       }
@@ -230,11 +380,11 @@ namespace tinystl
       }
       else
       { // 非 header 节点，也无左子节点
-        auto y = node->parent;
+        auto y = node->parent();
         while (node == y->left)
         {
           node = y;
-          y = y->parent;
+          y = y->parent();
         }
         node = y;
       }
@@ -265,7 +415,7 @@ namespace tinystl
     rb_tree_iterator() {}
     rb_tree_iterator(base_ptr x) { node = x; }
     rb_tree_iterator(node_ptr x) { node = x; }
-    rb_tree_iterator(const iterator &rhs) { node = rhs.node; }
+    rb_tree_iterator(const iterator &rhs) = default;
     rb_tree_iterator(const const_iterator &rhs) { node = rhs.node; }
 
     // 重载操作符
@@ -318,7 +468,7 @@ namespace tinystl
     rb_tree_const_iterator(base_ptr x) { node = x; }
     rb_tree_const_iterator(node_ptr x) { node = x; }
     rb_tree_const_iterator(const iterator &rhs) { node = rhs.node; }
-    rb_tree_const_iterator(const const_iterator &rhs) { node = rhs.node; }
+    rb_tree_const_iterator(const const_iterator &rhs) = default;
 
     // 重载操作符
     reference operator*() const { return node->get_node_ptr()->value; }
@@ -369,25 +519,25 @@ namespace tinystl
   template <class NodePtr>
   bool rb_tree_is_lchild(NodePtr node) noexcept
   {
-    return node == node->parent->left;
+    return node == node->parent()->left;
   }
 
   template <class NodePtr>
   bool rb_tree_is_red(NodePtr node) noexcept
   {
-    return node->color == rb_tree_red;
+    return node->color() == rb_tree_red;
   }
 
   template <class NodePtr>
-  void rb_tree_set_black(NodePtr &node) noexcept
+  void rb_tree_set_black(NodePtr node) noexcept
   {
-    node->color = rb_tree_black;
+    node->set_color(rb_tree_black);
   }
 
   template <class NodePtr>
-  void rb_tree_set_red(NodePtr &node) noexcept
+  void rb_tree_set_red(NodePtr node) noexcept
   {
-    node->color = rb_tree_red;
+    node->set_color(rb_tree_red);
   }
 
   template <class NodePtr>
@@ -396,8 +546,8 @@ namespace tinystl
     if (node->right != nullptr)
       return rb_tree_min(node->right);
     while (!rb_tree_is_lchild(node))
-      node = node->parent;
-    return node->parent;
+      node = node->parent();
+    return node->parent();
   }
 
   /*---------------------------------------*\
@@ -410,14 +560,14 @@ namespace tinystl
   |     b   c                 a   b         |
   \*---------------------------------------*/
   // 左旋，参数一为左旋点，参数二为根节点
-  template <class NodePtr>
+  template <class NodeUpdate, class NodePtr>
   void rb_tree_rotate_left(NodePtr x, NodePtr &root) noexcept
   {
     auto y = x->right;
     x->right = y->left;
     if (y->left != nullptr)
-      y->left->parent = x;
-    y->parent = x->parent;
+      y->left->set_parent(x);
+    y->set_parent(x->parent());
 
     if (x == root)
     {
@@ -425,15 +575,16 @@ namespace tinystl
     }
     else if (rb_tree_is_lchild(x))
     {
-      x->parent->left = y;
+      x->parent()->left = y;
     }
     else
     {
-      x->parent->right = x;
+      x->parent()->right = y;
     }
 
     y->left = x;
-    x->parent = y;
+    x->set_parent(y);
+    NodeUpdate::rotate(x, y);
   }
 
   /*----------------------------------------*\
@@ -446,14 +597,14 @@ namespace tinystl
   |   b   c                         c   a    |
   \*----------------------------------------*/
   // 右旋，参数一为右旋点，参数二为根节点
-  template <class NodePtr>
+  template <class NodeUpdate, class NodePtr>
   void rb_tree_rotate_right(NodePtr x, NodePtr &root) noexcept
   {
     auto y = x->left;
     x->left = y->right;
     if (y->right)
-      y->right->parent = x;
-    y->parent = x->parent;
+      y->right->set_parent(x);
+    y->set_parent(x->parent());
 
     if (x == root)
     { // 如果 x 为根节点，让 y 顶替 x 成为根节点
@@ -461,15 +612,16 @@ namespace tinystl
     }
     else if (rb_tree_is_lchild(x))
     { // 如果 x 是右子节点
-      x->parent->left = y;
+      x->parent()->left = y;
     }
     else
     { // 如果 x 是左子节点
-      x->parent->right = y;
+      x->parent()->right = y;
     }
     // 调整 x 与 y 的关系
     y->right = x;
-    x->parent = y;
+    x->set_parent(y);
+    NodeUpdate::rotate(x, y);
   }
 
   // 插入节点后使 rb tree 重新平衡，参数一为新增节点，参数二为根节点
@@ -485,44 +637,57 @@ namespace tinystl
   //
   // 参考博客: http://blog.csdn.net/v_JULY_v/article/details/6105630
   //          http://blog.csdn.net/v_JULY_v/article/details/6109153
-  template <class NodePtr>
+  template <class NodeUpdate, class NodePtr>
+  void rb_tree_insert_fixup(NodePtr x, NodePtr &root) noexcept;
+
+  template <class NodeUpdate, class NodePtr>
   void rb_tree_insert_rebalance(NodePtr x, NodePtr &root) noexcept
   {
+    NodeUpdate::insert(x, root);
     rb_tree_set_red(x); // 新增节点为红色
-    while (x != root && rb_tree_is_red(x->parent))
+    rb_tree_insert_fixup<NodeUpdate>(x, root);
+    rb_tree_set_black(root); // 根节点永远为黑
+  }
+
+  // 从红色节点 x 开始向上消除连续的红色节点，x 的两棵子树必须满足红黑树的性质且黑高相同
+  // 处理过程即上面的 case 2 ~ case 5，不修改根节点的颜色，由调用者决定
+  template <class NodeUpdate, class NodePtr>
+  void rb_tree_insert_fixup(NodePtr x, NodePtr &root) noexcept
+  {
+    while (x != root && rb_tree_is_red(x->parent()))
     {
-      if (rb_tree_is_lchild(x->parent))
+      if (rb_tree_is_lchild(x->parent()))
       { // 如果父节点是左子节点
-        auto uncle = x->parent->parent->right;
+        auto uncle = x->parent()->parent()->right;
         if (uncle != nullptr && rb_tree_is_red(uncle))
         { // case 3: 父节点和叔叔节点都为红
-          rb_tree_set_black(x->parent);
+          rb_tree_set_black(x->parent());
           rb_tree_set_black(uncle);
-          x = x->parent->parent;
+          x = x->parent()->parent();
           rb_tree_set_red(x);
         }
         else
         { // 无叔叔节点或叔叔节点为黑
           if (!rb_tree_is_lchild(x))
           { // case 4: 当前节点 x 为右子节点
-            x = x->parent;
-            rb_tree_rotate_left(x, root);
+            x = x->parent();
+            rb_tree_rotate_left<NodeUpdate>(x, root);
           }
           // 都转换成 case 5： 当前节点为左子节点
-          rb_tree_set_black(x->parent);
-          rb_tree_set_red(x->parent->parent);
-          rb_tree_rotate_right(x->parent->parent, root);
+          rb_tree_set_black(x->parent());
+          rb_tree_set_red(x->parent()->parent());
+          rb_tree_rotate_right<NodeUpdate>(x->parent()->parent(), root);
           break;
         }
       }
       else // 如果父节点是右子节点，对称处理
       {
-        auto uncle = x->parent->parent->left;
+        auto uncle = x->parent()->parent()->left;
         if (uncle != nullptr && rb_tree_is_red(uncle))
         { // case 3: 父节点和叔叔节点都为红
-          rb_tree_set_black(x->parent);
+          rb_tree_set_black(x->parent());
           rb_tree_set_black(uncle);
-          x = x->parent->parent;
+          x = x->parent()->parent();
           rb_tree_set_red(x);
           // 此时祖父节点为红，可能会破坏红黑树的性质，令当前节点为祖父节点，继续处理
         }
@@ -530,29 +695,29 @@ namespace tinystl
         { // 无叔叔节点或叔叔节点为黑
           if (rb_tree_is_lchild(x))
           { // case 4: 当前节点 x 为左子节点
-            x = x->parent;
-            rb_tree_rotate_right(x, root);
+            x = x->parent();
+            rb_tree_rotate_right<NodeUpdate>(x, root);
           }
           // 都转换成 case 5： 当前节点为左子节点
-          rb_tree_set_black(x->parent);
-          rb_tree_set_red(x->parent->parent);
-          rb_tree_rotate_left(x->parent->parent, root);
+          rb_tree_set_black(x->parent());
+          rb_tree_set_red(x->parent()->parent());
+          rb_tree_rotate_left<NodeUpdate>(x->parent()->parent(), root);
           break;
         }
       }
     }
-    rb_tree_set_black(root); // 根节点永远为黑
   }
 
   // 删除节点后使 rb tree 重新平衡，参数一为要删除的节点，参数二为根节点，参数三为最小节点，参数四为最大节点
   //
   // 参考博客: http://blog.csdn.net/v_JULY_v/article/details/6105630
   //          http://blog.csdn.net/v_JULY_v/article/details/6109153
-  template <class NodePtr>
+  template <class NodeUpdate, class NodePtr>
   NodePtr rb_tree_erase_rebalance(NodePtr z, NodePtr &root, NodePtr &leftmost, NodePtr &rightmost)
   {
     // y 是可能的替换节点，指向最终要删除的节点
     auto y = (z->left == nullptr || z->right == nullptr) ? z : rb_tree_next(z);
+    NodeUpdate::erase(y, root);
     // x 是 y 的一个独子节点或 NIL 节点
     auto x = y->left != nullptr ? y->left : y->right;
     // xp 为 x 的父节点
@@ -562,19 +727,19 @@ namespace tinystl
     // 用 y 顶替 z 的位置，用 x 顶替 y 的位置，最后用 y 指向 z
     if (y != z)
     {
-      z->left->parent = y;
+      z->left->set_parent(y);
       y->left = z->left;
 
       // 如果 y 不是 z 的右子节点，那么 z 的右子节点一定有左孩子
       if (y != z->right)
       { // x 替换 y 的位置
-        xp = y->parent;
+        xp = y->parent();
         if (x != nullptr)
-          x->parent = y->parent;
+          x->set_parent(y->parent());
 
-        y->parent->left = x;
+        y->parent()->left = x;
         y->right = z->right;
-        z->right->parent = y;
+        z->right->set_parent(y);
       }
       else
       {
@@ -585,27 +750,30 @@ namespace tinystl
       if (root == z)
         root = y;
       else if (rb_tree_is_lchild(z))
-        z->parent->left = y;
+        z->parent()->left = y;
       else
-        z->parent->right = y;
-      y->parent = z->parent;
-      swap(y->color, z->color);
+        z->parent()->right = y;
+      y->set_parent(z->parent());
+      auto color = y->color();
+      y->set_color(z->color());
+      z->set_color(color);
+      NodeUpdate::copy(y, z);
       y = z;
     }
     // y == z 说明 z 至多只有一个孩子
     else
     {
-      xp = y->parent;
+      xp = y->parent();
       if (x)
-        x->parent = y->parent;
+        x->set_parent(y->parent());
 
       // 连接 x 与 z 的父节点
       if (root == z)
         root = x;
       else if (rb_tree_is_lchild(z))
-        z->parent->left = x;
+        z->parent()->left = x;
       else
-        z->parent->right = x;
+        z->parent()->right = x;
 
       // 此时 z 有可能是最左节点或最右节点，更新数据
       if (leftmost == z)
@@ -613,6 +781,8 @@ namespace tinystl
       if (rightmost == z)
         rightmost = x == nullptr ? xp : rb_tree_max(x);
     }
+    // 只有删除根节点时 x 才会成为新的根，此时 xp 为 header
+    NodeUpdate::unlink(root == x ? nullptr : xp, root);
 
     // 此时，y 指向要删除的节点，x 为替代节点，从 x 节点开始调整。
     // 如果删除的节点为红色，树的性质没有被破坏，否则按照以下情况调整（x 为左子节点为例）：
@@ -633,7 +803,7 @@ namespace tinystl
           { // case 1
             rb_tree_set_black(brother);
             rb_tree_set_red(xp);
-            rb_tree_rotate_left(xp, root);
+            rb_tree_rotate_left<NodeUpdate>(xp, root);
             brother = xp->right;
           }
           // case 1 转为为了 case 2、3、4 中的一种
@@ -642,7 +812,7 @@ namespace tinystl
           { // case 2
             rb_tree_set_red(brother);
             x = xp;
-            xp = xp->parent;
+            xp = xp->parent();
           }
           else
           {
@@ -651,15 +821,15 @@ namespace tinystl
               if (brother->left != nullptr)
                 rb_tree_set_black(brother->left);
               rb_tree_set_red(brother);
-              rb_tree_rotate_right(brother, root);
+              rb_tree_rotate_right<NodeUpdate>(brother, root);
               brother = xp->right;
             }
             // 转为 case 4
-            brother->color = xp->color;
+            brother->set_color(xp->color());
             rb_tree_set_black(xp);
             if (brother->right != nullptr)
               rb_tree_set_black(brother->right);
-            rb_tree_rotate_left(xp, root);
+            rb_tree_rotate_left<NodeUpdate>(xp, root);
             break;
           }
         }
@@ -670,7 +840,7 @@ namespace tinystl
           { // case 1
             rb_tree_set_black(brother);
             rb_tree_set_red(xp);
-            rb_tree_rotate_right(xp, root);
+            rb_tree_rotate_right<NodeUpdate>(xp, root);
             brother = xp->left;
           }
           if ((brother->left == nullptr || !rb_tree_is_red(brother->left)) &&
@@ -678,7 +848,7 @@ namespace tinystl
           { // case 2
             rb_tree_set_red(brother);
             x = xp;
-            xp = xp->parent;
+            xp = xp->parent();
           }
           else
           {
@@ -687,15 +857,15 @@ namespace tinystl
               if (brother->right != nullptr)
                 rb_tree_set_black(brother->right);
               rb_tree_set_red(brother);
-              rb_tree_rotate_left(brother, root);
+              rb_tree_rotate_left<NodeUpdate>(brother, root);
               brother = xp->left;
             }
             // 转为 case 4
-            brother->color = xp->color;
+            brother->set_color(xp->color());
             rb_tree_set_black(xp);
             if (brother->left != nullptr)
               rb_tree_set_black(brother->left);
-            rb_tree_rotate_right(xp, root);
+            rb_tree_rotate_right<NodeUpdate>(xp, root);
             break;
           }
         }
@@ -706,9 +876,94 @@ namespace tinystl
     return y;
   }
 
+  // 以下函数作用于独立的子树：根节点的父节点为空，不含 header 节点
+  // 黑高指从根到 NIL 路径上黑色节点的个数，根节点为红时不计入，空树的黑高为 0
+
+  // 求子树 x 的黑高
+  template <class NodePtr>
+  size_t rb_tree_black_height(NodePtr x) noexcept
+  {
+    size_t bh = 0;
+    for (; x != nullptr; x = x->left)
+    {
+      if (!rb_tree_is_red(x))
+        ++bh;
+    }
+    return bh;
+  }
+
+  // 以节点 k 连接子树 l 与 r，l 中的键值都在 k 之前，r 中的键值都在 k 之后
+  // 参数 lbh、rbh 为两棵子树的黑高，返回新树的根，新树的黑高写入 bh
+  // 沿较高一棵树的右（左）链找到与较矮一棵树黑高相同的黑色节点 c，以红色的 k 顶替 c 的位置，
+  // c 与较矮的树成为 k 的两个孩子，再像插入一样向上修复，复杂度为 O(|lbh - rbh| + 1)，不计 NodeUpdate
+  template <class NodeUpdate, class NodePtr>
+  NodePtr rb_tree_join(NodePtr l, size_t lbh, NodePtr k, NodePtr r, size_t rbh, size_t &bh) noexcept
+  {
+    if (l != nullptr && rb_tree_is_red(l))
+    {
+      rb_tree_set_black(l);
+      ++lbh;
+    }
+    if (r != nullptr && rb_tree_is_red(r))
+    {
+      rb_tree_set_black(r);
+      ++rbh;
+    }
+    NodePtr root = nullptr;
+    NodePtr p = nullptr;
+    NodePtr c = nullptr;
+    if (lbh >= rbh)
+    { // 沿 l 的右链向下
+      root = l;
+      c = l;
+      for (size_t h = lbh; c != nullptr && (rb_tree_is_red(c) || h > rbh); p = c, c = c->right)
+      {
+        if (!rb_tree_is_red(c))
+          --h;
+      }
+      k->left = c;
+      k->right = r;
+      if (r != nullptr)
+        r->set_parent(k);
+      if (p != nullptr)
+        p->right = k;
+      bh = lbh;
+    }
+    else
+    { // 沿 r 的左链向下
+      root = r;
+      c = r;
+      for (size_t h = rbh; c != nullptr && (rb_tree_is_red(c) || h > lbh); p = c, c = c->left)
+      {
+        if (!rb_tree_is_red(c))
+          --h;
+      }
+      k->left = l;
+      k->right = c;
+      if (l != nullptr)
+        l->set_parent(k);
+      if (p != nullptr)
+        p->left = k;
+      bh = rbh;
+    }
+    if (c != nullptr)
+      c->set_parent(k);
+    k->set_parent_color(p, rb_tree_red);
+    if (p == nullptr)
+      root = k;
+    NodeUpdate::propagate(k);
+    rb_tree_insert_fixup<NodeUpdate>(k, root);
+    if (rb_tree_is_red(root))
+    {
+      rb_tree_set_black(root);
+      ++bh;
+    }
+    return root;
+  }
+
   // 模板类 rb_tree
-  // 参数一代表数据类型，参数二代表键值比较类型
-  template <class T, class Compare>
+  // 参数一代表数据类型，参数二代表键值比较类型，参数三代表节点更新策略，缺省不维护附加信息
+  template <class T, class Compare, class NodeUpdate = rb_tree_null_update>
   class rb_tree
   {
   public:
@@ -717,8 +972,8 @@ namespace tinystl
 
     typedef typename tree_traits::base_type base_type;
     typedef typename tree_traits::base_ptr base_ptr;
-    typedef typename tree_traits::node_type node_type;
-    typedef typename tree_traits::node_ptr node_ptr;
+    typedef typename NodeUpdate::template node<T>::type node_type;
+    typedef node_type *node_ptr;
     typedef typename tree_traits::key_type key_type;
     typedef typename tree_traits::mapped_type mapped_type;
     typedef typename tree_traits::value_type value_type;
@@ -726,8 +981,8 @@ namespace tinystl
 
     typedef tinystl::allocator<T> allocator_type;
     typedef tinystl::allocator<T> data_allocator;
-    typedef tinystl::allocator<T> base_allocator;
-    typedef tinystl::allocator<T> node_allocator;
+    typedef tinystl::allocator<base_type> base_allocator;
+    typedef tinystl::allocator<node_type> node_allocator;
 
     typedef typename allocator_type::pointer pointer;
     typedef typename allocator_type::const_pointer const_pointer;
@@ -741,7 +996,10 @@ namespace tinystl
     typedef tinystl::reverse_iterator<iterator> reverse_iterator;
     typedef tinystl::reverse_iterator<const_iterator> const_reverse_iterator;
 
-    allocator_type get_allocator() const { return node_allocator(); }
+    typedef tinystl::node_handle<node_type, value_type> node_handle_type;
+    typedef tinystl::node_insert_return<iterator, node_handle_type> insert_return_type;
+
+    allocator_type get_allocator() const { return allocator_type(); }
     key_compare key_comp() const { return key_comp_; }
 
   private:
@@ -750,9 +1008,15 @@ namespace tinystl
     size_type node_count_; // 节点数
     key_compare key_comp_; // 节点键值比较的准则
 
+    // compact 之后节点所在的连续内存块，块中的节点全部销毁后释放
+    node_ptr block_;
+    size_type block_size_;
+    size_type block_live_;
+
   private:
     // 以下三个函数用于取得根节点，最小节点和最大节点
-    base_ptr &root() const { return header_->parent; }
+    base_ptr root() const { return header_->parent(); }
+    void set_root(base_ptr x) { header_->set_parent(x); }
     base_ptr &leftmost() const { return header_->left; }
     base_ptr &rightmost() const { return header_->right; }
 
@@ -766,7 +1030,11 @@ namespace tinystl
     rb_tree &operator=(const rb_tree &rhs);
     rb_tree &operator=(rb_tree &&rhs);
 
-    ~rb_tree() { clear(); }
+    ~rb_tree()
+    {
+      clear();
+      base_allocator::deallocate(header_);
+    }
 
   public:
     // 迭代器相关操作
@@ -866,6 +1134,8 @@ namespace tinystl
     {
       size_type n = tinystl::distance(first, last);
       THROW_LENGTH_ERROR_IF(node_count_ > max_size() - n, "rb_tree<T, Comp>'s size too big");
+      if (node_count_ == 0 && build_from_sorted(first, last, false, iterator_category(first)))
+        return;
       for (; n > 0; --n, ++first)
         insert_multi(end(), *first);
     }
@@ -890,6 +1160,8 @@ namespace tinystl
     {
       size_type n = tinystl::distance(first, last);
       THROW_LENGTH_ERROR_IF(node_count_ > max_size() - n, "rb_tree<T, Comp>'s size too big");
+      if (node_count_ == 0 && build_from_sorted(first, last, true, iterator_category(first)))
+        return;
       for (; n > 0; --n, ++first)
         insert_unique(end(), *first);
     }
@@ -905,61 +1177,141 @@ namespace tinystl
 
     void clear();
 
+    // 节点句柄，节点在容器之间转移时只重新链接，不分配内存也不复制元素
+    // 例外：compact 内存块中的节点不能单独释放，摘下时先把元素移动到单独分配的节点中
+
+    node_handle_type extract(iterator position);
+    node_handle_type extract(const key_type &key);
+
+    insert_return_type insert_unique(node_handle_type &&nh);
+    iterator insert_unique(iterator hint, node_handle_type &&nh);
+    iterator insert_multi(node_handle_type &&nh);
+    iterator insert_multi(iterator hint, node_handle_type &&nh);
+
+    // 把 source 中的节点移入本树，用于键值不重复的树时，键值已存在的节点留在 source 中
+    void merge_unique(rb_tree &source);
+    void merge_multi(rb_tree &source);
+
     // rb_tree 相关操作
+    // 查找函数的参数类型 K 通常为 key_type，比较函数带有 is_transparent 标记时，
+    // 容器可以直接传入能与键值比较的其它类型，避免构造临时的键值
 
-    iterator find(const key_type &key);
-    const_iterator find(const key_type &key) const;
+    template <class K>
+    iterator find(const K &key);
+    template <class K>
+    const_iterator find(const K &key) const;
 
-    size_type count_multi(const key_type &key) const
-    {
-      auto p = equal_range_multi(key);
-      return static_cast<size_type>(tinystl::distance(p.first, p.second));
+    template <class K>
+    size_type count_multi(const K &key) const
+    { // 只下降一次，从 lower_bound 开始逐个数出相等的元素
+      size_type n = 0;
+      for (auto it = lower_bound(key); it != end() && !key_comp_(key, value_traits::get_key(*it)); ++it)
+        ++n;
+      return n;
     }
-    size_type count_unique(const key_type &key) const
+    template <class K>
+    size_type count_unique(const K &key) const
     {
       return find(key) != end() ? 1 : 0;
     }
 
-    iterator lower_bound(const key_type &key);
-    const_iterator lower_bound(const key_type &key) const;
+    template <class K>
+    iterator lower_bound(const K &key);
+    template <class K>
+    const_iterator lower_bound(const K &key) const;
 
-    iterator upper_bound(const key_type &key);
-    const_iterator upper_bound(const key_type &key) const;
+    template <class K>
+    iterator upper_bound(const K &key);
+    template <class K>
+    const_iterator upper_bound(const K &key) const;
 
+    template <class K>
     tinystl::pair<iterator, iterator>
-    equal_range_multi(const key_type &key)
+    equal_range_multi(const K &key)
     {
       return tinystl::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
     }
+    template <class K>
     tinystl::pair<const_iterator, const_iterator>
-    equal_range_multi(const key_type &key) const
+    equal_range_multi(const K &key) const
     {
       return tinystl::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
     }
 
+    template <class K>
     tinystl::pair<iterator, iterator>
-    equal_range_unique(const key_type &key)
+    equal_range_unique(const K &key)
     {
       iterator it = find(key);
       auto next = it;
       return it == end() ? tinystl::make_pair(it, it) : tinystl::make_pair(it, ++next);
     }
+    template <class K>
     tinystl::pair<const_iterator, const_iterator>
-    equal_range_unique(const key_type &key) const
+    equal_range_unique(const K &key) const
     {
       const_iterator it = find(key);
       auto next = it;
       return it == end() ? tinystl::make_pair(it, it) : tinystl::make_pair(it, ++next);
     }
 
+    // 顺序统计，NodeUpdate 为 rb_tree_size_update 时复杂度为 O(log n)，否则逐个遍历，复杂度为 O(n)
+
+    // 返回中序第 k 个（从 0 开始）元素的迭代器，k >= size() 时返回 end()
+    iterator nth(size_type k)
+    {
+      return nth_dispatch(k, m_bool_constant<NodeUpdate::order_statistics>());
+    }
+    const_iterator nth(size_type k) const
+    {
+      return const_cast<rb_tree *>(this)->nth(k);
+    }
+
+    // 返回键值小于 key 的元素个数，即 lower_bound(key) 的下标
+    size_type rank(const key_type &key) const
+    {
+      return rank_dispatch(key, m_bool_constant<NodeUpdate::order_statistics>());
+    }
+
+    // 返回 [first, last) 中的元素个数，last 必须可以从 first 到达
+    difference_type distance(const_iterator first, const_iterator last) const
+    {
+      return static_cast<difference_type>(index_of(last.node, m_bool_constant<NodeUpdate::order_statistics>())) -
+             static_cast<difference_type>(index_of(first.node, m_bool_constant<NodeUpdate::order_statistics>()));
+    }
+
+    // 带剪枝的中序遍历，借助 NodeUpdate 维护的附加信息做范围查询，参数均以 node_ptr 调用
+    // skip(x) 为真时跳过以 x 为根的整棵子树，stop(x) 为真时不再访问 x 以及中序在 x 之后的节点
+    // 其余节点按中序调用 visit(iterator)，visit 返回 false 时结束遍历
+    template <class Skip, class Stop, class Visit>
+    void visit_pruned(Skip skip, Stop stop, Visit visit)
+    {
+      visit_pruned_from(root(), skip, stop, visit);
+    }
+
     void swap(rb_tree &rhs) noexcept;
 
+    // 把所有节点按中序重新分配到一块连续内存中，树的形状和颜色不变，所有迭代器失效
+    void compact();
+
+    // 集合运算，用于键值不重复的树，rhs 的节点并入本树或被销毁，完成后 rhs 为空
+    // 基于 split / join 递归实现，复杂度为 O(m log(n / m + 1))，m <= n 为两棵树的元素个数
+    // threads > 1 时递归的顶部若干层在多个线程上并行执行，比较函数不能抛出异常
+    void union_unique(rb_tree &rhs, size_type threads = 1);        // 键值相同时保留本树的元素
+    void intersection_unique(rb_tree &rhs, size_type threads = 1); // 只保留 rhs 中也存在的元素
+    void difference_unique(rb_tree &rhs, size_type threads = 1);   // 删除 rhs 中存在的元素
+
   private:
     // node related
     template <class... Args>
     node_ptr create_node(Args &&...args);
     node_ptr clone_node(base_ptr x);
     void destroy_node(node_ptr p);
+    node_ptr extract_node(base_ptr x);
+    bool in_block(node_ptr p) const noexcept
+    {
+      return block_ != nullptr && p >= block_ && p < block_ + block_size_;
+    }
 
     // init / reset
     void rb_tree_init();
@@ -975,26 +1327,87 @@ namespace tinystl
     iterator insert_value_at(base_ptr x, const value_type &value, bool add_to_left);
     iterator insert_node_at(base_ptr x, node_ptr node, bool add_to_left);
 
-    // insert use hint
-    iterator insert_multi_use_hint(iterator hint, key_type key, node_ptr node);
-    iterator insert_unique_use_hint(iterator hint, key_type key, node_ptr node);
+    // insert node use hint
+    iterator insert_node_multi_use_hint(iterator hint, node_ptr node);
+    tinystl::pair<iterator, bool> insert_node_unique_use_hint(iterator hint, node_ptr node);
+    iterator insert_multi_use_hint(iterator hint, const key_type &key, node_ptr node);
+    tinystl::pair<iterator, bool> insert_unique_use_hint(iterator hint, const key_type &key, node_ptr node);
 
     // copy tree / erase tree
     base_ptr copy_from(base_ptr x, base_ptr p);
     void erase_since(base_ptr x);
+
+    // build from sorted range
+    template <class InputIterator>
+    bool build_from_sorted(InputIterator, InputIterator, bool, input_iterator_tag)
+    {
+      return false;
+    }
+    template <class ForwardIter>
+    bool build_from_sorted(ForwardIter first, ForwardIter last, bool unique, forward_iterator_tag);
+    template <class ForwardIter>
+    base_ptr build_since(ForwardIter &first, ForwardIter last, size_type n,
+                         size_type depth, size_type red_depth, bool unique);
+
+    // compact
+    base_ptr compact_from(base_ptr x, base_ptr p, node_ptr block, size_type &n);
+
+    // order statistics
+    iterator nth_dispatch(size_type k, m_true_type);
+    iterator nth_dispatch(size_type k, m_false_type);
+    size_type rank_dispatch(const key_type &key, m_true_type) const;
+    size_type rank_dispatch(const key_type &key, m_false_type) const;
+    size_type index_of(base_ptr x, m_true_type) const;
+    size_type index_of(base_ptr x, m_false_type) const;
+
+    // pruned traversal
+    template <class Skip, class Stop, class Visit>
+    bool visit_pruned_from(base_ptr x, Skip &skip, Stop &stop, Visit &visit);
+
+    // set operations
+    struct subtree
+    {
+      base_ptr root; // 独立子树的根，父节点为空
+      size_type bh;  // 黑高
+    };
+    struct set_op_context
+    {
+      size_type matches; // 两棵树中键值相同的元素对数
+      base_ptr garbage;  // 待销毁的子树，以根节点的 parent 指针串成链表
+    };
+    typedef void (rb_tree::*set_op)(subtree &, subtree &, set_op_context &, size_type);
+
+    size_type set_operation(rb_tree &rhs, size_type threads, set_op op, bool adopt_block);
+    subtree detach_tree() noexcept;
+    void attach_tree(subtree t) noexcept;
+    bool take_block(rb_tree &rhs, bool adopt);
+    void replace_node(base_ptr x, base_ptr q) noexcept;
+    static void expose(subtree t, subtree &l, subtree &r) noexcept;
+    static subtree join(subtree l, base_ptr k, subtree r) noexcept;
+    static subtree join2(subtree l, subtree r) noexcept;
+    static subtree split_last(subtree t, base_ptr &last) noexcept;
+    base_ptr split(subtree &t, const key_type &key, subtree &l, subtree &r) const;
+    static void discard(base_ptr x, set_op_context &ctx) noexcept;
+    static void rejoin(subtree &a, subtree al, subtree ar,
+                       subtree &b, subtree bl, base_ptr m, subtree br) noexcept;
+    template <class F, class G>
+    void fork(set_op_context &ctx, size_type depth, size_type bh, F f, G g);
+    void union_since(subtree &a, subtree &b, set_op_context &ctx, size_type depth);
+    void intersection_since(subtree &a, subtree &b, set_op_context &ctx, size_type depth);
+    void difference_since(subtree &a, subtree &b, set_op_context &ctx, size_type depth);
   };
 
   /*****************************************************************************************/
 
   // 复制构造函数
-  template <class T, class Compare>
-  rb_tree<T, Compare>::
+  template <class T, class Compare, class NodeUpdate>
+  rb_tree<T, Compare, NodeUpdate>::
       rb_tree(const rb_tree &rhs)
   {
     rb_tree_init();
     if (rhs.node_count_ != 0)
     {
-      root() = copy_from(rhs.root(), header_);
+      set_root(copy_from(rhs.root(), header_));
       leftmost() = rb_tree_min(root());
       rightmost() = rb_tree_max(root());
     }
@@ -1003,20 +1416,23 @@ namespace tinystl
   }
 
   // 移动构造函数
-  template <class T, class Compare>
-  rb_tree<T, Compare>::
+  template <class T, class Compare, class NodeUpdate>
+  rb_tree<T, Compare, NodeUpdate>::
       rb_tree(rb_tree &&rhs) noexcept
       : header_(tinystl::move(rhs.header_)),
         node_count_(rhs.node_count_),
-        key_comp_(rhs.key_comp_)
+        key_comp_(rhs.key_comp_),
+        block_(rhs.block_),
+        block_size_(rhs.block_size_),
+        block_live_(rhs.block_live_)
   {
     rhs.reset();
   }
 
   // 复制赋值操作符
-  template <class T, class Compare>
-  rb_tree<T, Compare> &
-  rb_tree<T, Compare>::
+  template <class T, class Compare, class NodeUpdate>
+  rb_tree<T, Compare, NodeUpdate> &
+  rb_tree<T, Compare, NodeUpdate>::
   operator=(const rb_tree &rhs)
   {
     if (this != &rhs)
@@ -1025,7 +1441,7 @@ namespace tinystl
 
       if (rhs.node_count_ != 0)
       {
-        root() = copy_from(rhs.root(), header_);
+        set_root(copy_from(rhs.root(), header_));
         leftmost() = rb_tree_min(root());
         rightmost() = rb_tree_max(root());
       }
@@ -1037,24 +1453,24 @@ namespace tinystl
   }
 
   // 移动赋值操作符
-  template <class T, class Compare>
-  rb_tree<T, Compare> &
-  rb_tree<T, Compare>::
+  template <class T, class Compare, class NodeUpdate>
+  rb_tree<T, Compare, NodeUpdate> &
+  rb_tree<T, Compare, NodeUpdate>::
   operator=(rb_tree &&rhs)
   {
-    clear();
-    header_ = tinystl::move(rhs.header_);
-    node_count_ = rhs.node_count_;
-    key_comp_ = rhs.key_comp_;
-    rhs.reset();
+    if (this != &rhs)
+    {
+      clear();
+      swap(rhs);
+    }
     return *this;
   }
 
   // 就地插入元素，键值允许重复
-  template <class T, class Compare>
+  template <class T, class Compare, class NodeUpdate>
   template <class... Args>
-  typename rb_tree<T, Compare>::iterator
-  rb_tree<T, Compare>::
+  typename rb_tree<T, Compare, NodeUpdate>::iterator
+  rb_tree<T, Compare, NodeUpdate>::
       emplace_multi(Args &&...args)
   {
     THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
@@ -1064,10 +1480,10 @@ namespace tinystl
   }
 
   // 就地插入元素，键值不允许重复
-  template <class T, class Compare>
+  template <class T, class Compare, class NodeUpdate>
   template <class... Args>
-  tinystl::pair<typename rb_tree<T, Compare>::iterator, bool>
-  rb_tree<T, Compare>::
+  tinystl::pair<typename rb_tree<T, Compare, NodeUpdate>::iterator, bool>
+  rb_tree<T, Compare, NodeUpdate>::
       emplace_unique(Args &&...args)
   {
     THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
@@ -1082,101 +1498,36 @@ namespace tinystl
   }
 
   // 就地插入元素，键值允许重复，当 hint 位置与插入位置接近时，插入操作的时间复杂度可以降低
-  template <class T, class Compare>
+  template <class T, class Compare, class NodeUpdate>
   template <class... Args>
-  typename rb_tree<T, Compare>::iterator
-  rb_tree<T, Compare>::
+  typename rb_tree<T, Compare, NodeUpdate>::iterator
+  rb_tree<T, Compare, NodeUpdate>::
       emplace_multi_use_hint(iterator hint, Args &&...args)
   {
     THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
     node_ptr np = create_node(tinystl::forward<Args>(args)...);
-    if (node_count_ == 0)
-    {
-      return insert_node_at(header_, np, true);
-    }
-    key_type key = value_traits::get_key(np->value);
-    if (hint == begin())
-    { // 位于 begin 处
-      if (key_comp_(key, value_traits::get_key(*hint)))
-      {
-        return insert_node_at(hint.node, np, true);
-      }
-      else
-      {
-        auto pos = get_insert_multi_pos(key);
-        return insert_node_at(pos.first, np, pos.second);
-      }
-    }
-    else if (hint == end())
-    { // 位于 end 处
-      if (!key_comp_(key, value_traits::get_key(rightmost()->get_node_ptr()->value)))
-      {
-        return insert_node_at(rightmost(), np, false);
-      }
-      else
-      {
-        auto pos = get_insert_multi_pos(key);
-        return insert_node_at(pos.first, np, pos.second);
-      }
-    }
-    return insert_multi_use_hint(hint, key, np);
+    return insert_node_multi_use_hint(hint, np);
   }
 
   // 就地插入元素，键值不允许重复，当 hint 位置与插入位置接近时，插入操作的时间复杂度可以降低
-  template <class T, class Compare>
+  template <class T, class Compare, class NodeUpdate>
   template <class... Args>
-  typename rb_tree<T, Compare>::iterator
-  rb_tree<T, Compare>::
+  typename rb_tree<T, Compare, NodeUpdate>::iterator
+  rb_tree<T, Compare, NodeUpdate>::
       emplace_unique_use_hint(iterator hint, Args &&...args)
   {
     THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
     node_ptr np = create_node(tinystl::forward<Args>(args)...);
-    if (node_count_ == 0)
-    {
-      return insert_node_at(header_, np, true);
-    }
-    key_type key = value_traits::get_key(np->value);
-    if (hint == begin())
-    { // 位于 begin 处
-      if (key_comp_(key, value_traits::get_key(*hint)))
-      {
-        return insert_node_at(hint.node, np, true);
-      }
-      else
-      {
-        auto pos = get_insert_unique_pos(key);
-        if (!pos.second)
-        {
-          destroy_node(np);
-          return pos.first.first;
-        }
-        return insert_node_at(pos.first.first, np, pos.first.second);
-      }
-    }
-    else if (hint == end())
-    { // 位于 end 处
-      if (key_comp_(value_traits::get_key(rightmost()->get_node_ptr()->value), key))
-      {
-        return insert_node_at(rightmost(), np, false);
-      }
-      else
-      {
-        auto pos = get_insert_unique_pos(key);
-        if (!pos.second)
-        {
-          destroy_node(np);
-          return pos.first.first;
-        }
-        return insert_node_at(pos.first.first, np, pos.first.second);
-      }
-    }
-    return insert_unique_use_hint(hint, key, np);
+    auto res = insert_node_unique_use_hint(hint, np);
+    if (!res.second)
+      destroy_node(np);
+    return res.first;
   }
 
   // 插入元素，节点键值允许重复
-  template <class T, class Compare>
-  typename rb_tree<T, Compare>::iterator
-  rb_tree<T, Compare>::
+  template <class T, class Compare, class NodeUpdate>
+  typename rb_tree<T, Compare, NodeUpdate>::iterator
+  rb_tree<T, Compare, NodeUpdate>::
       insert_multi(const value_type &value)
   {
     THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
@@ -1185,9 +1536,9 @@ namespace tinystl
   }
 
   // 插入新值，节点键值不允许重复，返回一个 pair，若插入成功，pair 的第二参数为 true，否则为 false
-  template <class T, class Compare>
-  tinystl::pair<typename rb_tree<T, Compare>::iterator, bool>
-  rb_tree<T, Compare>::
+  template <class T, class Compare, class NodeUpdate>
+  tinystl::pair<typename rb_tree<T, Compare, NodeUpdate>::iterator, bool>
+  rb_tree<T, Compare, NodeUpdate>::
       insert_unique(const value_type &value)
   {
     THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
@@ -1200,25 +1551,27 @@ namespace tinystl
   }
 
   // 删除 hint 位置的节点
-  template <class T, class Compare>
-  typename rb_tree<T, Compare>::iterator
-  rb_tree<T, Compare>::
+  template <class T, class Compare, class NodeUpdate>
+  typename rb_tree<T, Compare, NodeUpdate>::iterator
+  rb_tree<T, Compare, NodeUpdate>::
       erase(iterator hint)
   {
-    auto node = hint.node->get_node_ptr();
+    auto node = static_cast<node_ptr>(hint.node);
     iterator next(node);
     ++next;
 
-    rb_tree_erase_rebalance(hint.node, root(), leftmost(), rightmost());
+    base_ptr r = root();
+    rb_tree_erase_rebalance<NodeUpdate>(hint.node, r, leftmost(), rightmost());
+    set_root(r);
     destroy_node(node);
     --node_count_;
     return next;
   }
 
   // 删除键值等于 key 的元素，返回删除的个数
-  template <class T, class Compare>
-  typename rb_tree<T, Compare>::size_type
-  rb_tree<T, Compare>::
+  template <class T, class Compare, class NodeUpdate>
+  typename rb_tree<T, Compare, NodeUpdate>::size_type
+  rb_tree<T, Compare, NodeUpdate>::
       erase_multi(const key_type &key)
   {
     auto p = equal_range_multi(key);
@@ -1228,9 +1581,9 @@ namespace tinystl
   }
 
   // 删除键值等于 key 的元素，返回删除的个数
-  template <class T, class Compare>
-  typename rb_tree<T, Compare>::size_type
-  rb_tree<T, Compare>::
+  template <class T, class Compare, class NodeUpdate>
+  typename rb_tree<T, Compare, NodeUpdate>::size_type
+  rb_tree<T, Compare, NodeUpdate>::
       erase_unique(const key_type &key)
   {
     auto it = find(key);
@@ -1243,8 +1596,8 @@ namespace tinystl
   }
 
   // 删除[first, last)区间内的元素
-  template <class T, class Compare>
-  void rb_tree<T, Compare>::
+  template <class T, class Compare, class NodeUpdate>
+  void rb_tree<T, Compare, NodeUpdate>::
       erase(iterator first, iterator last)
   {
     if (first == begin() && last == end())
@@ -1259,25 +1612,136 @@ namespace tinystl
   }
 
   // 清空 rb tree
-  template <class T, class Compare>
-  void rb_tree<T, Compare>::
+  template <class T, class Compare, class NodeUpdate>
+  void rb_tree<T, Compare, NodeUpdate>::
       clear()
   {
     if (node_count_ != 0)
     {
       erase_since(root());
       leftmost() = header_;
-      root() = nullptr;
+      set_root(nullptr);
       rightmost() = header_;
       node_count_ = 0;
     }
   }
 
+  // 从树中摘下 position 处的节点，由返回的句柄持有
+  template <class T, class Compare, class NodeUpdate>
+  typename rb_tree<T, Compare, NodeUpdate>::node_handle_type
+  rb_tree<T, Compare, NodeUpdate>::
+      extract(iterator position)
+  {
+    return node_handle_type(extract_node(position.node));
+  }
+
+  // 摘下第一个键值等于 key 的节点，不存在时返回空的句柄
+  template <class T, class Compare, class NodeUpdate>
+  typename rb_tree<T, Compare, NodeUpdate>::node_handle_type
+  rb_tree<T, Compare, NodeUpdate>::
+      extract(const key_type &key)
+  {
+    iterator it = find(key);
+    return it == end() ? node_handle_type() : extract(it);
+  }
+
+  // 插入句柄持有的节点，键值不允许重复，插入失败时节点留在返回值的 node 中
+  template <class T, class Compare, class NodeUpdate>
+  typename rb_tree<T, Compare, NodeUpdate>::insert_return_type
+  rb_tree<T, Compare, NodeUpdate>::
+      insert_unique(node_handle_type &&nh)
+  {
+    if (nh.empty())
+      return insert_return_type{end(), false, node_handle_type()};
+    THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
+    auto res = get_insert_unique_pos(value_traits::get_key(nh.ptr_->value));
+    if (!res.second)
+      return insert_return_type{iterator(res.first.first), false, tinystl::move(nh)};
+    iterator it = insert_node_at(res.first.first, nh.release(), res.first.second);
+    return insert_return_type{it, true, node_handle_type()};
+  }
+
+  template <class T, class Compare, class NodeUpdate>
+  typename rb_tree<T, Compare, NodeUpdate>::iterator
+  rb_tree<T, Compare, NodeUpdate>::
+      insert_unique(iterator hint, node_handle_type &&nh)
+  {
+    if (nh.empty())
+      return end();
+    THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
+    auto res = insert_node_unique_use_hint(hint, nh.ptr_);
+    if (res.second)
+      nh.release();
+    return res.first;
+  }
+
+  // 插入句柄持有的节点，键值允许重复
+  template <class T, class Compare, class NodeUpdate>
+  typename rb_tree<T, Compare, NodeUpdate>::iterator
+  rb_tree<T, Compare, NodeUpdate>::
+      insert_multi(node_handle_type &&nh)
+  {
+    if (nh.empty())
+      return end();
+    THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
+    auto pos = get_insert_multi_pos(value_traits::get_key(nh.ptr_->value));
+    return insert_node_at(pos.first, nh.release(), pos.second);
+  }
+
+  template <class T, class Compare, class NodeUpdate>
+  typename rb_tree<T, Compare, NodeUpdate>::iterator
+  rb_tree<T, Compare, NodeUpdate>::
+      insert_multi(iterator hint, node_handle_type &&nh)
+  {
+    if (nh.empty())
+      return end();
+    THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
+    return insert_node_multi_use_hint(hint, nh.release());
+  }
+
+  // 把 source 中键值在本树中不存在的节点移入本树
+  template <class T, class Compare, class NodeUpdate>
+  void rb_tree<T, Compare, NodeUpdate>::
+      merge_unique(rb_tree &source)
+  {
+    if (this == &source)
+      return;
+    for (iterator it = source.begin(); it != source.end();)
+    {
+      auto pos = get_insert_unique_pos(value_traits::get_key(*it));
+      if (!pos.second)
+      { // 键值已存在，节点留在 source 中
+        ++it;
+        continue;
+      }
+      base_ptr x = it.node;
+      ++it;
+      insert_node_at(pos.first.first, source.extract_node(x), pos.first.second);
+    }
+  }
+
+  // 把 source 中的所有节点移入本树，键值相同的元素保持原来的相对顺序
+  template <class T, class Compare, class NodeUpdate>
+  void rb_tree<T, Compare, NodeUpdate>::
+      merge_multi(rb_tree &source)
+  {
+    if (this == &source)
+      return;
+    THROW_LENGTH_ERROR_IF(node_count_ > max_size() - source.node_count_, "rb_tree<T, Comp>'s size too big");
+    while (!source.empty())
+    {
+      base_ptr x = source.leftmost();
+      auto pos = get_insert_multi_pos(value_traits::get_key(x->get_node_ptr()->value));
+      insert_node_at(pos.first, source.extract_node(x), pos.second);
+    }
+  }
+
   // 查找键值为 k 的节点，返回指向它的迭代器
-  template <class T, class Compare>
-  typename rb_tree<T, Compare>::iterator
-  rb_tree<T, Compare>::
-      find(const key_type &key)
+  template <class T, class Compare, class NodeUpdate>
+  template <class K>
+  typename rb_tree<T, Compare, NodeUpdate>::iterator
+  rb_tree<T, Compare, NodeUpdate>::
+      find(const K &key)
   {
     auto y = header_; // 最后一个不小于 key 的节点
     auto x = root();
@@ -1296,10 +1760,11 @@ namespace tinystl
     return (j == end() || key_comp_(key, value_traits::get_key(*j))) ? end() : j;
   }
 
-  template <class T, class Compare>
-  typename rb_tree<T, Compare>::const_iterator
-  rb_tree<T, Compare>::
-      find(const key_type &key) const
+  template <class T, class Compare, class NodeUpdate>
+  template <class K>
+  typename rb_tree<T, Compare, NodeUpdate>::const_iterator
+  rb_tree<T, Compare, NodeUpdate>::
+      find(const K &key) const
   {
     auto y = header_; // 最后一个不小于 key 的节点
     auto x = root();
@@ -1319,10 +1784,11 @@ namespace tinystl
   }
 
   // 键值不小于 key 的第一个位置
-  template <class T, class Compare>
-  typename rb_tree<T, Compare>::iterator
-  rb_tree<T, Compare>::
-      lower_bound(const key_type &key)
+  template <class T, class Compare, class NodeUpdate>
+  template <class K>
+  typename rb_tree<T, Compare, NodeUpdate>::iterator
+  rb_tree<T, Compare, NodeUpdate>::
+      lower_bound(const K &key)
   {
     auto y = header_;
     auto x = root();
@@ -1340,10 +1806,11 @@ namespace tinystl
     return iterator(y);
   }
 
-  template <class T, class Compare>
-  typename rb_tree<T, Compare>::const_iterator
-  rb_tree<T, Compare>::
-      lower_bound(const key_type &key) const
+  template <class T, class Compare, class NodeUpdate>
+  template <class K>
+  typename rb_tree<T, Compare, NodeUpdate>::const_iterator
+  rb_tree<T, Compare, NodeUpdate>::
+      lower_bound(const K &key) const
   {
     auto y = header_;
     auto x = root();
@@ -1362,10 +1829,11 @@ namespace tinystl
   }
 
   // 键值不小于 key 的最后一个位置
-  template <class T, class Compare>
-  typename rb_tree<T, Compare>::iterator
-  rb_tree<T, Compare>::
-      upper_bound(const key_type &key)
+  template <class T, class Compare, class NodeUpdate>
+  template <class K>
+  typename rb_tree<T, Compare, NodeUpdate>::iterator
+  rb_tree<T, Compare, NodeUpdate>::
+      upper_bound(const K &key)
   {
     auto y = header_;
     auto x = root();
@@ -1383,10 +1851,11 @@ namespace tinystl
     return iterator(y);
   }
 
-  template <class T, class Compare>
-  typename rb_tree<T, Compare>::const_iterator
-  rb_tree<T, Compare>::
-      upper_bound(const key_type &key) const
+  template <class T, class Compare, class NodeUpdate>
+  template <class K>
+  typename rb_tree<T, Compare, NodeUpdate>::const_iterator
+  rb_tree<T, Compare, NodeUpdate>::
+      upper_bound(const K &key) const
   {
     auto y = header_;
     auto x = root();
@@ -1405,8 +1874,8 @@ namespace tinystl
   }
 
   // 交换 rb tree
-  template <class T, class Compare>
-  void rb_tree<T, Compare>::
+  template <class T, class Compare, class NodeUpdate>
+  void rb_tree<T, Compare, NodeUpdate>::
       swap(rb_tree &rhs) noexcept
   {
     if (this != &rhs)
@@ -1414,17 +1883,88 @@ namespace tinystl
       tinystl::swap(header_, rhs.header_);
       tinystl::swap(node_count_, rhs.node_count_);
       tinystl::swap(key_comp_, rhs.key_comp_);
+      tinystl::swap(block_, rhs.block_);
+      tinystl::swap(block_size_, rhs.block_size_);
+      tinystl::swap(block_live_, rhs.block_live_);
+    }
+  }
+
+  // 压缩 rb tree
+  // 新节点按中序依次放入一块连续内存，遍历时按地址顺序访问
+  // 元素的移动构造不抛出异常时移动元素，否则复制，复制失败时容器不变
+  template <class T, class Compare, class NodeUpdate>
+  void rb_tree<T, Compare, NodeUpdate>::
+      compact()
+  {
+    if (node_count_ == 0)
+      return;
+    node_ptr block = node_allocator::allocate(node_count_);
+    size_type n = 0;
+    base_ptr new_root = nullptr;
+    try
+    {
+      new_root = compact_from(root(), header_, block, n);
+    }
+    catch (...)
+    {
+      for (size_type i = 0; i < n; ++i)
+        data_allocator::destroy(tinystl::address_of(block[i].value));
+      node_allocator::deallocate(block, node_count_);
+      throw;
+    }
+    // 释放旧节点，旧的内存块在其中节点全部销毁时释放
+    erase_since(root());
+    set_root(new_root);
+    leftmost() = block[0].get_base_ptr();
+    rightmost() = block[node_count_ - 1].get_base_ptr();
+    block_ = block;
+    block_size_ = node_count_;
+    block_live_ = node_count_;
+  }
+
+  // 并集，键值相同时保留本树的元素，rhs 中重复的元素被销毁
+  template <class T, class Compare, class NodeUpdate>
+  void rb_tree<T, Compare, NodeUpdate>::
+      union_unique(rb_tree &rhs, size_type threads)
+  {
+    if (this == &rhs)
+      return;
+    const size_type n = node_count_ + rhs.node_count_;
+    node_count_ = n - set_operation(rhs, threads, &rb_tree::union_since, false);
+  }
+
+  // 交集，只保留 rhs 中也存在的元素，其余元素被销毁
+  template <class T, class Compare, class NodeUpdate>
+  void rb_tree<T, Compare, NodeUpdate>::
+      intersection_unique(rb_tree &rhs, size_type threads)
+  {
+    if (this == &rhs)
+      return;
+    node_count_ = set_operation(rhs, threads, &rb_tree::intersection_since, true);
+  }
+
+  // 差集，删除 rhs 中存在的元素，rhs 的元素全部被销毁
+  template <class T, class Compare, class NodeUpdate>
+  void rb_tree<T, Compare, NodeUpdate>::
+      difference_unique(rb_tree &rhs, size_type threads)
+  {
+    if (this == &rhs)
+    {
+      clear();
+      return;
     }
+    const size_type n = node_count_;
+    node_count_ = n - set_operation(rhs, threads, &rb_tree::difference_since, true);
   }
 
   /*****************************************************************************************/
   // helper function
 
   // 创建一个结点
-  template <class T, class Compare>
+  template <class T, class Compare, class NodeUpdate>
   template <class... Args>
-  typename rb_tree<T, Compare>::node_ptr
-  rb_tree<T, Compare>::
+  typename rb_tree<T, Compare, NodeUpdate>::node_ptr
+  rb_tree<T, Compare, NodeUpdate>::
       create_node(Args &&...args)
   {
     auto tmp = node_allocator::allocate(1);
@@ -1433,7 +1973,7 @@ namespace tinystl
       data_allocator::construct(tinystl::address_of(tmp->value), tinystl::forward<Args>(args)...);
       tmp->left = nullptr;
       tmp->right = nullptr;
-      tmp->parent = nullptr;
+      tmp->set_parent_color(nullptr, rb_tree_red);
     }
     catch (...)
     {
@@ -1444,52 +1984,96 @@ namespace tinystl
   }
 
   // 复制一个结点
-  template <class T, class Compare>
-  typename rb_tree<T, Compare>::node_ptr
-  rb_tree<T, Compare>::
+  template <class T, class Compare, class NodeUpdate>
+  typename rb_tree<T, Compare, NodeUpdate>::node_ptr
+  rb_tree<T, Compare, NodeUpdate>::
       clone_node(base_ptr x)
   {
     node_ptr tmp = create_node(x->get_node_ptr()->value);
-    tmp->color = x->color;
+    tmp->set_color(x->color());
     tmp->left = nullptr;
     tmp->right = nullptr;
+    NodeUpdate::copy(tmp->get_base_ptr(), x);
     return tmp;
   }
 
   // 销毁一个结点
-  template <class T, class Compare>
-  void rb_tree<T, Compare>::
+  template <class T, class Compare, class NodeUpdate>
+  void rb_tree<T, Compare, NodeUpdate>::
       destroy_node(node_ptr p)
   {
     data_allocator::destroy(&p->value);
-    node_allocator::deallocate(p);
+    if (in_block(p))
+    { // 位于 compact 分配的内存块中，最后一个节点销毁时释放整块内存
+      if (--block_live_ == 0)
+      {
+        node_allocator::deallocate(block_, block_size_);
+        block_ = nullptr;
+        block_size_ = 0;
+      }
+    }
+    else
+    {
+      node_allocator::deallocate(p);
+    }
+  }
+
+  // 把节点从树中摘下，返回的节点不属于任何树，颜色为红，没有父节点和子节点
+  // 节点位于 compact 的内存块中时，先把元素移动到单独分配的节点中，再销毁原节点
+  template <class T, class Compare, class NodeUpdate>
+  typename rb_tree<T, Compare, NodeUpdate>::node_ptr
+  rb_tree<T, Compare, NodeUpdate>::
+      extract_node(base_ptr x)
+  {
+    auto node = static_cast<node_ptr>(x);
+    node_ptr result = in_block(node) ? create_node(tinystl::move(node->value)) : node;
+    base_ptr r = root();
+    rb_tree_erase_rebalance<NodeUpdate>(x, r, leftmost(), rightmost());
+    set_root(r);
+    --node_count_;
+    if (result != node)
+    {
+      destroy_node(node);
+    }
+    else
+    {
+      result->left = nullptr;
+      result->right = nullptr;
+      result->set_parent_color(nullptr, rb_tree_red);
+    }
+    return result;
   }
 
   // 初始化容器
-  template <class T, class Compare>
-  void rb_tree<T, Compare>::
+  template <class T, class Compare, class NodeUpdate>
+  void rb_tree<T, Compare, NodeUpdate>::
       rb_tree_init()
   {
     header_ = base_allocator::allocate(1);
-    header_->color = rb_tree_red; // header_ 节点颜色为红，与 root 区分
-    root() = nullptr;
+    header_->set_parent_color(nullptr, rb_tree_red); // header_ 节点颜色为红，与 root 区分
     leftmost() = header_;
     rightmost() = header_;
     node_count_ = 0;
+    block_ = nullptr;
+    block_size_ = 0;
+    block_live_ = 0;
   }
 
   // reset 函数
-  template <class T, class Compare>
-  void rb_tree<T, Compare>::reset()
+  template <class T, class Compare, class NodeUpdate>
+  void rb_tree<T, Compare, NodeUpdate>::reset()
   {
     header_ = nullptr;
     node_count_ = 0;
+    block_ = nullptr;
+    block_size_ = 0;
+    block_live_ = 0;
   }
 
   // get_insert_multi_pos 函数
-  template <class T, class Compare>
-  tinystl::pair<typename rb_tree<T, Compare>::base_ptr, bool>
-  rb_tree<T, Compare>::get_insert_multi_pos(const key_type &key)
+  template <class T, class Compare, class NodeUpdate>
+  tinystl::pair<typename rb_tree<T, Compare, NodeUpdate>::base_ptr, bool>
+  rb_tree<T, Compare, NodeUpdate>::get_insert_multi_pos(const key_type &key)
   {
     auto x = root();
     auto y = header_;
@@ -1504,11 +2088,11 @@ namespace tinystl
   }
 
   // get_insert_unique_pos 函数
-  template <class T, class Compare>
-  tinystl::pair<tinystl::pair<typename rb_tree<T, Compare>::base_ptr, bool>, bool>
-  rb_tree<T, Compare>::get_insert_unique_pos(const key_type &key)
+  template <class T, class Compare, class NodeUpdate>
+  tinystl::pair<tinystl::pair<typename rb_tree<T, Compare, NodeUpdate>::base_ptr, bool>, bool>
+  rb_tree<T, Compare, NodeUpdate>::get_insert_unique_pos(const key_type &key)
   { // 返回一个 pair，第一个值为一个 pair，包含插入点的父节点和一个 bool 表示是否在左边插入，
-    // 第二个值为一个 bool，表示是否插入成功
+    // 第二个值为一个 bool，表示是否插入成功，失败时第一个值中的节点为键值重复的节点
     auto x = root();
     auto y = header_;
     bool add_to_left = true; // 树为空时也在 header_ 左边插入
@@ -1534,23 +2118,23 @@ namespace tinystl
     { // 表明新节点没有重复
       return tinystl::make_pair(tinystl::make_pair(y, add_to_left), true);
     }
-    // 进行至此，表示新节点与现有节点键值重复
-    return tinystl::make_pair(tinystl::make_pair(y, add_to_left), false);
+    // 进行至此，表示新节点与现有节点键值重复，返回重复的节点
+    return tinystl::make_pair(tinystl::make_pair(j.node, add_to_left), false);
   }
 
   // insert_value_at 函数
   // x 为插入点的父节点， value 为要插入的值，add_to_left 表示是否在左边插入
-  template <class T, class Compare>
-  typename rb_tree<T, Compare>::iterator
-  rb_tree<T, Compare>::
+  template <class T, class Compare, class NodeUpdate>
+  typename rb_tree<T, Compare, NodeUpdate>::iterator
+  rb_tree<T, Compare, NodeUpdate>::
       insert_value_at(base_ptr x, const value_type &value, bool add_to_left)
   {
     node_ptr node = create_node(value);
-    node->parent = x;
+    node->set_parent(x);
     auto base_node = node->get_base_ptr();
     if (x == header_)
     {
-      root() = base_node;
+      set_root(base_node);
       leftmost() = base_node;
       rightmost() = base_node;
     }
@@ -1566,23 +2150,25 @@ namespace tinystl
       if (rightmost() == x)
         rightmost() = base_node;
     }
-    rb_tree_insert_rebalance(base_node, root());
+    base_ptr r = root();
+    rb_tree_insert_rebalance<NodeUpdate>(base_node, r);
+    set_root(r);
     ++node_count_;
     return iterator(node);
   }
 
   // 在 x 节点处插入新的节点
   // x 为插入点的父节点， node 为要插入的节点，add_to_left 表示是否在左边插入
-  template <class T, class Compare>
-  typename rb_tree<T, Compare>::iterator
-  rb_tree<T, Compare>::
+  template <class T, class Compare, class NodeUpdate>
+  typename rb_tree<T, Compare, NodeUpdate>::iterator
+  rb_tree<T, Compare, NodeUpdate>::
       insert_node_at(base_ptr x, node_ptr node, bool add_to_left)
   {
-    node->parent = x;
+    node->set_parent(x);
     auto base_node = node->get_base_ptr();
     if (x == header_)
     {
-      root() = base_node;
+      set_root(base_node);
       leftmost() = base_node;
       rightmost() = base_node;
     }
@@ -1598,26 +2184,104 @@ namespace tinystl
       if (rightmost() == x)
         rightmost() = base_node;
     }
-    rb_tree_insert_rebalance(base_node, root());
+    base_ptr r = root();
+    rb_tree_insert_rebalance<NodeUpdate>(base_node, r);
+    set_root(r);
     ++node_count_;
     return iterator(node);
   }
 
-  // 插入元素，键值允许重复，使用 hint
-  template <class T, class Compare>
-  typename rb_tree<T, Compare>::iterator
-  rb_tree<T, Compare>::
-      insert_multi_use_hint(iterator hint, key_type key, node_ptr node)
+  // 插入节点，键值允许重复，使用 hint
+  template <class T, class Compare, class NodeUpdate>
+  typename rb_tree<T, Compare, NodeUpdate>::iterator
+  rb_tree<T, Compare, NodeUpdate>::
+      insert_node_multi_use_hint(iterator hint, node_ptr node)
   {
-    // 在 hint 附近寻找可插入的位置
-    auto np = hint.node;
-    auto before = hint;
-    --before;
-    auto bnp = before.node;
-    if (!key_comp_(key, value_traits::get_key(*before)) &&
-        !key_comp_(value_traits::get_key(*hint), key))
-    { // before <= node <= hint
-      if (bnp->right == nullptr)
+    if (node_count_ == 0)
+    {
+      return insert_node_at(header_, node, true);
+    }
+    const key_type &key = value_traits::get_key(node->value);
+    if (hint == begin())
+    { // 位于 begin 处
+      if (key_comp_(key, value_traits::get_key(*hint)))
+      {
+        return insert_node_at(hint.node, node, true);
+      }
+      else
+      {
+        auto pos = get_insert_multi_pos(key);
+        return insert_node_at(pos.first, node, pos.second);
+      }
+    }
+    else if (hint == end())
+    { // 位于 end 处
+      if (!key_comp_(key, value_traits::get_key(rightmost()->get_node_ptr()->value)))
+      {
+        return insert_node_at(rightmost(), node, false);
+      }
+      else
+      {
+        auto pos = get_insert_multi_pos(key);
+        return insert_node_at(pos.first, node, pos.second);
+      }
+    }
+    return insert_multi_use_hint(hint, key, node);
+  }
+
+  // 插入节点，键值不允许重复，使用 hint
+  // 键值已存在时不插入，返回已存在元素的迭代器，节点仍归调用者所有
+  template <class T, class Compare, class NodeUpdate>
+  tinystl::pair<typename rb_tree<T, Compare, NodeUpdate>::iterator, bool>
+  rb_tree<T, Compare, NodeUpdate>::
+      insert_node_unique_use_hint(iterator hint, node_ptr node)
+  {
+    if (node_count_ == 0)
+    {
+      return tinystl::make_pair(insert_node_at(header_, node, true), true);
+    }
+    const key_type &key = value_traits::get_key(node->value);
+    if (hint == begin())
+    { // 位于 begin 处
+      if (key_comp_(key, value_traits::get_key(*hint)))
+      {
+        return tinystl::make_pair(insert_node_at(hint.node, node, true), true);
+      }
+    }
+    else if (hint == end())
+    { // 位于 end 处
+      if (key_comp_(value_traits::get_key(rightmost()->get_node_ptr()->value), key))
+      {
+        return tinystl::make_pair(insert_node_at(rightmost(), node, false), true);
+      }
+    }
+    else
+    {
+      return insert_unique_use_hint(hint, key, node);
+    }
+    auto pos = get_insert_unique_pos(key);
+    if (!pos.second)
+    {
+      return tinystl::make_pair(iterator(pos.first.first), false);
+    }
+    return tinystl::make_pair(insert_node_at(pos.first.first, node, pos.first.second), true);
+  }
+
+  // 插入元素，键值允许重复，使用 hint
+  template <class T, class Compare, class NodeUpdate>
+  typename rb_tree<T, Compare, NodeUpdate>::iterator
+  rb_tree<T, Compare, NodeUpdate>::
+      insert_multi_use_hint(iterator hint, const key_type &key, node_ptr node)
+  {
+    // 在 hint 附近寻找可插入的位置
+    auto np = hint.node;
+    auto before = hint;
+    --before;
+    auto bnp = before.node;
+    if (!key_comp_(key, value_traits::get_key(*before)) &&
+        !key_comp_(value_traits::get_key(*hint), key))
+    { // before <= node <= hint
+      if (bnp->right == nullptr)
       {
         return insert_node_at(bnp, node, false);
       }
@@ -1631,10 +2295,10 @@ namespace tinystl
   }
 
   // 插入元素，键值不允许重复，使用 hint
-  template <class T, class Compare>
-  typename rb_tree<T, Compare>::iterator
-  rb_tree<T, Compare>::
-      insert_unique_use_hint(iterator hint, key_type key, node_ptr node)
+  template <class T, class Compare, class NodeUpdate>
+  tinystl::pair<typename rb_tree<T, Compare, NodeUpdate>::iterator, bool>
+  rb_tree<T, Compare, NodeUpdate>::
+      insert_unique_use_hint(iterator hint, const key_type &key, node_ptr node)
   {
     // 在 hint 附近寻找可插入的位置
     auto np = hint.node;
@@ -1646,30 +2310,29 @@ namespace tinystl
     { // before < node < hint
       if (bnp->right == nullptr)
       {
-        return insert_node_at(bnp, node, false);
+        return tinystl::make_pair(insert_node_at(bnp, node, false), true);
       }
       else if (np->left == nullptr)
       {
-        return insert_node_at(np, node, true);
+        return tinystl::make_pair(insert_node_at(np, node, true), true);
       }
     }
     auto pos = get_insert_unique_pos(key);
     if (!pos.second)
     {
-      destroy_node(node);
-      return pos.first.first;
+      return tinystl::make_pair(iterator(pos.first.first), false);
     }
-    return insert_node_at(pos.first.first, node, pos.first.second);
+    return tinystl::make_pair(insert_node_at(pos.first.first, node, pos.first.second), true);
   }
 
   // copy_from 函数
   // 递归复制一颗树，节点从 x 开始，p 为 x 的父节点
-  template <class T, class Compare>
-  typename rb_tree<T, Compare>::base_ptr
-  rb_tree<T, Compare>::copy_from(base_ptr x, base_ptr p)
+  template <class T, class Compare, class NodeUpdate>
+  typename rb_tree<T, Compare, NodeUpdate>::base_ptr
+  rb_tree<T, Compare, NodeUpdate>::copy_from(base_ptr x, base_ptr p)
   {
     auto top = clone_node(x);
-    top->parent = p;
+    top->set_parent(p);
     try
     {
       if (x->right)
@@ -1680,7 +2343,7 @@ namespace tinystl
       {
         auto y = clone_node(x);
         p->left = y;
-        y->parent = p;
+        y->set_parent(p);
         if (x->right)
           y->right = copy_from(x->right, y);
         p = y;
@@ -1697,59 +2360,766 @@ namespace tinystl
 
   // erase_since 函数
   // 从 x 节点开始删除该节点及其子树
-  template <class T, class Compare>
-  void rb_tree<T, Compare>::
+  template <class T, class Compare, class NodeUpdate>
+  void rb_tree<T, Compare, NodeUpdate>::
       erase_since(base_ptr x)
   {
     while (x != nullptr)
     {
       erase_since(x->right);
       auto y = x->left;
-      destroy_node(x->get_node_ptr());
+      destroy_node(static_cast<node_ptr>(x));
       x = y;
     }
   }
 
+  // build_from_sorted 函数
+  // 树为空且 [first, last) 已按键值有序时，自底向上建立一颗完全平衡的树，复杂度为 O(n)
+  // unique 为 true 时相邻的重复键值只保留第一个，区间无序时返回 false，由调用者逐个插入
+  template <class T, class Compare, class NodeUpdate>
+  template <class ForwardIter>
+  bool rb_tree<T, Compare, NodeUpdate>::
+      build_from_sorted(ForwardIter first, ForwardIter last, bool unique, forward_iterator_tag)
+  {
+    if (first == last)
+      return true;
+    // 检查是否有序，同时统计节点数
+    size_type n = 1;
+    for (auto prev = first, cur = first; ++cur != last; prev = cur)
+    {
+      if (key_comp_(value_traits::get_key(*cur), value_traits::get_key(*prev)))
+        return false;
+      if (!unique || key_comp_(value_traits::get_key(*prev), value_traits::get_key(*cur)))
+        ++n;
+    }
+    // 除最后一层外每层都是满的，把最后一层染成红色，其余为黑色，每条路径上的黑色节点数就相同
+    size_type red_depth = 0;
+    for (size_type m = n; m > 1; m >>= 1)
+      ++red_depth;
+    set_root(build_since(first, last, n, 0, red_depth, unique));
+    root()->set_parent(header_);
+    leftmost() = rb_tree_min(root());
+    rightmost() = rb_tree_max(root());
+    node_count_ = n;
+    return true;
+  }
+
+  // build_since 函数
+  // 从 first 开始按中序取 n 个节点建立子树，depth 为子树根的深度，返回子树的根，first 移到下一个未用的元素
+  template <class T, class Compare, class NodeUpdate>
+  template <class ForwardIter>
+  typename rb_tree<T, Compare, NodeUpdate>::base_ptr
+  rb_tree<T, Compare, NodeUpdate>::build_since(ForwardIter &first, ForwardIter last, size_type n,
+                                   size_type depth, size_type red_depth, bool unique)
+  {
+    if (n == 0)
+      return nullptr;
+    const size_type left_n = (n - 1) / 2;
+    base_ptr left = build_since(first, last, left_n, depth + 1, red_depth, unique);
+    base_ptr top = nullptr;
+    try
+    {
+      top = create_node(*first)->get_base_ptr();
+    }
+    catch (...)
+    {
+      erase_since(left);
+      throw;
+    }
+    top->set_color((depth == red_depth && depth != 0) ? rb_tree_red : rb_tree_black);
+    top->left = left;
+    if (left != nullptr)
+      left->set_parent(top);
+
+    auto prev = first;
+    ++first;
+    if (unique)
+    {
+      while (first != last && !key_comp_(value_traits::get_key(*prev), value_traits::get_key(*first)))
+        ++first;
+    }
+    try
+    {
+      top->right = build_since(first, last, n - 1 - left_n, depth + 1, red_depth, unique);
+    }
+    catch (...)
+    {
+      erase_since(top);
+      throw;
+    }
+    if (top->right != nullptr)
+      top->right->set_parent(top);
+    NodeUpdate::recompute(top);
+    return top;
+  }
+
+  // compact_from 函数
+  // 按中序把以 x 为根的子树复制到 block 中，n 为已使用的个数，p 为新子树的父节点
+  template <class T, class Compare, class NodeUpdate>
+  typename rb_tree<T, Compare, NodeUpdate>::base_ptr
+  rb_tree<T, Compare, NodeUpdate>::compact_from(base_ptr x, base_ptr p, node_ptr block, size_type &n)
+  {
+    base_ptr left = x->left != nullptr ? compact_from(x->left, nullptr, block, n) : nullptr;
+    node_ptr q = block + n;
+    data_allocator::construct(tinystl::address_of(q->value),
+                              std::move_if_noexcept(x->get_node_ptr()->value));
+    ++n;
+    q->set_parent_color(p, x->color());
+    NodeUpdate::copy(q->get_base_ptr(), x);
+    q->left = left;
+    if (left != nullptr)
+      left->set_parent(q);
+    q->right = nullptr;
+    if (x->right != nullptr)
+      q->right = compact_from(x->right, q, block, n);
+    return q;
+  }
+
+  // nth_dispatch 函数
+  // 维护了子树大小时，根据左子树的大小决定向左还是向右
+  template <class T, class Compare, class NodeUpdate>
+  typename rb_tree<T, Compare, NodeUpdate>::iterator
+  rb_tree<T, Compare, NodeUpdate>::nth_dispatch(size_type k, m_true_type)
+  {
+    if (k >= node_count_)
+      return end();
+    auto x = root();
+    while (true)
+    {
+      const size_type left = NodeUpdate::size(x->left);
+      if (k == left)
+        return iterator(x);
+      if (k < left)
+      {
+        x = x->left;
+      }
+      else
+      {
+        k -= left + 1;
+        x = x->right;
+      }
+    }
+  }
+
+  template <class T, class Compare, class NodeUpdate>
+  typename rb_tree<T, Compare, NodeUpdate>::iterator
+  rb_tree<T, Compare, NodeUpdate>::nth_dispatch(size_type k, m_false_type)
+  {
+    if (k >= node_count_)
+      return end();
+    iterator it = begin();
+    for (; k > 0; --k)
+      ++it;
+    return it;
+  }
+
+  // rank_dispatch 函数
+  // 沿查找 lower_bound 的路径，每向右走一步就累加左子树的大小与当前节点
+  template <class T, class Compare, class NodeUpdate>
+  typename rb_tree<T, Compare, NodeUpdate>::size_type
+  rb_tree<T, Compare, NodeUpdate>::rank_dispatch(const key_type &key, m_true_type) const
+  {
+    size_type r = 0;
+    auto x = root();
+    while (x != nullptr)
+    {
+      if (key_comp_(value_traits::get_key(x->get_node_ptr()->value), key))
+      {
+        r += NodeUpdate::size(x->left) + 1;
+        x = x->right;
+      }
+      else
+      {
+        x = x->left;
+      }
+    }
+    return r;
+  }
+
+  template <class T, class Compare, class NodeUpdate>
+  typename rb_tree<T, Compare, NodeUpdate>::size_type
+  rb_tree<T, Compare, NodeUpdate>::rank_dispatch(const key_type &key, m_false_type) const
+  {
+    return static_cast<size_type>(tinystl::distance(begin(), lower_bound(key)));
+  }
+
+  // index_of 函数
+  // 返回节点 x 的中序下标，x 为 header_ 时返回 size()
+  template <class T, class Compare, class NodeUpdate>
+  typename rb_tree<T, Compare, NodeUpdate>::size_type
+  rb_tree<T, Compare, NodeUpdate>::index_of(base_ptr x, m_true_type) const
+  {
+    if (x == header_)
+      return node_count_;
+    size_type r = NodeUpdate::size(x->left);
+    while (x != root())
+    {
+      auto p = x->parent();
+      if (x == p->right)
+        r += NodeUpdate::size(p->left) + 1;
+      x = p;
+    }
+    return r;
+  }
+
+  template <class T, class Compare, class NodeUpdate>
+  typename rb_tree<T, Compare, NodeUpdate>::size_type
+  rb_tree<T, Compare, NodeUpdate>::index_of(base_ptr x, m_false_type) const
+  {
+    return static_cast<size_type>(tinystl::distance(begin(), const_iterator(x)));
+  }
+
+  // visit_pruned_from 函数
+  // 遍历以 x 为根的子树，返回 false 表示整个遍历已经结束
+  template <class T, class Compare, class NodeUpdate>
+  template <class Skip, class Stop, class Visit>
+  bool rb_tree<T, Compare, NodeUpdate>::
+      visit_pruned_from(base_ptr x, Skip &skip, Stop &stop, Visit &visit)
+  {
+    while (x != nullptr && !skip(static_cast<node_ptr>(x)))
+    {
+      if (!visit_pruned_from(x->left, skip, stop, visit))
+        return false;
+      if (stop(static_cast<node_ptr>(x)) || !visit(iterator(x)))
+        return false;
+      x = x->right;
+    }
+    return true;
+  }
+
+  // set_operation 函数
+  // 把两棵树摘下交给 op 处理，结果留在本树，rhs 置空，返回两棵树中键值相同的元素对数
+  // 比较函数抛出异常时，op 把处理到一半的节点重新连接成两棵合法的子树，分别放回本树与 rhs，
+  // 已丢弃的节点照常销毁，两边的元素个数重新计算
+  // adopt_block 为 true 时 rhs 的节点不会进入结果，可以直接接管 rhs 的 compact 内存块，出错时再交还
+  template <class T, class Compare, class NodeUpdate>
+  typename rb_tree<T, Compare, NodeUpdate>::size_type
+  rb_tree<T, Compare, NodeUpdate>::
+      set_operation(rb_tree &rhs, size_type threads, set_op op, bool adopt_block)
+  {
+    const bool adopted = take_block(rhs, adopt_block);
+    subtree a = detach_tree();
+    subtree b = rhs.detach_tree();
+    size_type depth = 0; // 并行的层数，2^depth 个线程
+    while ((threads >> (depth + 1)) != 0)
+      ++depth;
+    set_op_context ctx = {0, nullptr};
+    try
+    {
+      (this->*op)(a, b, ctx, depth);
+    }
+    catch (...)
+    {
+      for (base_ptr x = ctx.garbage; x != nullptr; x = ctx.garbage)
+      {
+        ctx.garbage = x->parent();
+        erase_since(x);
+      }
+      attach_tree(a);
+      node_count_ = tinystl::distance(begin(), end());
+      rhs.attach_tree(b);
+      rhs.node_count_ = tinystl::distance(rhs.begin(), rhs.end());
+      if (adopted && block_ != nullptr)
+      { // 本树原来没有内存块，剩下的块中节点都已回到 rhs
+        rhs.block_ = block_;
+        rhs.block_size_ = block_size_;
+        rhs.block_live_ = block_live_;
+        block_ = nullptr;
+        block_size_ = 0;
+        block_live_ = 0;
+      }
+      throw;
+    }
+    // 所有线程结束之后再销毁被丢弃的节点，destroy_node 会修改内存块的计数
+    while (ctx.garbage != nullptr)
+    {
+      auto next = ctx.garbage->parent();
+      erase_since(ctx.garbage);
+      ctx.garbage = next;
+    }
+    attach_tree(a);
+    return ctx.matches;
+  }
+
+  // detach_tree 函数
+  // 把整棵树摘下作为独立的子树返回，本树置空
+  template <class T, class Compare, class NodeUpdate>
+  typename rb_tree<T, Compare, NodeUpdate>::subtree
+  rb_tree<T, Compare, NodeUpdate>::
+      detach_tree() noexcept
+  {
+    subtree t = {root(), rb_tree_black_height(root())};
+    if (t.root != nullptr)
+      t.root->set_parent(nullptr);
+    set_root(nullptr);
+    leftmost() = header_;
+    rightmost() = header_;
+    node_count_ = 0;
+    return t;
+  }
+
+  // attach_tree 函数
+  // 把独立的子树 t 作为整棵树挂到空的本树上，元素个数由调用者设置
+  template <class T, class Compare, class NodeUpdate>
+  void rb_tree<T, Compare, NodeUpdate>::
+      attach_tree(subtree t) noexcept
+  {
+    if (t.root == nullptr)
+      return;
+    rb_tree_set_black(t.root);
+    t.root->set_parent(header_);
+    set_root(t.root);
+    leftmost() = rb_tree_min(t.root);
+    rightmost() = rb_tree_max(t.root);
+  }
+
+  // take_block 函数
+  // rhs 的节点将归本树管理：adopt 为 true 且本树没有 compact 内存块时接管 rhs 的内存块并返回 true，
+  // 否则把 rhs 内存块中的元素逐个移动到单独分配的节点中，树的形状不变，不需要比较
+  // 分配失败时 rhs 仍然合法，部分节点已经换成单独分配的节点
+  template <class T, class Compare, class NodeUpdate>
+  bool rb_tree<T, Compare, NodeUpdate>::
+      take_block(rb_tree &rhs, bool adopt)
+  {
+    if (rhs.block_ == nullptr)
+      return false;
+    if (adopt && block_ == nullptr)
+    {
+      block_ = rhs.block_;
+      block_size_ = rhs.block_size_;
+      block_live_ = rhs.block_live_;
+      rhs.block_ = nullptr;
+      rhs.block_size_ = 0;
+      rhs.block_live_ = 0;
+      return true;
+    }
+    for (iterator it = rhs.begin(); it != rhs.end(); ++it)
+    {
+      node_ptr x = static_cast<node_ptr>(it.node);
+      if (!rhs.in_block(x))
+        continue;
+      node_ptr q = create_node(std::move_if_noexcept(x->value));
+      rhs.replace_node(x->get_base_ptr(), q->get_base_ptr());
+      it.node = q->get_base_ptr();
+      rhs.destroy_node(x);
+    }
+    return false;
+  }
+
+  // replace_node 函数
+  // 用不在树中的节点 q 替换节点 x 在树中的位置，颜色与附加信息照搬
+  template <class T, class Compare, class NodeUpdate>
+  void rb_tree<T, Compare, NodeUpdate>::
+      replace_node(base_ptr x, base_ptr q) noexcept
+  {
+    base_ptr p = x->parent();
+    q->set_parent_color(p, x->color());
+    NodeUpdate::copy(q, x);
+    q->left = x->left;
+    q->right = x->right;
+    if (q->left != nullptr)
+      q->left->set_parent(q);
+    if (q->right != nullptr)
+      q->right->set_parent(q);
+    if (p == header_)
+      set_root(q);
+    else if (p->left == x)
+      p->left = q;
+    else
+      p->right = q;
+    if (leftmost() == x)
+      leftmost() = q;
+    if (rightmost() == x)
+      rightmost() = q;
+  }
+
+  // expose 函数
+  // 断开子树 t 的根节点与两个孩子，左右子树写入 l、r
+  template <class T, class Compare, class NodeUpdate>
+  void rb_tree<T, Compare, NodeUpdate>::
+      expose(subtree t, subtree &l, subtree &r) noexcept
+  {
+    const size_type bh = rb_tree_is_red(t.root) ? t.bh : t.bh - 1;
+    l.root = t.root->left;
+    l.bh = bh;
+    r.root = t.root->right;
+    r.bh = bh;
+    if (l.root != nullptr)
+      l.root->set_parent(nullptr);
+    if (r.root != nullptr)
+      r.root->set_parent(nullptr);
+    t.root->left = nullptr;
+    t.root->right = nullptr;
+  }
+
+  // join 函数
+  // 以节点 k 连接子树 l 与 r，l 中的键值都小于 k，r 中的键值都大于 k
+  template <class T, class Compare, class NodeUpdate>
+  typename rb_tree<T, Compare, NodeUpdate>::subtree
+  rb_tree<T, Compare, NodeUpdate>::
+      join(subtree l, base_ptr k, subtree r) noexcept
+  {
+    subtree t;
+    t.root = rb_tree_join<NodeUpdate>(l.root, l.bh, k, r.root, r.bh, t.bh);
+    return t;
+  }
+
+  // join2 函数
+  // 连接子树 l 与 r，l 中的键值都小于 r 中的键值，以 l 的最大节点作为连接点
+  template <class T, class Compare, class NodeUpdate>
+  typename rb_tree<T, Compare, NodeUpdate>::subtree
+  rb_tree<T, Compare, NodeUpdate>::
+      join2(subtree l, subtree r) noexcept
+  {
+    if (l.root == nullptr)
+      return r;
+    if (r.root == nullptr)
+      return l;
+    base_ptr k = nullptr;
+    l = split_last(l, k);
+    return join(l, k, r);
+  }
+
+  // split_last 函数
+  // 摘下子树 t 的最大节点写入 last，返回剩余的部分
+  template <class T, class Compare, class NodeUpdate>
+  typename rb_tree<T, Compare, NodeUpdate>::subtree
+  rb_tree<T, Compare, NodeUpdate>::
+      split_last(subtree t, base_ptr &last) noexcept
+  {
+    subtree l, r;
+    expose(t, l, r);
+    if (r.root == nullptr)
+    {
+      last = t.root;
+      return l;
+    }
+    r = split_last(r, last);
+    return join(l, t.root, r);
+  }
+
+  // split 函数
+  // 按 key 拆分子树 t，小于 key 的部分写入 l，大于 key 的部分写入 r，
+  // 返回键值等于 key 的节点，没有则返回 nullptr
+  // 比较函数抛出异常时把已拆开的部分重新连接回 t 再抛出
+  template <class T, class Compare, class NodeUpdate>
+  typename rb_tree<T, Compare, NodeUpdate>::base_ptr
+  rb_tree<T, Compare, NodeUpdate>::
+      split(subtree &t, const key_type &key, subtree &l, subtree &r) const
+  {
+    if (t.root == nullptr)
+    {
+      l = t;
+      r = t;
+      return nullptr;
+    }
+    subtree tl, tr;
+    expose(t, tl, tr);
+    try
+    {
+      const key_type &k = value_traits::get_key(t.root->get_node_ptr()->value);
+      if (key_comp_(key, k))
+      {
+        base_ptr m = split(tl, key, l, r);
+        r = join(r, t.root, tr);
+        return m;
+      }
+      if (key_comp_(k, key))
+      {
+        base_ptr m = split(tr, key, l, r);
+        l = join(tl, t.root, l);
+        return m;
+      }
+    }
+    catch (...)
+    {
+      t = join(tl, t.root, tr);
+      throw;
+    }
+    l = tl;
+    r = tr;
+    return t.root;
+  }
+
+  // discard 函数
+  // 把子树 x 挂到待销毁的链表上
+  template <class T, class Compare, class NodeUpdate>
+  void rb_tree<T, Compare, NodeUpdate>::
+      discard(base_ptr x, set_op_context &ctx) noexcept
+  {
+    if (x == nullptr)
+      return;
+    x->set_parent(ctx.garbage);
+    ctx.garbage = x;
+  }
+
+  // rejoin 函数
+  // 子问题抛出异常后，把 a 的两部分以 a 的根重新连接，b 的两部分以 m 重新连接（m 为空时直接连接）
+  template <class T, class Compare, class NodeUpdate>
+  void rb_tree<T, Compare, NodeUpdate>::
+      rejoin(subtree &a, subtree al, subtree ar, subtree &b, subtree bl, base_ptr m, subtree br) noexcept
+  {
+    a = join(al, a.root, ar);
+    b = m != nullptr ? join(bl, m, br) : join2(bl, br);
+  }
+
+  // fork 函数
+  // 执行两个互不相干的子问题 f 与 g，depth > 0 且子树足够大时 g 在新线程上执行
+  // 并行时两个子问题的异常都先保存下来，等线程结束、g 丢弃的节点并入 ctx 之后再重新抛出
+  template <class T, class Compare, class NodeUpdate>
+  template <class F, class G>
+  void rb_tree<T, Compare, NodeUpdate>::
+      fork(set_op_context &ctx, size_type depth, size_type bh, F f, G g)
+  {
+    // 黑高为 10 的子树至少有 1023 个节点，更小的子问题不值得创建线程
+    if (depth == 0 || bh < 10)
+    {
+      f(ctx, depth);
+      g(ctx, depth);
+      return;
+    }
+    set_op_context sub = {0, nullptr};
+    std::exception_ptr f_error, g_error;
+    auto run_g = [&]()
+    {
+      try
+      {
+        g(sub, depth - 1);
+      }
+      catch (...)
+      {
+        g_error = std::current_exception();
+      }
+    };
+    std::thread worker;
+    try
+    {
+      worker = std::thread(run_g);
+    }
+    catch (const std::system_error &)
+    { // 无法创建线程时就地执行
+      run_g();
+    }
+    try
+    {
+      f(ctx, depth - 1);
+    }
+    catch (...)
+    {
+      f_error = std::current_exception();
+    }
+    if (worker.joinable())
+      worker.join();
+    ctx.matches += sub.matches;
+    if (sub.garbage != nullptr)
+    {
+      auto tail = sub.garbage;
+      while (tail->parent() != nullptr)
+        tail = tail->parent();
+      tail->set_parent(ctx.garbage);
+      ctx.garbage = sub.garbage;
+    }
+    if (f_error)
+      std::rethrow_exception(f_error);
+    if (g_error)
+      std::rethrow_exception(g_error);
+  }
+
+  // union_since 函数
+  // 用 a 的根拆分 b，两边的子树分别递归求并集，再以 a 的根连接，键值相同时保留 a 的节点
+  // 结果写入 a，b 置空；抛出异常时 a 为已处理的节点与 a 中剩下的节点，b 为 b 中剩下的节点，
+  // 左右两边的部分键值范围不相交，不需要比较就可以连接起来
+  template <class T, class Compare, class NodeUpdate>
+  void rb_tree<T, Compare, NodeUpdate>::
+      union_since(subtree &a, subtree &b, set_op_context &ctx, size_type depth)
+  {
+    if (b.root == nullptr)
+      return;
+    if (a.root == nullptr)
+    {
+      a = b;
+      b.root = nullptr;
+      return;
+    }
+    const size_type bh = tinystl::max(a.bh, b.bh);
+    subtree al, ar, bl, br;
+    expose(a, al, ar);
+    base_ptr m = nullptr;
+    try
+    {
+      m = split(b, value_traits::get_key(a.root->get_node_ptr()->value), bl, br);
+    }
+    catch (...)
+    { // split 已经恢复了 b
+      a = join(al, a.root, ar);
+      throw;
+    }
+    try
+    {
+      fork(ctx, depth, bh,
+           [&](set_op_context &c, size_type d)
+           { union_since(al, bl, c, d); },
+           [&](set_op_context &c, size_type d)
+           { union_since(ar, br, c, d); });
+    }
+    catch (...)
+    {
+      rejoin(a, al, ar, b, bl, m, br);
+      throw;
+    }
+    if (m != nullptr)
+    {
+      ++ctx.matches;
+      discard(m, ctx);
+    }
+    a = join(al, a.root, ar);
+    b.root = nullptr;
+  }
+
+  // intersection_since 函数
+  // a 的根在 b 中存在时以它连接两边的结果，否则丢弃 a 的根
+  // 结果写入 a，b 置空；抛出异常时与 union_since 相同
+  template <class T, class Compare, class NodeUpdate>
+  void rb_tree<T, Compare, NodeUpdate>::
+      intersection_since(subtree &a, subtree &b, set_op_context &ctx, size_type depth)
+  {
+    if (a.root == nullptr || b.root == nullptr)
+    {
+      discard(a.root, ctx);
+      discard(b.root, ctx);
+      a.root = nullptr;
+      b.root = nullptr;
+      return;
+    }
+    const size_type bh = tinystl::max(a.bh, b.bh);
+    subtree al, ar, bl, br;
+    expose(a, al, ar);
+    base_ptr m = nullptr;
+    try
+    {
+      m = split(b, value_traits::get_key(a.root->get_node_ptr()->value), bl, br);
+    }
+    catch (...)
+    { // split 已经恢复了 b
+      a = join(al, a.root, ar);
+      throw;
+    }
+    try
+    {
+      fork(ctx, depth, bh,
+           [&](set_op_context &c, size_type d)
+           { intersection_since(al, bl, c, d); },
+           [&](set_op_context &c, size_type d)
+           { intersection_since(ar, br, c, d); });
+    }
+    catch (...)
+    {
+      rejoin(a, al, ar, b, bl, m, br);
+      throw;
+    }
+    b.root = nullptr;
+    if (m != nullptr)
+    {
+      ++ctx.matches;
+      discard(m, ctx);
+      a = join(al, a.root, ar);
+      return;
+    }
+    discard(a.root, ctx);
+    a = join2(al, ar);
+  }
+
+  // difference_since 函数
+  // a 的根在 b 中存在时丢弃它，否则以它连接两边的结果
+  // 结果写入 a，b 置空；抛出异常时与 union_since 相同
+  template <class T, class Compare, class NodeUpdate>
+  void rb_tree<T, Compare, NodeUpdate>::
+      difference_since(subtree &a, subtree &b, set_op_context &ctx, size_type depth)
+  {
+    if (a.root == nullptr || b.root == nullptr)
+    {
+      discard(b.root, ctx);
+      b.root = nullptr;
+      return;
+    }
+    const size_type bh = tinystl::max(a.bh, b.bh);
+    subtree al, ar, bl, br;
+    expose(a, al, ar);
+    base_ptr m = nullptr;
+    try
+    {
+      m = split(b, value_traits::get_key(a.root->get_node_ptr()->value), bl, br);
+    }
+    catch (...)
+    { // split 已经恢复了 b
+      a = join(al, a.root, ar);
+      throw;
+    }
+    try
+    {
+      fork(ctx, depth, bh,
+           [&](set_op_context &c, size_type d)
+           { difference_since(al, bl, c, d); },
+           [&](set_op_context &c, size_type d)
+           { difference_since(ar, br, c, d); });
+    }
+    catch (...)
+    {
+      rejoin(a, al, ar, b, bl, m, br);
+      throw;
+    }
+    b.root = nullptr;
+    if (m != nullptr)
+    {
+      ++ctx.matches;
+      discard(m, ctx);
+      discard(a.root, ctx);
+      a = join2(al, ar);
+      return;
+    }
+    a = join(al, a.root, ar);
+  }
+
   // 重载比较操作符
-  template <class T, class Compare>
-  bool operator==(const rb_tree<T, Compare> &lhs, const rb_tree<T, Compare> &rhs)
+  template <class T, class Compare, class NodeUpdate>
+  bool operator==(const rb_tree<T, Compare, NodeUpdate> &lhs, const rb_tree<T, Compare, NodeUpdate> &rhs)
   {
     return lhs.size() == rhs.size() && tinystl::equal(lhs.begin(), lhs.end(), rhs.begin());
   }
 
-  template <class T, class Compare>
-  bool operator<(const rb_tree<T, Compare> &lhs, const rb_tree<T, Compare> &rhs)
+  template <class T, class Compare, class NodeUpdate>
+  bool operator<(const rb_tree<T, Compare, NodeUpdate> &lhs, const rb_tree<T, Compare, NodeUpdate> &rhs)
   {
     return tinystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
   }
 
-  template <class T, class Compare>
-  bool operator!=(const rb_tree<T, Compare> &lhs, const rb_tree<T, Compare> &rhs)
+  template <class T, class Compare, class NodeUpdate>
+  bool operator!=(const rb_tree<T, Compare, NodeUpdate> &lhs, const rb_tree<T, Compare, NodeUpdate> &rhs)
   {
     return !(lhs == rhs);
   }
 
-  template <class T, class Compare>
-  bool operator>(const rb_tree<T, Compare> &lhs, const rb_tree<T, Compare> &rhs)
+  template <class T, class Compare, class NodeUpdate>
+  bool operator>(const rb_tree<T, Compare, NodeUpdate> &lhs, const rb_tree<T, Compare, NodeUpdate> &rhs)
   {
     return rhs < lhs;
   }
 
-  template <class T, class Compare>
-  bool operator<=(const rb_tree<T, Compare> &lhs, const rb_tree<T, Compare> &rhs)
+  template <class T, class Compare, class NodeUpdate>
+  bool operator<=(const rb_tree<T, Compare, NodeUpdate> &lhs, const rb_tree<T, Compare, NodeUpdate> &rhs)
   {
     return !(rhs < lhs);
   }
 
-  template <class T, class Compare>
-  bool operator>=(const rb_tree<T, Compare> &lhs, const rb_tree<T, Compare> &rhs)
+  template <class T, class Compare, class NodeUpdate>
+  bool operator>=(const rb_tree<T, Compare, NodeUpdate> &lhs, const rb_tree<T, Compare, NodeUpdate> &rhs)
   {
     return !(lhs < rhs);
   }
 
   // 重载 tinystl 的 swap
-  template <class T, class Compare>
-  void swap(rb_tree<T, Compare> &lhs, rb_tree<T, Compare> &rhs) noexcept
+  template <class T, class Compare, class NodeUpdate>
+  void swap(rb_tree<T, Compare, NodeUpdate> &lhs, rb_tree<T, Compare, NodeUpdate> &rhs) noexcept
   {
     lhs.swap(rhs);
   }
@@ -0,0 +1,278 @@
+#ifndef TINYSTL_RCU_MAP_H_
+#define TINYSTL_RCU_MAP_H_
+
+// 这个头文件包含读-复制-更新（read-copy-update）的容器包装 rcu_container，以及
+// rcu_map           : 以 map 为版本的 rcu_container，附带按键值读写的接口
+// rcu_unordered_map : 以 unordered_map 为版本的 rcu_container，附带按键值读写的接口
+
+// notes:
+//
+// 1. 容器的每个版本都是不可变的，读者只需进入 epoch 临界区并读取一次当前版本的指针，
+//    不加锁、不重试，也不写任何共享的缓存行，是 wait-free 的
+// 2. 写者之间用一把互斥锁串行化：复制当前版本，在副本上修改，再用一次原子交换发布新版本
+//    旧版本交给 epoch_domain，等到所有可能读到它的读者离开之后才销毁，见 epoch.h
+// 3. 每次写入都复制整个容器，复杂度为 O(n)，适合读远多于写的场景，例如配置表与路由表
+//    多个修改应放在同一次 update 中完成
+// 4. read() 返回的 read_guard 持有临界区，在它析构之前看到的始终是同一个版本，只能在创建它的线程上使用
+//    长时间持有 read_guard 会推迟所有旧版本的回收
+
+#include <atomic>
+#include <mutex>
+#include <utility>
+
+#include "allocator.h"
+#include "utils.h"
+#include "map.h"
+#include "unordered_map.h"
+#include "epoch.h"
+
+namespace tinystl
+{
+
+  // 读者持有的版本，构造时进入临界区，析构时离开，可以移动不能复制
+  template <class Container>
+  class rcu_read_guard
+  {
+  private:
+    const Container *ptr_;
+
+  public:
+    explicit rcu_read_guard(const std::atomic<const Container *> &current)
+        : ptr_(nullptr)
+    {
+      epoch_domain::instance().enter();
+      ptr_ = current.load(std::memory_order_acquire);
+    }
+
+    rcu_read_guard(rcu_read_guard &&rhs) noexcept
+        : ptr_(rhs.ptr_)
+    {
+      rhs.ptr_ = nullptr;
+    }
+
+    rcu_read_guard(const rcu_read_guard &) = delete;
+    rcu_read_guard &operator=(const rcu_read_guard &) = delete;
+
+    ~rcu_read_guard()
+    {
+      if (ptr_ != nullptr)
+        epoch_domain::instance().leave();
+    }
+
+    const Container &operator*() const noexcept { return *ptr_; }
+    const Container *operator->() const noexcept { return ptr_; }
+    const Container *get() const noexcept { return ptr_; }
+  };
+
+  // 模板类 rcu_container
+  // 模板参数代表每个版本的容器类型，要求可以复制
+  template <class Container>
+  class rcu_container
+  {
+  public:
+    typedef Container container_type;
+    typedef rcu_read_guard<Container> read_guard;
+    typedef tinystl::allocator<Container> container_allocator;
+
+  private:
+    std::atomic<const Container *> current_;
+    std::mutex write_lock_;
+
+  public:
+    // 构造、析构函数
+    rcu_container() : current_(nullptr) { current_.store(create(), std::memory_order_relaxed); }
+    explicit rcu_container(const Container &c) : current_(nullptr)
+    {
+      current_.store(create(c), std::memory_order_relaxed);
+    }
+    explicit rcu_container(Container &&c) : current_(nullptr)
+    {
+      current_.store(create(tinystl::move(c)), std::memory_order_relaxed);
+    }
+
+    rcu_container(const rcu_container &) = delete;
+    rcu_container &operator=(const rcu_container &) = delete;
+
+    // 析构时不应再有读者，当前版本直接销毁，已退休的旧版本仍由 epoch_domain 负责
+    ~rcu_container() { destroy(const_cast<Container *>(current_.load(std::memory_order_relaxed))); }
+
+  public:
+    // 读者操作
+
+    // 取得当前版本
+    read_guard read() const { return read_guard(current_); }
+
+    // 在临界区内对当前版本调用 f，返回 f 的结果，结果中不应包含指向容器内部的指针或引用
+    template <class Function>
+    auto read(Function f) const -> decltype(f(std::declval<const Container &>()))
+    {
+      read_guard g(current_);
+      return f(*g);
+    }
+
+    // 写者操作
+
+    // 复制当前版本，调用 f 修改副本，然后发布；f 抛出异常时当前版本不变
+    template <class Function>
+    void update(Function f)
+    {
+      std::lock_guard<std::mutex> lk(write_lock_);
+      Container *next = create(*current_.load(std::memory_order_relaxed));
+      try
+      {
+        f(*next);
+      }
+      catch (...)
+      {
+        destroy(next);
+        throw;
+      }
+      publish(next);
+    }
+
+    // 用 c 整体替换当前版本
+    void store(const Container &c)
+    {
+      Container *next = create(c);
+      std::lock_guard<std::mutex> lk(write_lock_);
+      publish(next);
+    }
+    void store(Container &&c)
+    {
+      Container *next = create(tinystl::move(c));
+      std::lock_guard<std::mutex> lk(write_lock_);
+      publish(next);
+    }
+
+    // 等待当前所有读者离开，并销毁本线程退休的旧版本，不能在读者临界区内调用
+    void synchronize() { epoch_domain::instance().synchronize(); }
+
+  private:
+    // helper functions
+    template <class... Args>
+    static Container *create(Args &&...args)
+    {
+      Container *p = container_allocator::allocate();
+      try
+      {
+        container_allocator::construct(p, tinystl::forward<Args>(args)...);
+      }
+      catch (...)
+      {
+        container_allocator::deallocate(p);
+        throw;
+      }
+      return p;
+    }
+
+    static void destroy(void *p)
+    {
+      Container *c = static_cast<Container *>(p);
+      container_allocator::destroy(c);
+      container_allocator::deallocate(c);
+    }
+
+    // 发布新版本，旧版本退休，顺便回收已经安全的旧版本
+    void publish(Container *next)
+    {
+      const Container *old = current_.exchange(next, std::memory_order_acq_rel);
+      epoch_domain &domain = epoch_domain::instance();
+      domain.retire(const_cast<Container *>(old), &destroy);
+      domain.collect();
+    }
+  };
+
+  // rcu_map 与 rcu_unordered_map 的公共部分，提供按键值读写的接口
+  template <class Map>
+  class rcu_map_base : public rcu_container<Map>
+  {
+    typedef rcu_container<Map> base_type;
+
+  public:
+    typedef typename Map::key_type key_type;
+    typedef typename Map::mapped_type mapped_type;
+    typedef typename Map::size_type size_type;
+
+  public:
+    rcu_map_base() = default;
+    explicit rcu_map_base(const Map &m) : base_type(m) {}
+    explicit rcu_map_base(Map &&m) : base_type(tinystl::move(m)) {}
+
+    // 读者操作，均为 wait-free
+
+    // 键值存在时把实值复制到 value 中
+    bool get(const key_type &key, mapped_type &value) const
+    {
+      typename base_type::read_guard g = this->read();
+      auto it = g->find(key);
+      if (it == g->end())
+        return false;
+      value = it->second;
+      return true;
+    }
+
+    bool contains(const key_type &key) const
+    {
+      typename base_type::read_guard g = this->read();
+      return g->find(key) != g->end();
+    }
+
+    size_type size() const
+    {
+      typename base_type::read_guard g = this->read();
+      return g->size();
+    }
+    bool empty() const { return size() == 0; }
+
+    // 写者操作，每次都会复制整个容器，多个修改应使用 update
+
+    void insert_or_assign(const key_type &key, const mapped_type &value)
+    {
+      this->update([&key, &value](Map &m)
+                   { m[key] = value; });
+    }
+
+    size_type erase(const key_type &key)
+    {
+      size_type n = 0;
+      this->update([&key, &n](Map &m)
+                   { n = m.erase(key); });
+      return n;
+    }
+
+    void clear() { this->store(Map()); }
+  };
+
+  // 模板类 rcu_map
+  // 参数一代表键值类型，参数二代表实值类型，参数三代表键值的比较方式，缺省使用 tinystl::less
+  template <class Key, class T, class Compare = tinystl::less<Key>>
+  class rcu_map : public rcu_map_base<tinystl::map<Key, T, Compare>>
+  {
+    typedef rcu_map_base<tinystl::map<Key, T, Compare>> base_type;
+
+  public:
+    typedef tinystl::map<Key, T, Compare> map_type;
+
+    rcu_map() = default;
+    explicit rcu_map(const map_type &m) : base_type(m) {}
+    explicit rcu_map(map_type &&m) : base_type(tinystl::move(m)) {}
+  };
+
+  // 模板类 rcu_unordered_map
+  // 参数一代表键值类型，参数二代表实值类型，参数三代表哈希函数，参数四代表键值比较方式
+  template <class Key, class T, class Hash = tinystl::hash<Key>, class KeyEqual = tinystl::equal_to<Key>>
+  class rcu_unordered_map : public rcu_map_base<tinystl::unordered_map<Key, T, Hash, KeyEqual>>
+  {
+    typedef rcu_map_base<tinystl::unordered_map<Key, T, Hash, KeyEqual>> base_type;
+
+  public:
+    typedef tinystl::unordered_map<Key, T, Hash, KeyEqual> map_type;
+
+    rcu_unordered_map() = default;
+    explicit rcu_unordered_map(const map_type &m) : base_type(m) {}
+    explicit rcu_unordered_map(map_type &&m) : base_type(tinystl::move(m)) {}
+  };
+
+} // namespace tinystl
+
+#endif // !TINYSTL_RCU_MAP_H_
@@ -0,0 +1,873 @@
+#ifndef TINYSTL_ROBIN_HOOD_HASHTABLE_H_
+#define TINYSTL_ROBIN_HOOD_HASHTABLE_H_
+
+// 这个头文件包含一个模板类 robin_hood_hashtable
+// robin_hood_hashtable : 线性探查的 Robin Hood 哈希表，作为 robin_hood_map / robin_hood_set 的底层机制
+
+// notes:
+//
+// 1. 元素直接存放在槽数组中，另有一个与槽一一对应的字节数组，记录元素的探查距离加一，0 表示空槽
+// 2. 插入时，遇到探查距离比新元素短的（离家更近的）元素就把位置让给新元素，原有元素连同其后的一段整体后移一格，
+//    这样同一段中的元素按起始位置排列，所有元素的探查距离都比较平均，负载因子可以达到 0.9 以上
+// 3. 查找时一旦遇到空槽或探查距离比当前距离短的元素，就可以确定键值不存在，未命中的查找也很短
+// 4. 删除时把其后不在起始位置的元素整体前移一格（backward shift），不需要墓碑
+// 5. 起始位置由哈希值乘以黄金分割常数后的高位决定；槽数组末尾有一段溢出区，探查不回绕，
+//    元素越过槽数组末尾时加倍溢出区，超过最大负载因子时加倍容量
+// 6. 探查距离加一超过 254 时字节中记为 255（饱和），此时的真实距离由键值重新计算起始位置得到，
+//    只有大量键值的哈希值相同时才会出现，这时表退化为线性探查，但仍然正确；
+//    255 只保证真实值不小于 254，删除前先把将要前移的、真实值恰为 254 的饱和元素改记为 254，
+//    这样前移本身只改字节，不调用哈希函数
+// 7. 插入会移动其他元素，使所有迭代器与元素的引用失效；
+//    删除只移动被删元素之后的元素，erase 返回指向下一个元素的迭代器，可以边遍历边删除
+// 8. 元素以移动构造 + 析构的方式搬动，要求元素的移动构造不抛出异常
+// 9. 查找时在读探查距离的同时预取起始位置的槽
+
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+
+#include "functional.h"
+#include "hashtable.h"
+#include "memory.h"
+#include "utils.h"
+#include "exceptdef.h"
+
+namespace tinystl
+{
+  // 最小容量
+  static constexpr size_t rh_min_capacity = 16;
+
+  // 溢出区的缺省长度上限
+  static constexpr size_t rh_max_distance = 254;
+
+  // 探查距离加一存放在一个字节中，不小于这个值时为饱和，真实距离需要重新计算
+  static constexpr size_t rh_saturated_info = 255;
+
+  // 空表共用的哨兵，不会被写入
+  inline uint8_t *rh_empty_info() noexcept
+  {
+    static uint8_t sentinel = 1;
+    return &sentinel;
+  }
+
+  inline void rh_prefetch(const void *p) noexcept
+  {
+#if defined(__GNUC__)
+    __builtin_prefetch(p);
+#else
+    (void)p;
+#endif
+  }
+
+  // robin_hood_hashtable 的迭代器，由探查距离和槽两个指针组成，end() 指向末尾的哨兵
+  template <class T, class Ref, class Ptr>
+  struct rh_iterator : public iterator<forward_iterator_tag, T>
+  {
+    typedef rh_iterator<T, T &, T *> iterator;
+    typedef rh_iterator<T, const T &, const T *> const_iterator;
+    typedef rh_iterator self;
+
+    typedef T value_type;
+    typedef Ptr pointer;
+    typedef Ref reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    const uint8_t *info_;
+    T *slot_;
+
+    rh_iterator() noexcept : info_(nullptr), slot_(nullptr) {}
+    rh_iterator(const uint8_t *i, T *s) noexcept : info_(i), slot_(s) {}
+    rh_iterator(const iterator &rhs) noexcept
+        : info_(rhs.info_), slot_(rhs.slot_) {}
+    self &operator=(const iterator &rhs) noexcept
+    {
+      info_ = rhs.info_;
+      slot_ = rhs.slot_;
+      return *this;
+    }
+
+    reference operator*() const { return *slot_; }
+    pointer operator->() const { return slot_; }
+
+    self &operator++()
+    {
+      ++info_;
+      ++slot_;
+      skip_empty();
+      return *this;
+    }
+    self operator++(int)
+    {
+      self tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    // 跳过空槽，停在下一个元素或哨兵上
+    void skip_empty()
+    {
+      while (*info_ == 0)
+      {
+        ++info_;
+        ++slot_;
+      }
+    }
+
+    bool operator==(const self &rhs) const { return info_ == rhs.info_; }
+    bool operator!=(const self &rhs) const { return info_ != rhs.info_; }
+  };
+
+  // 模板类 robin_hood_hashtable，键值不允许重复
+  // 参数一代表数据类型，参数二代表哈希函数，参数三代表键值相等的比较函数
+  template <class T, class Hash, class KeyEqual>
+  class robin_hood_hashtable
+  {
+  public:
+    // robin_hood_hashtable 的型别定义
+    typedef ht_value_traits<T> value_traits;
+    typedef typename value_traits::key_type key_type;
+    typedef typename value_traits::mapped_type mapped_type;
+    typedef typename value_traits::value_type value_type;
+    typedef Hash hasher;
+    typedef KeyEqual key_equal;
+
+    typedef tinystl::allocator<T> allocator_type;
+    typedef tinystl::allocator<T> data_allocator;
+    typedef tinystl::allocator<uint8_t> info_allocator;
+
+    typedef typename allocator_type::pointer pointer;
+    typedef typename allocator_type::const_pointer const_pointer;
+    typedef typename allocator_type::reference reference;
+    typedef typename allocator_type::const_reference const_reference;
+    typedef typename allocator_type::size_type size_type;
+    typedef typename allocator_type::difference_type difference_type;
+
+    typedef rh_iterator<T, T &, T *> iterator;
+    typedef rh_iterator<T, const T &, const T *> const_iterator;
+
+    allocator_type get_allocator() const { return allocator_type(); }
+
+  private:
+    // 用以下九个数据表现 robin_hood_hashtable
+    uint8_t *info_;      // 探查距离加一（饱和于 255），共 capacity_ + overflow_ + 1 个，最后一个为哨兵
+    pointer slots_;      // 槽数组，共 capacity_ + overflow_ 个
+    size_type capacity_; // 起始位置的个数，为 0 或 2 的幂
+    size_type overflow_; // 溢出区的长度
+    size_type shift_;    // 计算起始位置时哈希值右移的位数
+    size_type size_;     // 元素个数
+    float mlf_;          // 最大负载因子
+    hasher hash_;
+    key_equal equal_;
+
+  public:
+    // 构造、复制、移动、析构函数
+    explicit robin_hood_hashtable(size_type count = 0,
+                                  const Hash &hash = Hash(),
+                                  const KeyEqual &equal = KeyEqual())
+        : info_(rh_empty_info()), slots_(nullptr), capacity_(0), overflow_(0), shift_(0), size_(0),
+          mlf_(0.9f), hash_(hash), equal_(equal)
+    {
+      if (count != 0)
+        resize(capacity_for(count));
+    }
+
+    robin_hood_hashtable(const robin_hood_hashtable &rhs);
+    robin_hood_hashtable(robin_hood_hashtable &&rhs) noexcept
+        : info_(rhs.info_), slots_(rhs.slots_), capacity_(rhs.capacity_), overflow_(rhs.overflow_),
+          shift_(rhs.shift_), size_(rhs.size_), mlf_(rhs.mlf_), hash_(rhs.hash_), equal_(rhs.equal_)
+    {
+      rhs.reset();
+    }
+
+    robin_hood_hashtable &operator=(const robin_hood_hashtable &rhs)
+    {
+      if (this != &rhs)
+      {
+        robin_hood_hashtable tmp(rhs);
+        swap(tmp);
+      }
+      return *this;
+    }
+    robin_hood_hashtable &operator=(robin_hood_hashtable &&rhs) noexcept
+    {
+      if (this != &rhs)
+      {
+        release();
+        swap(rhs);
+      }
+      return *this;
+    }
+
+    ~robin_hood_hashtable() { release(); }
+
+    // 迭代器相关操作
+    iterator begin() noexcept
+    {
+      iterator it(info_, slots_);
+      it.skip_empty();
+      return it;
+    }
+    const_iterator begin() const noexcept
+    {
+      const_iterator it(info_, slots_);
+      it.skip_empty();
+      return it;
+    }
+    iterator end() noexcept { return iterator(info_ + total(), slots_ + total()); }
+    const_iterator end() const noexcept { return const_iterator(info_ + total(), slots_ + total()); }
+
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    // 容量相关操作
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type max_size() const noexcept { return static_cast<size_type>(-1) / (sizeof(T) + 1) / 2; }
+
+    // 修改容器相关操作
+
+    template <class... Args>
+    pair<iterator, bool> emplace_unique(Args &&...args);
+
+    // 键值不存在时才用 args 构造实值，只用于映射
+    template <class K, class... Args>
+    pair<iterator, bool> try_emplace(K &&key, Args &&...args);
+
+    pair<iterator, bool> insert_unique(const value_type &value);
+    pair<iterator, bool> insert_unique(value_type &&value)
+    {
+      return emplace_unique(tinystl::move(value));
+    }
+
+    template <class InputIter>
+    void insert_unique(InputIter first, InputIter last)
+    {
+      for (; first != last; ++first)
+        insert_unique(*first);
+    }
+
+    // erase / clear
+
+    // 删除后其后的元素前移，返回指向下一个元素的迭代器
+    iterator erase(const_iterator position)
+    {
+      TINYSTL_DEBUG(position != cend());
+      const size_type i = static_cast<size_type>(position.info_ - info_);
+      erase_at(i);
+      return iterator_at(i);
+    }
+    iterator erase(const_iterator first, const_iterator last);
+
+    template <class K>
+    size_type erase_unique(const K &key)
+    {
+      const size_type i = find_index(key);
+      if (i == total())
+        return 0;
+      erase_at(i);
+      return 1;
+    }
+
+    void clear();
+
+    // 把 source 中键值不重复的元素移到本容器中
+    void merge_unique(robin_hood_hashtable &source);
+
+    void swap(robin_hood_hashtable &rhs) noexcept;
+
+    // 查找相关操作，参数类型 K 通常为 key_type，由容器在哈希函数与比较函数带有 is_transparent 时放开
+
+    template <class K>
+    iterator find(const K &key)
+    {
+      const size_type i = find_index(key);
+      return iterator(info_ + i, slots_ + i);
+    }
+    template <class K>
+    const_iterator find(const K &key) const
+    {
+      const size_type i = find_index(key);
+      return const_iterator(info_ + i, slots_ + i);
+    }
+
+    template <class K>
+    size_type count(const K &key) const
+    {
+      return find_index(key) == total() ? 0 : 1;
+    }
+
+    template <class K>
+    pair<iterator, iterator> equal_range(const K &key)
+    {
+      iterator it = find(key);
+      iterator last = it;
+      if (it != end())
+        ++last;
+      return tinystl::make_pair(it, last);
+    }
+    template <class K>
+    pair<const_iterator, const_iterator> equal_range(const K &key) const
+    {
+      const_iterator it = find(key);
+      const_iterator last = it;
+      if (it != end())
+        ++last;
+      return tinystl::make_pair(it, last);
+    }
+
+    // 容量与负载因子，起始位置的个数视为 bucket 数
+    size_type bucket_count() const noexcept { return capacity_; }
+    size_type max_bucket_count() const noexcept { return max_size(); }
+
+    float load_factor() const noexcept
+    {
+      return capacity_ != 0 ? static_cast<float>(size_) / capacity_ : 0.0f;
+    }
+    float max_load_factor() const noexcept { return mlf_; }
+    void max_load_factor(float ml)
+    {
+      THROW_OUT_OF_RANGE_IF(ml != ml || ml <= 0 || ml >= 1, "invalid hash load factor");
+      mlf_ = ml;
+      if (size_ > max_elements())
+        resize(capacity_for(size_));
+    }
+
+    void rehash(size_type count);
+    void reserve(size_type count)
+    {
+      const size_type cap = capacity_for(count);
+      if (cap > capacity_)
+        resize(cap);
+    }
+
+    hasher hash_fcn() const { return hash_; }
+    key_equal key_eq() const { return equal_; }
+
+  private:
+    // helper functions
+
+    size_type total() const noexcept { return capacity_ + overflow_; }
+
+    // 从槽 i 起的第一个元素
+    iterator iterator_at(size_type i) noexcept
+    {
+      iterator it(info_ + i, slots_ + i);
+      it.skip_empty();
+      return it;
+    }
+
+    // 槽 i 中元素的探查距离加一，饱和时重新计算
+    size_type info_at(size_type i) const
+    {
+      const size_type info = info_[i];
+      if (info != rh_saturated_info)
+        return info;
+      return i - home_of(value_traits::get_key(slots_[i])) + 1;
+    }
+    static uint8_t saturate(size_type info) noexcept
+    {
+      return static_cast<uint8_t>(info < rh_saturated_info ? info : rh_saturated_info);
+    }
+
+    static size_type overflow_for(size_type cap) noexcept
+    {
+      return cap < rh_max_distance ? cap : rh_max_distance;
+    }
+
+    size_type max_elements() const noexcept { return static_cast<size_type>(capacity_ * mlf_); }
+
+    // 哈希值乘以黄金分割常数，取高位作为起始位置
+    template <class K>
+    size_type home_of(const K &key) const
+    {
+      const uint64_t x = static_cast<uint64_t>(hash_(key)) * 0x9E3779B97F4A7C15ull;
+      return static_cast<size_type>(x >> shift_);
+    }
+
+    // 容纳 n 个元素所需的最小容量
+    size_type capacity_for(size_type n) const
+    {
+      THROW_LENGTH_ERROR_IF(n > max_size() / 2, "robin_hood_hashtable<T>'s size too big");
+      size_type cap = rh_min_capacity;
+      while (static_cast<size_type>(cap * mlf_) < n)
+        cap <<= 1;
+      return cap;
+    }
+
+    template <class K>
+    size_type find_index(const K &key) const;
+    template <class K>
+    pair<size_type, bool> find_or_prepare_insert(const K &key);
+    bool make_room(size_type i);
+    bool insert_moved(value_type &value);
+
+    template <class... Args>
+    void construct_at(size_type i, Args &&...args);
+    void erase_at(size_type i);
+    void shift_down(size_type i) noexcept;
+
+    void grow();
+    void grow_overflow();
+    void resize(size_type new_cap) { resize(new_cap, overflow_for(new_cap)); }
+    void resize(size_type new_cap, size_type new_overflow);
+    void destroy_all() noexcept;
+    void release() noexcept;
+    void reset() noexcept;
+  };
+
+  /*****************************************************************************************/
+
+  // 复制构造函数，两个表的布局完全相同，逐槽复制，不需要重新计算哈希值
+  template <class T, class Hash, class KeyEqual>
+  robin_hood_hashtable<T, Hash, KeyEqual>::
+      robin_hood_hashtable(const robin_hood_hashtable &rhs)
+      : info_(rh_empty_info()), slots_(nullptr), capacity_(0), overflow_(0), shift_(0), size_(0),
+        mlf_(rhs.mlf_), hash_(rhs.hash_), equal_(rhs.equal_)
+  {
+    if (rhs.size_ == 0)
+      return;
+    resize(rhs.capacity_, rhs.overflow_);
+    size_type i = 0;
+    try
+    {
+      for (; i < total(); ++i)
+      {
+        if (rhs.info_[i] != 0)
+          data_allocator::construct(slots_ + i, rhs.slots_[i]);
+      }
+    }
+    catch (...)
+    {
+      while (i-- > 0)
+      {
+        if (rhs.info_[i] != 0)
+          data_allocator::destroy(slots_ + i);
+      }
+      release();
+      throw;
+    }
+    std::memcpy(info_, rhs.info_, total());
+    size_ = rhs.size_;
+  }
+
+  // 就地构造元素，键值不允许重复
+  template <class T, class Hash, class KeyEqual>
+  template <class... Args>
+  pair<typename robin_hood_hashtable<T, Hash, KeyEqual>::iterator, bool>
+  robin_hood_hashtable<T, Hash, KeyEqual>::
+      emplace_unique(Args &&...args)
+  {
+    value_type tmp(tinystl::forward<Args>(args)...);
+    const pair<size_type, bool> r = find_or_prepare_insert(value_traits::get_key(tmp));
+    if (r.second)
+      construct_at(r.first, tinystl::move(tmp));
+    return tinystl::make_pair(iterator(info_ + r.first, slots_ + r.first), r.second);
+  }
+
+  // 键值不存在时构造 (key, mapped_type(args...))，键值已存在时不构造任何对象
+  template <class T, class Hash, class KeyEqual>
+  template <class K, class... Args>
+  pair<typename robin_hood_hashtable<T, Hash, KeyEqual>::iterator, bool>
+  robin_hood_hashtable<T, Hash, KeyEqual>::
+      try_emplace(K &&key, Args &&...args)
+  {
+    const pair<size_type, bool> r = find_or_prepare_insert(key);
+    if (r.second)
+      construct_at(r.first, tinystl::forward<K>(key), mapped_type(tinystl::forward<Args>(args)...));
+    return tinystl::make_pair(iterator(info_ + r.first, slots_ + r.first), r.second);
+  }
+
+  // 插入元素，键值已存在时不复制元素
+  template <class T, class Hash, class KeyEqual>
+  pair<typename robin_hood_hashtable<T, Hash, KeyEqual>::iterator, bool>
+  robin_hood_hashtable<T, Hash, KeyEqual>::
+      insert_unique(const value_type &value)
+  {
+    const pair<size_type, bool> r = find_or_prepare_insert(value_traits::get_key(value));
+    if (r.second)
+      construct_at(r.first, value);
+    return tinystl::make_pair(iterator(info_ + r.first, slots_ + r.first), r.second);
+  }
+
+  // 删除 [first, last) 内的元素，返回指向 last 所指元素的迭代器
+  // 每次删除后其后的元素前移，但相对顺序不变，所以区间内剩下的元素总是从 first 起的下一个元素
+  template <class T, class Hash, class KeyEqual>
+  typename robin_hood_hashtable<T, Hash, KeyEqual>::iterator
+  robin_hood_hashtable<T, Hash, KeyEqual>::
+      erase(const_iterator first, const_iterator last)
+  {
+    size_type n = 0;
+    for (const_iterator it = first; it != last; ++it)
+      ++n;
+    size_type i = static_cast<size_type>(first.info_ - info_);
+    for (; n > 0; --n)
+    {
+      while (info_[i] == 0)
+        ++i;
+      erase_at(i);
+    }
+    return iterator_at(i);
+  }
+
+  // 清空元素，保留容量
+  template <class T, class Hash, class KeyEqual>
+  void robin_hood_hashtable<T, Hash, KeyEqual>::
+      clear()
+  {
+    if (capacity_ == 0)
+      return;
+    destroy_all();
+    std::memset(info_, 0, total());
+    size_ = 0;
+  }
+
+  // 逐个移动 source 中的元素，source 删除元素时其后的元素会前移，所以先检查当前位置再前进
+  template <class T, class Hash, class KeyEqual>
+  void robin_hood_hashtable<T, Hash, KeyEqual>::
+      merge_unique(robin_hood_hashtable &source)
+  {
+    if (&source == this)
+      return;
+    size_type j = 0;
+    while (j < source.total())
+    {
+      if (source.info_[j] == 0)
+      {
+        ++j;
+        continue;
+      }
+      const pair<size_type, bool> r = find_or_prepare_insert(value_traits::get_key(source.slots_[j]));
+      if (r.second)
+      {
+        construct_at(r.first, tinystl::move(source.slots_[j]));
+        source.erase_at(j);
+      }
+      else
+      {
+        ++j;
+      }
+    }
+  }
+
+  template <class T, class Hash, class KeyEqual>
+  void robin_hood_hashtable<T, Hash, KeyEqual>::
+      swap(robin_hood_hashtable &rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      tinystl::swap(info_, rhs.info_);
+      tinystl::swap(slots_, rhs.slots_);
+      tinystl::swap(capacity_, rhs.capacity_);
+      tinystl::swap(overflow_, rhs.overflow_);
+      tinystl::swap(shift_, rhs.shift_);
+      tinystl::swap(size_, rhs.size_);
+      tinystl::swap(mlf_, rhs.mlf_);
+      tinystl::swap(hash_, rhs.hash_);
+      tinystl::swap(equal_, rhs.equal_);
+    }
+  }
+
+  // 重建为至少 count 个起始位置且能容纳当前元素的容量，count 与元素个数都为 0 时释放空间
+  template <class T, class Hash, class KeyEqual>
+  void robin_hood_hashtable<T, Hash, KeyEqual>::
+      rehash(size_type count)
+  {
+    if (count == 0 && size_ == 0)
+    {
+      release();
+      return;
+    }
+    size_type cap = capacity_for(size_);
+    while (cap < count)
+      cap <<= 1;
+    if (cap != capacity_)
+      resize(cap);
+  }
+
+  /*****************************************************************************************/
+  // helper function
+
+  // 查找键值为 key 的元素所在的槽，没有时返回 total()
+  // 遇到空槽或探查距离比当前距离短的元素时，键值不可能在更后面
+  template <class T, class Hash, class KeyEqual>
+  template <class K>
+  typename robin_hood_hashtable<T, Hash, KeyEqual>::size_type
+  robin_hood_hashtable<T, Hash, KeyEqual>::
+      find_index(const K &key) const
+  {
+    if (size_ == 0)
+      return total();
+    size_type i = home_of(key);
+    rh_prefetch(slots_ + i);
+    for (size_type info = 1;; ++i, ++info)
+    {
+      const size_type cur = info_at(i);
+      if (cur < info)
+        break;
+      if (cur == info && equal_(value_traits::get_key(slots_[i]), key))
+        return i;
+    }
+    return total();
+  }
+
+  // 键值存在时返回 (所在的槽, false)，否则占用一个槽并返回 (槽, true)，调用者负责在槽中构造元素
+  template <class T, class Hash, class KeyEqual>
+  template <class K>
+  pair<typename robin_hood_hashtable<T, Hash, KeyEqual>::size_type, bool>
+  robin_hood_hashtable<T, Hash, KeyEqual>::
+      find_or_prepare_insert(const K &key)
+  {
+    if (capacity_ == 0)
+      grow();
+    for (;;)
+    {
+      size_type i = home_of(key);
+      rh_prefetch(slots_ + i);
+      size_type info = 1;
+      for (;; ++i, ++info)
+      {
+        const size_type cur = info_at(i);
+        if (cur < info)
+          break;
+        if (cur == info && equal_(value_traits::get_key(slots_[i]), key))
+          return tinystl::make_pair(i, false);
+      }
+      // i 是新元素的位置：空槽，或者一个离家更近的元素
+      if (size_ + 1 > max_elements())
+      {
+        grow();
+      }
+      else if (make_room(i))
+      {
+        info_[i] = saturate(info);
+        ++size_;
+        return tinystl::make_pair(i, true);
+      }
+      else
+      {
+        grow_overflow();
+      }
+    }
+  }
+
+  // 把 i 开始的一段元素整体后移一格，为新元素腾出位置 i
+  // 这一段元素将越过槽数组末尾时不做修改，返回 false
+  template <class T, class Hash, class KeyEqual>
+  bool robin_hood_hashtable<T, Hash, KeyEqual>::
+      make_room(size_type i)
+  {
+    const size_type n = total();
+    size_type j = i;
+    while (j < n && info_[j] != 0)
+      ++j;
+    if (j == n)
+      return false;
+    for (; j > i; --j)
+    {
+      data_allocator::construct(slots_ + j, tinystl::move(slots_[j - 1]));
+      data_allocator::destroy(slots_ + j - 1);
+      info_[j] = saturate(info_[j - 1] + 1u);
+    }
+    return true;
+  }
+
+  // 重建时把 value 移到本表中，不检查键值是否重复
+  template <class T, class Hash, class KeyEqual>
+  bool robin_hood_hashtable<T, Hash, KeyEqual>::
+      insert_moved(value_type &value)
+  {
+    size_type i = home_of(value_traits::get_key(value));
+    size_type info = 1;
+    for (; info_at(i) >= info; ++i, ++info)
+    {
+    }
+    if (!make_room(i))
+      return false;
+    data_allocator::construct(slots_ + i, tinystl::move(value));
+    data_allocator::destroy(&value);
+    info_[i] = saturate(info);
+    ++size_;
+    return true;
+  }
+
+  // 在已占用的槽 i 中构造元素，失败时归还这个槽
+  template <class T, class Hash, class KeyEqual>
+  template <class... Args>
+  void robin_hood_hashtable<T, Hash, KeyEqual>::
+      construct_at(size_type i, Args &&...args)
+  {
+    try
+    {
+      data_allocator::construct(slots_ + i, tinystl::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+      shift_down(i);
+      --size_;
+      throw;
+    }
+  }
+
+  template <class T, class Hash, class KeyEqual>
+  void robin_hood_hashtable<T, Hash, KeyEqual>::
+      erase_at(size_type i)
+  {
+    // 饱和元素中真实值恰为 254 的改记为精确值，需要重新计算哈希值，可能抛出异常，此时表还没有改动
+    for (size_type j = i + 1; info_[j] > 1; ++j)
+    {
+      if (info_[j] == rh_saturated_info && info_at(j) == rh_saturated_info - 1)
+        info_[j] = rh_saturated_info - 1;
+    }
+    data_allocator::destroy(slots_ + i);
+    shift_down(i);
+    --size_;
+  }
+
+  // 槽 i 已经空出，把其后不在起始位置的元素逐个前移一格，哨兵的值为 1，会让循环停下
+  // 要求其后的饱和元素真实值都不小于 255，前移后仍然满足饱和的含义，所以不需要重新计算哈希值；
+  // make_room 刚后移过的一段总是满足这一点，删除时由 erase_at 预先处理
+  template <class T, class Hash, class KeyEqual>
+  void robin_hood_hashtable<T, Hash, KeyEqual>::
+      shift_down(size_type i) noexcept
+  {
+    for (size_type j = i + 1; info_[j] > 1; i = j++)
+    {
+      const uint8_t info = info_[j];
+      data_allocator::construct(slots_ + i, tinystl::move(slots_[j]));
+      data_allocator::destroy(slots_ + j);
+      info_[i] = info == rh_saturated_info ? info : static_cast<uint8_t>(info - 1);
+    }
+    info_[i] = 0;
+  }
+
+  // 容量加倍
+  template <class T, class Hash, class KeyEqual>
+  void robin_hood_hashtable<T, Hash, KeyEqual>::
+      grow()
+  {
+    resize(capacity_ == 0 ? rh_min_capacity : capacity_ * 2);
+  }
+
+  // 容量不变，溢出区加倍，用于大量键值的起始位置靠近槽数组末尾的情况
+  template <class T, class Hash, class KeyEqual>
+  void robin_hood_hashtable<T, Hash, KeyEqual>::
+      grow_overflow()
+  {
+    resize(capacity_, overflow_ * 2);
+  }
+
+  // 分配 new_cap 个起始位置与 new_overflow 个溢出槽，把元素逐个移过去
+  // 移动途中越过槽数组末尾时，先加倍已移过去的部分的溢出区，再移动剩下的元素
+  template <class T, class Hash, class KeyEqual>
+  void robin_hood_hashtable<T, Hash, KeyEqual>::
+      resize(size_type new_cap, size_type new_overflow)
+  {
+    TINYSTL_DEBUG(new_cap >= rh_min_capacity && (new_cap & (new_cap - 1)) == 0);
+    THROW_LENGTH_ERROR_IF(new_cap > max_size() || new_overflow > max_size() - new_cap,
+                          "robin_hood_hashtable<T>'s size too big");
+    const size_type new_total = new_cap + new_overflow;
+    uint8_t *new_info = info_allocator::allocate(new_total + 1);
+    pointer new_slots = nullptr;
+    try
+    {
+      new_slots = data_allocator::allocate(new_total);
+    }
+    catch (...)
+    {
+      info_allocator::deallocate(new_info, new_total + 1);
+      throw;
+    }
+    std::memset(new_info, 0, new_total);
+    new_info[new_total] = 1;
+
+    uint8_t *old_info = info_;
+    pointer old_slots = slots_;
+    const size_type old_cap = capacity_;
+    const size_type old_total = total();
+    info_ = new_info;
+    slots_ = new_slots;
+    capacity_ = new_cap;
+    overflow_ = new_overflow;
+    size_ = 0;
+    shift_ = 64;
+    for (size_type c = new_cap; c > 1; c >>= 1)
+      --shift_;
+
+    size_type j = 0;
+    for (; j < old_total; ++j)
+    {
+      if (old_info[j] != 0 && !insert_moved(old_slots[j]))
+        break;
+    }
+    try
+    {
+      for (; j < old_total; ++j)
+      {
+        if (old_info[j] == 0)
+          continue;
+        while (!insert_moved(old_slots[j]))
+          grow_overflow();
+      }
+    }
+    catch (...)
+    {
+      // 只保留已经移过去的元素
+      for (; j < old_total; ++j)
+      {
+        if (old_info[j] != 0)
+          data_allocator::destroy(old_slots + j);
+      }
+      info_allocator::deallocate(old_info, old_total + 1);
+      data_allocator::deallocate(old_slots, old_total);
+      throw;
+    }
+    if (old_cap != 0)
+    {
+      info_allocator::deallocate(old_info, old_total + 1);
+      data_allocator::deallocate(old_slots, old_total);
+    }
+  }
+
+  template <class T, class Hash, class KeyEqual>
+  void robin_hood_hashtable<T, Hash, KeyEqual>::
+      destroy_all() noexcept
+  {
+    if (size_ == 0)
+      return;
+    for (size_type i = 0; i < total(); ++i)
+    {
+      if (info_[i] != 0)
+        data_allocator::destroy(slots_ + i);
+    }
+  }
+
+  // 销毁所有元素并释放空间，回到空表
+  template <class T, class Hash, class KeyEqual>
+  void robin_hood_hashtable<T, Hash, KeyEqual>::
+      release() noexcept
+  {
+    if (capacity_ != 0)
+    {
+      destroy_all();
+      info_allocator::deallocate(info_, total() + 1);
+      data_allocator::deallocate(slots_, total());
+    }
+    reset();
+  }
+
+  template <class T, class Hash, class KeyEqual>
+  void robin_hood_hashtable<T, Hash, KeyEqual>::
+      reset() noexcept
+  {
+    info_ = rh_empty_info();
+    slots_ = nullptr;
+    capacity_ = 0;
+    overflow_ = 0;
+    shift_ = 0;
+    size_ = 0;
+  }
+
+} // namespace tinystl
+
+#endif // !TINYSTL_ROBIN_HOOD_HASHTABLE_H_
@@ -0,0 +1,306 @@
+#ifndef TINYSTL_ROBIN_HOOD_SET_H_
+#define TINYSTL_ROBIN_HOOD_SET_H_
+
+// 这个头文件包含一个模板类 robin_hood_set
+// robin_hood_set : 集合，键值即实值，键值不允许重复，接口与 unordered_set 相同
+
+// notes:
+//
+// 1. 底层为 Robin Hood 哈希表 tinystl::robin_hood_hashtable，元素直接存放在槽数组中，
+//    探查距离比较平均，负载因子缺省为 0.9，未命中的查找也能提前结束
+// 2. 插入与删除都可能移动其他元素，使所有迭代器与元素的引用失效，这一点与 unordered_set 不同
+// 3. 没有 local_iterator 与节点句柄
+
+#include "robin_hood_hashtable.h"
+
+namespace tinystl
+{
+
+  // 模板类 robin_hood_set，键值不允许重复
+  // 参数一代表键值类型，参数二代表哈希函数，缺省使用 tinystl::hash
+  // 参数三代表键值比较方式，缺省使用 tinystl::equal_to
+  template <class Key, class Hash = tinystl::hash<Key>, class KeyEqual = tinystl::equal_to<Key>>
+  class robin_hood_set
+  {
+    typedef robin_hood_hashtable<Key, Hash, KeyEqual> base_type;
+    base_type ht_;
+
+  public:
+    // 使用 robin_hood_hashtable 的型别
+
+    typedef typename base_type::allocator_type allocator_type;
+    typedef typename base_type::key_type key_type;
+    typedef typename base_type::value_type value_type;
+    typedef typename base_type::hasher hasher;
+    typedef typename base_type::key_equal key_equal;
+
+    typedef typename base_type::size_type size_type;
+    typedef typename base_type::difference_type difference_type;
+    typedef typename base_type::const_pointer pointer;
+    typedef typename base_type::const_pointer const_pointer;
+    typedef typename base_type::const_reference reference;
+    typedef typename base_type::const_reference const_reference;
+
+    typedef typename base_type::const_iterator iterator;
+    typedef typename base_type::const_iterator const_iterator;
+
+    allocator_type get_allocator() const { return ht_.get_allocator(); }
+
+  public:
+    // 构造、复制、移动函数
+
+    robin_hood_set() : ht_(0, Hash(), KeyEqual()) {}
+    explicit robin_hood_set(size_type bucket_count, const Hash &hash = Hash(), const KeyEqual &equal = KeyEqual())
+        : ht_(bucket_count, hash, equal) {}
+
+    template <class InputIterator>
+    robin_hood_set(InputIterator first, InputIterator last,
+                  const size_type bucket_count = 0,
+                  const Hash &hash = Hash(),
+                  const KeyEqual &equal = KeyEqual())
+        : ht_(bucket_count, hash, equal)
+    {
+      ht_.insert_unique(first, last);
+    }
+
+    robin_hood_set(std::initializer_list<value_type> ilist,
+                  const size_type bucket_count = 0,
+                  const Hash &hash = Hash(),
+                  const KeyEqual &equal = KeyEqual())
+        : ht_(tinystl::max(bucket_count, static_cast<size_type>(ilist.size())), hash, equal)
+    {
+      ht_.insert_unique(ilist.begin(), ilist.end());
+    }
+
+    robin_hood_set(const robin_hood_set &rhs)
+        : ht_(rhs.ht_)
+    {
+    }
+    robin_hood_set(robin_hood_set &&rhs) noexcept
+        : ht_(tinystl::move(rhs.ht_))
+    {
+    }
+
+    robin_hood_set &operator=(const robin_hood_set &rhs)
+    {
+      ht_ = rhs.ht_;
+      return *this;
+    }
+    robin_hood_set &operator=(robin_hood_set &&rhs)
+    {
+      ht_ = tinystl::move(rhs.ht_);
+      return *this;
+    }
+
+    robin_hood_set &operator=(std::initializer_list<value_type> ilist)
+    {
+      ht_.clear();
+      ht_.reserve(ilist.size());
+      ht_.insert_unique(ilist.begin(), ilist.end());
+      return *this;
+    }
+
+    ~robin_hood_set() = default;
+
+    // iterator
+
+    iterator begin() const noexcept
+    {
+      return ht_.begin();
+    }
+    iterator end() const noexcept
+    {
+      return ht_.end();
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+      return ht_.cbegin();
+    }
+    const_iterator cend() const noexcept
+    {
+      return ht_.cend();
+    }
+
+    // container
+    bool empty() const noexcept { return ht_.empty(); }
+
+    size_type size() const noexcept { return ht_.size(); }
+    size_type max_size() const noexcept { return ht_.max_size(); }
+
+    // 修改容器操作
+
+    // emplace / emplace_hint
+
+    template <class... Args>
+    pair<iterator, bool> emplace(Args &&...args)
+    {
+      return ht_.emplace_unique(tinystl::forward<Args>(args)...);
+    }
+
+    // [note]: hint 对开放寻址的哈希表没有意义，忽略它
+    template <class... Args>
+    iterator emplace_hint(const_iterator /*hint*/, Args &&...args)
+    {
+      return ht_.emplace_unique(tinystl::forward<Args>(args)...).first;
+    }
+
+    // insert
+
+    pair<iterator, bool> insert(const value_type &value)
+    {
+      return ht_.insert_unique(value);
+    }
+    pair<iterator, bool> insert(value_type &&value)
+    {
+      return ht_.emplace_unique(tinystl::move(value));
+    }
+
+    iterator insert(const_iterator /*hint*/, const value_type &value)
+    {
+      return ht_.insert_unique(value).first;
+    }
+    iterator insert(const_iterator /*hint*/, value_type &&value)
+    {
+      return ht_.emplace_unique(tinystl::move(value)).first;
+    }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last)
+    {
+      ht_.insert_unique(first, last);
+    }
+    void insert(std::initializer_list<value_type> ilist)
+    {
+      ht_.insert_unique(ilist.begin(), ilist.end());
+    }
+
+    // erase / clear
+
+    iterator erase(const_iterator it)
+    {
+      return ht_.erase(it);
+    }
+    iterator erase(const_iterator first, const_iterator last)
+    {
+      return ht_.erase(first, last);
+    }
+
+    size_type erase(const key_type &key)
+    {
+      return ht_.erase_unique(key);
+    }
+
+    void clear()
+    {
+      ht_.clear();
+    }
+
+    // 键值已存在的元素留在 source 中
+    void merge(robin_hood_set &source)
+    {
+      ht_.merge_unique(source.ht_);
+    }
+    void merge(robin_hood_set &&source)
+    {
+      ht_.merge_unique(source.ht_);
+    }
+
+    void swap(robin_hood_set &other) noexcept
+    {
+      ht_.swap(other.ht_);
+    }
+
+    // 查找相关
+
+    size_type count(const key_type &key) const
+    {
+      return ht_.count(key);
+    }
+
+    iterator find(const key_type &key) const
+    {
+      return ht_.find(key);
+    }
+
+    pair<iterator, iterator> equal_range(const key_type &key) const
+    {
+      return ht_.equal_range(key);
+    }
+
+    // 异构查找，Hash 与 KeyEqual 都带有 is_transparent 标记时才参与重载决议
+
+    template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+                  tinystl::is_transparent<H>::value && tinystl::is_transparent<E>::value, int>::type = 0>
+    size_type count(const K &key) const
+    {
+      return ht_.count(key);
+    }
+
+    template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+                  tinystl::is_transparent<H>::value && tinystl::is_transparent<E>::value, int>::type = 0>
+    iterator find(const K &key) const
+    {
+      return ht_.find(key);
+    }
+
+    template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+                  tinystl::is_transparent<H>::value && tinystl::is_transparent<E>::value, int>::type = 0>
+    pair<iterator, iterator> equal_range(const K &key) const
+    {
+      return ht_.equal_range(key);
+    }
+
+    // bucket interface，每个起始位置视为一个 bucket
+
+    size_type bucket_count() const noexcept
+    {
+      return ht_.bucket_count();
+    }
+    size_type max_bucket_count() const noexcept
+    {
+      return ht_.max_bucket_count();
+    }
+
+    // hash policy
+
+    float load_factor() const noexcept { return ht_.load_factor(); }
+
+    float max_load_factor() const noexcept { return ht_.max_load_factor(); }
+    void max_load_factor(float ml) { ht_.max_load_factor(ml); }
+
+    void rehash(size_type count) { ht_.rehash(count); }
+    void reserve(size_type count) { ht_.reserve(count); }
+
+    hasher hash_fcn() const { return ht_.hash_fcn(); }
+    key_equal key_eq() const { return ht_.key_eq(); }
+
+  public:
+    friend bool operator==(const robin_hood_set &lhs, const robin_hood_set &rhs)
+    {
+      if (lhs.size() != rhs.size())
+        return false;
+      for (const_iterator it = lhs.begin(); it != lhs.end(); ++it)
+      {
+        if (rhs.find(*it) == rhs.end())
+          return false;
+      }
+      return true;
+    }
+    friend bool operator!=(const robin_hood_set &lhs, const robin_hood_set &rhs)
+    {
+      return !(lhs == rhs);
+    }
+  };
+
+  // 重载 tinystl 的 swap
+  template <class Key, class Hash, class KeyEqual>
+  void swap(robin_hood_set<Key, Hash, KeyEqual> &lhs,
+            robin_hood_set<Key, Hash, KeyEqual> &rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+} // namespace tinystl
+
+#endif // !TINYSTL_ROBIN_HOOD_SET_H_
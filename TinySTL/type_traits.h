@@ -41,6 +41,27 @@ namespace tinystl
   {
   };
 
+  // is_transparent
+  // 比较函数或哈希函数定义了 is_transparent 型别时，容器的查找函数可以接受键值以外的类型
+
+  template <class T>
+  struct is_transparent
+  {
+  private:
+    struct two
+    {
+      char a;
+      char b;
+    };
+    template <class U>
+    static two test(...);
+    template <class U>
+    static char test(typename U::is_transparent * = 0);
+
+  public:
+    static const bool value = sizeof(test<T>(0)) == sizeof(char);
+  };
+
 }
 
 #endif // !TINYSTL_TYPE_TRAITS_H_
\ No newline at end of file
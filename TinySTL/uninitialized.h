@@ -35,8 +35,9 @@ namespace tinystl
     }
     catch (...)
     {
-      for (; result != cur; --cur)
-        tinystl::destroy(&*cur);
+      for (; result != cur; ++result)
+        tinystl::destroy(&*result);
+      throw;
     }
     return cur;
   }
@@ -77,6 +78,7 @@ namespace tinystl
     {
       for (; first != cur; ++first)
         tinystl::destroy(&*first);
+      throw;
     }
   }
 
@@ -89,6 +91,88 @@ namespace tinystl
                                            value_type>{});
   }
 
+  /*****************************************************************************************/
+  // uninitialized_fill_n
+  // 从 first 位置开始，填充 n 个元素值，返回填充结束的位置
+  /*****************************************************************************************/
+  template <class ForwardIter, class Size, class T>
+  ForwardIter
+  unchecked_uninit_fill_n(ForwardIter first, Size n, const T &value, std::true_type)
+  {
+    return tinystl::fill_n(first, n, value);
+  }
+
+  template <class ForwardIter, class Size, class T>
+  ForwardIter
+  unchecked_uninit_fill_n(ForwardIter first, Size n, const T &value, std::false_type)
+  {
+    auto cur = first;
+    try
+    {
+      for (; n > 0; --n, ++cur)
+      {
+        tinystl::construct(&*cur, value);
+      }
+    }
+    catch (...)
+    {
+      for (; first != cur; ++first)
+        tinystl::destroy(&*first);
+      throw;
+    }
+    return cur;
+  }
+
+  template <class ForwardIter, class Size, class T>
+  ForwardIter uninitialized_fill_n(ForwardIter first, Size n, const T &value)
+  {
+    return tinystl::unchecked_uninit_fill_n(first, n, value,
+                                          std::is_trivially_copy_assignable<
+                                              typename iterator_traits<ForwardIter>::
+                                                  value_type>{});
+  }
+
+  /*****************************************************************************************/
+  // uninitialized_move
+  // 把[first, last)上的内容移动到以 result 为起始处的空间，返回移动结束的位置
+  /*****************************************************************************************/
+  template <class InputIter, class ForwardIter>
+  ForwardIter
+  unchecked_uninit_move(InputIter first, InputIter last, ForwardIter result, std::true_type)
+  {
+    return tinystl::move(first, last, result);
+  }
+
+  template <class InputIter, class ForwardIter>
+  ForwardIter
+  unchecked_uninit_move(InputIter first, InputIter last, ForwardIter result, std::false_type)
+  {
+    ForwardIter cur = result;
+    try
+    {
+      for (; first != last; ++first, ++cur)
+      {
+        tinystl::construct(&*cur, tinystl::move(*first));
+      }
+    }
+    catch (...)
+    {
+      for (; result != cur; ++result)
+        tinystl::destroy(&*result);
+      throw;
+    }
+    return cur;
+  }
+
+  template <class InputIter, class ForwardIter>
+  ForwardIter uninitialized_move(InputIter first, InputIter last, ForwardIter result)
+  {
+    return tinystl::unchecked_uninit_move(first, last, result,
+                                        std::is_trivially_move_assignable<
+                                            typename iterator_traits<InputIter>::
+                                                value_type>{});
+  }
+
 } // namespace tinystl
 
 #endif
\ No newline at end of file
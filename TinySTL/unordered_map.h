@@ -13,13 +13,18 @@
 
 namespace tinystl
 {
+  template <class Key, class T, class Hash, class KeyEqual, class BucketPolicy>
+  class unordered_multimap;
+
   // 模板类 unordered_map，键值不允许重复
   // 参数一代表键值类型，参数二代表实值类型，参数三代表哈希函数，缺省使用 tinystl::hash
   // 参数四代表键值比较方式，缺省使用 tinystl::equal_to
-  template <class Key, class T, class Hash = tinystl::hash<Key>, class KeyEqual = tinystl::equal_to<Key>>
+  // 参数五代表 bucket 策略，缺省使用 tinystl::ht_prime_policy，见 hashtable.h
+  template <class Key, class T, class Hash = tinystl::hash<Key>, class KeyEqual = tinystl::equal_to<Key>,
+            class BucketPolicy = tinystl::ht_prime_policy>
   class unordered_map
   {
-    typedef hashtable<tinystl::pair<const Key, T>, Hash, KeyEqual> base_type;
+    typedef hashtable<tinystl::pair<const Key, T>, Hash, KeyEqual, BucketPolicy> base_type;
     base_type ht_;
 
   public:
@@ -44,6 +49,9 @@ namespace tinystl
     typedef typename base_type::local_iterator local_iterator;
     typedef typename base_type::const_local_iterator const_local_iterator;
 
+    typedef typename base_type::node_handle_type node_type;
+    typedef typename base_type::insert_return_type insert_return_type;
+
     allocator_type get_allocator() const { return ht_.get_allocator(); }
 
   public:
@@ -198,6 +206,44 @@ namespace tinystl
       ht_.clear();
     }
 
+    // 节点句柄，在容器之间转移元素时只重新链接节点，不分配内存也不复制元素
+
+    node_type extract(const_iterator position)
+    {
+      return ht_.extract(position);
+    }
+    node_type extract(const key_type &key)
+    {
+      return ht_.extract(key);
+    }
+
+    insert_return_type insert(node_type &&nh)
+    {
+      return ht_.insert_unique(tinystl::move(nh));
+    }
+    iterator insert(const_iterator hint, node_type &&nh)
+    {
+      return ht_.insert_unique_use_hint(hint, tinystl::move(nh));
+    }
+
+    // 键值已存在的元素留在 source 中
+    void merge(unordered_map &source)
+    {
+      ht_.merge_unique(source.ht_);
+    }
+    void merge(unordered_map &&source)
+    {
+      ht_.merge_unique(source.ht_);
+    }
+    void merge(unordered_multimap<Key, T, Hash, KeyEqual, BucketPolicy> &source)
+    {
+      ht_.merge_unique(source.ht_);
+    }
+    void merge(unordered_multimap<Key, T, Hash, KeyEqual, BucketPolicy> &&source)
+    {
+      ht_.merge_unique(source.ht_);
+    }
+
     void swap(unordered_map &other) noexcept
     {
       ht_.swap(other.ht_);
@@ -256,6 +302,41 @@ namespace tinystl
       return ht_.equal_range_unique(key);
     }
 
+    // 异构查找，Hash 与 KeyEqual 都带有 is_transparent 标记时才参与重载决议
+
+    template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+                  tinystl::is_transparent<H>::value && tinystl::is_transparent<E>::value, int>::type = 0>
+    size_type count(const K &key) const
+    {
+      return ht_.count(key);
+    }
+
+    template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+                  tinystl::is_transparent<H>::value && tinystl::is_transparent<E>::value, int>::type = 0>
+    iterator find(const K &key)
+    {
+      return ht_.find(key);
+    }
+    template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+                  tinystl::is_transparent<H>::value && tinystl::is_transparent<E>::value, int>::type = 0>
+    const_iterator find(const K &key) const
+    {
+      return ht_.find(key);
+    }
+
+    template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+                  tinystl::is_transparent<H>::value && tinystl::is_transparent<E>::value, int>::type = 0>
+    pair<iterator, iterator> equal_range(const K &key)
+    {
+      return ht_.equal_range_multi(key);
+    }
+    template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+                  tinystl::is_transparent<H>::value && tinystl::is_transparent<E>::value, int>::type = 0>
+    pair<const_iterator, const_iterator> equal_range(const K &key) const
+    {
+      return ht_.equal_range_multi(key);
+    }
+
     // bucket interface
 
     local_iterator begin(size_type n) noexcept
@@ -316,6 +397,7 @@ namespace tinystl
     key_equal key_eq() const { return ht_.key_eq(); }
 
   public:
+    friend class unordered_multimap<Key, T, Hash, KeyEqual, BucketPolicy>;
     friend bool operator==(const unordered_map &lhs, const unordered_map &rhs)
     {
       return lhs.ht_.equal_range_unique(rhs.ht_);
@@ -327,24 +409,24 @@ namespace tinystl
   };
 
   // 重载比较操作符
-  template <class Key, class T, class Hash, class KeyEqual>
-  bool operator==(const unordered_map<Key, T, Hash, KeyEqual> &lhs,
-                  const unordered_map<Key, T, Hash, KeyEqual> &rhs)
+  template <class Key, class T, class Hash, class KeyEqual, class BucketPolicy>
+  bool operator==(const unordered_map<Key, T, Hash, KeyEqual, BucketPolicy> &lhs,
+                  const unordered_map<Key, T, Hash, KeyEqual, BucketPolicy> &rhs)
   {
     return lhs == rhs;
   }
 
-  template <class Key, class T, class Hash, class KeyEqual>
-  bool operator!=(const unordered_map<Key, T, Hash, KeyEqual> &lhs,
-                  const unordered_map<Key, T, Hash, KeyEqual> &rhs)
+  template <class Key, class T, class Hash, class KeyEqual, class BucketPolicy>
+  bool operator!=(const unordered_map<Key, T, Hash, KeyEqual, BucketPolicy> &lhs,
+                  const unordered_map<Key, T, Hash, KeyEqual, BucketPolicy> &rhs)
   {
     return lhs != rhs;
   }
 
   // 重载 tinystl 的 swap
-  template <class Key, class T, class Hash, class KeyEqual>
-  void swap(unordered_map<Key, T, Hash, KeyEqual> &lhs,
-            unordered_map<Key, T, Hash, KeyEqual> &rhs)
+  template <class Key, class T, class Hash, class KeyEqual, class BucketPolicy>
+  void swap(unordered_map<Key, T, Hash, KeyEqual, BucketPolicy> &lhs,
+            unordered_map<Key, T, Hash, KeyEqual, BucketPolicy> &rhs)
   {
     lhs.swap(rhs);
   }
@@ -354,12 +436,14 @@ namespace tinystl
   // 模板类 unordered_multimap，键值允许重复
   // 参数一代表键值类型，参数二代表实值类型，参数三代表哈希函数，缺省使用 tinystl::hash
   // 参数四代表键值比较方式，缺省使用 tinystl::equal_to
-  template <class Key, class T, class Hash = tinystl::hash<Key>, class KeyEqual = tinystl::equal_to<Key>>
+  // 参数五代表 bucket 策略，缺省使用 tinystl::ht_prime_policy，见 hashtable.h
+  template <class Key, class T, class Hash = tinystl::hash<Key>, class KeyEqual = tinystl::equal_to<Key>,
+            class BucketPolicy = tinystl::ht_prime_policy>
   class unordered_multimap
   {
   private:
     // 使用 hashtable 作为底层机制
-    typedef hashtable<pair<const Key, T>, Hash, KeyEqual> base_type;
+    typedef hashtable<pair<const Key, T>, Hash, KeyEqual, BucketPolicy> base_type;
     base_type ht_;
 
   public:
@@ -383,6 +467,8 @@ namespace tinystl
     typedef typename base_type::local_iterator local_iterator;
     typedef typename base_type::const_local_iterator const_local_iterator;
 
+    typedef typename base_type::node_handle_type node_type;
+
     allocator_type get_allocator() const { return ht_.get_allocator(); }
 
   public:
@@ -549,6 +635,43 @@ namespace tinystl
       ht_.clear();
     }
 
+    // 节点句柄，在容器之间转移元素时只重新链接节点，不分配内存也不复制元素
+
+    node_type extract(const_iterator position)
+    {
+      return ht_.extract(position);
+    }
+    node_type extract(const key_type &key)
+    {
+      return ht_.extract(key);
+    }
+
+    iterator insert(node_type &&nh)
+    {
+      return ht_.insert_multi(tinystl::move(nh));
+    }
+    iterator insert(const_iterator hint, node_type &&nh)
+    {
+      return ht_.insert_multi_use_hint(hint, tinystl::move(nh));
+    }
+
+    void merge(unordered_multimap &source)
+    {
+      ht_.merge_multi(source.ht_);
+    }
+    void merge(unordered_multimap &&source)
+    {
+      ht_.merge_multi(source.ht_);
+    }
+    void merge(unordered_map<Key, T, Hash, KeyEqual, BucketPolicy> &source)
+    {
+      ht_.merge_multi(source.ht_);
+    }
+    void merge(unordered_map<Key, T, Hash, KeyEqual, BucketPolicy> &&source)
+    {
+      ht_.merge_multi(source.ht_);
+    }
+
     void swap(unordered_multimap &other) noexcept
     {
       ht_.swap(other.ht_);
@@ -579,6 +702,41 @@ namespace tinystl
       return ht_.equal_range_multi(key);
     }
 
+    // 异构查找，Hash 与 KeyEqual 都带有 is_transparent 标记时才参与重载决议
+
+    template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+                  tinystl::is_transparent<H>::value && tinystl::is_transparent<E>::value, int>::type = 0>
+    size_type count(const K &key) const
+    {
+      return ht_.count(key);
+    }
+
+    template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+                  tinystl::is_transparent<H>::value && tinystl::is_transparent<E>::value, int>::type = 0>
+    iterator find(const K &key)
+    {
+      return ht_.find(key);
+    }
+    template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+                  tinystl::is_transparent<H>::value && tinystl::is_transparent<E>::value, int>::type = 0>
+    const_iterator find(const K &key) const
+    {
+      return ht_.find(key);
+    }
+
+    template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+                  tinystl::is_transparent<H>::value && tinystl::is_transparent<E>::value, int>::type = 0>
+    pair<iterator, iterator> equal_range(const K &key)
+    {
+      return ht_.equal_range_multi(key);
+    }
+    template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+                  tinystl::is_transparent<H>::value && tinystl::is_transparent<E>::value, int>::type = 0>
+    pair<const_iterator, const_iterator> equal_range(const K &key) const
+    {
+      return ht_.equal_range_multi(key);
+    }
+
     // bucket interface
 
     local_iterator begin(size_type n) noexcept
@@ -639,6 +797,7 @@ namespace tinystl
     key_equal key_eq() const { return ht_.key_eq(); }
 
   public:
+    friend class unordered_map<Key, T, Hash, KeyEqual, BucketPolicy>;
     friend bool operator==(const unordered_multimap &lhs, const unordered_multimap &rhs)
     {
       return lhs.ht_.equal_range_multi(rhs.ht_);
@@ -650,24 +809,24 @@ namespace tinystl
   };
 
   // 重载比较操作符
-  template <class Key, class T, class Hash, class KeyEqual>
-  bool operator==(const unordered_multimap<Key, T, Hash, KeyEqual> &lhs,
-                  const unordered_multimap<Key, T, Hash, KeyEqual> &rhs)
+  template <class Key, class T, class Hash, class KeyEqual, class BucketPolicy>
+  bool operator==(const unordered_multimap<Key, T, Hash, KeyEqual, BucketPolicy> &lhs,
+                  const unordered_multimap<Key, T, Hash, KeyEqual, BucketPolicy> &rhs)
   {
     return lhs == rhs;
   }
 
-  template <class Key, class T, class Hash, class KeyEqual>
-  bool operator!=(const unordered_multimap<Key, T, Hash, KeyEqual> &lhs,
-                  const unordered_multimap<Key, T, Hash, KeyEqual> &rhs)
+  template <class Key, class T, class Hash, class KeyEqual, class BucketPolicy>
+  bool operator!=(const unordered_multimap<Key, T, Hash, KeyEqual, BucketPolicy> &lhs,
+                  const unordered_multimap<Key, T, Hash, KeyEqual, BucketPolicy> &rhs)
   {
     return lhs != rhs;
   }
 
   // 重载 tinystl 的 swap
-  template <class Key, class T, class Hash, class KeyEqual>
-  void swap(unordered_multimap<Key, T, Hash, KeyEqual> &lhs,
-            unordered_multimap<Key, T, Hash, KeyEqual> &rhs)
+  template <class Key, class T, class Hash, class KeyEqual, class BucketPolicy>
+  void swap(unordered_multimap<Key, T, Hash, KeyEqual, BucketPolicy> &lhs,
+            unordered_multimap<Key, T, Hash, KeyEqual, BucketPolicy> &rhs)
   {
     lhs.swap(rhs);
   }
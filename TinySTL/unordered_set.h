@@ -5,11 +5,15 @@
 
 namespace tinystl
 {
-  template <class Key, class Hash = tinystl::hash<Key>, class KeyEqual = tinystl::equal_to<Key>>
+  template <class Key, class Hash, class KeyEqual, class BucketPolicy>
+  class unordered_multiset;
+
+  template <class Key, class Hash = tinystl::hash<Key>, class KeyEqual = tinystl::equal_to<Key>,
+            class BucketPolicy = tinystl::ht_prime_policy>
   struct unordered_set
   {
   private:
-    typedef hashtable<Key, Hash, KeyEqual> base_type;
+    typedef hashtable<Key, Hash, KeyEqual, BucketPolicy> base_type;
     base_type ht_;
 
   public:
@@ -32,6 +36,9 @@ namespace tinystl
     typedef typename base_type::const_local_iterator local_iterator;
     typedef typename base_type::const_local_iterator const_local_iterator;
 
+    typedef typename base_type::node_handle_type node_type;
+    typedef tinystl::node_insert_return<iterator, node_type> insert_return_type;
+
     allocator_type get_allocator() const { return ht_.get_allocator(); }
 
   public:
@@ -186,6 +193,45 @@ namespace tinystl
       ht_.clear();
     }
 
+    // 节点句柄，在容器之间转移元素时只重新链接节点，不分配内存也不复制元素
+
+    node_type extract(const_iterator position)
+    {
+      return ht_.extract(position);
+    }
+    node_type extract(const key_type &key)
+    {
+      return ht_.extract(key);
+    }
+
+    insert_return_type insert(node_type &&nh)
+    {
+      auto res = ht_.insert_unique(tinystl::move(nh));
+      return insert_return_type{res.position, res.inserted, tinystl::move(res.node)};
+    }
+    iterator insert(const_iterator hint, node_type &&nh)
+    {
+      return ht_.insert_unique_use_hint(hint, tinystl::move(nh));
+    }
+
+    // 键值已存在的元素留在 source 中
+    void merge(unordered_set &source)
+    {
+      ht_.merge_unique(source.ht_);
+    }
+    void merge(unordered_set &&source)
+    {
+      ht_.merge_unique(source.ht_);
+    }
+    void merge(unordered_multiset<Key, Hash, KeyEqual, BucketPolicy> &source)
+    {
+      ht_.merge_unique(source.ht_);
+    }
+    void merge(unordered_multiset<Key, Hash, KeyEqual, BucketPolicy> &&source)
+    {
+      ht_.merge_unique(source.ht_);
+    }
+
     void swap(unordered_set &other) noexcept
     {
       ht_.swap(other.ht_);
@@ -216,6 +262,41 @@ namespace tinystl
       return ht_.equal_range_unique(key);
     }
 
+    // 异构查找，Hash 与 KeyEqual 都带有 is_transparent 标记时才参与重载决议
+
+    template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+                  tinystl::is_transparent<H>::value && tinystl::is_transparent<E>::value, int>::type = 0>
+    size_type count(const K &key) const
+    {
+      return ht_.count(key);
+    }
+
+    template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+                  tinystl::is_transparent<H>::value && tinystl::is_transparent<E>::value, int>::type = 0>
+    iterator find(const K &key)
+    {
+      return ht_.find(key);
+    }
+    template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+                  tinystl::is_transparent<H>::value && tinystl::is_transparent<E>::value, int>::type = 0>
+    const_iterator find(const K &key) const
+    {
+      return ht_.find(key);
+    }
+
+    template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+                  tinystl::is_transparent<H>::value && tinystl::is_transparent<E>::value, int>::type = 0>
+    pair<iterator, iterator> equal_range(const K &key)
+    {
+      return ht_.equal_range_multi(key);
+    }
+    template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+                  tinystl::is_transparent<H>::value && tinystl::is_transparent<E>::value, int>::type = 0>
+    pair<const_iterator, const_iterator> equal_range(const K &key) const
+    {
+      return ht_.equal_range_multi(key);
+    }
+
     // bucket interface
 
     local_iterator begin(size_type n) noexcept
@@ -276,6 +357,7 @@ namespace tinystl
     key_equal key_eq() const { return ht_.key_eq(); }
 
   public:
+    friend class unordered_multiset<Key, Hash, KeyEqual, BucketPolicy>;
     friend bool operator==(const unordered_set &lhs, const unordered_set &rhs)
     {
       return lhs.ht_.equal_range_unique(rhs.ht_);
@@ -287,24 +369,24 @@ namespace tinystl
   };
 
   // 重载比较操作符
-  template <class Key, class Hash, class KeyEqual, class Alloc>
-  bool operator==(const unordered_set<Key, Hash, KeyEqual> &lhs,
-                  const unordered_set<Key, Hash, KeyEqual> &rhs)
+  template <class Key, class Hash, class KeyEqual, class BucketPolicy>
+  bool operator==(const unordered_set<Key, Hash, KeyEqual, BucketPolicy> &lhs,
+                  const unordered_set<Key, Hash, KeyEqual, BucketPolicy> &rhs)
   {
     return lhs == rhs;
   }
 
-  template <class Key, class Hash, class KeyEqual, class Alloc>
-  bool operator!=(const unordered_set<Key, Hash, KeyEqual> &lhs,
-                  const unordered_set<Key, Hash, KeyEqual> &rhs)
+  template <class Key, class Hash, class KeyEqual, class BucketPolicy>
+  bool operator!=(const unordered_set<Key, Hash, KeyEqual, BucketPolicy> &lhs,
+                  const unordered_set<Key, Hash, KeyEqual, BucketPolicy> &rhs)
   {
     return lhs != rhs;
   }
 
   // 重载 tinystl 的 swap
-  template <class Key, class Hash, class KeyEqual, class Alloc>
-  void swap(unordered_set<Key, Hash, KeyEqual> &lhs,
-            unordered_set<Key, Hash, KeyEqual> &rhs)
+  template <class Key, class Hash, class KeyEqual, class BucketPolicy>
+  void swap(unordered_set<Key, Hash, KeyEqual, BucketPolicy> &lhs,
+            unordered_set<Key, Hash, KeyEqual, BucketPolicy> &rhs)
   {
     lhs.swap(rhs);
   }
@@ -314,11 +396,13 @@ namespace tinystl
   // 模板类 unordered_multiset，键值允许重复
   // 参数一代表键值类型，参数二代表哈希函数，缺省使用 tinystl::hash，
   // 参数三代表键值比较方式，缺省使用 tinystl::equal_to
-  template <class Key, class Hash = tinystl::hash<Key>, class KeyEqual = tinystl::equal_to<Key>>
+  // 参数四代表 bucket 策略，缺省使用 tinystl::ht_prime_policy，见 hashtable.h
+  template <class Key, class Hash = tinystl::hash<Key>, class KeyEqual = tinystl::equal_to<Key>,
+            class BucketPolicy = tinystl::ht_prime_policy>
   class unordered_multiset
   {
   private:
-    typedef hashtable<Key, Hash, KeyEqual> base_type;
+    typedef hashtable<Key, Hash, KeyEqual, BucketPolicy> base_type;
     base_type ht_;
 
   public:
@@ -341,6 +425,8 @@ namespace tinystl
     typedef typename base_type::const_local_iterator local_iterator;
     typedef typename base_type::const_local_iterator const_local_iterator;
 
+    typedef typename base_type::node_handle_type node_type;
+
     allocator_type get_allocator() const { return ht_.get_allocator(); }
 
   public:
@@ -506,6 +592,43 @@ namespace tinystl
       ht_.clear();
     }
 
+    // 节点句柄，在容器之间转移元素时只重新链接节点，不分配内存也不复制元素
+
+    node_type extract(const_iterator position)
+    {
+      return ht_.extract(position);
+    }
+    node_type extract(const key_type &key)
+    {
+      return ht_.extract(key);
+    }
+
+    iterator insert(node_type &&nh)
+    {
+      return ht_.insert_multi(tinystl::move(nh));
+    }
+    iterator insert(const_iterator hint, node_type &&nh)
+    {
+      return ht_.insert_multi_use_hint(hint, tinystl::move(nh));
+    }
+
+    void merge(unordered_multiset &source)
+    {
+      ht_.merge_multi(source.ht_);
+    }
+    void merge(unordered_multiset &&source)
+    {
+      ht_.merge_multi(source.ht_);
+    }
+    void merge(unordered_set<Key, Hash, KeyEqual, BucketPolicy> &source)
+    {
+      ht_.merge_multi(source.ht_);
+    }
+    void merge(unordered_set<Key, Hash, KeyEqual, BucketPolicy> &&source)
+    {
+      ht_.merge_multi(source.ht_);
+    }
+
     void swap(unordered_multiset &other) noexcept
     {
       ht_.swap(other.ht_);
@@ -536,6 +659,41 @@ namespace tinystl
       return ht_.equal_range_multi(key);
     }
 
+    // 异构查找，Hash 与 KeyEqual 都带有 is_transparent 标记时才参与重载决议
+
+    template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+                  tinystl::is_transparent<H>::value && tinystl::is_transparent<E>::value, int>::type = 0>
+    size_type count(const K &key) const
+    {
+      return ht_.count(key);
+    }
+
+    template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+                  tinystl::is_transparent<H>::value && tinystl::is_transparent<E>::value, int>::type = 0>
+    iterator find(const K &key)
+    {
+      return ht_.find(key);
+    }
+    template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+                  tinystl::is_transparent<H>::value && tinystl::is_transparent<E>::value, int>::type = 0>
+    const_iterator find(const K &key) const
+    {
+      return ht_.find(key);
+    }
+
+    template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+                  tinystl::is_transparent<H>::value && tinystl::is_transparent<E>::value, int>::type = 0>
+    pair<iterator, iterator> equal_range(const K &key)
+    {
+      return ht_.equal_range_multi(key);
+    }
+    template <class K, class H = Hash, class E = KeyEqual, typename std::enable_if<
+                  tinystl::is_transparent<H>::value && tinystl::is_transparent<E>::value, int>::type = 0>
+    pair<const_iterator, const_iterator> equal_range(const K &key) const
+    {
+      return ht_.equal_range_multi(key);
+    }
+
     // bucket interface
 
     local_iterator begin(size_type n) noexcept
@@ -596,6 +754,7 @@ namespace tinystl
     key_equal key_eq() const { return ht_.key_eq(); }
 
   public:
+    friend struct unordered_set<Key, Hash, KeyEqual, BucketPolicy>;
     friend bool operator==(const unordered_multiset &lhs, const unordered_multiset &rhs)
     {
       return lhs.ht_.equal_range_multi(rhs.ht_);
@@ -607,24 +766,24 @@ namespace tinystl
   };
 
   // 重载比较操作符
-  template <class Key, class Hash, class KeyEqual, class Alloc>
-  bool operator==(const unordered_multiset<Key, Hash, KeyEqual> &lhs,
-                  const unordered_multiset<Key, Hash, KeyEqual> &rhs)
+  template <class Key, class Hash, class KeyEqual, class BucketPolicy>
+  bool operator==(const unordered_multiset<Key, Hash, KeyEqual, BucketPolicy> &lhs,
+                  const unordered_multiset<Key, Hash, KeyEqual, BucketPolicy> &rhs)
   {
     return lhs == rhs;
   }
 
-  template <class Key, class Hash, class KeyEqual, class Alloc>
-  bool operator!=(const unordered_multiset<Key, Hash, KeyEqual> &lhs,
-                  const unordered_multiset<Key, Hash, KeyEqual> &rhs)
+  template <class Key, class Hash, class KeyEqual, class BucketPolicy>
+  bool operator!=(const unordered_multiset<Key, Hash, KeyEqual, BucketPolicy> &lhs,
+                  const unordered_multiset<Key, Hash, KeyEqual, BucketPolicy> &rhs)
   {
     return lhs != rhs;
   }
 
   // 重载 tinystl 的 swap
-  template <class Key, class Hash, class KeyEqual, class Alloc>
-  void swap(unordered_multiset<Key, Hash, KeyEqual> &lhs,
-            unordered_multiset<Key, Hash, KeyEqual> &rhs)
+  template <class Key, class Hash, class KeyEqual, class BucketPolicy>
+  void swap(unordered_multiset<Key, Hash, KeyEqual, BucketPolicy> &lhs,
+            unordered_multiset<Key, Hash, KeyEqual, BucketPolicy> &rhs)
   {
     lhs.swap(rhs);
   }
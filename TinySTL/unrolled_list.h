@@ -0,0 +1,714 @@
+#ifndef TINYSTL_UNROLLED_LIST_H_
+#define TINYSTL_UNROLLED_LIST_H_
+
+// 这个头文件包含一个模板类 unrolled_list
+// unrolled_list : 展开链表，每个节点保存一小段连续的元素，遍历时缓存友好
+
+// notes:
+//
+// 1. 节点容量由 unrolled_list_node_size 决定，每个节点约 256 字节
+// 2. 插入时若节点已满则把节点一分为二，删除后若节点过空则与后继节点合并
+// 3. 给定迭代器的插入 / 删除只移动一个节点内的元素，为常数时间
+// 4. 插入或删除会使同一节点（以及合并时后继节点）上的迭代器失效
+
+#include <initializer_list>
+#include <type_traits>
+
+#include "algobase.h"
+#include "allocator.h"
+#include "iterator.h"
+#include "memory.h"
+#include "utils.h"
+#include "exceptdef.h"
+
+namespace tinystl
+{
+  template <class T>
+  struct unrolled_list_node_size
+  {
+    static constexpr size_t value = sizeof(T) < 32 ? 256 / sizeof(T) : 8;
+  };
+
+  template <class T>
+  struct unrolled_list_node;
+  template <class T>
+  struct unrolled_list_node_base;
+
+  template <class T>
+  struct unrolled_list_node_traits
+  {
+    typedef unrolled_list_node_base<T> *base_ptr;
+    typedef unrolled_list_node<T> *node_ptr;
+  };
+
+  // unrolled_list 节点的链接部分，头节点只包含这一部分
+  template <class T>
+  struct unrolled_list_node_base
+  {
+    typedef typename unrolled_list_node_traits<T>::base_ptr base_ptr;
+    typedef typename unrolled_list_node_traits<T>::node_ptr node_ptr;
+
+    base_ptr prev;
+    base_ptr next;
+
+    node_ptr as_node() { return static_cast<node_ptr>(this); }
+    void unlink() { prev = next = this; }
+  };
+
+  // unrolled_list 节点，count 为节点中已构造的元素个数
+  template <class T>
+  struct unrolled_list_node : public unrolled_list_node_base<T>
+  {
+    static constexpr size_t capacity = unrolled_list_node_size<T>::value;
+
+    size_t count;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type data[capacity];
+
+    T *values() noexcept { return reinterpret_cast<T *>(data); }
+    bool full() const noexcept { return count == capacity; }
+  };
+
+  // unrolled_list 的迭代器，由所在节点和节点内下标组成
+  template <class T, class Ref, class Ptr>
+  struct unrolled_list_iterator : public iterator<bidirectional_iterator_tag, T>
+  {
+    typedef unrolled_list_iterator<T, T &, T *> iterator;
+    typedef unrolled_list_iterator<T, const T &, const T *> const_iterator;
+    typedef unrolled_list_iterator self;
+
+    typedef T value_type;
+    typedef Ptr pointer;
+    typedef Ref reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef typename unrolled_list_node_traits<T>::base_ptr base_ptr;
+
+    base_ptr node_;
+    size_type index_;
+
+    unrolled_list_iterator() noexcept : node_(nullptr), index_(0) {}
+    unrolled_list_iterator(base_ptr n, size_type i) noexcept : node_(n), index_(i) {}
+    unrolled_list_iterator(const iterator &rhs) noexcept
+        : node_(rhs.node_), index_(rhs.index_) {}
+    self &operator=(const iterator &rhs) noexcept
+    {
+      node_ = rhs.node_;
+      index_ = rhs.index_;
+      return *this;
+    }
+
+    reference operator*() const { return node_->as_node()->values()[index_]; }
+    pointer operator->() const { return &(operator*()); }
+
+    self &operator++()
+    {
+      TINYSTL_DEBUG(node_ != nullptr);
+      if (++index_ == node_->as_node()->count)
+      {
+        node_ = node_->next;
+        index_ = 0;
+      }
+      return *this;
+    }
+    self operator++(int)
+    {
+      self tmp = *this;
+      ++*this;
+      return tmp;
+    }
+    self &operator--()
+    {
+      TINYSTL_DEBUG(node_ != nullptr);
+      if (index_ == 0)
+      {
+        node_ = node_->prev;
+        index_ = node_->as_node()->count;
+      }
+      --index_;
+      return *this;
+    }
+    self operator--(int)
+    {
+      self tmp = *this;
+      --*this;
+      return tmp;
+    }
+
+    bool operator==(const self &rhs) const { return node_ == rhs.node_ && index_ == rhs.index_; }
+    bool operator!=(const self &rhs) const { return !(*this == rhs); }
+  };
+
+  // 模板类 unrolled_list
+  // 模板参数 T 代表数据类型
+  template <class T>
+  class unrolled_list
+  {
+  public:
+    typedef tinystl::allocator<T> allocator_type;
+    typedef tinystl::allocator<T> data_allocator;
+    typedef tinystl::allocator<unrolled_list_node<T>> node_allocator;
+
+    typedef typename allocator_type::value_type value_type;
+    typedef typename allocator_type::pointer pointer;
+    typedef typename allocator_type::const_pointer const_pointer;
+    typedef typename allocator_type::reference reference;
+    typedef typename allocator_type::const_reference const_reference;
+    typedef typename allocator_type::size_type size_type;
+    typedef typename allocator_type::difference_type difference_type;
+
+    typedef unrolled_list_iterator<T, T &, T *> iterator;
+    typedef unrolled_list_iterator<T, const T &, const T *> const_iterator;
+    typedef tinystl::reverse_iterator<iterator> reverse_iterator;
+    typedef tinystl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    typedef unrolled_list_node_base<T> base_type;
+    typedef typename unrolled_list_node_traits<T>::base_ptr base_ptr;
+    typedef typename unrolled_list_node_traits<T>::node_ptr node_ptr;
+
+    static constexpr size_type node_capacity = unrolled_list_node<T>::capacity;
+
+    allocator_type get_allocator() { return allocator_type(); }
+
+  private:
+    base_type header_; // 头节点，header_.next 为第一个节点，header_.prev 为最后一个节点
+    size_type size_;
+
+  public:
+    // 构造、复制、移动、析构函数
+    unrolled_list() noexcept : size_(0) { header_.unlink(); }
+
+    explicit unrolled_list(size_type n) : size_(0)
+    {
+      header_.unlink();
+      fill_init(n, value_type());
+    }
+
+    unrolled_list(size_type n, const value_type &value) : size_(0)
+    {
+      header_.unlink();
+      fill_init(n, value);
+    }
+
+    template <class Iter, typename std::enable_if<
+                              tinystl::is_input_iterator<Iter>::value, int>::type = 0>
+    unrolled_list(Iter first, Iter last) : size_(0)
+    {
+      header_.unlink();
+      copy_init(first, last);
+    }
+
+    unrolled_list(std::initializer_list<value_type> ilist) : size_(0)
+    {
+      header_.unlink();
+      copy_init(ilist.begin(), ilist.end());
+    }
+
+    unrolled_list(const unrolled_list &rhs) : size_(0)
+    {
+      header_.unlink();
+      copy_init(rhs.begin(), rhs.end());
+    }
+
+    unrolled_list(unrolled_list &&rhs) noexcept : size_(0)
+    {
+      header_.unlink();
+      take_nodes(rhs);
+    }
+
+    unrolled_list &operator=(const unrolled_list &rhs)
+    {
+      if (this != &rhs)
+      {
+        unrolled_list tmp(rhs);
+        swap(tmp);
+      }
+      return *this;
+    }
+
+    unrolled_list &operator=(unrolled_list &&rhs) noexcept
+    {
+      if (this != &rhs)
+      {
+        clear();
+        take_nodes(rhs);
+      }
+      return *this;
+    }
+
+    unrolled_list &operator=(std::initializer_list<value_type> ilist)
+    {
+      unrolled_list tmp(ilist);
+      swap(tmp);
+      return *this;
+    }
+
+    ~unrolled_list() { clear(); }
+
+  public:
+    // 迭代器相关操作
+    iterator begin() noexcept { return iterator(header_.next, 0); }
+    const_iterator begin() const noexcept { return const_iterator(header_.next, 0); }
+    iterator end() noexcept { return iterator(&header_, 0); }
+    const_iterator end() const noexcept { return const_iterator(const_cast<base_ptr>(&header_), 0); }
+
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // 容量相关操作
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type max_size() const noexcept { return static_cast<size_type>(-1); }
+
+    // 访问元素相关操作
+    reference front()
+    {
+      TINYSTL_DEBUG(!empty());
+      return *begin();
+    }
+    const_reference front() const
+    {
+      TINYSTL_DEBUG(!empty());
+      return *begin();
+    }
+    reference back()
+    {
+      TINYSTL_DEBUG(!empty());
+      return *(--end());
+    }
+    const_reference back() const
+    {
+      TINYSTL_DEBUG(!empty());
+      return *(--end());
+    }
+
+    // 修改容器相关操作
+
+    // emplace / emplace_front / emplace_back
+    template <class... Args>
+    iterator emplace(const_iterator pos, Args &&...args);
+
+    template <class... Args>
+    void emplace_front(Args &&...args) { emplace(cbegin(), tinystl::forward<Args>(args)...); }
+    template <class... Args>
+    void emplace_back(Args &&...args) { emplace(cend(), tinystl::forward<Args>(args)...); }
+
+    // insert
+    iterator insert(const_iterator pos, const value_type &value) { return emplace(pos, value); }
+    iterator insert(const_iterator pos, value_type &&value) { return emplace(pos, tinystl::move(value)); }
+    template <class Iter, typename std::enable_if<
+                              tinystl::is_input_iterator<Iter>::value, int>::type = 0>
+    iterator insert(const_iterator pos, Iter first, Iter last);
+
+    // push_front / push_back
+    void push_front(const value_type &value) { emplace(cbegin(), value); }
+    void push_front(value_type &&value) { emplace(cbegin(), tinystl::move(value)); }
+    void push_back(const value_type &value) { emplace(cend(), value); }
+    void push_back(value_type &&value) { emplace(cend(), tinystl::move(value)); }
+
+    // pop_front / pop_back
+    void pop_front()
+    {
+      TINYSTL_DEBUG(!empty());
+      erase(cbegin());
+    }
+    void pop_back()
+    {
+      TINYSTL_DEBUG(!empty());
+      erase(--cend());
+    }
+
+    // erase / clear
+    iterator erase(const_iterator pos);
+    iterator erase(const_iterator first, const_iterator last);
+    void clear();
+
+    void swap(unrolled_list &rhs) noexcept;
+
+    // 节点个数，用于观察元素的紧凑程度
+    size_type node_count() const noexcept;
+
+  private:
+    // helper functions
+
+    // create / destroy node
+    node_ptr create_node();
+    void destroy_node(node_ptr p);
+
+    // link / unlink node
+    void link_node_before(base_ptr pos, node_ptr p);
+    void unlink_node(node_ptr p);
+
+    // initialize
+    void fill_init(size_type n, const value_type &value);
+    template <class Iter>
+    void copy_init(Iter first, Iter last);
+
+    // 接管 rhs 的全部节点，rhs 变为空
+    void take_nodes(unrolled_list &rhs) noexcept;
+
+    // 在节点 p 的下标 i 处腾出一个未构造的位置
+    void open_gap(node_ptr p, size_type i);
+    // 把节点 p 的后一半元素移到一个新节点中，返回新节点
+    node_ptr split_node(node_ptr p);
+    // 把 p 的后继节点中的元素全部移到 p 的末尾，并释放后继节点
+    void merge_next(node_ptr p);
+  };
+
+  /*****************************************************************************************/
+
+  // 在 pos 处就地构造一个元素
+  template <class T>
+  template <class... Args>
+  typename unrolled_list<T>::iterator
+  unrolled_list<T>::emplace(const_iterator pos, Args &&...args)
+  {
+    THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "unrolled_list<T>'s size too big");
+    value_type tmp(tinystl::forward<Args>(args)...);
+
+    node_ptr p = nullptr;
+    size_type i = pos.index_;
+    if (pos.node_ == &header_)
+    { // 在尾部插入：放到最后一个节点的末尾，已满时新建节点
+      if (header_.prev != &header_ && !header_.prev->as_node()->full())
+      {
+        p = header_.prev->as_node();
+        i = p->count;
+      }
+      else
+      {
+        p = create_node();
+        link_node_before(&header_, p);
+        i = 0;
+      }
+    }
+    else
+    {
+      p = pos.node_->as_node();
+      if (p->full())
+      {
+        if (i == 0)
+        { // 在节点头部插入：优先放到前驱节点的末尾
+          if (p->prev != &header_ && !p->prev->as_node()->full())
+          {
+            p = p->prev->as_node();
+            i = p->count;
+          }
+          else
+          {
+            node_ptr q = create_node();
+            link_node_before(p, q);
+            p = q;
+          }
+        }
+        else
+        {
+          node_ptr q = split_node(p);
+          if (i > p->count)
+          {
+            i -= p->count;
+            p = q;
+          }
+        }
+      }
+    }
+    open_gap(p, i);
+    data_allocator::construct(p->values() + i, tinystl::move(tmp));
+    ++p->count;
+    ++size_;
+    return iterator(p, i);
+  }
+
+  // 在 pos 处插入 [first, last) 内的元素
+  template <class T>
+  template <class Iter, typename std::enable_if<
+                            tinystl::is_input_iterator<Iter>::value, int>::type>
+  typename unrolled_list<T>::iterator
+  unrolled_list<T>::insert(const_iterator pos, Iter first, Iter last)
+  {
+    if (first == last)
+      return iterator(pos.node_, pos.index_);
+    iterator cur = emplace(pos, *first);
+    size_type n = 1;
+    for (++first; first != last; ++first, ++n)
+    {
+      ++cur;
+      cur = emplace(cur, *first);
+    }
+    // 插入过程中的拆分可能使先前的迭代器失效，从最后插入的元素退回到第一个
+    for (; n > 1; --n)
+      --cur;
+    return cur;
+  }
+
+  // 删除 pos 处的元素
+  template <class T>
+  typename unrolled_list<T>::iterator
+  unrolled_list<T>::erase(const_iterator pos)
+  {
+    TINYSTL_DEBUG(pos != cend());
+    node_ptr p = pos.node_->as_node();
+    size_type i = pos.index_;
+    T *v = p->values();
+    tinystl::move(v + i + 1, v + p->count, v + i);
+    data_allocator::destroy(v + p->count - 1);
+    --p->count;
+    --size_;
+
+    if (p->count == 0)
+    {
+      base_ptr next = p->next;
+      unlink_node(p);
+      destroy_node(p);
+      return iterator(next, 0);
+    }
+    // 节点过空时与后继节点合并，合并后的节点不超过容量的四分之三
+    if (p->count < node_capacity / 4 && p->next != &header_ &&
+        p->count + p->next->as_node()->count <= node_capacity * 3 / 4)
+      merge_next(p);
+    if (i == p->count)
+      return iterator(p->next, 0);
+    return iterator(p, i);
+  }
+
+  // 删除 [first, last) 内的元素
+  template <class T>
+  typename unrolled_list<T>::iterator
+  unrolled_list<T>::erase(const_iterator first, const_iterator last)
+  {
+    // 删除会移动元素，last 可能失效，因此先计算个数
+    size_type n = tinystl::distance(first, last);
+    iterator cur(first.node_, first.index_);
+    for (; n > 0; --n)
+      cur = erase(cur);
+    return cur;
+  }
+
+  // 清空容器
+  template <class T>
+  void unrolled_list<T>::clear()
+  {
+    base_ptr cur = header_.next;
+    while (cur != &header_)
+    {
+      base_ptr next = cur->next;
+      node_ptr p = cur->as_node();
+      data_allocator::destroy(p->values(), p->values() + p->count);
+      destroy_node(p);
+      cur = next;
+    }
+    header_.unlink();
+    size_ = 0;
+  }
+
+  // 交换两个 unrolled_list
+  template <class T>
+  void unrolled_list<T>::swap(unrolled_list &rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      unrolled_list tmp(tinystl::move(rhs));
+      rhs.take_nodes(*this);
+      take_nodes(tmp);
+    }
+  }
+
+  template <class T>
+  typename unrolled_list<T>::size_type
+  unrolled_list<T>::node_count() const noexcept
+  {
+    size_type n = 0;
+    for (base_ptr cur = header_.next; cur != &header_; cur = cur->next)
+      ++n;
+    return n;
+  }
+
+  /*****************************************************************************************/
+  // helper function
+
+  // 创建一个空节点
+  template <class T>
+  typename unrolled_list<T>::node_ptr
+  unrolled_list<T>::create_node()
+  {
+    node_ptr p = node_allocator::allocate(1);
+    p->prev = nullptr;
+    p->next = nullptr;
+    p->count = 0;
+    return p;
+  }
+
+  // 释放节点，节点内的元素应已析构
+  template <class T>
+  void unrolled_list<T>::destroy_node(node_ptr p)
+  {
+    node_allocator::deallocate(p);
+  }
+
+  // 把节点 p 连接在 pos 之前
+  template <class T>
+  void unrolled_list<T>::link_node_before(base_ptr pos, node_ptr p)
+  {
+    p->prev = pos->prev;
+    p->next = pos;
+    pos->prev->next = p;
+    pos->prev = p;
+  }
+
+  template <class T>
+  void unrolled_list<T>::unlink_node(node_ptr p)
+  {
+    p->prev->next = p->next;
+    p->next->prev = p->prev;
+  }
+
+  // 用 n 个元素初始化容器
+  template <class T>
+  void unrolled_list<T>::fill_init(size_type n, const value_type &value)
+  {
+    try
+    {
+      for (; n > 0; --n)
+        emplace_back(value);
+    }
+    catch (...)
+    {
+      clear();
+      throw;
+    }
+  }
+
+  // 以 [first, last) 初始化容器
+  template <class T>
+  template <class Iter>
+  void unrolled_list<T>::copy_init(Iter first, Iter last)
+  {
+    try
+    {
+      for (; first != last; ++first)
+        emplace_back(*first);
+    }
+    catch (...)
+    {
+      clear();
+      throw;
+    }
+  }
+
+  template <class T>
+  void unrolled_list<T>::take_nodes(unrolled_list &rhs) noexcept
+  {
+    if (rhs.header_.next != &rhs.header_)
+    {
+      header_.next = rhs.header_.next;
+      header_.prev = rhs.header_.prev;
+      header_.next->prev = &header_;
+      header_.prev->next = &header_;
+      size_ = rhs.size_;
+      rhs.header_.unlink();
+      rhs.size_ = 0;
+    }
+  }
+
+  // 把 [i, count) 内的元素向后移动一位，节点必须未满
+  template <class T>
+  void unrolled_list<T>::open_gap(node_ptr p, size_type i)
+  {
+    TINYSTL_DEBUG(!p->full());
+    T *v = p->values();
+    const size_type n = p->count;
+    if (i == n)
+      return;
+    data_allocator::construct(v + n, tinystl::move(v[n - 1]));
+    tinystl::move_backward(v + i, v + n - 1, v + n);
+    data_allocator::destroy(v + i);
+  }
+
+  template <class T>
+  typename unrolled_list<T>::node_ptr
+  unrolled_list<T>::split_node(node_ptr p)
+  {
+    node_ptr q = create_node();
+    const size_type half = p->count / 2;
+    T *src = p->values();
+    T *dst = q->values();
+    for (size_type i = half; i < p->count; ++i)
+    {
+      data_allocator::construct(dst + (i - half), tinystl::move(src[i]));
+      data_allocator::destroy(src + i);
+    }
+    q->count = p->count - half;
+    p->count = half;
+    link_node_before(p->next, q);
+    return q;
+  }
+
+  template <class T>
+  void unrolled_list<T>::merge_next(node_ptr p)
+  {
+    node_ptr q = p->next->as_node();
+    T *src = q->values();
+    T *dst = p->values() + p->count;
+    for (size_type i = 0; i < q->count; ++i)
+    {
+      data_allocator::construct(dst + i, tinystl::move(src[i]));
+      data_allocator::destroy(src + i);
+    }
+    p->count += q->count;
+    unlink_node(q);
+    destroy_node(q);
+  }
+
+  // 重载比较操作符
+  template <class T>
+  bool operator==(const unrolled_list<T> &lhs, const unrolled_list<T> &rhs)
+  {
+    return lhs.size() == rhs.size() && tinystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+  }
+
+  template <class T>
+  bool operator!=(const unrolled_list<T> &lhs, const unrolled_list<T> &rhs)
+  {
+    return !(lhs == rhs);
+  }
+
+  template <class T>
+  bool operator<(const unrolled_list<T> &lhs, const unrolled_list<T> &rhs)
+  {
+    return tinystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+
+  template <class T>
+  bool operator>(const unrolled_list<T> &lhs, const unrolled_list<T> &rhs)
+  {
+    return rhs < lhs;
+  }
+
+  template <class T>
+  bool operator<=(const unrolled_list<T> &lhs, const unrolled_list<T> &rhs)
+  {
+    return !(rhs < lhs);
+  }
+
+  template <class T>
+  bool operator>=(const unrolled_list<T> &lhs, const unrolled_list<T> &rhs)
+  {
+    return !(lhs < rhs);
+  }
+
+  // 重载 tinystl 的 swap
+  template <class T>
+  void swap(unrolled_list<T> &lhs, unrolled_list<T> &rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+} // namespace tinystl
+
+#endif // !TINYSTL_UNROLLED_LIST_H_
@@ -7,6 +7,7 @@
 #include "allocator.h"
 #include "iterator.h"
 #include "memory.h"
+#include "uninitialized.h"
 #include "utils.h"
 #include "exceptdef.h"
 using namespace std;
@@ -75,7 +76,7 @@ namespace tinystl
     {
       range_init(rhs.begin_, rhs.end_);
     }
-    vector(vector &rhs) noexcept : begin_(rhs.begin_), end_(rhs.end_), cap_(rhs.cap_)
+    vector(vector &&rhs) noexcept : begin_(rhs.begin_), end_(rhs.end_), cap_(rhs.cap_)
     {
       rhs.begin_ = nullptr;
       rhs.end_ = nullptr;
@@ -248,8 +249,8 @@ namespace tinystl
 
     void reverse()
     {
-    tinystl:
-      reverse(begin(), end());
+      for (iterator first = begin_, last = end_; first < last && first < --last; ++first)
+        tinystl::iter_swap(first, last);
     }
 
     // swap
@@ -297,7 +298,7 @@ namespace tinystl
   {
     if (this == &rhs)
     {
-      return this;
+      return *this;
     }
     const size_type len = rhs.size();
     if (len > capacity())
@@ -307,21 +308,24 @@ namespace tinystl
     }
     else if (size() >= len)
     {
-      auto i = std::copy(rhs.begin(), rhs.end(), begin());
+      auto i = tinystl::copy(rhs.begin(), rhs.end(), begin());
       data_allocator::destroy(i, end_);
       end_ = begin_ + len;
     }
     else
     {
-      std::copy(rhs.begin(), rhs.begin() + size(), begin_);
-      std::uninitialized_copy(rhs.begin() + size(), rhs.end(), end_);
-      cap_ = end_ = begin_ + len;
+      tinystl::copy(rhs.begin(), rhs.begin() + size(), begin_);
+      tinystl::uninitialized_copy(rhs.begin() + size(), rhs.end(), end_);
+      end_ = begin_ + len;
     }
+    return *this;
   }
 
   template <class T>
   vector<T> &vector<T>::operator=(vector &&rhs) noexcept
   {
+    if (this == &rhs)
+      return *this;
     destroy_and_recover(begin_, end_, cap_ - begin_);
     begin_ = rhs.begin_;
     end_ = rhs.end_;
@@ -342,8 +346,16 @@ namespace tinystl
                             "n can not larger than max_size() in vector<T>::reserve(n)");
       const auto old_size = size();
       auto tmp = data_allocator::allocate(n);
-      uninitialized_move(begin_, end_, tmp);
-      data_allocator::deallocate(begin_, cap_ - begin_);
+      try
+      {
+        tinystl::uninitialized_move(begin_, end_, tmp);
+      }
+      catch (...)
+      {
+        data_allocator::deallocate(tmp, n);
+        throw;
+      }
+      destroy_and_recover(begin_, end_, cap_ - begin_);
       begin_ = tmp;
       end_ = tmp + old_size;
       cap_ = begin_ + n;
@@ -376,11 +388,11 @@ namespace tinystl
     }
     else if (end_ != cap_)
     {
-      auto new_end = end_;
-      data_allocator::construct(tinystl::address_of(*end_), *(end_ - 1));
-      ++new_end;
-      copy_backward(xpos, end_ - 1, end_);
-      *xpos = value_type(tinystl::forward<Args>(args)...);
+      value_type value_copy(tinystl::forward<Args>(args)...); // 先构造，避免 args 引用容器内的元素
+      data_allocator::construct(tinystl::address_of(*end_), tinystl::move(*(end_ - 1)));
+      ++end_;
+      tinystl::move_backward(xpos, end_ - 2, end_ - 1);
+      *xpos = tinystl::move(value_copy);
     }
     else
     {
@@ -442,13 +454,11 @@ namespace tinystl
     }
     else if (end_ != cap_)
     {
-      auto new_end = end_;
-      data_allocator::construct(tinystl::address_of(*end_), *(end_ - 1));
-      ++new_end;
-      auto value_copy = value; // 避免元素因以下复制操作而被改变
-      copy_backward(xpos, end_ - 1, end_);
+      auto value_copy = value; // 避免元素因以下移动操作而被改变
+      data_allocator::construct(tinystl::address_of(*end_), tinystl::move(*(end_ - 1)));
+      ++end_;
+      tinystl::move_backward(xpos, end_ - 2, end_ - 1);
       *xpos = tinystl::move(value_copy);
-      end_ = new_end;
     }
     else
     {
@@ -478,6 +488,8 @@ namespace tinystl
     TINYSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
     const auto n = first - begin();
     iterator r = begin_ + (first - begin());
+    if (first == last)
+      return r;
     data_allocator::destroy(tinystl::move(r + (last - first), end_, r), end_);
     end_ = end_ - (last - first);
     return begin_ + n;
@@ -503,9 +515,9 @@ namespace tinystl
   {
     if (this != &rhs)
     {
-      swap(begin_, rhs.begin_);
-      swap(end_, rhs.end_);
-      swap(cap_, rhs.cap_);
+      tinystl::swap(begin_, rhs.begin_);
+      tinystl::swap(end_, rhs.end_);
+      tinystl::swap(cap_, rhs.cap_);
     }
   }
 
@@ -543,7 +555,7 @@ namespace tinystl
     {
       begin_ = nullptr;
       end_ = nullptr;
-      cap = nullptr;
+      cap_ = nullptr;
       throw;
     }
   }
@@ -553,7 +565,15 @@ namespace tinystl
   {
     const size_type init_size = tinystl::max(static_cast<size_type>(16), n);
     init_space(n, init_size);
-    uninitialized_fill_n(begin_, n, value);
+    try
+    {
+      tinystl::uninitialized_fill_n(begin_, n, value);
+    }
+    catch (...)
+    {
+      data_allocator::deallocate(begin_, init_size);
+      throw;
+    }
   }
 
   // range_init 函数
@@ -562,10 +582,18 @@ namespace tinystl
   void vector<T>::
       range_init(Iter first, Iter last)
   {
-    const size_type init_size = tinystl::max(static_cast<size_type>(last - first),
-                                             static_cast<size_type>(16));
-    init_space(static_cast<size_type>(last - first), init_size);
-    uninitialized_copy(first, last, begin_);
+    const size_type len = static_cast<size_type>(tinystl::distance(first, last));
+    const size_type init_size = tinystl::max(len, static_cast<size_type>(16));
+    init_space(len, init_size);
+    try
+    {
+      tinystl::uninitialized_copy(first, last, begin_);
+    }
+    catch (...)
+    {
+      data_allocator::deallocate(begin_, init_size);
+      throw;
+    }
   }
 
   // destroy_and_recover 函数
@@ -610,12 +638,12 @@ namespace tinystl
     }
     else if (n > size())
     {
-      fill(begin(), end(), value);
-      end_ = uninitialized_fill_n(end_, n - size(), value);
+      tinystl::fill(begin(), end(), value);
+      end_ = tinystl::uninitialized_fill_n(end_, n - size(), value);
     }
     else
     {
-      erase(fill_n(begin_, n, value), end_);
+      erase(tinystl::fill_n(begin_, n, value), end_);
     }
   }
 
@@ -630,7 +658,7 @@ namespace tinystl
     }
     if (first == last)
     {
-      erase(first, last);
+      erase(cur, end_);
     }
     else
     {
@@ -652,7 +680,7 @@ namespace tinystl
     }
     else if (size() >= len)
     {
-      auto new_end = copy(first, last, begin_);
+      auto new_end = tinystl::copy(first, last, begin_);
       data_allocator::destroy(new_end, end_);
       end_ = new_end;
     }
@@ -660,8 +688,8 @@ namespace tinystl
     {
       auto mid = first;
       tinystl::advance(mid, size());
-      copy(first, mid, begin_);
-      auto new_end = uninitialized_copy(mid, last, end_);
+      tinystl::copy(first, mid, begin_);
+      auto new_end = tinystl::uninitialized_copy(mid, last, end_);
       end_ = new_end;
     }
   }
@@ -677,16 +705,17 @@ namespace tinystl
     auto new_end = new_begin;
     try
     {
-      new_end = uninitialized_move(begin_, pos, new_begin);
-      data_allocator::construct(tinystl::address_of(*new_end), tinystl::forward<Args>(args)...);
-      ++new_end;
-      new_end = uninitialized_move(pos, end_, new_end);
+      data_allocator::construct(tinystl::address_of(*(new_begin + (pos - begin_))),
+                                tinystl::forward<Args>(args)...);
     }
     catch (...)
     {
       data_allocator::deallocate(new_begin, new_size);
       throw;
     }
+    new_end = tinystl::uninitialized_move(begin_, pos, new_begin);
+    ++new_end;
+    new_end = tinystl::uninitialized_move(pos, end_, new_end);
     destroy_and_recover(begin_, end_, cap_ - begin_);
     begin_ = new_begin;
     end_ = new_end;
@@ -703,16 +732,16 @@ namespace tinystl
     const value_type &value_copy = value;
     try
     {
-      new_end = uninitialized_move(begin_, pos, new_begin);
-      data_allocator::construct(tinystl::address_of(*new_end), value_copy);
-      ++new_end;
-      new_end = uninitialized_move(pos, end_, new_end);
+      data_allocator::construct(tinystl::address_of(*(new_begin + (pos - begin_))), value_copy);
     }
     catch (...)
     {
       data_allocator::deallocate(new_begin, new_size);
       throw;
     }
+    new_end = tinystl::uninitialized_move(begin_, pos, new_begin);
+    ++new_end;
+    new_end = tinystl::uninitialized_move(pos, end_, new_end);
     destroy_and_recover(begin_, end_, cap_ - begin_);
     begin_ = new_begin;
     end_ = new_end;
@@ -735,16 +764,16 @@ namespace tinystl
       auto old_end = end_;
       if (after_elems > n)
       {
-        uninitialized_copy(end_ - n, end_, end_);
+        tinystl::uninitialized_move(end_ - n, end_, end_);
         end_ += n;
-        move_backward(pos, old_end - n, old_end);
-        uninitialized_fill_n(pos, n, value_copy);
+        tinystl::move_backward(pos, old_end - n, old_end);
+        tinystl::fill_n(pos, n, value_copy);
       }
       else
       {
-        end_ = uninitialized_fill_n(end_, n - after_elems, value_copy);
-        end_ = uninitialized_move(pos, old_end, end_);
-        uninitialized_fill_n(pos, after_elems, value_copy);
+        end_ = tinystl::uninitialized_fill_n(end_, n - after_elems, value_copy);
+        end_ = tinystl::uninitialized_move(pos, old_end, end_);
+        tinystl::fill_n(pos, after_elems, value_copy);
       }
     }
     else
@@ -754,16 +783,16 @@ namespace tinystl
       auto new_end = new_begin;
       try
       {
-        new_end = uninitialized_move(begin_, pos, new_begin);
-        new_end = uninitialized_fill_n(new_end, n, value);
-        new_end = uninitialized_move(pos, end_, new_end);
+        new_end = tinystl::uninitialized_move(begin_, pos, new_begin);
+        new_end = tinystl::uninitialized_fill_n(new_end, n, value_copy);
+        new_end = tinystl::uninitialized_move(pos, end_, new_end);
       }
       catch (...)
       {
         destroy_and_recover(new_begin, new_end, new_size);
         throw;
       }
-      data_allocator::deallocate(begin_, cap_ - begin_);
+      destroy_and_recover(begin_, end_, cap_ - begin_);
       begin_ = new_begin;
       end_ = new_end;
       cap_ = begin_ + new_size;
@@ -786,17 +815,17 @@ namespace tinystl
       auto old_end = end_;
       if (after_elems > n)
       {
-        end_ = uninitialized_copy(end_ - n, end_, end_);
-        move_backward(pos, old_end - n, old_end);
-        uninitialized_copy(first, last, pos);
+        end_ = tinystl::uninitialized_move(end_ - n, end_, end_);
+        tinystl::move_backward(pos, old_end - n, old_end);
+        tinystl::copy(first, last, pos);
       }
       else
       {
         auto mid = first;
         tinystl::advance(mid, after_elems);
-        end_ = uninitialized_copy(mid, last, end_);
-        end_ = uninitialized_move(pos, old_end, end_);
-        uninitialized_copy(first, mid, pos);
+        end_ = tinystl::uninitialized_copy(mid, last, end_);
+        end_ = tinystl::uninitialized_move(pos, old_end, end_);
+        tinystl::copy(first, mid, pos);
       }
     }
     else
@@ -806,16 +835,16 @@ namespace tinystl
       auto new_end = new_begin;
       try
       {
-        new_end = uninitialized_move(begin_, pos, new_begin);
-        new_end = uninitialized_copy(first, last, new_end);
-        new_end = uninitialized_move(pos, end_, new_end);
+        new_end = tinystl::uninitialized_move(begin_, pos, new_begin);
+        new_end = tinystl::uninitialized_copy(first, last, new_end);
+        new_end = tinystl::uninitialized_move(pos, end_, new_end);
       }
       catch (...)
       {
         destroy_and_recover(new_begin, new_end, new_size);
         throw;
       }
-      data_allocator::deallocate(begin_, cap_ - begin_);
+      destroy_and_recover(begin_, end_, cap_ - begin_);
       begin_ = new_begin;
       end_ = new_end;
       cap_ = begin_ + new_size;
@@ -829,14 +858,14 @@ namespace tinystl
     auto new_begin = data_allocator::allocate(size);
     try
     {
-      uninitialized_move(begin_, end_, new_begin);
+      tinystl::uninitialized_move(begin_, end_, new_begin);
     }
     catch (...)
     {
       data_allocator::deallocate(new_begin, size);
       throw;
     }
-    data_allocator::deallocate(begin_, cap_ - begin_);
+    destroy_and_recover(begin_, end_, cap_ - begin_);
     begin_ = new_begin;
     end_ = begin_ + size;
     cap_ = begin_ + size;
@@ -847,13 +876,13 @@ namespace tinystl
   template <class T>
   bool operator==(const vector<T> &lhs, const vector<T> &rhs)
   {
-    return lhs.size() == rhs.size() && equal((lhs.begin(), lhs.end(), rhs.begin()));
+    return lhs.size() == rhs.size() && tinystl::equal(lhs.begin(), lhs.end(), rhs.begin());
   }
 
   template <class T>
   bool operator<(const vector<T> &lhs, const vector<T> &rhs)
   {
-    return lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), lhs.end());
+    return tinystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
   }
 
   template <class T>
@@ -0,0 +1,264 @@
+#ifndef TINYSTL_WORK_STEALING_DEQUE_H_
+#define TINYSTL_WORK_STEALING_DEQUE_H_
+
+// 这个头文件包含一个无锁的工作窃取双端队列 work_stealing_deque
+// 算法为 Chase-Lev deque，内存序按照 Lê 等人 (PPoPP 2013) 给出的 C11 版本
+
+// notes:
+//
+// 1. 只有一个拥有者线程可以调用 push / pop，它们在底部 (bottom) 操作
+// 2. 任意多个窃取者线程可以调用 steal，它在顶部 (top) 操作
+// 3. 底层是可增长的环形数组，扩容后旧数组可能仍被窃取者读取，因此保留到析构时才释放
+// 4. 槽位以 std::atomic<T> 保存，要求 T 为 trivially copyable 的类型，例如任务指针
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+#include "allocator.h"
+#include "exceptdef.h"
+
+namespace tinystl
+{
+// 缓存行大小，用于隔开会被不同线程频繁写入的数据
+#ifndef TINYSTL_CACHELINE_SIZE
+#define TINYSTL_CACHELINE_SIZE 64
+#endif
+
+// work_stealing_deque 的初始容量
+#ifndef WS_DEQUE_INIT_SIZE
+#define WS_DEQUE_INIT_SIZE 64
+#endif
+
+  // work_stealing_deque 的环形数组，prev 指向扩容前的旧数组
+  template <class T>
+  struct ws_deque_array
+  {
+    typedef tinystl::allocator<std::atomic<T>> slot_allocator;
+
+    int64_t capacity;
+    int64_t mask;
+    std::atomic<T> *slots;
+    ws_deque_array *prev;
+
+    explicit ws_deque_array(int64_t n)
+        : capacity(n), mask(n - 1), slots(nullptr), prev(nullptr)
+    {
+      slots = slot_allocator::allocate(static_cast<size_t>(n));
+      for (int64_t i = 0; i < n; ++i)
+        ::new (static_cast<void *>(slots + i)) std::atomic<T>();
+    }
+
+    ~ws_deque_array()
+    {
+      slot_allocator::deallocate(slots, static_cast<size_t>(capacity));
+    }
+
+    ws_deque_array(const ws_deque_array &) = delete;
+    ws_deque_array &operator=(const ws_deque_array &) = delete;
+
+    void put(int64_t i, const T &value) noexcept
+    {
+      slots[i & mask].store(value, std::memory_order_relaxed);
+    }
+
+    T get(int64_t i) const noexcept
+    {
+      return slots[i & mask].load(std::memory_order_relaxed);
+    }
+  };
+
+  // 模板类 work_stealing_deque
+  // 模板参数代表数据类型
+  template <class T>
+  class work_stealing_deque
+  {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "the value_type of work_stealing_deque should be trivially copyable");
+
+  public:
+    typedef T value_type;
+    typedef size_t size_type;
+
+    typedef ws_deque_array<T> array_type;
+    typedef tinystl::allocator<array_type> array_allocator;
+
+  private:
+    // top 被窃取者修改，bottom 只被拥有者修改，分别放在不同的缓存行上
+    std::atomic<int64_t> top_;
+    char pad0_[TINYSTL_CACHELINE_SIZE - sizeof(std::atomic<int64_t>)];
+
+    std::atomic<int64_t> bottom_;
+    std::atomic<array_type *> array_;
+    char pad1_[TINYSTL_CACHELINE_SIZE - sizeof(std::atomic<int64_t>) - sizeof(std::atomic<array_type *>)];
+
+  public:
+    // 构造、析构函数
+    explicit work_stealing_deque(size_type capacity = WS_DEQUE_INIT_SIZE);
+
+    work_stealing_deque(const work_stealing_deque &) = delete;
+    work_stealing_deque &operator=(const work_stealing_deque &) = delete;
+
+    ~work_stealing_deque();
+
+  public:
+    // 容量相关操作，在并发修改时只是近似值
+    size_type size_approx() const noexcept
+    {
+      const int64_t b = bottom_.load(std::memory_order_relaxed);
+      const int64_t t = top_.load(std::memory_order_relaxed);
+      return b > t ? static_cast<size_type>(b - t) : 0;
+    }
+    bool empty_approx() const noexcept { return size_approx() == 0; }
+
+    size_type capacity() const noexcept
+    {
+      return static_cast<size_type>(array_.load(std::memory_order_relaxed)->capacity);
+    }
+
+    // 拥有者操作
+    void push(const value_type &value);
+    bool pop(value_type &value);
+
+    // 窃取者操作，队列为空或与其他线程竞争失败时返回 false
+    bool steal(value_type &value);
+
+  private:
+    // helper functions
+    array_type *create_array(int64_t n);
+    void destroy_array(array_type *a);
+    array_type *grow(array_type *a, int64_t b, int64_t t);
+  };
+
+  /*****************************************************************************************/
+
+  // 构造函数
+  template <class T>
+  work_stealing_deque<T>::work_stealing_deque(size_type capacity)
+      : top_(0), bottom_(0), array_(nullptr)
+  {
+    THROW_LENGTH_ERROR_IF(capacity > (static_cast<size_type>(1) << 62),
+                          "work_stealing_deque<T>'s capacity too big");
+    int64_t n = 2;
+    while (static_cast<size_type>(n) < capacity)
+      n <<= 1;
+    array_.store(create_array(n), std::memory_order_relaxed);
+  }
+
+  // 析构函数，释放当前数组以及所有旧数组
+  template <class T>
+  work_stealing_deque<T>::~work_stealing_deque()
+  {
+    array_type *a = array_.load(std::memory_order_relaxed);
+    while (a != nullptr)
+    {
+      array_type *prev = a->prev;
+      destroy_array(a);
+      a = prev;
+    }
+  }
+
+  // 在底部放入元素，空间不足时扩容
+  template <class T>
+  void work_stealing_deque<T>::push(const value_type &value)
+  {
+    const int64_t b = bottom_.load(std::memory_order_relaxed);
+    const int64_t t = top_.load(std::memory_order_acquire);
+    array_type *a = array_.load(std::memory_order_relaxed);
+    if (b - t > a->capacity - 1)
+      a = grow(a, b, t);
+    a->put(b, value);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+  }
+
+  // 从底部取出元素，队列为空时返回 false
+  // 只剩最后一个元素时与窃取者在 top 上竞争
+  template <class T>
+  bool work_stealing_deque<T>::pop(value_type &value)
+  {
+    const int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    array_type *a = array_.load(std::memory_order_relaxed);
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top_.load(std::memory_order_relaxed);
+    if (t > b)
+    { // 队列为空，恢复 bottom
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return false;
+    }
+    value = a->get(b);
+    if (t == b)
+    { // 最后一个元素
+      const bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                    std::memory_order_relaxed);
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return won;
+    }
+    return true;
+  }
+
+  // 从顶部窃取元素
+  template <class T>
+  bool work_stealing_deque<T>::steal(value_type &value)
+  {
+    int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t b = bottom_.load(std::memory_order_acquire);
+    if (t >= b)
+      return false;
+    // 原文使用 consume，这里按惯例加强为 acquire
+    array_type *a = array_.load(std::memory_order_acquire);
+    const value_type x = a->get(t);
+    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed))
+      return false;
+    value = x;
+    return true;
+  }
+
+  /*****************************************************************************************/
+  // helper function
+
+  template <class T>
+  typename work_stealing_deque<T>::array_type *
+  work_stealing_deque<T>::create_array(int64_t n)
+  {
+    array_type *a = array_allocator::allocate(1);
+    try
+    {
+      array_allocator::construct(a, n);
+    }
+    catch (...)
+    {
+      array_allocator::deallocate(a, 1);
+      throw;
+    }
+    return a;
+  }
+
+  template <class T>
+  void work_stealing_deque<T>::destroy_array(array_type *a)
+  {
+    array_allocator::destroy(a);
+    array_allocator::deallocate(a, 1);
+  }
+
+  // 容量翻倍，把 [t, b) 内的元素复制到新数组，旧数组挂在新数组的 prev 上
+  template <class T>
+  typename work_stealing_deque<T>::array_type *
+  work_stealing_deque<T>::grow(array_type *a, int64_t b, int64_t t)
+  {
+    THROW_LENGTH_ERROR_IF(a->capacity > (static_cast<int64_t>(1) << 61),
+                          "work_stealing_deque<T> too long");
+    array_type *na = create_array(a->capacity << 1);
+    for (int64_t i = t; i < b; ++i)
+      na->put(i, a->get(i));
+    na->prev = a;
+    array_.store(na, std::memory_order_release);
+    return na;
+  }
+
+} // namespace tinystl
+
+#endif // !TINYSTL_WORK_STEALING_DEQUE_H_